@@ -0,0 +1,55 @@
+//go:build libsecp256k1_sdk
+// +build libsecp256k1_sdk
+
+package secp256k1
+
+import (
+	"math/big"
+	"testing"
+
+	"github.com/cometbft/cometbft/crypto"
+
+	"github.com/cosmos/cosmos-sdk/crypto/keys/secp256k1/internal/secp256k1"
+)
+
+// libsecp256k1 halves of the backend comparison benchmarks in bench_test.go.
+
+func benchSignRecoverable(b *testing.B, priv *PrivKey, hash []byte) []byte {
+	b.Helper()
+	sig, err := secp256k1.Sign(hash, priv.Key)
+	if err != nil {
+		b.Fatal(err)
+	}
+	return sig
+}
+
+// benchVerifyUncached bypasses the signature cache PubKey.VerifySignature uses.
+func benchVerifyUncached(pub *PubKey, msg, sig []byte) bool {
+	return secp256k1.VerifySignature(pub.Bytes(), crypto.Sha256(msg), sig)
+}
+
+func benchRecoverPubkey(hash, sig []byte) error {
+	_, err := secp256k1.RecoverPubkey(hash, sig)
+	return err
+}
+
+func benchParsePubkey(pub []byte) ([2]*big.Int, error) {
+	x, y := secp256k1.DecompressPubkey(pub)
+	if x == nil {
+		return [2]*big.Int{}, secp256k1.ErrInvalidPubkey
+	}
+	return [2]*big.Int{x, y}, nil
+}
+
+func benchDecompressPubkey(pub []byte) error {
+	_, err := benchParsePubkey(pub)
+	return err
+}
+
+func benchCompressPubkey(x, y *big.Int) []byte {
+	return secp256k1.CompressPubkey(x, y)
+}
+
+func benchScalarMult(x, y *big.Int, k []byte) (*big.Int, *big.Int) {
+	return secp256k1.S256().ScalarMult(x, y, k)
+}
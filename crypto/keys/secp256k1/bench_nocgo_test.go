@@ -0,0 +1,52 @@
+//go:build !libsecp256k1_sdk
+// +build !libsecp256k1_sdk
+
+package secp256k1
+
+import (
+	"math/big"
+	"testing"
+
+	secp "github.com/decred/dcrd/dcrec/secp256k1/v4"
+	"github.com/decred/dcrd/dcrec/secp256k1/v4/ecdsa"
+)
+
+// dcrd halves of the backend comparison benchmarks in bench_test.go.
+
+func benchSignRecoverable(b *testing.B, priv *PrivKey, hash []byte) []byte {
+	b.Helper()
+	return ecdsa.SignCompact(secp.PrivKeyFromBytes(priv.Key), hash, false)
+}
+
+func benchVerifyUncached(pub *PubKey, msg, sig []byte) bool {
+	return pub.VerifySignature(msg, sig)
+}
+
+func benchRecoverPubkey(hash, sig []byte) error {
+	_, _, err := ecdsa.RecoverCompact(sig, hash)
+	return err
+}
+
+func benchParsePubkey(pub []byte) ([2]*big.Int, error) {
+	key, err := secp.ParsePubKey(pub)
+	if err != nil {
+		return [2]*big.Int{}, err
+	}
+	return [2]*big.Int{key.X(), key.Y()}, nil
+}
+
+func benchDecompressPubkey(pub []byte) error {
+	_, err := secp.ParsePubKey(pub)
+	return err
+}
+
+func benchCompressPubkey(x, y *big.Int) []byte {
+	var fx, fy secp.FieldVal
+	fx.SetByteSlice(x.Bytes())
+	fy.SetByteSlice(y.Bytes())
+	return secp.NewPublicKey(&fx, &fy).SerializeCompressed()
+}
+
+func benchScalarMult(x, y *big.Int, k []byte) (*big.Int, *big.Int) {
+	return secp.S256().ScalarMult(x, y, k)
+}
@@ -1,13 +1,30 @@
 package secp256k1
 
 import (
+	"errors"
 	"io"
+	"math/big"
 	"testing"
 
+	"github.com/cometbft/cometbft/crypto"
+
 	"github.com/cosmos/cosmos-sdk/crypto/keys/internal/benchmarking"
 	"github.com/cosmos/cosmos-sdk/crypto/types"
 )
 
+// The benchmarks below have the same names in both builds, so the libsecp256k1
+// (cgo) and dcrd (nocgo) backends can be compared with benchstat:
+//
+//	go test -run NONE -bench . -count 10 > nocgo.txt
+//	go test -tags libsecp256k1_sdk -run NONE -bench . -count 10 > cgo.txt
+//	benchstat nocgo.txt cgo.txt
+//
+// The backend specific halves live in bench_cgo_test.go and bench_nocgo_test.go.
+//
+// The cgo build verifies through a signature cache, so BenchmarkVerification*,
+// which check the same signature over and over, measure cache hits there;
+// BenchmarkVerificationUncached measures the curve arithmetic in both.
+
 func BenchmarkKeyGeneration(b *testing.B) {
 	b.ReportAllocs()
 	benchmarkKeygenWrapper := func(reader io.Reader) types.PrivKey {
@@ -28,3 +45,130 @@ func BenchmarkVerification(b *testing.B) {
 	priv := GenPrivKey()
 	benchmarking.BenchmarkVerification(b, priv)
 }
+
+var errBenchVerify = errors.New("signature does not verify")
+
+func BenchmarkSigningParallel(b *testing.B) {
+	priv := GenPrivKey()
+	msg := []byte("Hello, world!")
+	benchmarkParallel(b, func() error {
+		_, err := priv.Sign(msg)
+		return err
+	})
+}
+
+func BenchmarkVerificationParallel(b *testing.B) {
+	priv := GenPrivKey()
+	pub := priv.PubKey()
+	msg := []byte("Hello, world!")
+	sig, err := priv.Sign(msg)
+	if err != nil {
+		b.Fatal(err)
+	}
+	benchmarkParallel(b, func() error {
+		if !pub.VerifySignature(msg, sig) {
+			return errBenchVerify
+		}
+		return nil
+	})
+}
+
+func BenchmarkVerificationUncached(b *testing.B) {
+	priv := GenPrivKey()
+	pub := priv.PubKey().(*PubKey)
+	msg := []byte("Hello, world!")
+	sig, err := priv.Sign(msg)
+	if err != nil {
+		b.Fatal(err)
+	}
+	benchmarkSerialAndParallel(b, func() error {
+		if !benchVerifyUncached(pub, msg, sig) {
+			return errBenchVerify
+		}
+		return nil
+	})
+}
+
+func BenchmarkRecoverPubkey(b *testing.B) {
+	priv := GenPrivKey()
+	hash := crypto.Sha256([]byte("Hello, world!"))
+	sig := benchSignRecoverable(b, priv, hash)
+	benchmarkSerialAndParallel(b, func() error {
+		return benchRecoverPubkey(hash, sig)
+	})
+}
+
+func BenchmarkDecompressPubkey(b *testing.B) {
+	pub := GenPrivKey().PubKey().Bytes()
+	benchmarkSerialAndParallel(b, func() error {
+		return benchDecompressPubkey(pub)
+	})
+}
+
+func BenchmarkCompressPubkey(b *testing.B) {
+	x, y := benchPubkeyCoords(b, GenPrivKey())
+	benchmarkSerialAndParallel(b, func() error {
+		benchCompressPubkey(x, y)
+		return nil
+	})
+}
+
+func BenchmarkScalarMult(b *testing.B) {
+	x, y := benchPubkeyCoords(b, GenPrivKey())
+	k := GenPrivKey().Key
+	benchmarkSerialAndParallel(b, func() error {
+		benchScalarMult(x, y, k)
+		return nil
+	})
+}
+
+// BenchmarkCallOverhead rejects a malformed public key, which returns after a
+// few instructions; for the cgo backend this is essentially the cost of
+// crossing into C and back.
+func BenchmarkCallOverhead(b *testing.B) {
+	pub := make([]byte, PubKeySize)
+	benchmarkSerialAndParallel(b, func() error {
+		if benchDecompressPubkey(pub) == nil {
+			return errors.New("malformed pubkey accepted")
+		}
+		return nil
+	})
+}
+
+func benchPubkeyCoords(b *testing.B, priv *PrivKey) (x, y *big.Int) {
+	b.Helper()
+	pub, err := benchParsePubkey(priv.PubKey().Bytes())
+	if err != nil {
+		b.Fatal(err)
+	}
+	return pub[0], pub[1]
+}
+
+// benchmarkSerialAndParallel runs op as a "serial" and a "parallel"
+// (b.RunParallel, GOMAXPROCS goroutines) sub-benchmark, reporting allocations.
+func benchmarkSerialAndParallel(b *testing.B, op func() error) {
+	b.Run("serial", func(b *testing.B) {
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			if err := op(); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+	b.Run("parallel", func(b *testing.B) {
+		benchmarkParallel(b, op)
+	})
+}
+
+func benchmarkParallel(b *testing.B, op func() error) {
+	b.ReportAllocs()
+	b.ResetTimer()
+	b.RunParallel(func(pb *testing.PB) {
+		for pb.Next() {
+			if err := op(); err != nil {
+				b.Error(err)
+				return
+			}
+		}
+	})
+}
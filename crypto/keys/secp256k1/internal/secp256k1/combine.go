@@ -0,0 +1,96 @@
+//go:build !gofuzz && cgo
+// +build !gofuzz,cgo
+
+package secp256k1
+
+/*
+#include "libsecp256k1/include/secp256k1.h"
+*/
+import "C"
+
+import (
+	"errors"
+	"runtime"
+	"sync"
+	"unsafe"
+)
+
+var ErrPubkeySumInfinity = errors.New("public keys add up to infinity")
+
+// combineChunk is the fewest keys CombinePubkeys gives a goroutine of its own.
+const combineChunk = 256
+
+// CombinePubkeys returns the sum of pubkeys, given in any format ECDH
+// accepts, as a 33-byte compressed public key. Large sets are split between
+// up to GOMAXPROCS goroutines, which parse and add up a share each. The keys
+// are public, so this is not constant time.
+func CombinePubkeys(pubkeys [][]byte) ([]byte, error) {
+	n := len(pubkeys)
+	if n == 0 {
+		return nil, ErrInvalidPubkey
+	}
+	workers := runtime.GOMAXPROCS(0)
+	if chunks := (n + combineChunk - 1) / combineChunk; workers > chunks {
+		workers = chunks
+	}
+
+	// The library takes an array of pointers to keys, which cgo only allows
+	// if the keys are pinned.
+	var pinner runtime.Pinner
+	defer pinner.Unpin()
+	points := make([]C.secp256k1_pubkey, n+workers)
+	ptrs := make([]*C.secp256k1_pubkey, n)
+	pinner.Pin(&points[0])
+	for i := range ptrs {
+		ptrs[i] = &points[i]
+	}
+
+	// Worker w leaves the sum of its share in points[n+w].
+	var (
+		wg   sync.WaitGroup
+		errs = make([]error, workers)
+		sums = make([]bool, workers)
+	)
+	for w := 0; w < workers; w++ {
+		start, end := n*w/workers, n*(w+1)/workers
+		wg.Add(1)
+		go func(w, start, end int) {
+			defer wg.Done()
+			for i := start; i < end; i++ {
+				if len(pubkeys[i]) == 0 {
+					errs[w] = ErrInvalidPubkey
+					return
+				}
+				if C.secp256k1_ec_pubkey_parse(context, &points[i], (*C.uchar)(unsafe.Pointer(&pubkeys[i][0])), C.size_t(len(pubkeys[i]))) != 1 {
+					errs[w] = ErrInvalidPubkey
+					return
+				}
+			}
+			// A share may add up to infinity; it then adds nothing to the total.
+			sums[w] = C.secp256k1_ec_pubkey_combine(context, &points[n+w], &ptrs[start], C.size_t(end-start)) == 1
+		}(w, start, end)
+	}
+	wg.Wait()
+
+	// Add up the shares, reusing the start of ptrs.
+	k := 0
+	for w := 0; w < workers; w++ {
+		if errs[w] != nil {
+			return nil, errs[w]
+		}
+		if sums[w] {
+			ptrs[k] = &points[n+w]
+			k++
+		}
+	}
+	var sum C.secp256k1_pubkey
+	if k == 0 || C.secp256k1_ec_pubkey_combine(context, &sum, &ptrs[0], C.size_t(k)) != 1 {
+		return nil, ErrPubkeySumInfinity
+	}
+	var (
+		out    = make([]byte, 33)
+		outlen = C.size_t(len(out))
+	)
+	C.secp256k1_ec_pubkey_serialize(context, (*C.uchar)(unsafe.Pointer(&out[0])), &outlen, &sum, C.SECP256K1_EC_COMPRESSED)
+	return out, nil
+}
@@ -0,0 +1,64 @@
+//go:build !gofuzz && cgo
+// +build !gofuzz,cgo
+
+package secp256k1
+
+/*
+#include "libsecp256k1/include/secp256k1.h"
+#include "libsecp256k1/include/secp256k1_ecdh.h"
+*/
+import "C"
+
+import "unsafe"
+
+// ECDH returns the 32-byte shared secret of seckey and pubkey, the SHA256
+// hash of their product point in compressed form. pubkey may be in any of the
+// formats RecoverPubkey and CompressPubkey return.
+func ECDH(pubkey, seckey []byte) ([]byte, error) {
+	if len(seckey) != 32 {
+		return nil, ErrInvalidKey
+	}
+	if len(pubkey) == 0 {
+		return nil, ErrInvalidPubkey
+	}
+	var point C.secp256k1_pubkey
+	if C.secp256k1_ec_pubkey_parse(context, &point, (*C.uchar)(unsafe.Pointer(&pubkey[0])), C.size_t(len(pubkey))) != 1 {
+		return nil, ErrInvalidPubkey
+	}
+	secret := make([]byte, 32)
+	if C.secp256k1_ecdh(context, (*C.uchar)(unsafe.Pointer(&secret[0])), &point, (*C.uchar)(unsafe.Pointer(&seckey[0]))) != 1 {
+		return nil, ErrInvalidKey
+	}
+	return secret, nil
+}
+
+// ECDHBatch returns the shared secrets of seckey with each of pubkeys, the
+// same as ECDH gives. Computing them in one batch saves the per-key scalar
+// setup and most modular inversions.
+func ECDHBatch(pubkeys [][]byte, seckey []byte) ([][]byte, error) {
+	if len(seckey) != 32 {
+		return nil, ErrInvalidKey
+	}
+	n := len(pubkeys)
+	if n == 0 {
+		return [][]byte{}, nil
+	}
+	points := make([]C.secp256k1_pubkey, n)
+	for i, pubkey := range pubkeys {
+		if len(pubkey) == 0 {
+			return nil, ErrInvalidPubkey
+		}
+		if C.secp256k1_ec_pubkey_parse(context, &points[i], (*C.uchar)(unsafe.Pointer(&pubkey[0])), C.size_t(len(pubkey))) != 1 {
+			return nil, ErrInvalidPubkey
+		}
+	}
+	buf := make([]byte, 32*n)
+	if C.secp256k1_ecdh_batch(context, (*C.uchar)(unsafe.Pointer(&buf[0])), &points[0], C.size_t(n), (*C.uchar)(unsafe.Pointer(&seckey[0]))) != 1 {
+		return nil, ErrInvalidKey
+	}
+	secrets := make([][]byte, n)
+	for i := range secrets {
+		secrets[i] = buf[32*i : 32*(i+1) : 32*(i+1)]
+	}
+	return secrets, nil
+}
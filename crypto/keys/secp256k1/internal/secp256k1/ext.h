@@ -3,8 +3,9 @@
 // the LICENSE file.
 
 // secp256k1_context_create_sign_verify creates a context for signing and signature verification.
+// Its tables are built on first use.
 static secp256k1_context* secp256k1_context_create_sign_verify() {
-	return secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+	return secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_LAZY);
 }
 
 // secp256k1_ext_ecdsa_recover recovers the public key of an encoded compact signature.
@@ -128,3 +129,252 @@ int secp256k1_ext_scalar_mul(const secp256k1_context* ctx, unsigned char *point,
 	secp256k1_scalar_clear(&s);
 	return ret;
 }
+
+// secp256k1_ext_scalar_mul_xonly multiplies a point given by its X coordinate
+// by a scalar in constant time, and returns only the X coordinate of the
+// result. Either Y gives the same X, so Y is neither needed nor recovered.
+//
+// Returns: 1: multiplication was successful
+//          0: scalar was invalid (zero or overflow), or X is not on the curve
+// Args:    ctx:      pointer to a context object (cannot be NULL)
+//  Out:    point:    the X coordinate of the multiplied point (usually secret)
+//  In:     point:    pointer to a 32-byte X coordinate, big-endian.
+//          scalar:   a 32-byte scalar with which to multiply the point
+int secp256k1_ext_scalar_mul_xonly(const secp256k1_context* ctx, unsigned char *point, const unsigned char *scalar) {
+	int ret = 0;
+	int overflow = 0;
+	secp256k1_fe x;
+	secp256k1_scalar s;
+	ARG_CHECK(point != NULL);
+	ARG_CHECK(scalar != NULL);
+	(void)ctx;
+
+	secp256k1_scalar_set_b32(&s, scalar, &overflow);
+	if (overflow || secp256k1_scalar_is_zero(&s) || !secp256k1_fe_set_b32(&x, point)) {
+		ret = 0;
+	} else if (secp256k1_ecmult_const_xonly(&x, &x, &s, 0)) {
+		secp256k1_fe_get_b32(point, &x);
+		ret = 1;
+	}
+	secp256k1_scalar_clear(&s);
+	return ret;
+}
+
+// secp256k1_ext_ecdsa_verify_cached verifies an encoded compact signature through
+// a signature cache.
+//
+// Returns: 1: signature is valid
+//          0: signature is invalid
+// Args:    ctx:        pointer to a context object (cannot be NULL)
+//          cache:      pointer to a signature cache (cannot be NULL)
+//  In:     sigdata:    pointer to a 64-byte signature (cannot be NULL)
+//          msgdata:    pointer to a 32-byte message (cannot be NULL)
+//          pubkeydata: pointer to public key data (cannot be NULL)
+//          pubkeylen:  length of pubkeydata
+int secp256k1_ext_ecdsa_verify_cached(
+	const secp256k1_context* ctx,
+	secp256k1_sigcache *cache,
+	const unsigned char *sigdata,
+	const unsigned char *msgdata,
+	const unsigned char *pubkeydata,
+	size_t pubkeylen
+) {
+	secp256k1_ecdsa_signature sig;
+	secp256k1_pubkey pubkey;
+
+	if (!secp256k1_ecdsa_signature_parse_compact(ctx, &sig, sigdata)) {
+		return 0;
+	}
+	if (!secp256k1_ec_pubkey_parse(ctx, &pubkey, pubkeydata, pubkeylen)) {
+		return 0;
+	}
+	return secp256k1_ecdsa_verify_cached(ctx, cache, &sig, msgdata, &pubkey);
+}
+
+// secp256k1_ext_pubkey_layout identifies how this build lays out the parsed
+// public key in secp256k1_pubkey, which differs between field implementations
+// and byte orders. Parsed keys may only be reused by a build with the same layout.
+unsigned int secp256k1_ext_pubkey_layout(void) {
+	const uint16_t one = 1;
+	unsigned int layout = sizeof(secp256k1_ge_storage) == 64 ? 1 : 2;
+#ifdef USE_FIELD_5X52
+	layout |= 0x10;
+#endif
+	if (*(const unsigned char *)&one == 0) {
+		layout |= 0x100;
+	}
+	return layout;
+}
+
+// secp256k1_ext_pubkey_check checks that a parsed public key, e.g. one read back
+// from disk, is exactly what secp256k1_ec_pubkey_parse makes of a compressed key.
+//
+// Returns: 1: pubkey is the canonical parsed form of pubkeydata
+//          0: otherwise
+// Args:    ctx:        pointer to a context object (cannot be NULL)
+//  In:     pubkeydata: pointer to a 33-byte compressed public key (cannot be NULL)
+//          pubkey:     the parsed public key to check (cannot be NULL)
+int secp256k1_ext_pubkey_check(
+	const secp256k1_context* ctx,
+	const unsigned char *pubkeydata,
+	const secp256k1_pubkey *pubkey
+) {
+	secp256k1_ge ge;
+	secp256k1_pubkey canonical;
+	unsigned char out[33];
+	size_t outlen = sizeof(out);
+	(void)ctx;
+
+	if (sizeof(secp256k1_ge_storage) == 64) {
+		secp256k1_ge_storage s;
+		memcpy(&s, &pubkey->data[0], 64);
+		secp256k1_ge_from_storage(&ge, &s);
+	} else {
+		secp256k1_fe x, y;
+		if (!secp256k1_fe_set_b32(&x, pubkey->data) || !secp256k1_fe_set_b32(&y, pubkey->data + 32)) {
+			return 0;
+		}
+		secp256k1_ge_set_xy(&ge, &x, &y);
+	}
+	// Values at or above the field size would still pass the curve check
+	// once reduced, so insist on the canonical encoding as well.
+	secp256k1_fe_normalize_var(&ge.x);
+	secp256k1_fe_normalize_var(&ge.y);
+	if (!secp256k1_ge_is_valid_var(&ge)) {
+		return 0;
+	}
+	secp256k1_pubkey_save(&canonical, &ge);
+	if (memcmp(canonical.data, pubkey->data, sizeof(canonical.data)) != 0) {
+		return 0;
+	}
+	if (!secp256k1_eckey_pubkey_serialize(&ge, out, &outlen, 1)) {
+		return 0;
+	}
+	return memcmp(out, pubkeydata, sizeof(out)) == 0;
+}
+
+// secp256k1_ext_ecdsa_verify_parsed verifies an encoded compact signature against
+// an already parsed public key, through a signature cache if one is given.
+//
+// Returns: 1: signature is valid
+//          0: signature is invalid
+// Args:    ctx:        pointer to a context object (cannot be NULL)
+//          cache:      pointer to a signature cache, or NULL
+//  In:     sigdata:    pointer to a 64-byte signature (cannot be NULL)
+//          msgdata:    pointer to a 32-byte message (cannot be NULL)
+//          pubkey:     the parsed public key (cannot be NULL)
+int secp256k1_ext_ecdsa_verify_parsed(
+	const secp256k1_context* ctx,
+	secp256k1_sigcache *cache,
+	const unsigned char *sigdata,
+	const unsigned char *msgdata,
+	const secp256k1_pubkey *pubkey
+) {
+	secp256k1_ecdsa_signature sig;
+
+	if (!secp256k1_ecdsa_signature_parse_compact(ctx, &sig, sigdata)) {
+		return 0;
+	}
+	if (cache != NULL) {
+		return secp256k1_ecdsa_verify_cached(ctx, cache, &sig, msgdata, pubkey);
+	}
+	return secp256k1_ecdsa_verify(ctx, &sig, msgdata, pubkey);
+}
+
+// secp256k1_ext_musig_pubkey_agg aggregates compressed public keys for MuSig2.
+//
+// Returns: 1: the keys were aggregated
+//          0: a key was invalid
+// Args:    ctx:        pointer to a context object (cannot be NULL)
+//  Out:    agg_pk:     the aggregated x-only public key (cannot be NULL)
+//          cache:      the key aggregation cache (cannot be NULL)
+//  In:     pubkeydata: pointer to n 33-byte compressed public keys, back to back (cannot be NULL)
+//          n:          the number of keys (must be at least 1)
+int secp256k1_ext_musig_pubkey_agg(
+	const secp256k1_context* ctx,
+	secp256k1_xonly_pubkey *agg_pk,
+	secp256k1_musig_keyagg_cache *cache,
+	const unsigned char *pubkeydata,
+	size_t n
+) {
+	secp256k1_pubkey *pubkeys = malloc(n * sizeof(secp256k1_pubkey));
+	const secp256k1_pubkey **ptrs = malloc(n * sizeof(secp256k1_pubkey *));
+	size_t i;
+	int ret = pubkeys != NULL && ptrs != NULL;
+
+	for (i = 0; ret && i < n; i++) {
+		ret = secp256k1_ec_pubkey_parse(ctx, &pubkeys[i], pubkeydata + 33 * i, 33);
+		ptrs[i] = &pubkeys[i];
+	}
+	if (ret) {
+		ret = secp256k1_musig_pubkey_agg(ctx, agg_pk, cache, ptrs, n);
+	}
+	free(pubkeys);
+	free(ptrs);
+	return ret;
+}
+
+// secp256k1_ext_musig_nonce_agg aggregates serialized MuSig2 public nonces.
+//
+// Returns: 1: the nonces were aggregated
+//          0: a nonce was invalid
+// Args:    ctx:        pointer to a context object (cannot be NULL)
+//  Out:    aggnonce:   the aggregate nonce (cannot be NULL)
+//  In:     noncedata:  pointer to n 66-byte public nonces, back to back (cannot be NULL)
+//          n:          the number of nonces (must be at least 1)
+int secp256k1_ext_musig_nonce_agg(
+	const secp256k1_context* ctx,
+	secp256k1_musig_aggnonce *aggnonce,
+	const unsigned char *noncedata,
+	size_t n
+) {
+	secp256k1_musig_pubnonce *nonces = malloc(n * sizeof(secp256k1_musig_pubnonce));
+	const secp256k1_musig_pubnonce **ptrs = malloc(n * sizeof(secp256k1_musig_pubnonce *));
+	size_t i;
+	int ret = nonces != NULL && ptrs != NULL;
+
+	for (i = 0; ret && i < n; i++) {
+		ret = secp256k1_musig_pubnonce_parse(ctx, &nonces[i], noncedata + 66 * i);
+		ptrs[i] = &nonces[i];
+	}
+	if (ret) {
+		ret = secp256k1_musig_nonce_agg(ctx, aggnonce, ptrs, n);
+	}
+	free(nonces);
+	free(ptrs);
+	return ret;
+}
+
+// secp256k1_ext_musig_partial_sig_agg aggregates serialized MuSig2 partial
+// signatures into a BIP340 signature.
+//
+// Returns: 1: the signature was created
+//          0: a partial signature was invalid
+// Args:    ctx:        pointer to a context object (cannot be NULL)
+//  Out:    sig64:      pointer to a 64-byte array for the signature (cannot be NULL)
+//  In:     session:    the signing session (cannot be NULL)
+//          sigdata:    pointer to n 32-byte partial signatures, back to back (cannot be NULL)
+//          n:          the number of partial signatures (must be at least 1)
+int secp256k1_ext_musig_partial_sig_agg(
+	const secp256k1_context* ctx,
+	unsigned char *sig64,
+	const secp256k1_musig_session *session,
+	const unsigned char *sigdata,
+	size_t n
+) {
+	secp256k1_musig_partial_sig *sigs = malloc(n * sizeof(secp256k1_musig_partial_sig));
+	const secp256k1_musig_partial_sig **ptrs = malloc(n * sizeof(secp256k1_musig_partial_sig *));
+	size_t i;
+	int ret = sigs != NULL && ptrs != NULL;
+
+	for (i = 0; ret && i < n; i++) {
+		ret = secp256k1_musig_partial_sig_parse(ctx, &sigs[i], sigdata + 32 * i);
+		ptrs[i] = &sigs[i];
+	}
+	if (ret) {
+		ret = secp256k1_musig_partial_sig_agg(ctx, sig64, session, ptrs, n);
+	}
+	free(sigs);
+	free(ptrs);
+	return ret;
+}
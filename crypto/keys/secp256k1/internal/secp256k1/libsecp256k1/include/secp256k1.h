@@ -42,6 +42,13 @@ extern "C" {
  */
 typedef struct secp256k1_context_struct secp256k1_context;
 
+/** Opaque data structure that holds a table of multiples of one public key,
+ *  for multiplying that key by many scalars quickly and in constant time.
+ *  Once created it is only read, so it can be used by several threads at once.
+ *  See secp256k1_point_precomp_create.
+ */
+typedef struct secp256k1_point_precomp_struct secp256k1_point_precomp;
+
 /** Opaque data structure that holds a parsed and valid public key.
  *
  *  The exact representation of data inside is implementation defined and not
@@ -148,12 +155,26 @@ typedef int (*secp256k1_nonce_function)(
 /** The higher bits contain the actual data. Do not use directly. */
 #define SECP256K1_FLAGS_BIT_CONTEXT_VERIFY (1 << 8)
 #define SECP256K1_FLAGS_BIT_CONTEXT_SIGN (1 << 9)
+#define SECP256K1_FLAGS_BIT_CONTEXT_HUGEPAGES (1 << 10)
+#define SECP256K1_FLAGS_BIT_CONTEXT_LAZY (1 << 11)
 #define SECP256K1_FLAGS_BIT_COMPRESSION (1 << 8)
 
 /** Flags to pass to secp256k1_context_create. */
 #define SECP256K1_CONTEXT_VERIFY (SECP256K1_FLAGS_TYPE_CONTEXT | SECP256K1_FLAGS_BIT_CONTEXT_VERIFY)
 #define SECP256K1_CONTEXT_SIGN (SECP256K1_FLAGS_TYPE_CONTEXT | SECP256K1_FLAGS_BIT_CONTEXT_SIGN)
 #define SECP256K1_CONTEXT_NONE (SECP256K1_FLAGS_TYPE_CONTEXT)
+/** Can be combined with the flags above to place the precomputed tables on
+ *  2 MiB hugepages where the platform supports it, cutting TLB misses on table
+ *  lookups. Falls back to ordinary (cache line aligned) memory otherwise. */
+#define SECP256K1_CONTEXT_HUGEPAGES (SECP256K1_FLAGS_TYPE_CONTEXT | SECP256K1_FLAGS_BIT_CONTEXT_HUGEPAGES)
+/** Can be combined with the flags above to leave building the tables for
+ *  signing and for verification (up to 1.4 MiB) until the first call that
+ *  needs them, so a process that never signs or verifies never pays for them.
+ *  The first such call takes that much longer, and concurrent first calls on
+ *  one context wait for a single build. Has no effect (the tables are built
+ *  right away) where the compiler lacks __atomic builtins.
+ *  See secp256k1_context_warmup. */
+#define SECP256K1_CONTEXT_LAZY (SECP256K1_FLAGS_TYPE_CONTEXT | SECP256K1_FLAGS_BIT_CONTEXT_LAZY)
 
 /** Flag to pass to secp256k1_ec_pubkey_serialize and secp256k1_ec_privkey_export. */
 #define SECP256K1_EC_COMPRESSED (SECP256K1_FLAGS_TYPE_COMPRESSION | SECP256K1_FLAGS_BIT_COMPRESSION)
@@ -177,6 +198,17 @@ SECP256K1_API secp256k1_context* secp256k1_context_clone(
     const secp256k1_context* ctx
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_WARN_UNUSED_RESULT;
 
+/** Build the tables a context created with SECP256K1_CONTEXT_LAZY left for
+ *  first use, now. Does nothing for other contexts, or if they are built
+ *  already. Safe to call concurrently with any function taking a const
+ *  context.
+ *
+ *  Args:    ctx: an existing context object (cannot be NULL)
+ */
+SECP256K1_API void secp256k1_context_warmup(
+    const secp256k1_context* ctx
+) SECP256K1_ARG_NONNULL(1);
+
 /** Destroy a secp256k1 context object.
  *
  *  The context pointer may not be used afterwards.
@@ -379,6 +411,36 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdsa_verify(
     const secp256k1_pubkey *pubkey
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Verify two ECDSA signatures at once.
+ *
+ *  Returns: 1: both signatures are correct
+ *           0: at least one signature is incorrect or unparsable
+ *  Args:    ctx:       a secp256k1 context object, initialized for verification.
+ *  Out:     results:   pointer to an array of 2 ints that receives the result of
+ *                      secp256k1_ecdsa_verify for each signature (can be NULL)
+ *  In:      sig1:      the first signature being verified (cannot be NULL)
+ *           msg1_32:   the 32-byte message hash signed by sig1 (cannot be NULL)
+ *           pubkey1:   the public key sig1 is verified with (cannot be NULL)
+ *           sig2:      the second signature being verified (cannot be NULL)
+ *           msg2_32:   the 32-byte message hash signed by sig2 (cannot be NULL)
+ *           pubkey2:   the public key sig2 is verified with (cannot be NULL)
+ *
+ *  Gives the same answers as two calls to secp256k1_ecdsa_verify, but advances
+ *  both verifications together, so that cores with spare execution units can
+ *  overlap them. Whether that is faster depends on the CPU; measure with
+ *  bench_verify x2.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdsa_verify_x2(
+    const secp256k1_context* ctx,
+    int *results,
+    const secp256k1_ecdsa_signature *sig1,
+    const unsigned char *msg1_32,
+    const secp256k1_pubkey *pubkey1,
+    const secp256k1_ecdsa_signature *sig2,
+    const unsigned char *msg2_32,
+    const secp256k1_pubkey *pubkey2
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5) SECP256K1_ARG_NONNULL(6) SECP256K1_ARG_NONNULL(7) SECP256K1_ARG_NONNULL(8);
+
 /** Convert a signature to a normalized lower-S form.
  *
  *  Returns: 1 if sigin was not normalized, 0 if it already was.
@@ -459,6 +521,32 @@ SECP256K1_API int secp256k1_ecdsa_sign(
     const void *ndata
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Create ECDSA signatures for a batch of messages.
+ *
+ *  Returns: 1: all signatures created
+ *           0: the nonce generation function failed, or a private key was invalid, for at least one entry.
+ *  Args:    ctx:     pointer to a context object, initialized for signing (cannot be NULL)
+ *  Out:     sigs:    pointer to an array of n signatures (cannot be NULL)
+ *  In:      msgs32:  pointer to n consecutive 32-byte message hashes (cannot be NULL)
+ *           seckeys: pointer to n consecutive 32-byte secret keys (cannot be NULL)
+ *           n:       the number of signatures to create
+ *           noncefp: pointer to a nonce generation function. If NULL, secp256k1_nonce_function_default is used
+ *           ndata:   pointer to arbitrary data used by the nonce generation function (can be NULL)
+ *
+ * Each sigs[i] is what secp256k1_ecdsa_sign would produce for msgs32[32*i] and seckeys[32*i]; entries that
+ * fail are zeroed without affecting the others. Signing together saves one field and one scalar inversion per
+ * signature.
+ */
+SECP256K1_API int secp256k1_ecdsa_sign_batch(
+    const secp256k1_context* ctx,
+    secp256k1_ecdsa_signature *sigs,
+    const unsigned char *msgs32,
+    const unsigned char *seckeys,
+    size_t n,
+    secp256k1_nonce_function noncefp,
+    const void *ndata
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
 /** Verify an ECDSA secret key.
  *
  *  Returns: 1: secret key is valid
@@ -543,6 +631,50 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_tweak_mul(
     const unsigned char *tweak
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
 
+/** Precompute multiples of a public key for secp256k1_point_precomp_mul.
+ *
+ *  Returns: a newly created table (64 KiB), or NULL on illegal arguments or
+ *           when out of memory (after calling the error callback).
+ *  Args:    ctx:    pointer to a context object (cannot be NULL)
+ *  In:      pubkey: pointer to the public key to precompute (cannot be NULL)
+ *
+ *  Building the table costs about as much as 8 multiplications and takes
+ *  time that depends on the public key, which is assumed not to be secret.
+ *  It pays off for a key that is multiplied by many scalars, such as a
+ *  long-lived ECDH key or a master public key.
+ */
+SECP256K1_API secp256k1_point_precomp* secp256k1_point_precomp_create(
+    const secp256k1_context* ctx,
+    const secp256k1_pubkey *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+/** Destroy a table created by secp256k1_point_precomp_create.
+ *
+ *  Args:   precomp: an existing table to destroy (can be NULL)
+ */
+SECP256K1_API void secp256k1_point_precomp_destroy(
+    secp256k1_point_precomp* precomp
+);
+
+/** Multiply a precomputed public key by a scalar in constant time.
+ * Returns: 0 if the scalar was out of range or zero, 1 otherwise.
+ * Args:    ctx:     pointer to a context object (cannot be NULL)
+ * Out:     pubkey:  pointer to a public key object set to scalar times the
+ *                   precomputed key, the same as secp256k1_ec_pubkey_tweak_mul
+ *                   would give (zeroed on failure)
+ * In:      precomp: pointer to the table of the key (cannot be NULL)
+ *          scalar:  pointer to a 32-byte scalar, which may be secret
+ *
+ * This works like secp256k1_ec_pubkey_create does for the generator, and is
+ * about as fast. Unlike secp256k1_ec_pubkey_tweak_mul it is constant time.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_point_precomp_mul(
+    const secp256k1_context* ctx,
+    secp256k1_pubkey *pubkey,
+    const secp256k1_point_precomp *precomp,
+    const unsigned char *scalar
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
 /** Updates the context randomization.
  *  Returns: 1: randomization successfully updated
  *           0: error
@@ -562,6 +694,10 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_context_randomize(
  *                      (cannot be NULL)
  *  In:     ins:        pointer to array of pointers to public keys (cannot be NULL)
  *          n:          the number of public keys to add together (must be at least 1)
+ *
+ *  This is not constant time, so the keys should not be secret. Adding up
+ *  many keys (from a hundred or so on) takes heap memory, about 130 bytes
+ *  per key.
  */
 SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_combine(
     const secp256k1_context* ctx,
@@ -24,6 +24,75 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdh(
   const unsigned char *privkey
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Compute EC Diffie-Hellman secrets of one private key with many public keys
+ *  in constant time
+ *  Returns: 1: all secrets were computed
+ *           0: scalar was invalid (zero or overflow), or a public key was
+ *              invalid; the secrets that could not be computed are zeroed
+ *  Args:    ctx:        pointer to a context object (cannot be NULL)
+ *  Out:     results:    a 32*n-byte array which will be populated by the
+ *                       ECDH secret with each public key in turn, each the
+ *                       same as secp256k1_ecdh gives
+ *  In:      pubkeys:    a pointer to an array of n initialized public keys
+ *           n:          the number of public keys
+ *           privkey:    a 32-byte scalar with which to multiply the points
+ *
+ *  This is faster per secret than calling secp256k1_ecdh n times: the scalar
+ *  is recoded only once, and the conversions of the results to affine
+ *  coordinates share one field inversion per 32 public keys.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdh_batch(
+  const secp256k1_context* ctx,
+  unsigned char *results,
+  const secp256k1_pubkey *pubkeys,
+  size_t n,
+  const unsigned char *privkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(5);
+
+/** Compute an EC Diffie-Hellman secret with a precomputed public key in
+ *  constant time
+ *  Returns: 1: exponentiation was successful
+ *           0: scalar was invalid (zero or overflow)
+ *  Args:    ctx:        pointer to a context object (cannot be NULL)
+ *  Out:     result:     a 32-byte array which will be populated by the ECDH
+ *                       secret, the same as secp256k1_ecdh gives
+ *  In:      precomp:    a pointer to the table secp256k1_point_precomp_create
+ *                       made for the public key
+ *           privkey:    a 32-byte scalar with which to multiply the point
+ *
+ *  This is about 1.7 times as fast as secp256k1_ecdh, for a public key that
+ *  is used often enough to be worth precomputing, like a server's.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdh_precomp(
+  const secp256k1_context* ctx,
+  unsigned char *result,
+  const secp256k1_point_precomp *precomp,
+  const unsigned char *privkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
+/** Compute the X coordinate of an EC Diffie-Hellman point in constant time
+ *  Returns: 1: exponentiation was successful
+ *           0: scalar was invalid (zero or overflow), or input32 is not the
+ *              X coordinate of a point on the curve
+ *  Args:    ctx:        pointer to a context object (cannot be NULL)
+ *  Out:     output32:   a 32-byte array which will be populated by the X
+ *                       coordinate of privkey times the point
+ *  In:      input32:    the 32-byte X coordinate of a public key, such as a
+ *                       compressed public key without its first byte
+ *           privkey:    a 32-byte scalar with which to multiply the point
+ *
+ *  Unlike secp256k1_ecdh this neither needs nor gives the Y coordinate, which
+ *  saves decompressing the public key and suits protocols, like ECIES, that
+ *  derive the secret from X alone. The output is not hashed; it should be
+ *  passed through a key derivation function before use.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdh_xonly(
+  const secp256k1_context* ctx,
+  unsigned char *output32,
+  const unsigned char *input32,
+  const unsigned char *privkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
 # ifdef __cplusplus
 }
 # endif
@@ -0,0 +1,305 @@
+#ifndef _SECP256K1_MUSIG_
+# define _SECP256K1_MUSIG_
+
+# include "secp256k1.h"
+# include "secp256k1_schnorrsig.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/** This module implements MuSig2 multi-signatures as specified in BIP327
+ *  (without key tweaking). n signers aggregate their public keys into one
+ *  x-only public key, and together produce one BIP340 signature for it, which
+ *  secp256k1_schnorrsig_verify checks at the cost of a single signature.
+ *
+ *  Signing takes two rounds:
+ *  1. Every signer calls secp256k1_musig_nonce_gen and sends out the public
+ *     nonce. Once all have arrived they are combined with
+ *     secp256k1_musig_nonce_agg, and secp256k1_musig_nonce_process turns the
+ *     result into a session for the message.
+ *  2. Every signer calls secp256k1_musig_partial_sign and sends out the
+ *     partial signature. secp256k1_musig_partial_sig_agg combines them.
+ *
+ *  A secret nonce must never be used for two partial signatures: that reveals
+ *  the secret key. secp256k1_musig_partial_sign clears the secret nonce it is
+ *  given to help with that, but it cannot stop copies from being reused.
+ */
+
+/** Opaque data structure that caches what signing and verification need
+ *  to know about an aggregated public key.
+ *
+ *  Like the other structures of this module, it is guaranteed to be the given
+ *  size and can be safely copied/moved, but its contents are implementation
+ *  defined. It is only valid once secp256k1_musig_pubkey_agg filled it in.
+ */
+typedef struct {
+    unsigned char data[133];
+} secp256k1_musig_keyagg_cache;
+
+/** Opaque data structure that holds a signer's secret nonce. It must not be
+ *  copied, and it must be used for at most one partial signature. */
+typedef struct {
+    unsigned char data[132];
+} secp256k1_musig_secnonce;
+
+/** Opaque data structure that holds a signer's public nonce. Use
+ *  secp256k1_musig_pubnonce_serialize and secp256k1_musig_pubnonce_parse to
+ *  send it to the other signers. */
+typedef struct {
+    unsigned char data[132];
+} secp256k1_musig_pubnonce;
+
+/** Opaque data structure that holds the aggregate of all public nonces. */
+typedef struct {
+    unsigned char data[132];
+} secp256k1_musig_aggnonce;
+
+/** Opaque data structure that holds the values signing a given message with
+ *  a given aggregate nonce needs. */
+typedef struct {
+    unsigned char data[101];
+} secp256k1_musig_session;
+
+/** Opaque data structure that holds a partial signature. */
+typedef struct {
+    unsigned char data[36];
+} secp256k1_musig_partial_sig;
+
+/** Parse a 66-byte public nonce.
+ *
+ *  Returns: 1 if the nonce was valid, 0 otherwise.
+ *  Args: ctx:      a secp256k1 context object.
+ *  Out:  nonce:    pointer to a nonce object.
+ *  In:   in66:     pointer to the 66-byte nonce to parse: two compressed points.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_musig_pubnonce_parse(
+    const secp256k1_context* ctx,
+    secp256k1_musig_pubnonce* nonce,
+    const unsigned char *in66
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Serialize a public nonce into 66 bytes.
+ *
+ *  Returns: 1 if the nonce was valid, 0 otherwise.
+ *  Args: ctx:      a secp256k1 context object.
+ *  Out:  out66:    pointer to a 66-byte array to store the serialized nonce.
+ *  In:   nonce:    pointer to the nonce.
+ */
+SECP256K1_API int secp256k1_musig_pubnonce_serialize(
+    const secp256k1_context* ctx,
+    unsigned char *out66,
+    const secp256k1_musig_pubnonce* nonce
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Parse a 66-byte aggregate nonce, in which a point at infinity is encoded
+ *  as 33 zero bytes.
+ *
+ *  Returns: 1 if the nonce was valid, 0 otherwise.
+ *  Args: ctx:      a secp256k1 context object.
+ *  Out:  nonce:    pointer to a nonce object.
+ *  In:   in66:     pointer to the 66-byte nonce to parse.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_musig_aggnonce_parse(
+    const secp256k1_context* ctx,
+    secp256k1_musig_aggnonce* nonce,
+    const unsigned char *in66
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Serialize an aggregate nonce into 66 bytes.
+ *
+ *  Returns: 1 if the nonce was valid, 0 otherwise.
+ *  Args: ctx:      a secp256k1 context object.
+ *  Out:  out66:    pointer to a 66-byte array to store the serialized nonce.
+ *  In:   nonce:    pointer to the nonce.
+ */
+SECP256K1_API int secp256k1_musig_aggnonce_serialize(
+    const secp256k1_context* ctx,
+    unsigned char *out66,
+    const secp256k1_musig_aggnonce* nonce
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Parse a 32-byte partial signature.
+ *
+ *  Returns: 1 if the signature was valid, 0 if it overflows the group order.
+ *  Args: ctx:      a secp256k1 context object.
+ *  Out:  sig:      pointer to a partial signature object.
+ *  In:   in32:     pointer to the 32-byte signature to parse.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_musig_partial_sig_parse(
+    const secp256k1_context* ctx,
+    secp256k1_musig_partial_sig* sig,
+    const unsigned char *in32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Serialize a partial signature into 32 bytes.
+ *
+ *  Returns: 1 always.
+ *  Args: ctx:      a secp256k1 context object.
+ *  Out:  out32:    pointer to a 32-byte array to store the serialized signature.
+ *  In:   sig:      pointer to the partial signature.
+ */
+SECP256K1_API int secp256k1_musig_partial_sig_serialize(
+    const secp256k1_context* ctx,
+    unsigned char *out32,
+    const secp256k1_musig_partial_sig* sig
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Aggregate public keys into one x-only public key.
+ *
+ *  Returns: 1 if the public keys were aggregated.
+ *           0 if a public key was invalid, or (with negligible probability
+ *             for honest keys) the aggregate is the point at infinity, or
+ *             when out of memory (after calling the error callback).
+ *  Args:        ctx:       a secp256k1 context object, initialized for verification.
+ *  Out:      agg_pk:       pointer to the aggregated x-only public key (can be NULL)
+ *      keyagg_cache:       pointer to a cache for signing and verifying with
+ *                          the aggregated key (can be NULL)
+ *  In:      pubkeys:       pointer to an array of n public keys (cannot be NULL)
+ *                 n:       the number of public keys (must be at least 1)
+ *
+ *  The order of the keys matters: the same keys in another order make another
+ *  aggregated key. Each key is weighted by a hash of all of them, and all n
+ *  multiplications share one multi-scalar multiplication, so the cost grows
+ *  much slower than n single multiplications. Callers that check signatures
+ *  against the same keys repeatedly should keep keyagg_cache around.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_musig_pubkey_agg(
+    const secp256k1_context* ctx,
+    secp256k1_xonly_pubkey *agg_pk,
+    secp256k1_musig_keyagg_cache *keyagg_cache,
+    const secp256k1_pubkey * const* pubkeys,
+    size_t n
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(4);
+
+/** Generate a secret and a public nonce for one signing session.
+ *
+ *  Returns: 1 if the nonces were generated.
+ *           0 if an argument was invalid.
+ *  Args:           ctx:       a secp256k1 context object, initialized for signing.
+ *  Out:       secnonce:       pointer to the secret nonce to keep (cannot be NULL)
+ *             pubnonce:       pointer to the public nonce to send out (cannot be NULL)
+ *  In/Out: session_secrand32: 32 bytes of fresh randomness, which are cleared
+ *                             (cannot be NULL)
+ *  In:          seckey:       the signer's 32-byte secret key (can be NULL)
+ *               pubkey:       the signer's public key (cannot be NULL)
+ *                msg32:       the 32-byte message to be signed (can be NULL)
+ *         keyagg_cache:       the cache of the aggregated key (can be NULL)
+ *        extra_input32:       32 more bytes to derive the nonce from (can be NULL)
+ *
+ *  The nonces are derived as BIP327 specifies. session_secrand32 must be
+ *  uniformly random and never used twice; everything else is optional and
+ *  only guards against a bad source of randomness.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_musig_nonce_gen(
+    const secp256k1_context* ctx,
+    secp256k1_musig_secnonce *secnonce,
+    secp256k1_musig_pubnonce *pubnonce,
+    unsigned char *session_secrand32,
+    const unsigned char *seckey,
+    const secp256k1_pubkey *pubkey,
+    const unsigned char *msg32,
+    const secp256k1_musig_keyagg_cache *keyagg_cache,
+    const unsigned char *extra_input32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(6);
+
+/** Aggregate the public nonces of all signers.
+ *
+ *  Returns: 1 if the nonces were aggregated, 0 if an argument was invalid.
+ *  Args:        ctx:       a secp256k1 context object.
+ *  Out:    aggnonce:       pointer to the aggregate nonce (cannot be NULL)
+ *  In:    pubnonces:       pointer to an array of n public nonces (cannot be NULL)
+ *                 n:       the number of nonces (must be at least 1)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_musig_nonce_agg(
+    const secp256k1_context* ctx,
+    secp256k1_musig_aggnonce *aggnonce,
+    const secp256k1_musig_pubnonce * const* pubnonces,
+    size_t n
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Start a session for signing a message with an aggregate nonce.
+ *
+ *  Returns: 1 if the session was started, 0 if an argument was invalid.
+ *  Args:          ctx:       a secp256k1 context object, initialized for verification.
+ *  Out:       session:       pointer to the session (cannot be NULL)
+ *  In:       aggnonce:       pointer to the aggregate nonce (cannot be NULL)
+ *               msg32:       the 32-byte message to sign (cannot be NULL)
+ *        keyagg_cache:       the cache of the aggregated key (cannot be NULL)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_musig_nonce_process(
+    const secp256k1_context* ctx,
+    secp256k1_musig_session *session,
+    const secp256k1_musig_aggnonce *aggnonce,
+    const unsigned char *msg32,
+    const secp256k1_musig_keyagg_cache *keyagg_cache
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5);
+
+/** Produce a partial signature.
+ *
+ *  Returns: 1 if the partial signature was created.
+ *           0 if the secret key was invalid or does not belong to the
+ *             public key the secret nonce was made for.
+ *  Args:          ctx:       a secp256k1 context object, initialized for signing.
+ *  Out:   partial_sig:       pointer to the partial signature (cannot be NULL)
+ *  In/Out:   secnonce:       pointer to the secret nonce, which is cleared so
+ *                            that it cannot be used again (cannot be NULL)
+ *  In:         seckey:       the signer's 32-byte secret key (cannot be NULL)
+ *        keyagg_cache:       the cache of the aggregated key (cannot be NULL)
+ *             session:       the session (cannot be NULL)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_musig_partial_sign(
+    const secp256k1_context* ctx,
+    secp256k1_musig_partial_sig *partial_sig,
+    secp256k1_musig_secnonce *secnonce,
+    const unsigned char *seckey,
+    const secp256k1_musig_keyagg_cache *keyagg_cache,
+    const secp256k1_musig_session *session
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5) SECP256K1_ARG_NONNULL(6);
+
+/** Verify the partial signature of one signer.
+ *
+ *  Returns: 1: correct partial signature
+ *           0: incorrect partial signature
+ *  Args:          ctx:       a secp256k1 context object, initialized for verification.
+ *  In:    partial_sig:       pointer to the partial signature (cannot be NULL)
+ *            pubnonce:       the signer's public nonce (cannot be NULL)
+ *              pubkey:       the signer's public key (cannot be NULL)
+ *        keyagg_cache:       the cache of the aggregated key (cannot be NULL)
+ *             session:       the session (cannot be NULL)
+ *
+ *  secp256k1_musig_partial_sig_agg does not need this: an aggregated
+ *  signature that verifies is valid whatever its parts were. It is for
+ *  finding out which signer to blame when it does not.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_musig_partial_sig_verify(
+    const secp256k1_context* ctx,
+    const secp256k1_musig_partial_sig *partial_sig,
+    const secp256k1_musig_pubnonce *pubnonce,
+    const secp256k1_pubkey *pubkey,
+    const secp256k1_musig_keyagg_cache *keyagg_cache,
+    const secp256k1_musig_session *session
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5) SECP256K1_ARG_NONNULL(6);
+
+/** Aggregate partial signatures into a BIP340 signature.
+ *
+ *  Returns: 1 if the signature was created, 0 if an argument was invalid.
+ *  Args:          ctx:       a secp256k1 context object.
+ *  Out:         sig64:       pointer to a 64-byte array to store the signature (cannot be NULL)
+ *  In:        session:       the session (cannot be NULL)
+ *        partial_sigs:       pointer to an array of n partial signatures (cannot be NULL)
+ *                   n:       the number of partial signatures (must be at least 1)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_musig_partial_sig_agg(
+    const secp256k1_context* ctx,
+    unsigned char *sig64,
+    const secp256k1_musig_session *session,
+    const secp256k1_musig_partial_sig * const* partial_sigs,
+    size_t n
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
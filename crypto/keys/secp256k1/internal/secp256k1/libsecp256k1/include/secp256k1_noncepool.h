@@ -0,0 +1,119 @@
+#ifndef _SECP256K1_NONCEPOOL_
+# define _SECP256K1_NONCEPOOL_
+
+# include "secp256k1.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/** Opaque pool of precomputed signing nonces.
+ *
+ *  Each entry holds what signing needs of a random nonce k: the r value of
+ *  kG, its recovery id and 1/k. Filling the pool does the expensive part of
+ *  signing (the point multiplication and both inversions) ahead of time,
+ *  so that secp256k1_ecdsa_sign_pooled is left with two scalar
+ *  multiplications and an addition.
+ *
+ *  Unlike secp256k1_ecdsa_sign, pooled signatures use random rather than
+ *  deterministic nonces, so the safety of the key rests on no entry ever
+ *  being used twice:
+ *  - An entry is handed out at most once, and wiped when it is.
+ *  - A pool is owned by the process that created it. In a process forked
+ *    off that one it is empty: signing and filling fail there. Create a new
+ *    pool instead. This does not rest on process ids, which get reused:
+ *    the entries are mapped to be wiped on fork where the kernel supports
+ *    that (Linux 4.14 and later), and a pthread_atfork handler marks every
+ *    pool as foreign to the child.
+ *  - Nonces are derived from the seed given to secp256k1_noncepool_fill
+ *    together with the process id, a serial number that tells the pools of
+ *    a process apart, and a counter of the pool's fills. A seed reused by
+ *    mistake within one process thus still gives fresh nonces; once the
+ *    counter runs out (after 2^32 - 1 fills), filling fails. Across
+ *    processes, e.g. after a restart, only a fresh seed rules out reuse.
+ *  - A copy of the whole process, such as a restored VM snapshot, cannot be
+ *    told apart from the original. Call secp256k1_noncepool_clear after
+ *    restoring one.
+ *
+ *  A pool may be shared between threads without locking: filling, signing
+ *  and clearing are lock-free with respect to each other.
+ */
+typedef struct secp256k1_noncepool_struct secp256k1_noncepool;
+
+/** Create an empty nonce pool.
+ *
+ *  Returns: a newly created pool, or NULL on illegal arguments, or when out
+ *           of memory or of pool serial numbers (after calling the error
+ *           callback).
+ *  Args:    ctx:    an existing context object (cannot be NULL)
+ *  In:      n:      the number of entries the pool holds (at least 1)
+ */
+SECP256K1_API secp256k1_noncepool* secp256k1_noncepool_create(
+    const secp256k1_context* ctx,
+    size_t n
+) SECP256K1_ARG_NONNULL(1) SECP256K1_WARN_UNUSED_RESULT;
+
+/** Wipe and destroy a nonce pool.
+ *
+ *  No other thread may use the pool during or after this call.
+ *  Args:   pool: an existing pool to destroy (can be NULL)
+ */
+SECP256K1_API void secp256k1_noncepool_destroy(
+    secp256k1_noncepool* pool
+);
+
+/** Add entries to a nonce pool.
+ *
+ *  Returns: the number of entries added, at most 32 per call; 0 if the pool
+ *           is full, not owned by this process, out of fills, or on illegal
+ *           arguments.
+ *  Args:    ctx:    pointer to a context object, initialized for signing (cannot be NULL)
+ *           pool:   the pool to fill (cannot be NULL)
+ *  In:      seed32: 32 fresh random bytes (cannot be NULL)
+ *
+ *  Meant to be called from a background thread until it returns 0.
+ */
+SECP256K1_API size_t secp256k1_noncepool_fill(
+    const secp256k1_context* ctx,
+    secp256k1_noncepool *pool,
+    const unsigned char *seed32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Wipe all entries of a nonce pool.
+ *
+ *  Entries that a concurrent secp256k1_noncepool_fill is still computing are
+ *  not affected, so stop the threads filling the pool first.
+ *  Args:   pool: the pool to clear (cannot be NULL)
+ */
+SECP256K1_API void secp256k1_noncepool_clear(
+    secp256k1_noncepool *pool
+) SECP256K1_ARG_NONNULL(1);
+
+/** Create an ECDSA signature with a nonce taken from a pool.
+ *
+ *  Returns: 1: signature created
+ *           0: the pool is empty (or not owned by this process), or the private key was invalid.
+ *  Args:    ctx:    pointer to a context object (cannot be NULL)
+ *           pool:   the pool to take a nonce from (cannot be NULL)
+ *  Out:     sig:    pointer to an array where the signature will be placed (cannot be NULL)
+ *           recid:  pointer to an int that receives the recovery id (can be NULL)
+ *  In:      msg32:  the 32-byte message hash being signed (cannot be NULL)
+ *           seckey: pointer to a 32-byte secret key (cannot be NULL)
+ *
+ * The created signature is always in lower-S form. An invalid key does not
+ * use up an entry; on an empty pool, fall back to secp256k1_ecdsa_sign.
+ */
+SECP256K1_API int secp256k1_ecdsa_sign_pooled(
+    const secp256k1_context* ctx,
+    secp256k1_noncepool *pool,
+    secp256k1_ecdsa_signature *sig,
+    int *recid,
+    const unsigned char *msg32,
+    const unsigned char *seckey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(5) SECP256K1_ARG_NONNULL(6);
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
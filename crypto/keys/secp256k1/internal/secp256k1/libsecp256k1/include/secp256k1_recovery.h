@@ -87,6 +87,28 @@ SECP256K1_API int secp256k1_ecdsa_sign_recoverable(
     const void *ndata
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Create recoverable ECDSA signatures for a batch of messages, as secp256k1_ecdsa_sign_batch does.
+ *
+ *  Returns: 1: all signatures created
+ *           0: the nonce generation function failed, or a private key was invalid, for at least one entry.
+ *  Args:    ctx:     pointer to a context object, initialized for signing (cannot be NULL)
+ *  Out:     sigs:    pointer to an array of n signatures (cannot be NULL)
+ *  In:      msgs32:  pointer to n consecutive 32-byte message hashes (cannot be NULL)
+ *           seckeys: pointer to n consecutive 32-byte secret keys (cannot be NULL)
+ *           n:       the number of signatures to create
+ *           noncefp: pointer to a nonce generation function. If NULL, secp256k1_nonce_function_default is used
+ *           ndata:   pointer to arbitrary data used by the nonce generation function (can be NULL)
+ */
+SECP256K1_API int secp256k1_ecdsa_sign_recoverable_batch(
+    const secp256k1_context* ctx,
+    secp256k1_ecdsa_recoverable_signature *sigs,
+    const unsigned char *msgs32,
+    const unsigned char *seckeys,
+    size_t n,
+    secp256k1_nonce_function noncefp,
+    const void *ndata
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
 /** Recover an ECDSA public key from a signature.
  *
  *  Returns: 1: public key successfully recovered (which guarantees a correct signature).
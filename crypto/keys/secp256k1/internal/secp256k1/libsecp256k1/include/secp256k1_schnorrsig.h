@@ -0,0 +1,140 @@
+#ifndef _SECP256K1_SCHNORRSIG_
+# define _SECP256K1_SCHNORRSIG_
+
+# include "secp256k1.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/** This module implements BIP340 Schnorr signatures over secp256k1: 64-byte
+ *  signatures (R.x, s) on 32-byte messages, checked against 32-byte x-only
+ *  public keys, i.e. the X coordinate of the point whose Y is even.
+ */
+
+/** Opaque data structure that holds a parsed x-only public key.
+ *
+ *  The exact representation of data inside is implementation defined and not
+ *  guaranteed to be portable between different platforms or versions. It is
+ *  however guaranteed to be 64 bytes in size, and can be safely copied/moved.
+ *  If you need to convert to a format suitable for storage or transmission,
+ *  use secp256k1_xonly_pubkey_serialize and secp256k1_xonly_pubkey_parse.
+ */
+typedef struct {
+    unsigned char data[64];
+} secp256k1_xonly_pubkey;
+
+/** Parse a 32-byte x-only public key into a secp256k1_xonly_pubkey object.
+ *
+ *  Returns: 1 if the public key was fully valid.
+ *           0 if the public key could not be parsed or is invalid.
+ *  Args: ctx:      a secp256k1 context object.
+ *  Out:  pubkey:   pointer to a pubkey object. If 1 is returned, it is set to a
+ *                  parsed version of input. If not, it's set to an invalid value.
+ *  In:   input32:  pointer to a serialized x-only public key.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_xonly_pubkey_parse(
+    const secp256k1_context* ctx,
+    secp256k1_xonly_pubkey* pubkey,
+    const unsigned char *input32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Serialize an x-only public key into 32 bytes.
+ *
+ *  Returns: 1 if the public key was valid, 0 otherwise.
+ *  Args:   ctx:        a secp256k1 context object.
+ *  Out:    output32:   a pointer to a 32-byte array to place the serialized key in.
+ *  In:     pubkey:     a pointer to a secp256k1_xonly_pubkey containing an
+ *                      initialized public key.
+ */
+SECP256K1_API int secp256k1_xonly_pubkey_serialize(
+    const secp256k1_context* ctx,
+    unsigned char *output32,
+    const secp256k1_xonly_pubkey* pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Convert a public key into the x-only public key with the same X coordinate.
+ *
+ *  Returns: 1 if the public key was valid, 0 otherwise.
+ *  Args:         ctx:        a secp256k1 context object.
+ *  Out:   xonly_pubkey:      pointer to an x-only public key object.
+ *           pk_parity:       pointer to an int that is set to 1 if the Y
+ *                            coordinate of pubkey is odd, 0 otherwise
+ *                            (can be NULL).
+ *  In:           pubkey:     pointer to a public key that is converted.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_xonly_pubkey_from_pubkey(
+    const secp256k1_context* ctx,
+    secp256k1_xonly_pubkey *xonly_pubkey,
+    int *pk_parity,
+    const secp256k1_pubkey *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(4);
+
+/** Create a BIP340 Schnorr signature.
+ *
+ *  Returns: 1: signature created
+ *           0: the secret key was invalid.
+ *  Args:    ctx:        pointer to a context object, initialized for signing (cannot be NULL)
+ *  Out:     sig64:      pointer to a 64-byte array to store the serialized signature (cannot be NULL)
+ *  In:      msg32:      the 32-byte message being signed (cannot be NULL)
+ *           seckey:     pointer to a 32-byte secret key (cannot be NULL)
+ *           aux_rand32: 32 bytes of fresh randomness (can be NULL)
+ *
+ *  The nonce is derived from the secret key, the message and aux_rand32 as
+ *  BIP340 specifies, so a poor source of randomness does not endanger the key.
+ *  Passing fresh randomness is still recommended, as it protects against
+ *  side-channel attacks; NULL is treated as 32 zero bytes.
+ */
+SECP256K1_API int secp256k1_schnorrsig_sign(
+    const secp256k1_context* ctx,
+    unsigned char *sig64,
+    const unsigned char *msg32,
+    const unsigned char *seckey,
+    const unsigned char *aux_rand32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
+/** Verify a BIP340 Schnorr signature.
+ *
+ *  Returns: 1: correct signature
+ *           0: incorrect signature
+ *  Args:    ctx:       a secp256k1 context object, initialized for verification.
+ *  In:      sig64:     pointer to the 64-byte signature to verify (cannot be NULL)
+ *           msg32:     the 32-byte message being verified (cannot be NULL)
+ *           pubkey:    pointer to an x-only public key to verify with (cannot be NULL)
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorrsig_verify(
+    const secp256k1_context* ctx,
+    const unsigned char *sig64,
+    const unsigned char *msg32,
+    const secp256k1_xonly_pubkey *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
+/** Verify a batch of BIP340 Schnorr signatures at once.
+ *
+ *  Returns: 1: all signatures are correct (or n is 0)
+ *           0: at least one signature is incorrect
+ *  Args:    ctx:       a secp256k1 context object, initialized for verification.
+ *  In:      sig64:     pointer to n 64-byte signatures, back to back (cannot be NULL if n > 0)
+ *           msg32:     pointer to n 32-byte messages, back to back (cannot be NULL if n > 0)
+ *           pubkeys:   pointer to an array of n x-only public keys (cannot be NULL if n > 0)
+ *           n:         the number of signatures
+ *
+ *  Signature i is checked against message i and public key i. Rather than
+ *  checking each of them, all are combined, with random weights, into one
+ *  multi-scalar multiplication, which saves about a third of the time per
+ *  signature. A 0 result does not tell which signature is incorrect; use
+ *  secp256k1_schnorrsig_verify to find out.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorrsig_verify_batch(
+    const secp256k1_context* ctx,
+    const unsigned char *sig64,
+    const unsigned char *msg32,
+    const secp256k1_xonly_pubkey *pubkeys,
+    size_t n
+) SECP256K1_ARG_NONNULL(1);
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef _SECP256K1_SCHNORRSIG_HALFAGG_
+# define _SECP256K1_SCHNORRSIG_HALFAGG_
+
+# include "secp256k1.h"
+# include "secp256k1_schnorrsig.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/** This module implements non-interactive half-aggregation of BIP340 Schnorr
+ *  signatures: n signatures, each on its own message by its own key, are
+ *  compressed into one aggregate signature of 32*n + 32 bytes (the R values
+ *  of all signatures and one combined s value), which is checked with
+ *  multi-scalar multiplications much like a batch of the original signatures.
+ *  Anyone can aggregate; no secret keys are needed.
+ *
+ *  The aggregate commits to the order of the (public key, message) pairs,
+ *  so verification must be given them in the order they were aggregated in.
+ */
+
+/** Aggregate n BIP340 signatures.
+ *
+ *  Returns: 1: the signatures were aggregated
+ *           0: a signature has an s value that is not below the group order,
+ *              or aggsig_len is smaller than 32*(n+1)
+ *  Args:    ctx:        a secp256k1 context object.
+ *  Out:     aggsig:     pointer to an array of *aggsig_len bytes to store the
+ *                       aggregate signature in (cannot be NULL)
+ *  In/Out:  aggsig_len: pointer to the size of aggsig; set to the size of the
+ *                       aggregate signature, 32*(n+1), on success (cannot be NULL)
+ *  In:      pubkeys:    pointer to an array of n x-only public keys (cannot be NULL if n > 0)
+ *           msgs32:     pointer to n 32-byte messages, back to back (cannot be NULL if n > 0)
+ *           sigs64:     pointer to n 64-byte signatures, back to back (cannot be NULL if n > 0)
+ *           n:          the number of signatures
+ *
+ *  Signature i must be a signature of message i by public key i. The
+ *  signatures are not verified; an invalid one makes the aggregate invalid.
+ */
+SECP256K1_API int secp256k1_schnorrsig_aggregate(
+    const secp256k1_context* ctx,
+    unsigned char *aggsig,
+    size_t *aggsig_len,
+    const secp256k1_xonly_pubkey *pubkeys,
+    const unsigned char *msgs32,
+    const unsigned char *sigs64,
+    size_t n
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Add n_new BIP340 signatures to an aggregate of n_before signatures.
+ *
+ *  Returns: 1: the signatures were added
+ *           0: a signature or the aggregate has an s value that is not below
+ *              the group order, or aggsig_len is smaller than 32*(n_before+n_new+1)
+ *  Args:    ctx:        a secp256k1 context object.
+ *  In/Out:  aggsig:     pointer to an array of *aggsig_len bytes that holds the
+ *                       32*(n_before+1)-byte aggregate of the first n_before
+ *                       signatures, and is updated in place (cannot be NULL)
+ *           aggsig_len: pointer to the size of aggsig; set to the size of the
+ *                       new aggregate signature on success (cannot be NULL)
+ *  In:      pubkeys:    pointer to an array of n_before+n_new x-only public
+ *                       keys: those of the aggregated signatures, then those
+ *                       of the new ones (cannot be NULL if n_before+n_new > 0)
+ *           msgs32:     pointer to n_before+n_new 32-byte messages, in the
+ *                       same order (cannot be NULL if n_before+n_new > 0)
+ *           new_sigs64: pointer to the n_new 64-byte signatures to add (cannot
+ *                       be NULL if n_new > 0)
+ *           n_before:   the number of signatures in the aggregate
+ *           n_new:      the number of signatures to add
+ *
+ *  The result is the same as aggregating all n_before+n_new signatures at
+ *  once with secp256k1_schnorrsig_aggregate.
+ */
+SECP256K1_API int secp256k1_schnorrsig_inc_aggregate(
+    const secp256k1_context* ctx,
+    unsigned char *aggsig,
+    size_t *aggsig_len,
+    const secp256k1_xonly_pubkey *pubkeys,
+    const unsigned char *msgs32,
+    const unsigned char *new_sigs64,
+    size_t n_before,
+    size_t n_new
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Verify an aggregate signature.
+ *
+ *  Returns: 1: correct aggregate signature
+ *           0: incorrect aggregate signature
+ *  Args:    ctx:        a secp256k1 context object, initialized for verification.
+ *  In:      pubkeys:    pointer to an array of n x-only public keys (cannot be NULL if n > 0)
+ *           msgs32:     pointer to n 32-byte messages, back to back (cannot be NULL if n > 0)
+ *           n:          the number of signatures that were aggregated
+ *           aggsig:     pointer to the aggregate signature (cannot be NULL)
+ *           aggsig_len: the size of the aggregate signature, which must be 32*(n+1)
+ *
+ *  A correct aggregate signature shows that message i was signed by public
+ *  key i for every i. An incorrect one does not tell which signature was
+ *  invalid. Verifying costs a little more (about 15%) than
+ *  secp256k1_schnorrsig_verify_batch on the n original signatures, as the
+ *  weights the aggregate fixes are 256 bits rather than 128.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorrsig_aggverify(
+    const secp256k1_context* ctx,
+    const secp256k1_xonly_pubkey *pubkeys,
+    const unsigned char *msgs32,
+    size_t n,
+    const unsigned char *aggsig,
+    size_t aggsig_len
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(5);
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef _SECP256K1_SIGCACHE_
+# define _SECP256K1_SIGCACHE_
+
+# include "secp256k1.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/** Opaque cache of signatures that passed verification.
+ *
+ *  Entries are SHA256(salt || pubkey || msg32 || sig), so the slots they land
+ *  in cannot be predicted without the salt. Only successful verifications are
+ *  remembered; when the table is full a random resident is evicted.
+ *
+ *  A cache may be shared between threads without any locking: lookups and
+ *  insertions are lock-free, and a concurrent insertion can at worst cause
+ *  a miss (and thus a full verification), never a false hit.
+ */
+typedef struct secp256k1_sigcache_struct secp256k1_sigcache;
+
+/** Create a signature cache.
+ *
+ *  Returns: a newly created cache, or NULL on illegal arguments or when out of
+ *           memory (after calling the error callback).
+ *  Args:    ctx:    an existing context object (cannot be NULL)
+ *  In:      size:   memory to use for the table in bytes; each entry takes
+ *                   32 (at least 128)
+ *           salt32: 32 secret random bytes keying the cache (cannot be NULL)
+ */
+SECP256K1_API secp256k1_sigcache* secp256k1_sigcache_create(
+    const secp256k1_context* ctx,
+    size_t size,
+    const unsigned char *salt32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(3) SECP256K1_WARN_UNUSED_RESULT;
+
+/** Destroy a signature cache.
+ *
+ *  No other thread may use the cache during or after this call.
+ *  Args:   cache: an existing cache to destroy (can be NULL)
+ */
+SECP256K1_API void secp256k1_sigcache_destroy(
+    secp256k1_sigcache* cache
+);
+
+/** Verify an ECDSA signature, consulting and filling a signature cache.
+ *
+ *  Returns: 1: correct signature
+ *           0: incorrect or unparseable signature
+ *  Args:    ctx:       a secp256k1 context object, initialized for verification.
+ *           cache:     a signature cache (cannot be NULL)
+ *  In:      sig:       the signature being verified (cannot be NULL)
+ *           msg32:     the 32-byte message hash being verified (cannot be NULL)
+ *           pubkey:    pointer to an initialized public key to verify with (cannot be NULL)
+ *
+ *  Gives the same result as secp256k1_ecdsa_verify, but a signature that was
+ *  verified through the same cache before is accepted after a hash lookup.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdsa_verify_cached(
+    const secp256k1_context* ctx,
+    secp256k1_sigcache *cache,
+    const secp256k1_ecdsa_signature *sig,
+    const unsigned char *msg32,
+    const secp256k1_pubkey *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5);
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
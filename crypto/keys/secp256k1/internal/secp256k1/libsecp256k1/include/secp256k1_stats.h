@@ -0,0 +1,48 @@
+#ifndef _SECP256K1_STATS_
+# define _SECP256K1_STATS_
+
+# include <stdint.h>
+
+# include "secp256k1.h"
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/** Operation counters, as returned by secp256k1_context_get_stats. */
+typedef struct {
+    uint64_t field_mul;    /* field multiplications */
+    uint64_t field_sqr;    /* field squarings */
+    uint64_t field_inv;    /* field inversions, constant and variable time */
+    uint64_t field_sqrt;   /* field square roots (pubkey decompression, recovery) */
+    uint64_t scalar_inv;   /* scalar inversions, constant and variable time */
+    uint64_t ecmult;       /* a*P + b*G (verification, recovery, tweaks) */
+    uint64_t ecmult_const; /* constant time a*P (ECDH) */
+    uint64_t ecmult_gen;   /* a*G (signing, key generation) */
+    uint64_t alloc;        /* heap allocations and table mappings */
+} secp256k1_stats;
+
+/** Read the operation counters of the library.
+ *
+ *  Returns: 1 always.
+ *  Args:    ctx:   pointer to a context object (cannot be NULL)
+ *  Out:     stats: pointer to the counters, summed over all threads since the
+ *                  library was loaded (cannot be NULL)
+ *
+ *  Counting is per thread rather than per context, as the arithmetic does not
+ *  know which context it is working for; every thread that used the library
+ *  contributes, including ones that have exited. Other threads' counts are
+ *  read without synchronization, so they may lag behind slightly while those
+ *  threads are still running. Take two snapshots and subtract them to measure
+ *  a piece of work.
+ */
+SECP256K1_API int secp256k1_context_get_stats(
+  const secp256k1_context* ctx,
+  secp256k1_stats *stats
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
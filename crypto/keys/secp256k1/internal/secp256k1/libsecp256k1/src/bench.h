@@ -7,14 +7,81 @@
 #ifndef _SECP256K1_BENCH_H_
 #define _SECP256K1_BENCH_H_
 
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <math.h>
+
+#if defined(HAVE_CLOCK_GETTIME)
+#include <time.h>
+#else
 #include "sys/time.h"
+#endif
+
+#if defined(HAVE_SCHED_SETAFFINITY)
+#include <sched.h>
+#endif
+
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BENCH_HAVE_RDTSC 1
+#endif
+
+/** Which hardware counters run_benchmark reports (see --perf). */
+#define BENCH_PERF_NONE 0
+#define BENCH_PERF_DEFAULT 1 /* instructions, cache misses, branch misses */
+#define BENCH_PERF_CACHE 2   /* cache references and misses, L1d and dTLB load misses */
+
+/** Settings shared by all benchmarks of a program, filled in by bench_init. */
+typedef struct {
+    int count;   /* timed runs per benchmark; 0 keeps each benchmark's own */
+    int warmup;  /* untimed runs before the timed ones */
+    int json;    /* print one JSON object per benchmark instead of text */
+    int perf;    /* BENCH_PERF_* */
+    int cpu;     /* CPU to pin to, or -1 */
+} bench_options;
+
+static bench_options bench_opts = {0, 1, 0, BENCH_PERF_NONE, -1};
 
 static double gettimedouble(void) {
+#if defined(HAVE_CLOCK_GETTIME)
+    struct timespec ts;
+#if defined(CLOCK_MONOTONIC_RAW)
+    /* Not slewed by NTP, so run lengths are comparable. */
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return ts.tv_nsec * 0.000000001 + ts.tv_sec;
+#else
     struct timeval tv;
     gettimeofday(&tv, NULL);
     return tv.tv_usec * 0.000001 + tv.tv_sec;
+#endif
+}
+
+/** Read the time stamp counter, or return 0 where there is none. This counts
+ *  at the nominal frequency of the CPU, not the actual clock of the core; for
+ *  meaningful cycle figures disable frequency scaling and turbo. */
+static uint64_t bench_rdtsc(void) {
+#if defined(BENCH_HAVE_RDTSC)
+    uint32_t lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return 0;
+#endif
 }
 
 void print_number(double x) {
@@ -30,37 +97,270 @@ void print_number(double x) {
     printf("%.*f", c, x);
 }
 
+typedef struct {
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+    int set;
+} bench_perf_event;
+
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+#define BENCH_HW_CACHE_READ_MISS(c) ((c) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const bench_perf_event bench_perf_events[] = {
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, BENCH_PERF_DEFAULT},
+    {"cache-references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, BENCH_PERF_CACHE},
+    {"cache-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, BENCH_PERF_DEFAULT},
+    {"cache-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, BENCH_PERF_CACHE},
+    {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, BENCH_PERF_DEFAULT},
+    {"L1d-load-misses", PERF_TYPE_HW_CACHE, BENCH_HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D), BENCH_PERF_CACHE},
+    {"dTLB-load-misses", PERF_TYPE_HW_CACHE, BENCH_HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_DTLB), BENCH_PERF_CACHE}
+};
+#define BENCH_PERF_EVENTS ((int)(sizeof(bench_perf_events) / sizeof(bench_perf_events[0])))
+#else
+#define BENCH_PERF_EVENTS 0
+#endif
+
+/* One counter per selected event; fd is -1 if the kernel refused it (no PMU,
+ * perf_event_paranoid), in which case it is reported as unavailable. */
+typedef struct {
+    const bench_perf_event *event;
+    int fd;
+    uint64_t total;
+} bench_perf_counter;
+
+static int bench_perf_open(bench_perf_counter *counters) {
+    int n = 0;
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+    int i;
+    for (i = 0; i < BENCH_PERF_EVENTS; i++) {
+        struct perf_event_attr attr;
+        if (bench_perf_events[i].set != bench_opts.perf) {
+            continue;
+        }
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = bench_perf_events[i].type;
+        attr.config = bench_perf_events[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        /* Also count threads started while the counter is open. */
+        attr.inherit = 1;
+        counters[n].event = &bench_perf_events[i];
+        counters[n].fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        counters[n].total = 0;
+        n++;
+    }
+#else
+    (void)counters;
+#endif
+    return n;
+}
+
+static void bench_perf_enable(bench_perf_counter *counters, int n, int enable) {
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+    int i;
+    for (i = 0; i < n; i++) {
+        if (counters[i].fd >= 0) {
+            ioctl(counters[i].fd, enable ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+#else
+    (void)counters;
+    (void)n;
+    (void)enable;
+#endif
+}
+
+static void bench_perf_close(bench_perf_counter *counters, int n) {
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+    int i;
+    for (i = 0; i < n; i++) {
+        uint64_t value = 0;
+        if (counters[i].fd < 0) {
+            continue;
+        }
+        if (read(counters[i].fd, &value, sizeof(value)) == sizeof(value)) {
+            counters[i].total = value;
+        }
+        close(counters[i].fd);
+    }
+#else
+    (void)counters;
+    (void)n;
+#endif
+}
+
+/** Strip the harness options (all starting with "--") from argv, apply them,
+ *  and return the new argc. The remaining arguments are left to the program. */
+int bench_init(int argc, char **argv) {
+    int i, n = 1;
+    for (i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strncmp(arg, "--", 2) != 0) {
+            argv[n++] = argv[i];
+        } else if (strncmp(arg, "--count=", 8) == 0 && atoi(arg + 8) > 0) {
+            bench_opts.count = atoi(arg + 8);
+        } else if (strncmp(arg, "--warmup=", 9) == 0 && atoi(arg + 9) >= 0) {
+            bench_opts.warmup = atoi(arg + 9);
+        } else if (strcmp(arg, "--json") == 0) {
+            bench_opts.json = 1;
+        } else if (strcmp(arg, "--perf") == 0) {
+            bench_opts.perf = BENCH_PERF_DEFAULT;
+        } else if (strcmp(arg, "--perf=cache") == 0) {
+            bench_opts.perf = BENCH_PERF_CACHE;
+        } else if (strncmp(arg, "--cpu=", 6) == 0 && atoi(arg + 6) >= 0) {
+            bench_opts.cpu = atoi(arg + 6);
+        } else {
+            fprintf(stderr, "Options: --count=N (timed runs), --warmup=N (untimed runs, default 1), --json,\n"
+                            "         --perf, --perf=cache (hardware counters), --cpu=N (pin to CPU N)\n");
+            exit(arg[2] == 'h' ? 0 : 1);
+        }
+    }
+    argv[n] = NULL;
+
+    if (bench_opts.cpu >= 0) {
+#if defined(HAVE_SCHED_SETAFFINITY)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(bench_opts.cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            fprintf(stderr, "Cannot pin to CPU %d\n", bench_opts.cpu);
+            exit(1);
+        }
+#else
+        fprintf(stderr, "CPU pinning is not supported on this platform\n");
+        exit(1);
+#endif
+    }
+#if !defined(HAVE_LINUX_PERF_EVENT_H)
+    if (bench_opts.perf != BENCH_PERF_NONE) {
+        fprintf(stderr, "Hardware counters require Linux perf events\n");
+        exit(1);
+    }
+#endif
+    return n;
+}
+
+static int bench_cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/** Nearest-rank percentile p (0..100) of the n sorted values in v. */
+static double bench_percentile(const double *v, int n, int p) {
+    int rank = (p * n + 99) / 100;
+    return v[rank < 1 ? 0 : rank - 1];
+}
+
+static void bench_print_time(const char *label, double seconds) {
+    printf("%s", label);
+    print_number(seconds * 1000000.0);
+    printf("us");
+}
+
+/** Run benchmark count times (bench_opts.count if set), after bench_opts.warmup
+ *  untimed runs, and report the time per iteration: min, median, mean, 99th
+ *  percentile and max over the runs, the median in TSC cycles where there is a
+ *  TSC, and the selected hardware counters averaged over all timed iterations. */
 void run_benchmark(char *name, void (*benchmark)(void*), void (*setup)(void*), void (*teardown)(void*), void* data, int count, int iter) {
     int i;
-    double min = HUGE_VAL;
+    double *times;
+    double *cycles;
     double sum = 0.0;
-    double max = 0.0;
+    bench_perf_counter counters[BENCH_PERF_EVENTS + 1];
+    int ncounters;
+
+    if (bench_opts.count > 0) {
+        count = bench_opts.count;
+    }
+    times = (double *)malloc(sizeof(double) * count);
+    cycles = (double *)malloc(sizeof(double) * count);
+    if (times == NULL || cycles == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    for (i = 0; i < bench_opts.warmup; i++) {
+        if (setup != NULL) {
+            setup(data);
+        }
+        benchmark(data);
+        if (teardown != NULL) {
+            teardown(data);
+        }
+    }
+
+    ncounters = bench_perf_open(counters);
     for (i = 0; i < count; i++) {
-        double begin, total;
+        double begin;
+        uint64_t tsc;
         if (setup != NULL) {
             setup(data);
         }
+        bench_perf_enable(counters, ncounters, 1);
         begin = gettimedouble();
+        tsc = bench_rdtsc();
         benchmark(data);
-        total = gettimedouble() - begin;
+        cycles[i] = (double)(bench_rdtsc() - tsc) / iter;
+        times[i] = (gettimedouble() - begin) / iter;
+        bench_perf_enable(counters, ncounters, 0);
         if (teardown != NULL) {
             teardown(data);
         }
-        if (total < min) {
-            min = total;
+        sum += times[i];
+    }
+    bench_perf_close(counters, ncounters);
+
+    qsort(times, count, sizeof(double), bench_cmp_double);
+    qsort(cycles, count, sizeof(double), bench_cmp_double);
+
+    if (bench_opts.json) {
+        printf("{\"name\": \"%s\", \"count\": %d, \"iterations\": %d, \"unit\": \"us\", "
+               "\"min\": %.6f, \"median\": %.6f, \"mean\": %.6f, \"p99\": %.6f, \"max\": %.6f",
+               name, count, iter,
+               times[0] * 1000000.0, bench_percentile(times, count, 50) * 1000000.0,
+               sum / count * 1000000.0, bench_percentile(times, count, 99) * 1000000.0,
+               times[count - 1] * 1000000.0);
+#if defined(BENCH_HAVE_RDTSC)
+        printf(", \"cycles_median\": %.1f", bench_percentile(cycles, count, 50));
+#endif
+        for (i = 0; i < ncounters; i++) {
+            if (counters[i].fd >= 0) {
+                printf(", \"%s\": %.2f", counters[i].event->name, (double)counters[i].total / ((double)count * iter));
+            } else {
+                printf(", \"%s\": null", counters[i].event->name);
+            }
         }
-        if (total > max) {
-            max = total;
+        printf("}\n");
+    } else {
+        printf("%s:", name);
+        bench_print_time(" min ", times[0]);
+        bench_print_time(" / median ", bench_percentile(times, count, 50));
+        bench_print_time(" / avg ", sum / count);
+        bench_print_time(" / p99 ", bench_percentile(times, count, 99));
+        bench_print_time(" / max ", times[count - 1]);
+#if defined(BENCH_HAVE_RDTSC)
+        printf(" / ");
+        print_number(bench_percentile(cycles, count, 50));
+        printf(" cycles");
+#endif
+        printf("\n");
+        for (i = 0; i < ncounters; i++) {
+            printf("%s: %s ", name, counters[i].event->name);
+            if (counters[i].fd >= 0) {
+                print_number((double)counters[i].total / ((double)count * iter));
+                printf(" / iteration\n");
+            } else {
+                printf("unavailable\n");
+            }
         }
-        sum += total;
     }
-    printf("%s: min ", name);
-    print_number(min * 1000000.0 / iter);
-    printf("us / avg ");
-    print_number((sum / count) * 1000000.0 / iter);
-    printf("us / max ");
-    print_number(max * 1000000.0 / iter);
-    printf("us\n");
+    fflush(stdout);
+
+    free(times);
+    free(cycles);
 }
 
 #endif
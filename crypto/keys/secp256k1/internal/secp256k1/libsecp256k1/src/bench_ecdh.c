@@ -4,6 +4,10 @@
  * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
  **********************************************************************/
 
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
 #include <string.h>
 
 #include "include/secp256k1.h"
@@ -14,6 +18,9 @@
 typedef struct {
     secp256k1_context *ctx;
     secp256k1_pubkey point;
+    secp256k1_pubkey points[100];
+    secp256k1_point_precomp *precomp;
+    unsigned char point_x[32];
     unsigned char scalar[32];
 } bench_ecdh_t;
 
@@ -34,6 +41,19 @@ static void bench_ecdh_setup(void* arg) {
         data->scalar[i] = i + 1;
     }
     CHECK(secp256k1_ec_pubkey_parse(data->ctx, &data->point, point, sizeof(point)) == 1);
+    memcpy(data->point_x, point + 1, 32);
+    for (i = 0; i < 100; i++) {
+        data->points[i] = data->point;
+    }
+    data->precomp = secp256k1_point_precomp_create(data->ctx, &data->point);
+    CHECK(data->precomp != NULL);
+}
+
+static void bench_ecdh_teardown(void* arg) {
+    bench_ecdh_t *data = (bench_ecdh_t*)arg;
+
+    secp256k1_point_precomp_destroy(data->precomp);
+    secp256k1_context_destroy(data->ctx);
 }
 
 static void bench_ecdh(void* arg) {
@@ -46,9 +66,47 @@ static void bench_ecdh(void* arg) {
     }
 }
 
-int main(void) {
+static void bench_ecdh_precomp(void* arg) {
+    int i;
+    unsigned char res[32];
+    bench_ecdh_t *data = (bench_ecdh_t*)arg;
+
+    for (i = 0; i < 20000; i++) {
+        CHECK(secp256k1_ecdh_precomp(data->ctx, res, data->precomp, data->scalar) == 1);
+    }
+}
+
+static void bench_ecdh_xonly(void* arg) {
+    int i;
+    unsigned char res[32];
+    bench_ecdh_t *data = (bench_ecdh_t*)arg;
+
+    for (i = 0; i < 20000; i++) {
+        CHECK(secp256k1_ecdh_xonly(data->ctx, res, data->point_x, data->scalar) == 1);
+    }
+}
+
+static void bench_ecdh_batch(void* arg) {
+    int i;
+    unsigned char res[100 * 32];
+    bench_ecdh_t *data = (bench_ecdh_t*)arg;
+
+    for (i = 0; i < 200; i++) {
+        CHECK(secp256k1_ecdh_batch(data->ctx, res, data->points, 100, data->scalar) == 1);
+    }
+}
+
+int main(int argc, char **argv) {
     bench_ecdh_t data;
 
-    run_benchmark("ecdh", bench_ecdh, bench_ecdh_setup, NULL, &data, 10, 20000);
+    if (bench_init(argc, argv) != 1) {
+        fprintf(stderr, "Usage: %s [options]\n", argv[0]);
+        return 1;
+    }
+
+    run_benchmark("ecdh", bench_ecdh, bench_ecdh_setup, bench_ecdh_teardown, &data, 10, 20000);
+    run_benchmark("ecdh_batch", bench_ecdh_batch, bench_ecdh_setup, bench_ecdh_teardown, &data, 10, 20000);
+    run_benchmark("ecdh_precomp", bench_ecdh_precomp, bench_ecdh_setup, bench_ecdh_teardown, &data, 10, 20000);
+    run_benchmark("ecdh_xonly", bench_ecdh_xonly, bench_ecdh_setup, bench_ecdh_teardown, &data, 10, 20000);
     return 0;
 }
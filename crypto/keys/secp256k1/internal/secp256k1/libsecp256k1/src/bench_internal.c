@@ -3,6 +3,11 @@
  * Distributed under the MIT software license, see the accompanying   *
  * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
  **********************************************************************/
+
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
 #include <stdio.h>
 
 #include "include/secp256k1.h"
@@ -25,6 +30,7 @@ typedef struct {
     secp256k1_gej gej_x, gej_y;
     unsigned char data[64];
     int wnaf[256];
+    secp256k1_wnaf_entry wnaf_compact[256];
 } bench_inv_t;
 
 void bench_setup(void* arg) {
@@ -227,6 +233,25 @@ void bench_group_add_affine_var(void* arg) {
     }
 }
 
+void bench_group_double_add_affine_var(void* arg) {
+    int i;
+    bench_inv_t *data = (bench_inv_t*)arg;
+
+    for (i = 0; i < 200000; i++) {
+        secp256k1_gej_double_add_ge_var(&data->gej_x, &data->gej_x, &data->ge_y);
+    }
+}
+
+void bench_group_add_zaddu_var(void* arg) {
+    int i;
+    bench_inv_t *data = (bench_inv_t*)arg;
+    secp256k1_fe zr;
+
+    for (i = 0; i < 200000; i++) {
+        secp256k1_ge_zaddu_var(&data->ge_y, &data->ge_x, &data->ge_x, &data->ge_y, &zr);
+    }
+}
+
 void bench_group_jacobi_var(void* arg) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
@@ -236,6 +261,18 @@ void bench_group_jacobi_var(void* arg) {
     }
 }
 
+void bench_ecmult_odd_multiples(void* arg) {
+    int i;
+    bench_inv_t *data = (bench_inv_t*)arg;
+    secp256k1_ge pre[ECMULT_TABLE_SIZE(WINDOW_A)];
+
+    for (i = 0; i < 20000; i++) {
+        secp256k1_ecmult_odd_multiples_table_globalz_windowa(pre, &data->gej_x.z, &data->gej_x);
+        data->gej_x.x = pre[1].x;
+        data->gej_x.y = pre[1].y;
+    }
+}
+
 void bench_ecmult_wnaf(void* arg) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
@@ -246,6 +283,16 @@ void bench_ecmult_wnaf(void* arg) {
     }
 }
 
+void bench_ecmult_wnaf_compact(void* arg) {
+    int i;
+    bench_inv_t *data = (bench_inv_t*)arg;
+
+    for (i = 0; i < 20000; i++) {
+        secp256k1_ecmult_wnaf_compact(data->wnaf_compact, 256, &data->scalar_x, WINDOW_A);
+        secp256k1_scalar_add(&data->scalar_x, &data->scalar_x, &data->scalar_y);
+    }
+}
+
 void bench_wnaf_const(void* arg) {
     int i;
     bench_inv_t *data = (bench_inv_t*)arg;
@@ -341,6 +388,7 @@ int have_flag(int argc, char** argv, char *flag) {
 
 int main(int argc, char **argv) {
     bench_inv_t data;
+    argc = bench_init(argc, argv);
     if (have_flag(argc, argv, "scalar") || have_flag(argc, argv, "add")) run_benchmark("scalar_add", bench_scalar_add, bench_setup, NULL, &data, 10, 2000000);
     if (have_flag(argc, argv, "scalar") || have_flag(argc, argv, "negate")) run_benchmark("scalar_negate", bench_scalar_negate, bench_setup, NULL, &data, 10, 2000000);
     if (have_flag(argc, argv, "scalar") || have_flag(argc, argv, "sqr")) run_benchmark("scalar_sqr", bench_scalar_sqr, bench_setup, NULL, &data, 10, 200000);
@@ -363,10 +411,14 @@ int main(int argc, char **argv) {
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "add")) run_benchmark("group_add_var", bench_group_add_var, bench_setup, NULL, &data, 10, 200000);
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "add")) run_benchmark("group_add_affine", bench_group_add_affine, bench_setup, NULL, &data, 10, 200000);
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "add")) run_benchmark("group_add_affine_var", bench_group_add_affine_var, bench_setup, NULL, &data, 10, 200000);
+    if (have_flag(argc, argv, "group") || have_flag(argc, argv, "add")) run_benchmark("group_double_add_affine_var", bench_group_double_add_affine_var, bench_setup, NULL, &data, 10, 200000);
+    if (have_flag(argc, argv, "group") || have_flag(argc, argv, "add")) run_benchmark("group_add_zaddu_var", bench_group_add_zaddu_var, bench_setup, NULL, &data, 10, 200000);
     if (have_flag(argc, argv, "group") || have_flag(argc, argv, "jacobi")) run_benchmark("group_jacobi_var", bench_group_jacobi_var, bench_setup, NULL, &data, 10, 20000);
 
     if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "wnaf")) run_benchmark("wnaf_const", bench_wnaf_const, bench_setup, NULL, &data, 10, 20000);
+    if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "table")) run_benchmark("ecmult_odd_multiples", bench_ecmult_odd_multiples, bench_setup, NULL, &data, 10, 20000);
     if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "wnaf")) run_benchmark("ecmult_wnaf", bench_ecmult_wnaf, bench_setup, NULL, &data, 10, 20000);
+    if (have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "wnaf")) run_benchmark("ecmult_wnaf_compact", bench_ecmult_wnaf_compact, bench_setup, NULL, &data, 10, 20000);
 
     if (have_flag(argc, argv, "hash") || have_flag(argc, argv, "sha256")) run_benchmark("hash_sha256", bench_sha256, bench_setup, NULL, &data, 10, 20000);
     if (have_flag(argc, argv, "hash") || have_flag(argc, argv, "hmac")) run_benchmark("hash_hmac_sha256", bench_hmac_sha256, bench_setup, NULL, &data, 10, 20000);
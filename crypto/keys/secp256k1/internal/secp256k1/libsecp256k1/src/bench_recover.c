@@ -4,6 +4,10 @@
  * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
  **********************************************************************/
 
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
 #include "include/secp256k1.h"
 #include "include/secp256k1_recovery.h"
 #include "util.h"
@@ -48,9 +52,14 @@ void bench_recover_setup(void* arg) {
     }
 }
 
-int main(void) {
+int main(int argc, char **argv) {
     bench_recover_t data;
 
+    if (bench_init(argc, argv) != 1) {
+        fprintf(stderr, "Usage: %s [options]\n", argv[0]);
+        return 1;
+    }
+
     data.ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
 
     run_benchmark("ecdsa_recover", bench_recover, bench_recover_setup, NULL, &data, 10, 20000);
@@ -0,0 +1,285 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(HAVE_SYS_MMAN_H)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "include/secp256k1.h"
+#include "include/secp256k1_recovery.h"
+#include "util.h"
+#include "hash_impl.h"
+#include "testrand_impl.h"
+#include "bench.h"
+
+/* Replays a corpus of signatures with a different key each, as found in a
+ * block, instead of one key and message over and over.
+ *
+ * Corpus file layout (also read by the Go replay benchmarks):
+ *   header:  "SECPRPLY" | version (uint32 LE, 1) | record count (uint32 LE)
+ *   records: pubkey (33, compressed) | digest (32) | signature (64, R || S)
+ *            | recid (1)
+ * so that the last 65 bytes of a record are the [R || S || V] signature the
+ * Go wrapper takes. "generate" writes one from the test RNG; a given seed
+ * always produces the same file. */
+
+#define REPLAY_MAGIC "SECPRPLY"
+#define REPLAY_VERSION 1
+#define REPLAY_HEADER_SIZE 16
+#define REPLAY_RECORD_SIZE 130
+
+typedef struct {
+    secp256k1_context *ctx;
+    const unsigned char *records;
+    size_t count;
+} bench_replay_t;
+
+static void bench_replay_verify(void* arg) {
+    size_t i;
+    bench_replay_t *data = (bench_replay_t*)arg;
+
+    for (i = 0; i < data->count; i++) {
+        const unsigned char *rec = data->records + i * REPLAY_RECORD_SIZE;
+        secp256k1_pubkey pubkey;
+        secp256k1_ecdsa_signature sig;
+        PREFETCH(rec + 4 * REPLAY_RECORD_SIZE);
+        CHECK(secp256k1_ec_pubkey_parse(data->ctx, &pubkey, rec, 33) == 1);
+        CHECK(secp256k1_ecdsa_signature_parse_compact(data->ctx, &sig, rec + 65) == 1);
+        CHECK(secp256k1_ecdsa_verify(data->ctx, &sig, rec + 33, &pubkey) == 1);
+    }
+}
+
+static void bench_replay_recover(void* arg) {
+    size_t i;
+    bench_replay_t *data = (bench_replay_t*)arg;
+
+    for (i = 0; i < data->count; i++) {
+        const unsigned char *rec = data->records + i * REPLAY_RECORD_SIZE;
+        secp256k1_pubkey pubkey;
+        secp256k1_ecdsa_recoverable_signature sig;
+        unsigned char pubkeyc[33];
+        size_t pubkeylen = 33;
+        PREFETCH(rec + 4 * REPLAY_RECORD_SIZE);
+        CHECK(secp256k1_ecdsa_recoverable_signature_parse_compact(data->ctx, &sig, rec + 65, rec[129]) == 1);
+        CHECK(secp256k1_ecdsa_recover(data->ctx, &pubkey, &sig, rec + 33) == 1);
+        CHECK(secp256k1_ec_pubkey_serialize(data->ctx, pubkeyc, &pubkeylen, &pubkey, SECP256K1_EC_COMPRESSED) == 1);
+        CHECK(memcmp(pubkeyc, rec, 33) == 0);
+    }
+}
+
+static void replay_write_u32(unsigned char *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+static uint32_t replay_read_u32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int replay_generate(secp256k1_context *ctx, const char *path, uint32_t count, const unsigned char *seed16) {
+    unsigned char header[REPLAY_HEADER_SIZE];
+    FILE *f = fopen(path, "wb");
+    uint32_t i;
+
+    if (f == NULL) {
+        fprintf(stderr, "Cannot create %s\n", path);
+        return 0;
+    }
+    memcpy(header, REPLAY_MAGIC, 8);
+    replay_write_u32(header + 8, REPLAY_VERSION);
+    replay_write_u32(header + 12, count);
+    CHECK(fwrite(header, sizeof(header), 1, f) == 1);
+
+    secp256k1_rand_seed(seed16);
+    for (i = 0; i < count; i++) {
+        unsigned char rec[REPLAY_RECORD_SIZE];
+        unsigned char seckey[32];
+        secp256k1_pubkey pubkey;
+        secp256k1_ecdsa_recoverable_signature sig;
+        size_t pubkeylen = 33;
+        int recid;
+        do {
+            secp256k1_rand256(seckey);
+        } while (!secp256k1_ec_seckey_verify(ctx, seckey));
+        secp256k1_rand256(rec + 33);
+        CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey, seckey) == 1);
+        CHECK(secp256k1_ec_pubkey_serialize(ctx, rec, &pubkeylen, &pubkey, SECP256K1_EC_COMPRESSED) == 1);
+        CHECK(secp256k1_ecdsa_sign_recoverable(ctx, &sig, rec + 33, seckey, NULL, NULL) == 1);
+        CHECK(secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, rec + 65, &recid, &sig) == 1);
+        rec[129] = recid;
+        CHECK(fwrite(rec, sizeof(rec), 1, f) == 1);
+    }
+    if (fclose(f) != 0) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+/** Map (or, without mmap, read) a corpus file. Returns a pointer to the whole
+ *  file and its length in *len, or NULL if it cannot be read or is not a
+ *  corpus. */
+static unsigned char *replay_load(const char *path, size_t *len, int *mapped) {
+    unsigned char *buf = NULL;
+    *mapped = 0;
+#if defined(HAVE_SYS_MMAN_H)
+    {
+        struct stat st;
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "Cannot open %s\n", path);
+            return NULL;
+        }
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+                madvise(p, st.st_size, MADV_SEQUENTIAL);
+#endif
+                buf = (unsigned char *)p;
+                *len = st.st_size;
+                *mapped = 1;
+            }
+        }
+        close(fd);
+    }
+#endif
+    if (buf == NULL) {
+        FILE *f = fopen(path, "rb");
+        long size;
+        if (f == NULL) {
+            fprintf(stderr, "Cannot open %s\n", path);
+            return NULL;
+        }
+        if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) <= 0 || fseek(f, 0, SEEK_SET) != 0 ||
+            (buf = (unsigned char *)malloc(size)) == NULL || fread(buf, size, 1, f) != 1) {
+            fprintf(stderr, "Cannot read %s\n", path);
+            free(buf);
+            fclose(f);
+            return NULL;
+        }
+        fclose(f);
+        *len = size;
+    }
+    if (*len < REPLAY_HEADER_SIZE || memcmp(buf, REPLAY_MAGIC, 8) != 0 ||
+        replay_read_u32(buf + 8) != REPLAY_VERSION ||
+        replay_read_u32(buf + 12) == 0 ||
+        *len != REPLAY_HEADER_SIZE + (size_t)replay_read_u32(buf + 12) * REPLAY_RECORD_SIZE) {
+        fprintf(stderr, "%s is not a replay corpus\n", path);
+#if defined(HAVE_SYS_MMAN_H)
+        if (*mapped) {
+            munmap(buf, *len);
+            return NULL;
+        }
+#endif
+        free(buf);
+        return NULL;
+    }
+    return buf;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "Usage: %s [options] generate FILE [COUNT] [SEED]\n"
+                    "       %s [options] FILE [verify] [recover]\n"
+                    "SEED is 32 hex digits; COUNT defaults to 4000.\n", argv0, argv0);
+}
+
+int main(int argc, char **argv) {
+    bench_replay_t data;
+    unsigned char *file;
+    size_t len;
+    int mapped;
+    int verify = 0, recover = 0;
+    int i;
+
+    argc = bench_init(argc, argv);
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    data.ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+    if (strcmp(argv[1], "generate") == 0) {
+        /* Fixed default seed, so corpora made on different machines match. */
+        unsigned char seed16[16] = {
+            's', 'e', 'c', 'p', '2', '5', '6', 'k', '1', ' ', 'r', 'e', 'p', 'l', 'a', 'y'
+        };
+        long count = 4000;
+        int ok;
+        if (argc < 3 || argc > 5 || (argc > 3 && (count = atol(argv[3])) <= 0)) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (argc > 4) {
+            if (strlen(argv[4]) != 32) {
+                usage(argv[0]);
+                return 1;
+            }
+            for (i = 0; i < 16; i++) {
+                unsigned int byte;
+                if (sscanf(argv[4] + 2 * i, "%2x", &byte) != 1) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                seed16[i] = byte;
+            }
+        }
+        ok = replay_generate(data.ctx, argv[2], (uint32_t)count, seed16);
+        secp256k1_context_destroy(data.ctx);
+        return ok ? 0 : 1;
+    }
+
+    for (i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "verify") == 0) {
+            verify = 1;
+        } else if (strcmp(argv[i], "recover") == 0) {
+            recover = 1;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!verify && !recover) {
+        verify = recover = 1;
+    }
+
+    file = replay_load(argv[1], &len, &mapped);
+    if (file == NULL) {
+        return 1;
+    }
+    data.records = file + REPLAY_HEADER_SIZE;
+    data.count = replay_read_u32(file + 12);
+
+    if (verify) {
+        run_benchmark("replay_verify", bench_replay_verify, NULL, NULL, &data, 10, (int)data.count);
+    }
+    if (recover) {
+        run_benchmark("replay_recover", bench_replay_recover, NULL, NULL, &data, 10, (int)data.count);
+    }
+
+#if defined(HAVE_SYS_MMAN_H)
+    if (mapped) {
+        munmap(file, len);
+    } else {
+        free(file);
+    }
+#else
+    free(file);
+#endif
+    secp256k1_context_destroy(data.ctx);
+    return 0;
+}
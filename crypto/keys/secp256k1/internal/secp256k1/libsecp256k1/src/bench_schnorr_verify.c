@@ -4,44 +4,51 @@
  * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
  **********************************************************************/
 
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
 #include <stdio.h>
 #include <string.h>
 
 #include "include/secp256k1.h"
-#include "include/secp256k1_schnorr.h"
+#include "include/secp256k1_schnorrsig.h"
 #include "util.h"
 #include "bench.h"
 
-typedef struct {
-    unsigned char key[32];
-    unsigned char sig[64];
-    unsigned char pubkey[33];
-    size_t pubkeylen;
-} benchmark_schnorr_sig_t;
+#define BENCH_SCHNORR_SIGS 64
 
 typedef struct {
     secp256k1_context *ctx;
-    unsigned char msg[32];
-    benchmark_schnorr_sig_t sigs[64];
-    int numsigs;
+    unsigned char keys[BENCH_SCHNORR_SIGS][32];
+    unsigned char msgs[BENCH_SCHNORR_SIGS][32];
+    unsigned char sigs[BENCH_SCHNORR_SIGS][64];
+    secp256k1_xonly_pubkey pubkeys[BENCH_SCHNORR_SIGS];
 } benchmark_schnorr_verify_t;
 
 static void benchmark_schnorr_init(void* arg) {
     int i, k;
     benchmark_schnorr_verify_t* data = (benchmark_schnorr_verify_t*)arg;
 
-    for (i = 0; i < 32; i++) {
-        data->msg[i] = 1 + i;
-    }
-    for (k = 0; k < data->numsigs; k++) {
+    for (k = 0; k < BENCH_SCHNORR_SIGS; k++) {
         secp256k1_pubkey pubkey;
         for (i = 0; i < 32; i++) {
-            data->sigs[k].key[i] = 33 + i + k;
+            data->keys[k][i] = 33 + i + k;
+            data->msgs[k][i] = 1 + i + k;
         }
-        secp256k1_schnorr_sign(data->ctx, data->sigs[k].sig, data->msg, data->sigs[k].key, NULL, NULL);
-        data->sigs[k].pubkeylen = 33;
-        CHECK(secp256k1_ec_pubkey_create(data->ctx, &pubkey, data->sigs[k].key));
-        CHECK(secp256k1_ec_pubkey_serialize(data->ctx, data->sigs[k].pubkey, &data->sigs[k].pubkeylen, &pubkey, SECP256K1_EC_COMPRESSED));
+        CHECK(secp256k1_schnorrsig_sign(data->ctx, data->sigs[k], data->msgs[k], data->keys[k], NULL));
+        CHECK(secp256k1_ec_pubkey_create(data->ctx, &pubkey, data->keys[k]));
+        CHECK(secp256k1_xonly_pubkey_from_pubkey(data->ctx, &data->pubkeys[k], NULL, &pubkey));
+    }
+}
+
+static void benchmark_schnorr_sign(void* arg) {
+    int i;
+    benchmark_schnorr_verify_t* data = (benchmark_schnorr_verify_t*)arg;
+
+    for (i = 0; i < 20000; i++) {
+        CHECK(secp256k1_schnorrsig_sign(data->ctx, data->sigs[0], data->msgs[0], data->keys[0], NULL));
+        memcpy(data->msgs[0], data->sigs[0], 32);
     }
 }
 
@@ -49,24 +56,35 @@ static void benchmark_schnorr_verify(void* arg) {
     int i;
     benchmark_schnorr_verify_t* data = (benchmark_schnorr_verify_t*)arg;
 
-    for (i = 0; i < 20000 / data->numsigs; i++) {
-        secp256k1_pubkey pubkey;
-        data->sigs[0].sig[(i >> 8) % 64] ^= (i & 0xFF);
-        CHECK(secp256k1_ec_pubkey_parse(data->ctx, &pubkey, data->sigs[0].pubkey, data->sigs[0].pubkeylen));
-        CHECK(secp256k1_schnorr_verify(data->ctx, data->sigs[0].sig, data->msg, &pubkey) == ((i & 0xFF) == 0));
-        data->sigs[0].sig[(i >> 8) % 64] ^= (i & 0xFF);
+    for (i = 0; i < 20000; i++) {
+        data->sigs[0][(i >> 8) % 64] ^= (i & 0xFF);
+        CHECK(secp256k1_schnorrsig_verify(data->ctx, data->sigs[0], data->msgs[0], &data->pubkeys[0]) == ((i & 0xFF) == 0));
+        data->sigs[0][(i >> 8) % 64] ^= (i & 0xFF);
     }
 }
 
+static void benchmark_schnorr_verify_batch(void* arg) {
+    int i;
+    benchmark_schnorr_verify_t* data = (benchmark_schnorr_verify_t*)arg;
 
+    for (i = 0; i < 20000 / BENCH_SCHNORR_SIGS; i++) {
+        CHECK(secp256k1_schnorrsig_verify_batch(data->ctx, data->sigs[0], data->msgs[0], data->pubkeys, BENCH_SCHNORR_SIGS));
+    }
+}
 
-int main(void) {
+int main(int argc, char **argv) {
     benchmark_schnorr_verify_t data;
 
+    if (bench_init(argc, argv) != 1) {
+        fprintf(stderr, "Usage: %s [options]\n", argv[0]);
+        return 1;
+    }
+
     data.ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
 
-    data.numsigs = 1;
-    run_benchmark("schnorr_verify", benchmark_schnorr_verify, benchmark_schnorr_init, NULL, &data, 10, 20000);
+    run_benchmark("schnorrsig_sign", benchmark_schnorr_sign, benchmark_schnorr_init, NULL, &data, 10, 20000);
+    run_benchmark("schnorrsig_verify", benchmark_schnorr_verify, benchmark_schnorr_init, NULL, &data, 10, 20000);
+    run_benchmark("schnorrsig_verify_batch", benchmark_schnorr_verify_batch, benchmark_schnorr_init, NULL, &data, 10, 20000 / BENCH_SCHNORR_SIGS * BENCH_SCHNORR_SIGS);
 
     secp256k1_context_destroy(data.ctx);
     return 0;
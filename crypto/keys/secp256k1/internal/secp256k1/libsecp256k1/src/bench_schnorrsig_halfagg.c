@@ -0,0 +1,94 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "include/secp256k1.h"
+#include "include/secp256k1_schnorrsig.h"
+#include "include/secp256k1_schnorrsig_halfagg.h"
+#include "util.h"
+#include "bench.h"
+
+/* About the number of signatures in a block. */
+#define BENCH_HALFAGG_SIGS 1024
+
+typedef struct {
+    secp256k1_context *ctx;
+    unsigned char msgs[BENCH_HALFAGG_SIGS * 32];
+    unsigned char sigs[BENCH_HALFAGG_SIGS * 64];
+    unsigned char aggsig[(BENCH_HALFAGG_SIGS + 1) * 32];
+    size_t aggsig_len;
+    secp256k1_xonly_pubkey pubkeys[BENCH_HALFAGG_SIGS];
+} benchmark_halfagg_t;
+
+static void benchmark_halfagg_init(void* arg) {
+    int i, k;
+    unsigned char key[32];
+    benchmark_halfagg_t* data = (benchmark_halfagg_t*)arg;
+
+    for (k = 0; k < BENCH_HALFAGG_SIGS; k++) {
+        secp256k1_pubkey pubkey;
+        for (i = 0; i < 32; i++) {
+            key[i] = 33 + i + k;
+            data->msgs[32 * k + i] = 1 + i + k;
+        }
+        key[0] = k >> 8;
+        CHECK(secp256k1_schnorrsig_sign(data->ctx, &data->sigs[64 * k], &data->msgs[32 * k], key, NULL));
+        CHECK(secp256k1_ec_pubkey_create(data->ctx, &pubkey, key));
+        CHECK(secp256k1_xonly_pubkey_from_pubkey(data->ctx, &data->pubkeys[k], NULL, &pubkey));
+    }
+    data->aggsig_len = sizeof(data->aggsig);
+    CHECK(secp256k1_schnorrsig_aggregate(data->ctx, data->aggsig, &data->aggsig_len, data->pubkeys, data->msgs, data->sigs, BENCH_HALFAGG_SIGS));
+}
+
+static void benchmark_halfagg_aggregate(void* arg) {
+    int i;
+    benchmark_halfagg_t* data = (benchmark_halfagg_t*)arg;
+
+    for (i = 0; i < 10; i++) {
+        data->aggsig_len = sizeof(data->aggsig);
+        CHECK(secp256k1_schnorrsig_aggregate(data->ctx, data->aggsig, &data->aggsig_len, data->pubkeys, data->msgs, data->sigs, BENCH_HALFAGG_SIGS));
+    }
+}
+
+static void benchmark_halfagg_aggverify(void* arg) {
+    benchmark_halfagg_t* data = (benchmark_halfagg_t*)arg;
+
+    CHECK(secp256k1_schnorrsig_aggverify(data->ctx, data->pubkeys, data->msgs, BENCH_HALFAGG_SIGS, data->aggsig, data->aggsig_len));
+}
+
+static void benchmark_halfagg_verify_batch(void* arg) {
+    benchmark_halfagg_t* data = (benchmark_halfagg_t*)arg;
+
+    CHECK(secp256k1_schnorrsig_verify_batch(data->ctx, data->sigs, data->msgs, data->pubkeys, BENCH_HALFAGG_SIGS));
+}
+
+int main(int argc, char **argv) {
+    benchmark_halfagg_t *data;
+
+    if (bench_init(argc, argv) != 1) {
+        fprintf(stderr, "Usage: %s [options]\n", argv[0]);
+        return 1;
+    }
+
+    data = (benchmark_halfagg_t*)malloc(sizeof(benchmark_halfagg_t));
+    data->ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+
+    /* All per signature; the batch verification of the same signatures is
+     * there to compare with. */
+    run_benchmark("schnorrsig_aggregate", benchmark_halfagg_aggregate, benchmark_halfagg_init, NULL, data, 10, 10 * BENCH_HALFAGG_SIGS);
+    run_benchmark("schnorrsig_aggverify", benchmark_halfagg_aggverify, benchmark_halfagg_init, NULL, data, 10, BENCH_HALFAGG_SIGS);
+    run_benchmark("schnorrsig_verify_batch", benchmark_halfagg_verify_batch, benchmark_halfagg_init, NULL, data, 10, BENCH_HALFAGG_SIGS);
+
+    secp256k1_context_destroy(data->ctx);
+    free(data);
+    return 0;
+}
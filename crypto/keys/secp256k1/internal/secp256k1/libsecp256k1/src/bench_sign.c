@@ -4,7 +4,14 @@
  * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
  **********************************************************************/
 
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
 #include "include/secp256k1.h"
+#ifdef ENABLE_MODULE_NONCEPOOL
+#include "include/secp256k1_noncepool.h"
+#endif
 #include "util.h"
 #include "bench.h"
 
@@ -12,6 +19,11 @@ typedef struct {
     secp256k1_context* ctx;
     unsigned char msg[32];
     unsigned char key[32];
+    unsigned char msgs[100][32];
+    unsigned char keys[100][32];
+#ifdef ENABLE_MODULE_NONCEPOOL
+    secp256k1_noncepool *pool;
+#endif
 } bench_sign_t;
 
 static void bench_sign_setup(void* arg) {
@@ -24,6 +36,12 @@ static void bench_sign_setup(void* arg) {
     for (i = 0; i < 32; i++) {
         data->key[i] = i + 65;
     }
+    for (i = 0; i < 100; i++) {
+        memcpy(data->msgs[i], data->msg, 32);
+        memcpy(data->keys[i], data->key, 32);
+        data->msgs[i][0] = i;
+        data->keys[i][0] = i;
+    }
 }
 
 static void bench_sign(void* arg) {
@@ -44,12 +62,66 @@ static void bench_sign(void* arg) {
     }
 }
 
-int main(void) {
+static void bench_sign_batch(void* arg) {
+    int i;
+    bench_sign_t *data = (bench_sign_t*)arg;
+
+    unsigned char sig[64];
+    secp256k1_ecdsa_signature signatures[100];
+    for (i = 0; i < 200; i++) {
+        int j;
+        CHECK(secp256k1_ecdsa_sign_batch(data->ctx, signatures, data->msgs[0], data->keys[0], 100, NULL, NULL));
+        for (j = 0; j < 100; j++) {
+            CHECK(secp256k1_ecdsa_signature_serialize_compact(data->ctx, sig, &signatures[j]));
+            memcpy(data->msgs[j], sig, 32);
+            memcpy(data->keys[j], sig + 32, 32);
+        }
+    }
+}
+
+#ifdef ENABLE_MODULE_NONCEPOOL
+static void bench_sign_pooled_setup(void* arg) {
+    unsigned char seed[32] = { 0 };
+    bench_sign_t *data = (bench_sign_t*)arg;
+
+    bench_sign_setup(arg);
+    while (secp256k1_noncepool_fill(data->ctx, data->pool, seed)) {
+        seed[0]++;
+    }
+}
+
+static void bench_sign_pooled(void* arg) {
+    int i;
+    bench_sign_t *data = (bench_sign_t*)arg;
+
+    unsigned char sig[64];
+    for (i = 0; i < 20000; i++) {
+        secp256k1_ecdsa_signature signature;
+        CHECK(secp256k1_ecdsa_sign_pooled(data->ctx, data->pool, &signature, NULL, data->msg, data->key));
+        CHECK(secp256k1_ecdsa_signature_serialize_compact(data->ctx, sig, &signature));
+        memcpy(data->msg, sig, 32);
+        memcpy(data->key, sig + 32, 32);
+    }
+}
+#endif
+
+int main(int argc, char **argv) {
     bench_sign_t data;
 
+    if (bench_init(argc, argv) != 1) {
+        fprintf(stderr, "Usage: %s [options]\n", argv[0]);
+        return 1;
+    }
+
     data.ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
 
     run_benchmark("ecdsa_sign", bench_sign, bench_sign_setup, NULL, &data, 10, 20000);
+    run_benchmark("ecdsa_sign_batch", bench_sign_batch, bench_sign_setup, NULL, &data, 10, 20000);
+#ifdef ENABLE_MODULE_NONCEPOOL
+    data.pool = secp256k1_noncepool_create(data.ctx, 20000);
+    run_benchmark("ecdsa_sign_pooled", bench_sign_pooled, bench_sign_pooled_setup, NULL, &data, 10, 20000);
+    secp256k1_noncepool_destroy(data.pool);
+#endif
 
     secp256k1_context_destroy(data.ctx);
     return 0;
@@ -0,0 +1,397 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "include/secp256k1.h"
+#ifdef ENABLE_MODULE_RECOVERY
+#include "include/secp256k1_recovery.h"
+#endif
+#ifdef ENABLE_MODULE_ECDH
+#include "include/secp256k1_ecdh.h"
+#endif
+#include "util.h"
+#include "bench.h"
+
+/* Scaling benchmark: runs one operation on 1..N threads at once, either all
+ * sharing one context (and so one copy of the precomputed tables) or each with
+ * its own, and reports aggregate throughput and how far it is from linear. */
+
+#define BENCH_THREADS_MAX 256
+
+/** Distinct inputs per thread, so the threads do not all work on one key. */
+#define BENCH_THREADS_INPUTS 64
+
+enum {
+    BENCH_OP_VERIFY,
+    BENCH_OP_SIGN,
+#ifdef ENABLE_MODULE_RECOVERY
+    BENCH_OP_RECOVER,
+#endif
+#ifdef ENABLE_MODULE_ECDH
+    BENCH_OP_ECDH,
+#endif
+    BENCH_OPS
+};
+
+static const char *bench_op_arg[BENCH_OPS] = {
+    "verify",
+    "sign",
+#ifdef ENABLE_MODULE_RECOVERY
+    "recover",
+#endif
+#ifdef ENABLE_MODULE_ECDH
+    "ecdh",
+#endif
+};
+
+static const char *bench_op_name[BENCH_OPS] = {
+    "ecdsa_verify",
+    "ecdsa_sign",
+#ifdef ENABLE_MODULE_RECOVERY
+    "ecdsa_recover",
+#endif
+#ifdef ENABLE_MODULE_ECDH
+    "ecdh",
+#endif
+};
+
+typedef struct {
+    unsigned char seckey[32];
+    unsigned char msg[32];
+    secp256k1_pubkey pubkey;
+    secp256k1_ecdsa_signature sig;
+#ifdef ENABLE_MODULE_RECOVERY
+    secp256k1_ecdsa_recoverable_signature rsig;
+#endif
+} bench_threads_input;
+
+/* State of one measurement, shared by its workers. */
+typedef struct {
+    int op;
+    int iters;               /* operations per thread */
+    int private_ctx;         /* each worker creates its own context */
+    unsigned int flags;      /* for private contexts */
+    const secp256k1_context *ctx;
+    const bench_threads_input *inputs;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int ready;               /* workers waiting for the start signal */
+    int go;
+} bench_threads_run;
+
+typedef struct {
+    bench_threads_run *run;
+    pthread_t thread;
+    int index;
+    double elapsed;
+} bench_threads_worker;
+
+static void bench_threads_op(const secp256k1_context *ctx, int op, const bench_threads_input *in) {
+    switch (op) {
+    case BENCH_OP_VERIFY:
+        CHECK(secp256k1_ecdsa_verify(ctx, &in->sig, in->msg, &in->pubkey) == 1);
+        break;
+    case BENCH_OP_SIGN: {
+        secp256k1_ecdsa_signature sig;
+        CHECK(secp256k1_ecdsa_sign(ctx, &sig, in->msg, in->seckey, NULL, NULL) == 1);
+        break;
+    }
+#ifdef ENABLE_MODULE_RECOVERY
+    case BENCH_OP_RECOVER: {
+        secp256k1_pubkey pubkey;
+        CHECK(secp256k1_ecdsa_recover(ctx, &pubkey, &in->rsig, in->msg) == 1);
+        break;
+    }
+#endif
+#ifdef ENABLE_MODULE_ECDH
+    case BENCH_OP_ECDH: {
+        unsigned char secret[32];
+        CHECK(secp256k1_ecdh(ctx, secret, &in->pubkey, in->seckey) == 1);
+        break;
+    }
+#endif
+    }
+}
+
+static void *bench_threads_main(void *arg) {
+    bench_threads_worker *w = (bench_threads_worker *)arg;
+    bench_threads_run *run = w->run;
+    const bench_threads_input *inputs = &run->inputs[w->index * BENCH_THREADS_INPUTS];
+    secp256k1_context *own = NULL;
+    const secp256k1_context *ctx = run->ctx;
+    double begin;
+    int i;
+
+    if (run->private_ctx) {
+        own = secp256k1_context_create(run->flags);
+        ctx = own;
+    }
+    /* One untimed operation, so page faults on the tables are not measured. */
+    bench_threads_op(ctx, run->op, &inputs[0]);
+
+    pthread_mutex_lock(&run->lock);
+    run->ready++;
+    pthread_cond_broadcast(&run->cond);
+    while (!run->go) {
+        pthread_cond_wait(&run->cond, &run->lock);
+    }
+    pthread_mutex_unlock(&run->lock);
+
+    begin = gettimedouble();
+    for (i = 0; i < run->iters; i++) {
+        bench_threads_op(ctx, run->op, &inputs[i % BENCH_THREADS_INPUTS]);
+    }
+    w->elapsed = gettimedouble() - begin;
+
+    if (own != NULL) {
+        secp256k1_context_destroy(own);
+    }
+    return NULL;
+}
+
+/** Run nthreads workers once. Returns the wall clock time from the start
+ *  signal until the last worker finished, and the ratio of the slowest to the
+ *  fastest worker in *spread. */
+static double bench_threads_once(bench_threads_run *run, bench_threads_worker *workers, int nthreads, double *spread, bench_perf_counter *counters, int ncounters) {
+    double begin, elapsed, lo, hi;
+    int i;
+
+    run->ready = 0;
+    run->go = 0;
+    for (i = 0; i < nthreads; i++) {
+        workers[i].run = run;
+        workers[i].index = i;
+        CHECK(pthread_create(&workers[i].thread, NULL, bench_threads_main, &workers[i]) == 0);
+    }
+    pthread_mutex_lock(&run->lock);
+    while (run->ready < nthreads) {
+        pthread_cond_wait(&run->cond, &run->lock);
+    }
+    bench_perf_enable(counters, ncounters, 1);
+    begin = gettimedouble();
+    run->go = 1;
+    pthread_cond_broadcast(&run->cond);
+    pthread_mutex_unlock(&run->lock);
+    for (i = 0; i < nthreads; i++) {
+        CHECK(pthread_join(workers[i].thread, NULL) == 0);
+    }
+    elapsed = gettimedouble() - begin;
+    bench_perf_enable(counters, ncounters, 0);
+
+    lo = hi = workers[0].elapsed;
+    for (i = 1; i < nthreads; i++) {
+        if (workers[i].elapsed < lo) {
+            lo = workers[i].elapsed;
+        }
+        if (workers[i].elapsed > hi) {
+            hi = workers[i].elapsed;
+        }
+    }
+    *spread = hi / lo;
+    return elapsed;
+}
+
+/** Measure run on nthreads threads count times and report the median
+ *  throughput; base is the single-thread throughput of the same mode, or 0
+ *  when this is the single-thread measurement. Returns the throughput. */
+static double bench_threads_measure(bench_threads_run *run, int nthreads, int count, double base) {
+    bench_threads_worker workers[BENCH_THREADS_MAX];
+    bench_perf_counter counters[BENCH_PERF_EVENTS + 1];
+    double rates[64];
+    double spread = 1.0;
+    double rate, scaling;
+    const char *mode = run->private_ctx ? "private" : "shared";
+    int ncounters;
+    int i;
+
+    ncounters = bench_perf_open(counters);
+    for (i = 0; i < count; i++) {
+        double s;
+        rates[i] = (double)nthreads * run->iters / bench_threads_once(run, workers, nthreads, &s, counters, ncounters);
+        if (s > spread) {
+            spread = s;
+        }
+    }
+    bench_perf_close(counters, ncounters);
+    qsort(rates, count, sizeof(double), bench_cmp_double);
+    rate = bench_percentile(rates, count, 50);
+    scaling = base > 0.0 ? rate / base : 1.0;
+
+    if (bench_opts.json) {
+        printf("{\"name\": \"%s\", \"context\": \"%s\", \"threads\": %d, \"count\": %d, \"iterations\": %d, "
+               "\"ops_per_sec\": %.1f, \"speedup\": %.3f, \"efficiency\": %.3f, \"spread\": %.3f",
+               bench_op_name[run->op], mode, nthreads, count, run->iters,
+               rate, scaling, scaling / nthreads, spread);
+        for (i = 0; i < ncounters; i++) {
+            if (counters[i].fd >= 0) {
+                printf(", \"%s\": %.2f", counters[i].event->name, (double)counters[i].total / ((double)count * nthreads * run->iters));
+            } else {
+                printf(", \"%s\": null", counters[i].event->name);
+            }
+        }
+        printf("}\n");
+    } else {
+        printf("%s %s %d threads: %.0f ops/s, speedup %.2f, efficiency %.1f%%, spread %.2f\n",
+               bench_op_name[run->op], mode, nthreads, rate, scaling, 100.0 * scaling / nthreads, spread);
+        for (i = 0; i < ncounters; i++) {
+            printf("%s %s %d threads: %s ", bench_op_name[run->op], mode, nthreads, counters[i].event->name);
+            if (counters[i].fd >= 0) {
+                print_number((double)counters[i].total / ((double)count * nthreads * run->iters));
+                printf(" / operation\n");
+            } else {
+                printf("unavailable\n");
+            }
+        }
+    }
+    fflush(stdout);
+    return rate;
+}
+
+static void bench_threads_inputs(const secp256k1_context *ctx, bench_threads_input *inputs, int n) {
+    int i, j;
+    for (i = 0; i < n; i++) {
+        bench_threads_input *in = &inputs[i];
+        /* The leading counter keeps keys distinct and well below the order. */
+        in->seckey[0] = 0;
+        in->seckey[1] = (i + 1) >> 16;
+        in->seckey[2] = (i + 1) >> 8;
+        in->seckey[3] = (i + 1);
+        for (j = 4; j < 32; j++) {
+            in->seckey[j] = 33 + j + 7 * i;
+        }
+        for (j = 0; j < 32; j++) {
+            in->msg[j] = 1 + j + 11 * i;
+        }
+        CHECK(secp256k1_ec_pubkey_create(ctx, &in->pubkey, in->seckey) == 1);
+        CHECK(secp256k1_ecdsa_sign(ctx, &in->sig, in->msg, in->seckey, NULL, NULL) == 1);
+#ifdef ENABLE_MODULE_RECOVERY
+        CHECK(secp256k1_ecdsa_sign_recoverable(ctx, &in->rsig, in->msg, in->seckey, NULL, NULL) == 1);
+#endif
+    }
+}
+
+static void usage(const char *argv0) {
+    int i;
+    fprintf(stderr, "Usage: %s [options] [threads=N] [iters=N] [shared] [private] [hugepages]", argv0);
+    for (i = 0; i < BENCH_OPS; i++) {
+        fprintf(stderr, " [%s]", bench_op_arg[i]);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char **argv) {
+    bench_threads_run run;
+    bench_threads_input *inputs;
+    secp256k1_context *ctx;
+    int ops[BENCH_OPS] = {0};
+    int any_op = 0;
+    int modes[2] = {0, 0};
+    int max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int iters = 2000;
+    int count;
+    int i, op, mode;
+
+    argc = bench_init(argc, argv);
+    run.flags = SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY;
+    for (i = 1; i < argc; i++) {
+        int matched = 0;
+        for (op = 0; op < BENCH_OPS; op++) {
+            if (strcmp(argv[i], bench_op_arg[op]) == 0) {
+                ops[op] = 1;
+                any_op = 1;
+                matched = 1;
+            }
+        }
+        if (matched) {
+            continue;
+        } else if (strncmp(argv[i], "threads=", 8) == 0 && atoi(argv[i] + 8) > 0) {
+            max_threads = atoi(argv[i] + 8);
+        } else if (strncmp(argv[i], "iters=", 6) == 0 && atoi(argv[i] + 6) > 0) {
+            iters = atoi(argv[i] + 6);
+        } else if (strcmp(argv[i], "shared") == 0) {
+            modes[0] = 1;
+        } else if (strcmp(argv[i], "private") == 0) {
+            modes[1] = 1;
+        } else if (strcmp(argv[i], "hugepages") == 0) {
+            run.flags |= SECP256K1_CONTEXT_HUGEPAGES;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (bench_opts.cpu >= 0) {
+        /* Pinning the process would put every worker on the same CPU. */
+        fprintf(stderr, "--cpu is not supported by %s\n", argv[0]);
+        return 1;
+    }
+    if (!any_op) {
+        for (op = 0; op < BENCH_OPS; op++) {
+            ops[op] = 1;
+        }
+    }
+    if (!modes[0] && !modes[1]) {
+        modes[0] = modes[1] = 1;
+    }
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+    if (max_threads > BENCH_THREADS_MAX) {
+        max_threads = BENCH_THREADS_MAX;
+    }
+    count = bench_opts.count > 0 ? bench_opts.count : 3;
+    if (count > 64) {
+        count = 64;
+    }
+
+    ctx = secp256k1_context_create(run.flags);
+    inputs = (bench_threads_input *)malloc(sizeof(bench_threads_input) * BENCH_THREADS_INPUTS * max_threads);
+    CHECK(inputs != NULL);
+    bench_threads_inputs(ctx, inputs, BENCH_THREADS_INPUTS * max_threads);
+
+    run.ctx = ctx;
+    run.inputs = inputs;
+    run.iters = iters;
+    CHECK(pthread_mutex_init(&run.lock, NULL) == 0);
+    CHECK(pthread_cond_init(&run.cond, NULL) == 0);
+
+    for (op = 0; op < BENCH_OPS; op++) {
+        if (!ops[op]) {
+            continue;
+        }
+        run.op = op;
+        for (mode = 0; mode < 2; mode++) {
+            double base;
+            int nthreads;
+            if (!modes[mode]) {
+                continue;
+            }
+            run.private_ctx = mode;
+            base = bench_threads_measure(&run, 1, count, 0.0);
+            /* Powers of two, then the maximum itself. */
+            for (nthreads = 2; nthreads < max_threads; nthreads *= 2) {
+                bench_threads_measure(&run, nthreads, count, base);
+            }
+            if (max_threads > 1) {
+                bench_threads_measure(&run, max_threads, count, base);
+            }
+        }
+    }
+
+    pthread_cond_destroy(&run.cond);
+    pthread_mutex_destroy(&run.lock);
+    free(inputs);
+    secp256k1_context_destroy(ctx);
+    return 0;
+}
@@ -4,6 +4,10 @@
  * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
  **********************************************************************/
 
+#if defined HAVE_CONFIG_H
+#include "libsecp256k1-config.h"
+#endif
+
 #include <stdio.h>
 #include <string.h>
 
@@ -11,6 +15,12 @@
 #include "util.h"
 #include "bench.h"
 
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #ifdef ENABLE_OPENSSL_TESTS
 #include <openssl/bn.h>
 #include <openssl/ecdsa.h>
@@ -49,6 +59,30 @@ static void benchmark_verify(void* arg) {
     }
 }
 
+/* Each iteration checks two signatures with one secp256k1_ecdsa_verify_x2 call:
+ * the modified one from benchmark_verify and the original. */
+static void benchmark_verify_x2(void* arg) {
+    int i;
+    benchmark_verify_t* data = (benchmark_verify_t*)arg;
+
+    for (i = 0; i < 10000; i++) {
+        secp256k1_pubkey pubkey;
+        secp256k1_ecdsa_signature sig[2];
+        int results[2];
+        CHECK(secp256k1_ecdsa_signature_parse_der(data->ctx, &sig[1], data->sig, data->siglen) == 1);
+        data->sig[data->siglen - 1] ^= (i & 0xFF);
+        data->sig[data->siglen - 2] ^= ((i >> 8) & 0xFF);
+        data->sig[data->siglen - 3] ^= ((i >> 16) & 0xFF);
+        CHECK(secp256k1_ec_pubkey_parse(data->ctx, &pubkey, data->pubkey, data->pubkeylen) == 1);
+        CHECK(secp256k1_ecdsa_signature_parse_der(data->ctx, &sig[0], data->sig, data->siglen) == 1);
+        CHECK(secp256k1_ecdsa_verify_x2(data->ctx, results, &sig[0], data->msg, &pubkey, &sig[1], data->msg, &pubkey) == (i == 0));
+        CHECK(results[0] == (i == 0) && results[1] == 1);
+        data->sig[data->siglen - 1] ^= (i & 0xFF);
+        data->sig[data->siglen - 2] ^= ((i >> 8) & 0xFF);
+        data->sig[data->siglen - 3] ^= ((i >> 16) & 0xFF);
+    }
+}
+
 #ifdef ENABLE_OPENSSL_TESTS
 static void benchmark_verify_openssl(void* arg) {
     int i;
@@ -79,13 +113,76 @@ static void benchmark_verify_openssl(void* arg) {
 }
 #endif
 
-int main(void) {
+#ifdef HAVE_LINUX_PERF_EVENT_H
+/** Size of the buffer the background process keeps streaming through; well
+ *  beyond the last level cache of current server parts. */
+#define THRASH_SIZE (64 << 20)
+
+/* Fork a process that keeps evicting the shared cache levels, as the rest of a
+ * node (mempool, state DB, networking) would while signatures get checked. */
+static pid_t thrash_start(void) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        volatile unsigned char *buf = (volatile unsigned char *)malloc(THRASH_SIZE);
+        size_t i;
+        if (buf == NULL) {
+            _exit(1);
+        }
+        for (;;) {
+            for (i = 0; i < THRASH_SIZE; i += 64) {
+                buf[i]++;
+            }
+        }
+    }
+    return pid;
+}
+
+static void thrash_stop(pid_t pid) {
+    if (pid > 0) {
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+    }
+}
+#endif
+
+int main(int argc, char **argv) {
     int i;
     secp256k1_pubkey pubkey;
     secp256k1_ecdsa_signature sig;
     benchmark_verify_t data;
+    int cachemiss = 0;
+    int thrash = 0;
+    int x2 = 0;
+    unsigned int flags = SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY;
 
-    data.ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    argc = bench_init(argc, argv);
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "cachemiss") == 0) {
+            cachemiss = 1;
+        } else if (strcmp(argv[i], "thrash") == 0) {
+            cachemiss = 1;
+            thrash = 1;
+        } else if (strcmp(argv[i], "hugepages") == 0) {
+            flags |= SECP256K1_CONTEXT_HUGEPAGES;
+        } else if (strcmp(argv[i], "x2") == 0) {
+            x2 = 1;
+        } else {
+            fprintf(stderr, "Usage: %s [options] [cachemiss] [thrash] [hugepages] [x2]\n", argv[0]);
+            return 1;
+        }
+    }
+#ifndef HAVE_LINUX_PERF_EVENT_H
+    if (cachemiss) {
+        fprintf(stderr, "Cache miss reporting requires Linux perf events.\n");
+        return 1;
+    }
+#endif
+    if (cachemiss) {
+        /* Same as --perf=cache. */
+        bench_opts.perf = BENCH_PERF_CACHE;
+    }
+
+    data.ctx = secp256k1_context_create(flags);
 
     for (i = 0; i < 32; i++) {
         data.msg[i] = 1 + i;
@@ -100,7 +197,19 @@ int main(void) {
     data.pubkeylen = 33;
     CHECK(secp256k1_ec_pubkey_serialize(data.ctx, data.pubkey, &data.pubkeylen, &pubkey, SECP256K1_EC_COMPRESSED) == 1);
 
-    run_benchmark("ecdsa_verify", benchmark_verify, NULL, NULL, &data, 10, 20000);
+    if (thrash) {
+#ifdef HAVE_LINUX_PERF_EVENT_H
+        pid_t pid = thrash_start();
+        run_benchmark("ecdsa_verify_thrash", benchmark_verify, NULL, NULL, &data, 10, 20000);
+        thrash_stop(pid);
+#endif
+    } else {
+        run_benchmark("ecdsa_verify", benchmark_verify, NULL, NULL, &data, 10, 20000);
+    }
+    if (x2) {
+        /* Reported per signature, for comparison with the line above. */
+        run_benchmark("ecdsa_verify_x2", benchmark_verify_x2, NULL, NULL, &data, 10, 20000);
+    }
 #ifdef ENABLE_OPENSSL_TESTS
     data.ec_group = EC_GROUP_new_by_curve_name(NID_secp256k1);
     run_benchmark("ecdsa_verify_openssl", benchmark_verify_openssl, NULL, NULL, &data, 10, 20000);
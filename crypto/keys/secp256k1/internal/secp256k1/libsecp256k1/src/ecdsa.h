@@ -16,6 +16,22 @@
 static int secp256k1_ecdsa_sig_parse(secp256k1_scalar *r, secp256k1_scalar *s, const unsigned char *sig, size_t size);
 static int secp256k1_ecdsa_sig_serialize(unsigned char *sig, size_t *size, const secp256k1_scalar *r, const secp256k1_scalar *s);
 static int secp256k1_ecdsa_sig_verify(const secp256k1_ecmult_context *ctx, const secp256k1_scalar* r, const secp256k1_scalar* s, const secp256k1_ge *pubkey, const secp256k1_scalar *message);
+/** Verify two signatures at once. On input results[i] says whether entry i is
+ *  to be checked at all; on output it holds whether it is valid. */
+static void secp256k1_ecdsa_sig_verify_x2(const secp256k1_ecmult_context *ctx, int *results, const secp256k1_scalar *r, const secp256k1_scalar *s, const secp256k1_ge *pubkey, const secp256k1_scalar *message);
 static int secp256k1_ecdsa_sig_sign(const secp256k1_ecmult_gen_context *ctx, secp256k1_scalar* r, secp256k1_scalar* s, const secp256k1_scalar *seckey, const secp256k1_scalar *message, const secp256k1_scalar *nonce, int *recid);
 
+/** Most signatures secp256k1_ecdsa_sig_sign_batch creates at once. */
+#define SECP256K1_ECDSA_SIGN_BATCH 32
+/** Compute, for len <= SECP256K1_ECDSA_SIGN_BATCH nonzero nonces, the r value and recovery id (recid may be NULL)
+ *  each gives a signature, and the inverse of each nonce, sharing one field and one scalar inversion. */
+static void secp256k1_ecdsa_sig_nonce_batch(const secp256k1_ecmult_gen_context *ctx, secp256k1_scalar *r, secp256k1_scalar *noncei, int *recid, const secp256k1_scalar *nonce, size_t len);
+/** Finish a signature from the r value and recovery id of a nonce and the nonce's inverse. Returns 0 if s is zero;
+ *  otherwise s is made low, flipping *recid (if not NULL) when it is negated. */
+static int secp256k1_ecdsa_sig_sign_inv(secp256k1_scalar *s, const secp256k1_scalar *r, const secp256k1_scalar *seckey, const secp256k1_scalar *message, const secp256k1_scalar *noncei, int *recid);
+/** Like secp256k1_ecdsa_sig_sign for len <= SECP256K1_ECDSA_SIGN_BATCH entries, sharing one field inversion
+ *  between the R points and one scalar inversion between the nonces. ok[i] receives what
+ *  secp256k1_ecdsa_sig_sign would have returned for entry i; recid may be NULL. */
+static void secp256k1_ecdsa_sig_sign_batch(const secp256k1_ecmult_gen_context *ctx, int *ok, secp256k1_scalar* r, secp256k1_scalar* s, const secp256k1_scalar *seckey, const secp256k1_scalar *message, const secp256k1_scalar *nonce, int *recid, size_t len);
+
 #endif
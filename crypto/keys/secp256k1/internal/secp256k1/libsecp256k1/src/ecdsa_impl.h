@@ -200,25 +200,29 @@ static int secp256k1_ecdsa_sig_serialize(unsigned char *sig, size_t *size, const
     return 1;
 }
 
-static int secp256k1_ecdsa_sig_verify(const secp256k1_ecmult_context *ctx, const secp256k1_scalar *sigr, const secp256k1_scalar *sigs, const secp256k1_ge *pubkey, const secp256k1_scalar *message) {
-    unsigned char c[32];
-    secp256k1_scalar sn, u1, u2;
-#if !defined(EXHAUSTIVE_TEST_ORDER)
-    secp256k1_fe xr;
-#endif
-    secp256k1_gej pubkeyj;
-    secp256k1_gej pr;
+/** Compute the scalars u1 = message/s and u2 = r/s of the verification
+ *  equation. Returns 0 if r or s is zero. */
+static int secp256k1_ecdsa_sig_verify_scalars(secp256k1_scalar *u1, secp256k1_scalar *u2, const secp256k1_scalar *sigr, const secp256k1_scalar *sigs, const secp256k1_scalar *message) {
+    secp256k1_scalar sn;
 
     if (secp256k1_scalar_is_zero(sigr) || secp256k1_scalar_is_zero(sigs)) {
         return 0;
     }
 
     secp256k1_scalar_inverse_var(&sn, sigs);
-    secp256k1_scalar_mul(&u1, &sn, message);
-    secp256k1_scalar_mul(&u2, &sn, sigr);
-    secp256k1_gej_set_ge(&pubkeyj, pubkey);
-    secp256k1_ecmult(ctx, &pr, &pubkeyj, &u2, &u1);
-    if (secp256k1_gej_is_infinity(&pr)) {
+    secp256k1_scalar_mul(u1, &sn, message);
+    secp256k1_scalar_mul(u2, &sn, sigr);
+    return 1;
+}
+
+/** Check that the recomputed R point pr matches r. */
+static int secp256k1_ecdsa_sig_check_r(const secp256k1_scalar *sigr, const secp256k1_gej *pr) {
+    unsigned char c[32];
+#if !defined(EXHAUSTIVE_TEST_ORDER)
+    secp256k1_fe xr;
+#endif
+
+    if (secp256k1_gej_is_infinity(pr)) {
         return 0;
     }
 
@@ -226,7 +230,8 @@ static int secp256k1_ecdsa_sig_verify(const secp256k1_ecmult_context *ctx, const
 {
     secp256k1_scalar computed_r;
     secp256k1_ge pr_ge;
-    secp256k1_ge_set_gej(&pr_ge, &pr);
+    secp256k1_gej prj = *pr;
+    secp256k1_ge_set_gej(&pr_ge, &prj);
     secp256k1_fe_normalize(&pr_ge.x);
 
     secp256k1_fe_get_b32(c, &pr_ge.x);
@@ -253,7 +258,7 @@ static int secp256k1_ecdsa_sig_verify(const secp256k1_ecmult_context *ctx, const
      *  Thus, we can avoid the inversion, but we have to check both cases separately.
      *  secp256k1_gej_eq_x implements the (xr * pr.z^2 mod p == pr.x) test.
      */
-    if (secp256k1_gej_eq_x_var(&xr, &pr)) {
+    if (secp256k1_gej_eq_x_var(&xr, pr)) {
         /* xr * pr.z^2 mod p == pr.x, so the signature is valid. */
         return 1;
     }
@@ -262,7 +267,7 @@ static int secp256k1_ecdsa_sig_verify(const secp256k1_ecmult_context *ctx, const
         return 0;
     }
     secp256k1_fe_add(&xr, &secp256k1_ecdsa_const_order_as_fe);
-    if (secp256k1_gej_eq_x_var(&xr, &pr)) {
+    if (secp256k1_gej_eq_x_var(&xr, pr)) {
         /* (xr + n) * pr.z^2 mod p == pr.x, so the signature is valid. */
         return 1;
     }
@@ -270,6 +275,45 @@ static int secp256k1_ecdsa_sig_verify(const secp256k1_ecmult_context *ctx, const
 #endif
 }
 
+static int secp256k1_ecdsa_sig_verify(const secp256k1_ecmult_context *ctx, const secp256k1_scalar *sigr, const secp256k1_scalar *sigs, const secp256k1_ge *pubkey, const secp256k1_scalar *message) {
+    secp256k1_scalar u1, u2;
+    secp256k1_gej pubkeyj;
+    secp256k1_gej pr;
+
+    if (!secp256k1_ecdsa_sig_verify_scalars(&u1, &u2, sigr, sigs, message)) {
+        return 0;
+    }
+    secp256k1_gej_set_ge(&pubkeyj, pubkey);
+    secp256k1_ecmult(ctx, &pr, &pubkeyj, &u2, &u1);
+    return secp256k1_ecdsa_sig_check_r(sigr, &pr);
+}
+
+static void secp256k1_ecdsa_sig_verify_x2(const secp256k1_ecmult_context *ctx, int *results, const secp256k1_scalar *sigr, const secp256k1_scalar *sigs, const secp256k1_ge *pubkey, const secp256k1_scalar *message) {
+    secp256k1_scalar u1[2], u2[2];
+    secp256k1_gej pubkeyj[2];
+    secp256k1_gej pr[2];
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        results[i] = results[i] && secp256k1_ecdsa_sig_verify_scalars(&u1[i], &u2[i], &sigr[i], &sigs[i], &message[i]);
+        if (results[i]) {
+            secp256k1_gej_set_ge(&pubkeyj[i], &pubkey[i]);
+        }
+    }
+    if (results[0] && results[1]) {
+        secp256k1_ecmult_x2(ctx, &pr[0], &pubkeyj[0], &u2[0], &u1[0], &pr[1], &pubkeyj[1], &u2[1], &u1[1]);
+    } else {
+        for (i = 0; i < 2; i++) {
+            if (results[i]) {
+                secp256k1_ecmult(ctx, &pr[i], &pubkeyj[i], &u2[i], &u1[i]);
+            }
+        }
+    }
+    for (i = 0; i < 2; i++) {
+        results[i] = results[i] && secp256k1_ecdsa_sig_check_r(&sigr[i], &pr[i]);
+    }
+}
+
 static int secp256k1_ecdsa_sig_sign(const secp256k1_ecmult_gen_context *ctx, secp256k1_scalar *sigr, secp256k1_scalar *sigs, const secp256k1_scalar *seckey, const secp256k1_scalar *message, const secp256k1_scalar *nonce, int *recid) {
     unsigned char b[32];
     secp256k1_gej rp;
@@ -312,4 +356,77 @@ static int secp256k1_ecdsa_sig_sign(const secp256k1_ecmult_gen_context *ctx, sec
     return 1;
 }
 
+static void secp256k1_ecdsa_sig_nonce_batch(const secp256k1_ecmult_gen_context *ctx, secp256k1_scalar *sigr, secp256k1_scalar *noncei, int *recid, const secp256k1_scalar *nonce, size_t len) {
+    unsigned char b[32];
+    secp256k1_gej rp[SECP256K1_ECDSA_SIGN_BATCH];
+    secp256k1_fe z[SECP256K1_ECDSA_SIGN_BATCH];
+    secp256k1_fe zi[SECP256K1_ECDSA_SIGN_BATCH];
+    secp256k1_ge r;
+    size_t i;
+    int overflow;
+
+    VERIFY_CHECK(len <= SECP256K1_ECDSA_SIGN_BATCH);
+    if (len == 0) {
+        return;
+    }
+    i = 0;
+    do {
+        secp256k1_ecmult_gen(ctx, &rp[i], &nonce[i]);
+        z[i] = rp[i].z;
+    } while (++i < len);
+    /* The nonces are nonzero, so no R is infinity and no z is zero. */
+    secp256k1_fe_inv_all(zi, z, len);
+    secp256k1_scalar_inverse_all(noncei, nonce, len);
+
+    for (i = 0; i < len; i++) {
+        secp256k1_ge_set_gej_zinv(&r, &rp[i], &zi[i]);
+        secp256k1_fe_normalize(&r.x);
+        secp256k1_fe_normalize(&r.y);
+        secp256k1_fe_get_b32(b, &r.x);
+        overflow = 0;
+        secp256k1_scalar_set_b32(&sigr[i], b, &overflow);
+        /* These two conditions should be checked before calling */
+        VERIFY_CHECK(!secp256k1_scalar_is_zero(&sigr[i]));
+        VERIFY_CHECK(overflow == 0);
+
+        if (recid) {
+            /* See secp256k1_ecdsa_sig_sign for the overflow condition. */
+            recid[i] = (overflow ? 2 : 0) | (secp256k1_fe_is_odd(&r.y) ? 1 : 0);
+        }
+    }
+    secp256k1_ge_clear(&r);
+    memset(rp, 0, sizeof(rp));
+    memset(z, 0, sizeof(z));
+    memset(zi, 0, sizeof(zi));
+}
+
+static int secp256k1_ecdsa_sig_sign_inv(secp256k1_scalar *sigs, const secp256k1_scalar *sigr, const secp256k1_scalar *seckey, const secp256k1_scalar *message, const secp256k1_scalar *noncei, int *recid) {
+    secp256k1_scalar n;
+    secp256k1_scalar_mul(&n, sigr, seckey);
+    secp256k1_scalar_add(&n, &n, message);
+    secp256k1_scalar_mul(sigs, noncei, &n);
+    secp256k1_scalar_clear(&n);
+    if (secp256k1_scalar_is_zero(sigs)) {
+        return 0;
+    }
+    if (secp256k1_scalar_is_high(sigs)) {
+        secp256k1_scalar_negate(sigs, sigs);
+        if (recid) {
+            *recid ^= 1;
+        }
+    }
+    return 1;
+}
+
+static void secp256k1_ecdsa_sig_sign_batch(const secp256k1_ecmult_gen_context *ctx, int *ok, secp256k1_scalar *sigr, secp256k1_scalar *sigs, const secp256k1_scalar *seckey, const secp256k1_scalar *message, const secp256k1_scalar *nonce, int *recid, size_t len) {
+    secp256k1_scalar ni[SECP256K1_ECDSA_SIGN_BATCH];
+    size_t i;
+
+    secp256k1_ecdsa_sig_nonce_batch(ctx, sigr, ni, recid, nonce, len);
+    for (i = 0; i < len; i++) {
+        ok[i] = secp256k1_ecdsa_sig_sign_inv(&sigs[i], &sigr[i], &seckey[i], &message[i], &ni[i], recid ? &recid[i] : NULL);
+    }
+    memset(ni, 0, sizeof(ni));
+}
+
 #endif
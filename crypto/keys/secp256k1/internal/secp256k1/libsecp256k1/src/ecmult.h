@@ -10,16 +10,23 @@
 #include "num.h"
 #include "group.h"
 
+/** A non-zero digit of a number in WNAF notation, and its position. */
+typedef struct {
+    int pos;
+    int digit;
+} secp256k1_wnaf_entry;
+
 typedef struct {
     /* For accelerating the computation of a*P + b*G: */
     secp256k1_ge_storage (*pre_g)[];    /* odd multiples of the generator */
 #ifdef USE_ENDOMORPHISM
-    secp256k1_ge_storage (*pre_g_128)[]; /* odd multiples of 2^128*generator */
+    secp256k1_ge_storage (*pre_g_128)[]; /* odd multiples of 2^128*generator, allocated together with pre_g */
 #endif
+    int hugepages; /* whether the tables were requested on hugepages */
 } secp256k1_ecmult_context;
 
 static void secp256k1_ecmult_context_init(secp256k1_ecmult_context *ctx);
-static void secp256k1_ecmult_context_build(secp256k1_ecmult_context *ctx, const secp256k1_callback *cb);
+static void secp256k1_ecmult_context_build(secp256k1_ecmult_context *ctx, int hugepages, const secp256k1_callback *cb);
 static void secp256k1_ecmult_context_clone(secp256k1_ecmult_context *dst,
                                            const secp256k1_ecmult_context *src, const secp256k1_callback *cb);
 static void secp256k1_ecmult_context_clear(secp256k1_ecmult_context *ctx);
@@ -28,4 +35,15 @@ static int secp256k1_ecmult_context_is_built(const secp256k1_ecmult_context *ctx
 /** Double multiply: R = na*A + ng*G */
 static void secp256k1_ecmult(const secp256k1_ecmult_context *ctx, secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng);
 
+/** Two independent double multiplies, R1 = na1*A1 + ng1*G and R2 = na2*A2 + ng2*G,
+ *  advanced in lockstep so the field operations of one can overlap with those
+ *  of the other. */
+static void secp256k1_ecmult_x2(const secp256k1_ecmult_context *ctx, secp256k1_gej *r1, const secp256k1_gej *a1, const secp256k1_scalar *na1, const secp256k1_scalar *ng1, secp256k1_gej *r2, const secp256k1_gej *a2, const secp256k1_scalar *na2, const secp256k1_scalar *ng2);
+
+/** Multi-multiply: R = sum(na[i]*A[i], i=0..n-1) + ng*G, in variable time.
+ *  All terms share one run of doublings, and the tables of all A[i] are made
+ *  affine with a single inversion, and scalars below 2^128 take half the
+ *  additions of others. Needs about 2 KiB of heap per point. */
+static void secp256k1_ecmult_multi_var(const secp256k1_ecmult_context *ctx, secp256k1_gej *r, const secp256k1_ge *a, const secp256k1_scalar *na, size_t n, const secp256k1_scalar *ng, const secp256k1_callback *cb);
+
 #endif
@@ -12,4 +12,20 @@
 
 static void secp256k1_ecmult_const(secp256k1_gej *r, const secp256k1_ge *a, const secp256k1_scalar *q);
 
+/** Set r to the X coordinate of q*P, for a point P with X coordinate x and a
+ *  nonzero q, without ever computing the Y coordinate of P. Unless
+ *  known_on_curve is set, first check (in variable time) that x is on the
+ *  curve, and return 0 if not. Constant time in q. */
+static int secp256k1_ecmult_const_xonly(secp256k1_fe *r, const secp256k1_fe *x, const secp256k1_scalar *q, int known_on_curve);
+
+/** Fill the 64 rows of 16 entries of prec for multiplying a with
+ *  secp256k1_ecmult_const_precomp: entry 16*j + i holds i*16^j*a plus an
+ *  offset, and the offsets of all rows add up to zero. Variable time in a.
+ *  Returns 0 if out of memory. */
+static int secp256k1_ecmult_const_precomp_build(secp256k1_ge_storage *prec, const secp256k1_ge *a, const secp256k1_callback *cb);
+
+/** Set r to q*a, given the table secp256k1_ecmult_const_precomp_build made for a.
+ *  Like secp256k1_ecmult_gen, this is one addition per 4 bits of q. Constant time in q. */
+static void secp256k1_ecmult_const_precomp(secp256k1_gej *r, const secp256k1_ge_storage *prec, const secp256k1_scalar *q);
+
 #endif
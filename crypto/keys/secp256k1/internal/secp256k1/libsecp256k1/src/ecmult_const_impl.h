@@ -9,6 +9,7 @@
 
 #include "scalar.h"
 #include "group.h"
+#include "hash.h"
 #include "ecmult_const.h"
 #include "ecmult_impl.h"
 
@@ -19,24 +20,19 @@
 #endif
 #define WNAF_SIZE(w) ((WNAF_BITS + (w) - 1) / (w))
 
-/* This is like `ECMULT_TABLE_GET_GE` but is constant time */
+/* This is like `ECMULT_TABLE_GET_GE` but is constant time. The table holds
+ * storage entries so that it can be scanned whole, see the comment in
+ * ecmult_gen_impl.h for why no secret data may be used in array indices. */
 #define ECMULT_CONST_TABLE_GET_GE(r,pre,n,w) do { \
-    int m; \
+    secp256k1_ge_storage tmps; \
     int abs_n = (n) * (((n) > 0) * 2 - 1); \
     int idx_n = abs_n / 2; \
     secp256k1_fe neg_y; \
     VERIFY_CHECK(((n) & 1) == 1); \
     VERIFY_CHECK((n) >= -((1 << ((w)-1)) - 1)); \
     VERIFY_CHECK((n) <=  ((1 << ((w)-1)) - 1)); \
-    VERIFY_SETUP(secp256k1_fe_clear(&(r)->x)); \
-    VERIFY_SETUP(secp256k1_fe_clear(&(r)->y)); \
-    for (m = 0; m < ECMULT_TABLE_SIZE(w); m++) { \
-        /* This loop is used to avoid secret data in array indices. See
-         * the comment in ecmult_gen_impl.h for rationale. */ \
-        secp256k1_fe_cmov(&(r)->x, &(pre)[m].x, m == idx_n); \
-        secp256k1_fe_cmov(&(r)->y, &(pre)[m].y, m == idx_n); \
-    } \
-    (r)->infinity = 0; \
+    secp256k1_ge_storage_table_get(&tmps, (pre), ECMULT_TABLE_SIZE(w), idx_n); \
+    secp256k1_ge_from_storage((r), &tmps); \
     secp256k1_fe_negate(&neg_y, &(r)->y, 1); \
     secp256k1_fe_cmov(&(r)->y, &neg_y, (n) != abs_n); \
 } while(0)
@@ -119,32 +115,50 @@ static int secp256k1_wnaf_const(int *wnaf, secp256k1_scalar s, int w) {
 }
 
 
-static void secp256k1_ecmult_const(secp256k1_gej *r, const secp256k1_ge *a, const secp256k1_scalar *scalar) {
-    secp256k1_ge pre_a[ECMULT_TABLE_SIZE(WINDOW_A)];
-    secp256k1_ge tmpa;
-    secp256k1_fe Z;
-
-    int skew_1;
+/** A scalar recoded for constant-time multiplication: its wNAF digits and
+ *  skew, or with the endomorphism those of both halves of its split. */
+typedef struct {
     int wnaf_1[1 + WNAF_SIZE(WINDOW_A - 1)];
+    int skew_1;
 #ifdef USE_ENDOMORPHISM
-    secp256k1_ge pre_a_lam[ECMULT_TABLE_SIZE(WINDOW_A)];
     int wnaf_lam[1 + WNAF_SIZE(WINDOW_A - 1)];
     int skew_lam;
-    secp256k1_scalar q_1, q_lam;
 #endif
+} secp256k1_ecmult_const_recoding;
 
-    int i;
-    secp256k1_scalar sc = *scalar;
-
-    /* build wnaf representation for q. */
+static void secp256k1_ecmult_const_recode(secp256k1_ecmult_const_recoding *rec, const secp256k1_scalar *scalar) {
 #ifdef USE_ENDOMORPHISM
+    secp256k1_scalar q_1, q_lam;
+
     /* split q into q_1 and q_lam (where q = q_1 + q_lam*lambda, and q_1 and q_lam are ~128 bit) */
-    secp256k1_scalar_split_lambda(&q_1, &q_lam, &sc);
-    skew_1   = secp256k1_wnaf_const(wnaf_1,   q_1,   WINDOW_A - 1);
-    skew_lam = secp256k1_wnaf_const(wnaf_lam, q_lam, WINDOW_A - 1);
+    secp256k1_scalar_split_lambda(&q_1, &q_lam, scalar);
+    rec->skew_1   = secp256k1_wnaf_const(rec->wnaf_1,   q_1,   WINDOW_A - 1);
+    rec->skew_lam = secp256k1_wnaf_const(rec->wnaf_lam, q_lam, WINDOW_A - 1);
 #else
-    skew_1   = secp256k1_wnaf_const(wnaf_1, sc, WINDOW_A - 1);
+    rec->skew_1   = secp256k1_wnaf_const(rec->wnaf_1, *scalar, WINDOW_A - 1);
 #endif
+}
+
+/** Multiply a by the scalar that rec was recoded from. Recoding a scalar once
+ *  and calling this for each point saves the recoding when many points are
+ *  multiplied by the same scalar. */
+static void secp256k1_ecmult_const_recoded(secp256k1_gej *r, const secp256k1_ge *a, const secp256k1_ecmult_const_recoding *rec) {
+    secp256k1_ge_storage pre_a[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_ge pre_a_ge[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_ge tmpa;
+    secp256k1_fe Z;
+
+    const int *wnaf_1 = rec->wnaf_1;
+    int skew_1 = rec->skew_1;
+#ifdef USE_ENDOMORPHISM
+    secp256k1_ge_storage pre_a_lam[ECMULT_TABLE_SIZE(WINDOW_A)];
+    const int *wnaf_lam = rec->wnaf_lam;
+    int skew_lam = rec->skew_lam;
+#endif
+
+    int i;
+
+    SECP256K1_STATS_INC(ecmult_const);
 
     /* Calculate odd multiples of a.
      * All multiples are brought to the same Z 'denominator', which is stored
@@ -153,13 +167,14 @@ static void secp256k1_ecmult_const(secp256k1_gej *r, const secp256k1_ge *a, cons
      * the Z coordinate of the result once at the end.
      */
     secp256k1_gej_set_ge(r, a);
-    secp256k1_ecmult_odd_multiples_table_globalz_windowa(pre_a, &Z, r);
+    secp256k1_ecmult_odd_multiples_table_globalz_windowa(pre_a_ge, &Z, r);
     for (i = 0; i < ECMULT_TABLE_SIZE(WINDOW_A); i++) {
-        secp256k1_fe_normalize_weak(&pre_a[i].y);
+        secp256k1_ge_to_storage(&pre_a[i], &pre_a_ge[i]);
     }
 #ifdef USE_ENDOMORPHISM
     for (i = 0; i < ECMULT_TABLE_SIZE(WINDOW_A); i++) {
-        secp256k1_ge_mul_lambda(&pre_a_lam[i], &pre_a[i]);
+        secp256k1_ge_mul_lambda(&tmpa, &pre_a_ge[i]);
+        secp256k1_ge_to_storage(&pre_a_lam[i], &tmpa);
     }
 #endif
 
@@ -199,41 +214,158 @@ static void secp256k1_ecmult_const(secp256k1_gej *r, const secp256k1_ge *a, cons
     secp256k1_fe_mul(&r->z, &r->z, &Z);
 
     {
-        /* Correct for wNAF skew */
-        secp256k1_ge correction = *a;
-        secp256k1_ge_storage correction_1_stor;
-#ifdef USE_ENDOMORPHISM
-        secp256k1_ge_storage correction_lam_stor;
-#endif
-        secp256k1_ge_storage a2_stor;
+        /* Correct for wNAF skew: subtract a once, and once more for odd
+         * numbers. Both subtractions are always done so this stays
+         * constant-time, and unlike adding a precomputed -2a it needs no
+         * inversion. gej_add_ge handles the sums that hit infinity. */
+        secp256k1_ge correction;
         secp256k1_gej tmpj;
-        secp256k1_gej_set_ge(&tmpj, &correction);
-        secp256k1_gej_double_var(&tmpj, &tmpj, NULL);
-        secp256k1_ge_set_gej(&correction, &tmpj);
-        secp256k1_ge_to_storage(&correction_1_stor, a);
-#ifdef USE_ENDOMORPHISM
-        secp256k1_ge_to_storage(&correction_lam_stor, a);
-#endif
-        secp256k1_ge_to_storage(&a2_stor, &correction);
-
-        /* For odd numbers this is 2a (so replace it), for even ones a (so no-op) */
-        secp256k1_ge_storage_cmov(&correction_1_stor, &a2_stor, skew_1 == 2);
-#ifdef USE_ENDOMORPHISM
-        secp256k1_ge_storage_cmov(&correction_lam_stor, &a2_stor, skew_lam == 2);
-#endif
 
-        /* Apply the correction */
-        secp256k1_ge_from_storage(&correction, &correction_1_stor);
-        secp256k1_ge_neg(&correction, &correction);
+        secp256k1_ge_neg(&correction, a);
         secp256k1_gej_add_ge(r, r, &correction);
+        secp256k1_gej_add_ge(&tmpj, r, &correction);
+        secp256k1_gej_cmov(r, &tmpj, skew_1 == 2);
 
 #ifdef USE_ENDOMORPHISM
-        secp256k1_ge_from_storage(&correction, &correction_lam_stor);
-        secp256k1_ge_neg(&correction, &correction);
         secp256k1_ge_mul_lambda(&correction, &correction);
         secp256k1_gej_add_ge(r, r, &correction);
+        secp256k1_gej_add_ge(&tmpj, r, &correction);
+        secp256k1_gej_cmov(r, &tmpj, skew_lam == 2);
 #endif
     }
 }
 
+static void secp256k1_ecmult_const(secp256k1_gej *r, const secp256k1_ge *a, const secp256k1_scalar *scalar) {
+    secp256k1_ecmult_const_recoding rec;
+    secp256k1_ecmult_const_recode(&rec, scalar);
+    secp256k1_ecmult_const_recoded(r, a, &rec);
+}
+
+static int secp256k1_ecmult_const_xonly(secp256k1_fe *r, const secp256k1_fe *x, const secp256k1_scalar *q, int known_on_curve) {
+    secp256k1_fe g, c;
+    secp256k1_ge p;
+    secp256k1_gej rj;
+
+    /* With g = x^3 + 7 = y^2, the Jacobian point (x*g, g^2, y) is P. The
+     * group law does not involve the constant 7, so, as with the tables of
+     * ecmult_const, the multiplication can pretend Z is 1 and scale Z by y at
+     * the end: run it on the affine point (x*g, g^2), which lies on the
+     * isomorphic curve Y^2 = X^3 + 7*g^3, and divide the X coordinate of the
+     * result by (Z*y)^2 = Z^2*g. That needs neither y nor a square root. */
+    secp256k1_fe_sqr(&g, x);
+    secp256k1_fe_mul(&g, &g, x);
+    secp256k1_fe_set_int(&c, CURVE_B);
+    secp256k1_fe_add(&g, &c);
+    if (!known_on_curve && !secp256k1_fe_is_quad_var(&g)) {
+        /* P would lie on the twist, where the multiplication would leak
+         * the scalar modulo its small factors. */
+        return 0;
+    }
+    secp256k1_fe_mul(&p.x, &g, x);
+    secp256k1_fe_sqr(&p.y, &g);
+    p.infinity = 0;
+
+    VERIFY_CHECK(!secp256k1_scalar_is_zero(q));
+    secp256k1_ecmult_const(&rj, &p, q);
+
+    /* One inversion, which like the multiplication is constant time. */
+    secp256k1_fe_sqr(&c, &rj.z);
+    secp256k1_fe_mul(&c, &c, &g);
+    secp256k1_fe_inv(&c, &c);
+    secp256k1_fe_mul(r, &rj.x, &c);
+    secp256k1_fe_normalize(r);
+    return 1;
+}
+
+static int secp256k1_ecmult_const_precomp_build(secp256k1_ge_storage *prec, const secp256k1_ge *a, const secp256k1_callback *cb) {
+    secp256k1_ge *precg;
+    secp256k1_gej *precj;
+    secp256k1_gej abase, offbase, offj;
+    secp256k1_ge offset;
+    int i, j;
+    VERIFY_CHECK(!a->infinity);
+
+    precg = (secp256k1_ge*)checked_malloc(cb, sizeof(secp256k1_ge) * 1024);
+    precj = (secp256k1_gej*)checked_malloc(cb, sizeof(secp256k1_gej) * 1024);
+    if (precg == NULL || precj == NULL) {
+        free(precg);
+        free(precj);
+        return 0;
+    }
+
+    /* Like the nums point of ecmult_gen, the offset must have no known
+     * discrete logarithm with respect to a, or some entry could be infinity.
+     * Hash a to a point to get one. */
+    {
+        static const unsigned char tag[] = "secp256k1 ecmult_const precomp offset";
+        unsigned char buf[64];
+        unsigned char cnt = 0;
+        secp256k1_ge an = *a;
+        secp256k1_fe x;
+        secp256k1_fe_normalize_var(&an.x);
+        secp256k1_fe_normalize_var(&an.y);
+        secp256k1_fe_get_b32(buf, &an.x);
+        secp256k1_fe_get_b32(buf + 32, &an.y);
+        for (;;) {
+            unsigned char h[32];
+            secp256k1_sha256_t sha;
+            secp256k1_sha256_initialize(&sha);
+            secp256k1_sha256_write(&sha, tag, sizeof(tag) - 1);
+            secp256k1_sha256_write(&sha, buf, sizeof(buf));
+            secp256k1_sha256_write(&sha, &cnt, 1);
+            secp256k1_sha256_finalize(&sha, h);
+            cnt++;
+            if (secp256k1_fe_set_b32(&x, h) && secp256k1_ge_set_xo_var(&offset, &x, 0)) {
+                break;
+            }
+        }
+    }
+
+    secp256k1_gej_set_ge(&abase, a); /* 16^j * a */
+    secp256k1_gej_set_ge(&offbase, &offset); /* 2^j * offset */
+    for (j = 0; j < 64; j++) {
+        /* Set precj[j*16 .. j*16+15] to (offbase, offbase + abase, ..., offbase + 15*abase). */
+        precj[j*16] = offbase;
+        for (i = 1; i < 16; i++) {
+            secp256k1_gej_add_var(&precj[j*16 + i], &precj[j*16 + i - 1], &abase, NULL);
+        }
+        for (i = 0; i < 4; i++) {
+            secp256k1_gej_double_var(&abase, &abase, NULL);
+        }
+        secp256k1_gej_double_var(&offbase, &offbase, NULL);
+        if (j == 62) {
+            /* In the last row the offset is (1 - 2^63) * offset, so they all add up to zero. */
+            secp256k1_gej_set_ge(&offj, &offset);
+            secp256k1_gej_neg(&offbase, &offbase);
+            secp256k1_gej_add_var(&offbase, &offbase, &offj, NULL);
+        }
+    }
+    secp256k1_ge_set_all_gej_var(precg, precj, 1024, cb);
+    for (i = 0; i < 1024; i++) {
+        secp256k1_ge_to_storage(&prec[i], &precg[i]);
+    }
+    free(precg);
+    free(precj);
+    return 1;
+}
+
+static void secp256k1_ecmult_const_precomp(secp256k1_gej *r, const secp256k1_ge_storage *prec, const secp256k1_scalar *q) {
+    secp256k1_ge add;
+    secp256k1_ge_storage adds;
+    int bits;
+    int j;
+    SECP256K1_STATS_INC(ecmult_const);
+    secp256k1_gej_set_infinity(r);
+    for (j = 0; j < 64; j++) {
+        bits = secp256k1_scalar_get_bits(q, j * 4, 4);
+        /* Read the whole row; see ecmult_gen_impl.h. */
+        secp256k1_ge_storage_table_get(&adds, &prec[j * 16], 16, bits);
+        secp256k1_ge_from_storage(&add, &adds);
+        secp256k1_gej_add_ge(r, r, &add);
+    }
+    bits = 0;
+    secp256k1_ge_clear(&add);
+    memset(&adds, 0, sizeof(adds));
+}
+
 #endif
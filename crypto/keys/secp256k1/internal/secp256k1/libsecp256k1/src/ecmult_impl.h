@@ -44,44 +44,55 @@
 /** The number of entries a table with precomputed multiples needs to have. */
 #define ECMULT_TABLE_SIZE(w) (1 << ((w)-2))
 
+/** The maximum number of entries in a compact wnaf of len bits: each non-zero
+ *  digit is followed by at least w-1 zero ones. */
+#define ECMULT_WNAF_COMPACT_SIZE(len, w) (((len) + (w) - 1) / (w))
+
+/** How many bit positions ahead of their use the lookups into the precomputed
+ *  G tables are prefetched. Each position costs at least one doubling, so this
+ *  comfortably covers a trip to DRAM for the 1.375 MiB of G tables. */
+#define ECMULT_PREFETCH_DISTANCE 8
+
 /** Fill a table 'prej' with precomputed odd multiples of a. Prej will contain
  *  the values [1*a,3*a,...,(2*n-1)*a], so it space for n values. zr[0] will
  *  contain prej[0].z / a.z. The other zr[i] values = prej[i].z / prej[i-1].z.
  *  Prej's Z values are undefined, except for the last value.
  */
 static void secp256k1_ecmult_odd_multiples_table(int n, secp256k1_gej *prej, secp256k1_fe *zr, const secp256k1_gej *a) {
-    secp256k1_gej d;
-    secp256k1_ge a_ge, d_ge;
+    secp256k1_ge a_ge, d_ge, p_ge;
+    secp256k1_fe z;
     int i;
 
     VERIFY_CHECK(!a->infinity);
 
-    secp256k1_gej_double_var(&d, a, NULL);
-
     /*
-     * Perform the additions on an isomorphism where 'd' is affine: drop the z coordinate
-     * of 'd', and scale the 1P starting value's x/y coordinates without changing its z.
+     * Work on the isomorphism where a is affine: take its x and y as they are,
+     * and fold a's z back in at the end. Every multiple and the running 2*a are
+     * kept on a common Z with co-Z formulas, so no step computes a Z coordinate
+     * and the additions need fewer multiplications than mixed ones.
      */
-    d_ge.x = d.x;
-    d_ge.y = d.y;
-    d_ge.infinity = 0;
-
-    secp256k1_ge_set_gej_zinv(&a_ge, a, &d.z);
-    prej[0].x = a_ge.x;
-    prej[0].y = a_ge.y;
-    prej[0].z = a->z;
+    a_ge.x = a->x;
+    a_ge.y = a->y;
+    a_ge.infinity = 0;
+    secp256k1_fe_normalize_weak(&a_ge.x);
+    secp256k1_fe_normalize_weak(&a_ge.y);
+
+    secp256k1_ge_dblu(&d_ge, &p_ge, &a_ge, &zr[0]);
+    prej[0].x = p_ge.x;
+    prej[0].y = p_ge.y;
     prej[0].infinity = 0;
+    secp256k1_fe_mul(&z, &a->z, &zr[0]);
 
-    zr[0] = d.z;
     for (i = 1; i < n; i++) {
-        secp256k1_gej_add_ge_var(&prej[i], &prej[i-1], &d_ge, &zr[i]);
+        secp256k1_ge_zaddu_var(&p_ge, &d_ge, &d_ge, &p_ge, &zr[i]);
+        prej[i].x = p_ge.x;
+        prej[i].y = p_ge.y;
+        prej[i].infinity = 0;
+        secp256k1_fe_mul(&z, &z, &zr[i]);
     }
 
-    /*
-     * Each point in 'prej' has a z coordinate too small by a factor of 'd.z'. Only
-     * the final point's z coordinate is actually used though, so just update that.
-     */
-    secp256k1_fe_mul(&prej[n-1].z, &prej[n-1].z, &d.z);
+    /* Only the final point's z coordinate is used. */
+    prej[n-1].z = z;
 }
 
 /** Fill a table 'pre' with precomputed odd multiples of a.
@@ -154,14 +165,31 @@ static void secp256k1_ecmult_odd_multiples_table_storage_var(int n, secp256k1_ge
     } \
 } while(0)
 
+/** Number of precomputed G table entries, across all tables. */
+#ifdef USE_ENDOMORPHISM
+#define ECMULT_G_TABLES_SIZE (2 * ECMULT_TABLE_SIZE(WINDOW_G))
+#else
+#define ECMULT_G_TABLES_SIZE ECMULT_TABLE_SIZE(WINDOW_G)
+#endif
+
 static void secp256k1_ecmult_context_init(secp256k1_ecmult_context *ctx) {
     ctx->pre_g = NULL;
 #ifdef USE_ENDOMORPHISM
     ctx->pre_g_128 = NULL;
 #endif
+    ctx->hugepages = 0;
 }
 
-static void secp256k1_ecmult_context_build(secp256k1_ecmult_context *ctx, const secp256k1_callback *cb) {
+/* Allocate all G tables as one block, so that they share as few (huge)pages as possible. */
+static void secp256k1_ecmult_context_alloc(secp256k1_ecmult_context *ctx, int hugepages, const secp256k1_callback *cb) {
+    ctx->hugepages = hugepages;
+    ctx->pre_g = (secp256k1_ge_storage (*)[])checked_table_malloc(cb, sizeof((*ctx->pre_g)[0]) * ECMULT_G_TABLES_SIZE, hugepages);
+#ifdef USE_ENDOMORPHISM
+    ctx->pre_g_128 = (secp256k1_ge_storage (*)[])(*ctx->pre_g + ECMULT_TABLE_SIZE(WINDOW_G));
+#endif
+}
+
+static void secp256k1_ecmult_context_build(secp256k1_ecmult_context *ctx, int hugepages, const secp256k1_callback *cb) {
     secp256k1_gej gj;
 
     if (ctx->pre_g != NULL) {
@@ -171,7 +199,7 @@ static void secp256k1_ecmult_context_build(secp256k1_ecmult_context *ctx, const
     /* get the generator */
     secp256k1_gej_set_ge(&gj, &secp256k1_ge_const_g);
 
-    ctx->pre_g = (secp256k1_ge_storage (*)[])checked_malloc(cb, sizeof((*ctx->pre_g)[0]) * ECMULT_TABLE_SIZE(WINDOW_G));
+    secp256k1_ecmult_context_alloc(ctx, hugepages, cb);
 
     /* precompute the tables with odd multiples */
     secp256k1_ecmult_odd_multiples_table_storage_var(ECMULT_TABLE_SIZE(WINDOW_G), *ctx->pre_g, &gj, cb);
@@ -181,8 +209,6 @@ static void secp256k1_ecmult_context_build(secp256k1_ecmult_context *ctx, const
         secp256k1_gej g_128j;
         int i;
 
-        ctx->pre_g_128 = (secp256k1_ge_storage (*)[])checked_malloc(cb, sizeof((*ctx->pre_g_128)[0]) * ECMULT_TABLE_SIZE(WINDOW_G));
-
         /* calculate 2^128*generator */
         g_128j = gj;
         for (i = 0; i < 128; i++) {
@@ -196,21 +222,11 @@ static void secp256k1_ecmult_context_build(secp256k1_ecmult_context *ctx, const
 static void secp256k1_ecmult_context_clone(secp256k1_ecmult_context *dst,
                                            const secp256k1_ecmult_context *src, const secp256k1_callback *cb) {
     if (src->pre_g == NULL) {
-        dst->pre_g = NULL;
-    } else {
-        size_t size = sizeof((*dst->pre_g)[0]) * ECMULT_TABLE_SIZE(WINDOW_G);
-        dst->pre_g = (secp256k1_ge_storage (*)[])checked_malloc(cb, size);
-        memcpy(dst->pre_g, src->pre_g, size);
-    }
-#ifdef USE_ENDOMORPHISM
-    if (src->pre_g_128 == NULL) {
-        dst->pre_g_128 = NULL;
+        secp256k1_ecmult_context_init(dst);
     } else {
-        size_t size = sizeof((*dst->pre_g_128)[0]) * ECMULT_TABLE_SIZE(WINDOW_G);
-        dst->pre_g_128 = (secp256k1_ge_storage (*)[])checked_malloc(cb, size);
-        memcpy(dst->pre_g_128, src->pre_g_128, size);
+        secp256k1_ecmult_context_alloc(dst, src->hugepages, cb);
+        memcpy(dst->pre_g, src->pre_g, sizeof((*dst->pre_g)[0]) * ECMULT_G_TABLES_SIZE);
     }
-#endif
 }
 
 static int secp256k1_ecmult_context_is_built(const secp256k1_ecmult_context *ctx) {
@@ -218,10 +234,7 @@ static int secp256k1_ecmult_context_is_built(const secp256k1_ecmult_context *ctx
 }
 
 static void secp256k1_ecmult_context_clear(secp256k1_ecmult_context *ctx) {
-    free(ctx->pre_g);
-#ifdef USE_ENDOMORPHISM
-    free(ctx->pre_g_128);
-#endif
+    table_free(ctx->pre_g);
     secp256k1_ecmult_context_init(ctx);
 }
 
@@ -283,49 +296,199 @@ static int secp256k1_ecmult_wnaf(int *wnaf, int len, const secp256k1_scalar *a,
     return last_set_bit + 1;
 }
 
-static void secp256k1_ecmult(const secp256k1_ecmult_context *ctx, secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng) {
+/** Convert a number to compact WNAF notation: the list of its (position,
+ *  digit) pairs with a non-zero digit, in increasing order of position. The
+ *  number becomes represented by sum(2^wnaf[j].pos * wnaf[j].digit), and the
+ *  digits obey the same guarantees as those of secp256k1_ecmult_wnaf. wnaf must
+ *  have room for ECMULT_WNAF_COMPACT_SIZE(len, w) entries; the number of
+ *  entries written is returned.
+ *
+ *  Rather than testing one bit at a time, whole runs of positions that result
+ *  in zero digits are skipped at once, up to 30 bits per scalar access.
+ */
+static int secp256k1_ecmult_wnaf_compact(secp256k1_wnaf_entry *wnaf, int len, const secp256k1_scalar *a, int w) {
+    secp256k1_scalar s = *a;
+    int n = 0;
+    int bit = 0;
+    int sign = 1;
+    int carry = 0;
+
+    VERIFY_CHECK(wnaf != NULL);
+    VERIFY_CHECK(0 <= len && len <= 256);
+    VERIFY_CHECK(a != NULL);
+    VERIFY_CHECK(2 <= w && w <= 31);
+
+    if (secp256k1_scalar_get_bits(&s, 255, 1)) {
+        secp256k1_scalar_negate(&s, &s);
+        sign = -1;
+    }
+
+    while (bit < len) {
+        int now;
+        int word;
+        unsigned int run;
+
+        /* Positions whose bit equals the carry produce zero digits. Flip the
+         * bits when carrying, so that the next digit starts at the lowest set
+         * bit of the chunk. */
+        now = len - bit;
+        if (now > 30) {
+            now = 30;
+        }
+        run = secp256k1_scalar_get_bits_var(&s, bit, now);
+        if (carry) {
+            run = ~run & ((1U << now) - 1);
+        }
+        if (run == 0) {
+            bit += now;
+            continue;
+        }
+        bit += secp256k1_ctz32_var(run);
+
+        now = w;
+        if (now > len - bit) {
+            now = len - bit;
+        }
+
+        word = secp256k1_scalar_get_bits_var(&s, bit, now) + carry;
+
+        carry = (word >> (w-1)) & 1;
+        word -= carry << w;
+
+        wnaf[n].pos = bit;
+        wnaf[n].digit = sign * word;
+        n++;
+
+        bit += now;
+    }
+#ifdef VERIFY
+    CHECK(carry == 0);
+    CHECK(n <= ECMULT_WNAF_COMPACT_SIZE(len, w));
+    while (bit < 256) {
+        CHECK(secp256k1_scalar_get_bits(&s, bit++, 1) == 0);
+    }
+#endif
+    return n;
+}
+
+/** Return the larger of pos and the position of the highest remaining entry,
+ *  wnaf[n], of a compact wnaf list (if any). */
+static SECP256K1_INLINE int secp256k1_ecmult_wnaf_top(const secp256k1_wnaf_entry *wnaf, int n, int pos) {
+    if (n >= 0 && wnaf[n].pos > pos) {
+        return wnaf[n].pos;
+    }
+    return pos;
+}
+
+/** Prefetch the precomputed G table entries that the compact wnaf entries at
+ *  indices *cursor and below will look up, for as long as their position is
+ *  at least limit, and move *cursor past them. An entry may straddle two
+ *  cache lines, so both are requested. */
+static SECP256K1_INLINE void secp256k1_ecmult_prefetch_g(const secp256k1_ge_storage *pre, const secp256k1_wnaf_entry *wnaf, int *cursor, int limit) {
+    while (*cursor >= 0 && wnaf[*cursor].pos >= limit) {
+        int n = wnaf[*cursor].digit;
+        const unsigned char *p = (const unsigned char *)&pre[(n < 0 ? -n : n) >> 1];
+        PREFETCH(p);
+        PREFETCH(p + sizeof(secp256k1_ge_storage) - 1);
+        (*cursor)--;
+    }
+}
+
+/** The state of one double multiply na*A + ng*G while its compact wnaf
+ *  entries are walked from the top position down. */
+typedef struct {
     secp256k1_ge pre_a[ECMULT_TABLE_SIZE(WINDOW_A)];
-    secp256k1_ge tmpa;
     secp256k1_fe Z;
 #ifdef USE_ENDOMORPHISM
     secp256k1_ge pre_a_lam[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_wnaf_entry wnaf_na_1[ECMULT_WNAF_COMPACT_SIZE(130, WINDOW_A)];
+    secp256k1_wnaf_entry wnaf_na_lam[ECMULT_WNAF_COMPACT_SIZE(130, WINDOW_A)];
+    int n_na_1;
+    int n_na_lam;
+    secp256k1_wnaf_entry wnaf_ng_1[ECMULT_WNAF_COMPACT_SIZE(129, WINDOW_G)];
+    int n_ng_1;
+    int pf_ng_1;
+    secp256k1_wnaf_entry wnaf_ng_128[ECMULT_WNAF_COMPACT_SIZE(129, WINDOW_G)];
+    int n_ng_128;
+    int pf_ng_128;
+#else
+    secp256k1_wnaf_entry wnaf_na[ECMULT_WNAF_COMPACT_SIZE(256, WINDOW_A)];
+    int n_na;
+    secp256k1_wnaf_entry wnaf_ng[ECMULT_WNAF_COMPACT_SIZE(256, WINDOW_G)];
+    int n_ng;
+    int pf_ng;
+#endif
+} secp256k1_ecmult_state;
+
+/** Return the position of the next event of st, i.e. the highest position
+ *  that still has a non-zero digit in one of its streams, or -1 if none. */
+static SECP256K1_INLINE int secp256k1_ecmult_state_next(const secp256k1_ecmult_state *st) {
+    int pos = -1;
+#ifdef USE_ENDOMORPHISM
+    pos = secp256k1_ecmult_wnaf_top(st->wnaf_na_1, st->n_na_1, pos);
+    pos = secp256k1_ecmult_wnaf_top(st->wnaf_na_lam, st->n_na_lam, pos);
+    pos = secp256k1_ecmult_wnaf_top(st->wnaf_ng_1, st->n_ng_1, pos);
+    pos = secp256k1_ecmult_wnaf_top(st->wnaf_ng_128, st->n_ng_128, pos);
+#else
+    pos = secp256k1_ecmult_wnaf_top(st->wnaf_na, st->n_na, pos);
+    pos = secp256k1_ecmult_wnaf_top(st->wnaf_ng, st->n_ng, pos);
+#endif
+    return pos;
+}
+
+/** Recode na and ng and build the table of odd multiples of a. Returns the
+ *  position of the first event. */
+static int secp256k1_ecmult_state_init(const secp256k1_ecmult_context *ctx, secp256k1_ecmult_state *st, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng) {
+#ifdef USE_ENDOMORPHISM
     secp256k1_scalar na_1, na_lam;
     /* Split G factors. */
     secp256k1_scalar ng_1, ng_128;
-    int wnaf_na_1[130];
-    int wnaf_na_lam[130];
-    int bits_na_1;
-    int bits_na_lam;
-    int wnaf_ng_1[129];
-    int bits_ng_1;
-    int wnaf_ng_128[129];
-    int bits_ng_128;
-#else
-    int wnaf_na[256];
-    int bits_na;
-    int wnaf_ng[256];
-    int bits_ng;
-#endif
     int i;
-    int bits;
+#endif
+    int pos;
 
 #ifdef USE_ENDOMORPHISM
     /* split na into na_1 and na_lam (where na = na_1 + na_lam*lambda, and na_1 and na_lam are ~128 bit) */
     secp256k1_scalar_split_lambda(&na_1, &na_lam, na);
 
     /* build wnaf representation for na_1 and na_lam. */
-    bits_na_1   = secp256k1_ecmult_wnaf(wnaf_na_1,   130, &na_1,   WINDOW_A);
-    bits_na_lam = secp256k1_ecmult_wnaf(wnaf_na_lam, 130, &na_lam, WINDOW_A);
-    VERIFY_CHECK(bits_na_1 <= 130);
-    VERIFY_CHECK(bits_na_lam <= 130);
-    bits = bits_na_1;
-    if (bits_na_lam > bits) {
-        bits = bits_na_lam;
-    }
+    st->n_na_1   = secp256k1_ecmult_wnaf_compact(st->wnaf_na_1,   130, &na_1,   WINDOW_A);
+    st->n_na_lam = secp256k1_ecmult_wnaf_compact(st->wnaf_na_lam, 130, &na_lam, WINDOW_A);
+
+    /* split ng into ng_1 and ng_128 (where gn = gn_1 + gn_128*2^128, and gn_1 and gn_128 are ~128 bit) */
+    secp256k1_scalar_split_128(&ng_1, &ng_128, ng);
+
+    /* Build wnaf representation for ng_1 and ng_128 */
+    st->n_ng_1   = secp256k1_ecmult_wnaf_compact(st->wnaf_ng_1,   129, &ng_1,   WINDOW_G);
+    st->n_ng_128 = secp256k1_ecmult_wnaf_compact(st->wnaf_ng_128, 129, &ng_128, WINDOW_G);
+
+    /* The entries are consumed from the highest position down. */
+    st->n_na_1--;
+    st->n_na_lam--;
+    st->n_ng_1--;
+    st->n_ng_128--;
+#else
+    /* build wnaf representation for na and ng. */
+    st->n_na     = secp256k1_ecmult_wnaf_compact(st->wnaf_na,     256, na,      WINDOW_A);
+    st->n_ng     = secp256k1_ecmult_wnaf_compact(st->wnaf_ng,     256, ng,      WINDOW_G);
+
+    /* The entries are consumed from the highest position down. */
+    st->n_na--;
+    st->n_ng--;
+#endif
+    pos = secp256k1_ecmult_state_next(st);
+
+    /* Start pulling in the first G table entries we need, so their latency
+     * overlaps with building the table for a below. The main loop keeps
+     * ECMULT_PREFETCH_DISTANCE positions ahead from there on. */
+#ifdef USE_ENDOMORPHISM
+    st->pf_ng_1 = st->n_ng_1;
+    st->pf_ng_128 = st->n_ng_128;
+    secp256k1_ecmult_prefetch_g(*ctx->pre_g, st->wnaf_ng_1, &st->pf_ng_1, pos - ECMULT_PREFETCH_DISTANCE);
+    secp256k1_ecmult_prefetch_g(*ctx->pre_g_128, st->wnaf_ng_128, &st->pf_ng_128, pos - ECMULT_PREFETCH_DISTANCE);
 #else
-    /* build wnaf representation for na. */
-    bits_na     = secp256k1_ecmult_wnaf(wnaf_na,     256, na,      WINDOW_A);
-    bits = bits_na;
+    st->pf_ng = st->n_ng;
+    secp256k1_ecmult_prefetch_g(*ctx->pre_g, st->wnaf_ng, &st->pf_ng, pos - ECMULT_PREFETCH_DISTANCE);
 #endif
 
     /* Calculate odd multiples of a.
@@ -338,69 +501,304 @@ static void secp256k1_ecmult(const secp256k1_ecmult_context *ctx, secp256k1_gej
      * of 1/Z, so we can use secp256k1_gej_add_zinv_var, which uses the same
      * isomorphism to efficiently add with a known Z inverse.
      */
-    secp256k1_ecmult_odd_multiples_table_globalz_windowa(pre_a, &Z, a);
+    secp256k1_ecmult_odd_multiples_table_globalz_windowa(st->pre_a, &st->Z, a);
 
 #ifdef USE_ENDOMORPHISM
     for (i = 0; i < ECMULT_TABLE_SIZE(WINDOW_A); i++) {
-        secp256k1_ge_mul_lambda(&pre_a_lam[i], &pre_a[i]);
+        secp256k1_ge_mul_lambda(&st->pre_a_lam[i], &st->pre_a[i]);
     }
+#endif
 
-    /* split ng into ng_1 and ng_128 (where gn = gn_1 + gn_128*2^128, and gn_1 and gn_128 are ~128 bit) */
-    secp256k1_scalar_split_128(&ng_1, &ng_128, ng);
+    return pos;
+}
 
-    /* Build wnaf representation for ng_1 and ng_128 */
-    bits_ng_1   = secp256k1_ecmult_wnaf(wnaf_ng_1,   129, &ng_1,   WINDOW_G);
-    bits_ng_128 = secp256k1_ecmult_wnaf(wnaf_ng_128, 129, &ng_128, WINDOW_G);
-    if (bits_ng_1 > bits) {
-        bits = bits_ng_1;
+/** Add b to r, or set r to 2*r + b if *dbl is set (which is then cleared). */
+static SECP256K1_INLINE void secp256k1_ecmult_add_ge(secp256k1_gej *r, const secp256k1_ge *b, int *dbl) {
+    if (*dbl) {
+        secp256k1_gej_double_add_ge_var(r, r, b);
+        *dbl = 0;
+    } else {
+        secp256k1_gej_add_ge_var(r, r, b, NULL);
+    }
+}
+
+/** As secp256k1_ecmult_add_ge, for a b whose Z has the inverse bzinv. */
+static SECP256K1_INLINE void secp256k1_ecmult_add_zinv(secp256k1_gej *r, const secp256k1_ge *b, const secp256k1_fe *bzinv, int *dbl) {
+    if (*dbl) {
+        secp256k1_gej_double_add_zinv_var(r, r, b, bzinv);
+        *dbl = 0;
+    } else {
+        secp256k1_gej_add_zinv_var(r, r, b, bzinv);
+    }
+}
+
+/** Add the digits of all streams of st at position pos into r, and return the
+ *  position of the next event. If dbl is set, r is doubled first; that
+ *  doubling is fused with the first addition. */
+static SECP256K1_INLINE int secp256k1_ecmult_state_add(const secp256k1_ecmult_context *ctx, secp256k1_ecmult_state *st, secp256k1_gej *r, int pos, int dbl) {
+    secp256k1_ge tmpa;
+    int n;
+#ifdef USE_ENDOMORPHISM
+    secp256k1_ecmult_prefetch_g(*ctx->pre_g, st->wnaf_ng_1, &st->pf_ng_1, pos - ECMULT_PREFETCH_DISTANCE);
+    secp256k1_ecmult_prefetch_g(*ctx->pre_g_128, st->wnaf_ng_128, &st->pf_ng_128, pos - ECMULT_PREFETCH_DISTANCE);
+    if (st->n_na_1 >= 0 && st->wnaf_na_1[st->n_na_1].pos == pos) {
+        n = st->wnaf_na_1[st->n_na_1--].digit;
+        ECMULT_TABLE_GET_GE(&tmpa, st->pre_a, n, WINDOW_A);
+        secp256k1_ecmult_add_ge(r, &tmpa, &dbl);
+    }
+    if (st->n_na_lam >= 0 && st->wnaf_na_lam[st->n_na_lam].pos == pos) {
+        n = st->wnaf_na_lam[st->n_na_lam--].digit;
+        ECMULT_TABLE_GET_GE(&tmpa, st->pre_a_lam, n, WINDOW_A);
+        secp256k1_ecmult_add_ge(r, &tmpa, &dbl);
+    }
+    if (st->n_ng_1 >= 0 && st->wnaf_ng_1[st->n_ng_1].pos == pos) {
+        n = st->wnaf_ng_1[st->n_ng_1--].digit;
+        ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g, n, WINDOW_G);
+        secp256k1_ecmult_add_zinv(r, &tmpa, &st->Z, &dbl);
     }
-    if (bits_ng_128 > bits) {
-        bits = bits_ng_128;
+    if (st->n_ng_128 >= 0 && st->wnaf_ng_128[st->n_ng_128].pos == pos) {
+        n = st->wnaf_ng_128[st->n_ng_128--].digit;
+        ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g_128, n, WINDOW_G);
+        secp256k1_ecmult_add_zinv(r, &tmpa, &st->Z, &dbl);
     }
 #else
-    bits_ng     = secp256k1_ecmult_wnaf(wnaf_ng,     256, ng,      WINDOW_G);
-    if (bits_ng > bits) {
-        bits = bits_ng;
+    secp256k1_ecmult_prefetch_g(*ctx->pre_g, st->wnaf_ng, &st->pf_ng, pos - ECMULT_PREFETCH_DISTANCE);
+    if (st->n_na >= 0 && st->wnaf_na[st->n_na].pos == pos) {
+        n = st->wnaf_na[st->n_na--].digit;
+        ECMULT_TABLE_GET_GE(&tmpa, st->pre_a, n, WINDOW_A);
+        secp256k1_ecmult_add_ge(r, &tmpa, &dbl);
+    }
+    if (st->n_ng >= 0 && st->wnaf_ng[st->n_ng].pos == pos) {
+        n = st->wnaf_ng[st->n_ng--].digit;
+        ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g, n, WINDOW_G);
+        secp256k1_ecmult_add_zinv(r, &tmpa, &st->Z, &dbl);
     }
 #endif
+    /* pos is always an event of st, so some addition consumed the doubling. */
+    VERIFY_CHECK(!dbl);
+    return secp256k1_ecmult_state_next(st);
+}
+
+/** Undo the isomorphism of the table of a on the finished result r. */
+static SECP256K1_INLINE void secp256k1_ecmult_state_finish(const secp256k1_ecmult_state *st, secp256k1_gej *r) {
+    if (!r->infinity) {
+        secp256k1_fe_mul(&r->z, &r->z, &st->Z);
+    }
+}
 
+static void secp256k1_ecmult(const secp256k1_ecmult_context *ctx, secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng) {
+    secp256k1_ecmult_state st;
+    int i;
+    int pos;
+
+    SECP256K1_STATS_INC(ecmult);
+    pos = secp256k1_ecmult_state_init(ctx, &st, a, na, ng);
     secp256k1_gej_set_infinity(r);
 
-    for (i = bits - 1; i >= 0; i--) {
-        int n;
-        secp256k1_gej_double_var(r, r, NULL);
-#ifdef USE_ENDOMORPHISM
-        if (i < bits_na_1 && (n = wnaf_na_1[i])) {
-            ECMULT_TABLE_GET_GE(&tmpa, pre_a, n, WINDOW_A);
-            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+    /* Walk the non-zero digits of all streams as events in decreasing order
+     * of position. r holds the sum so far, scaled down by 2^i; between two
+     * events only a run of doublings is needed to bring it to the next one. */
+    i = pos;
+    while (pos >= 0) {
+        /* The last doubling of the run is done together with the first addition. */
+        int dbl = i > pos;
+        for (; i > pos + 1; i--) {
+            secp256k1_gej_double_var(r, r, NULL);
         }
-        if (i < bits_na_lam && (n = wnaf_na_lam[i])) {
-            ECMULT_TABLE_GET_GE(&tmpa, pre_a_lam, n, WINDOW_A);
-            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        i = pos;
+        pos = secp256k1_ecmult_state_add(ctx, &st, r, pos, dbl);
+    }
+    /* Bring the last event down to position 0. */
+    for (; i > 0; i--) {
+        secp256k1_gej_double_var(r, r, NULL);
+    }
+
+    secp256k1_ecmult_state_finish(&st, r);
+}
+
+static void secp256k1_ecmult_x2(const secp256k1_ecmult_context *ctx, secp256k1_gej *r1, const secp256k1_gej *a1, const secp256k1_scalar *na1, const secp256k1_scalar *ng1, secp256k1_gej *r2, const secp256k1_gej *a2, const secp256k1_scalar *na2, const secp256k1_scalar *ng2) {
+    secp256k1_ecmult_state st1, st2;
+    int i;
+    int pos1, pos2;
+
+    SECP256K1_STATS_ADD(ecmult, 2);
+    pos1 = secp256k1_ecmult_state_init(ctx, &st1, a1, na1, ng1);
+    pos2 = secp256k1_ecmult_state_init(ctx, &st2, a2, na2, ng2);
+    secp256k1_gej_set_infinity(r1);
+    secp256k1_gej_set_infinity(r2);
+
+    /* As in secp256k1_ecmult, but both sums are kept at the same scale 2^i so
+     * every doubling can be done for the two at once. Until its first event a
+     * sum is still infinity, which the paired doubling passes through. */
+    i = pos1 > pos2 ? pos1 : pos2;
+    while (pos1 >= 0 || pos2 >= 0) {
+        int pos = pos1 > pos2 ? pos1 : pos2;
+        int dbl = i > pos;
+        for (; i > pos + 1; i--) {
+            secp256k1_gej_double_x2_var(r1, r1, r2, r2);
         }
-        if (i < bits_ng_1 && (n = wnaf_ng_1[i])) {
-            ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g, n, WINDOW_G);
-            secp256k1_gej_add_zinv_var(r, r, &tmpa, &Z);
+        i = pos;
+        if (pos1 == pos) {
+            pos1 = secp256k1_ecmult_state_add(ctx, &st1, r1, pos, dbl);
+        } else if (dbl) {
+            secp256k1_gej_double_var(r1, r1, NULL);
         }
-        if (i < bits_ng_128 && (n = wnaf_ng_128[i])) {
-            ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g_128, n, WINDOW_G);
-            secp256k1_gej_add_zinv_var(r, r, &tmpa, &Z);
+        if (pos2 == pos) {
+            pos2 = secp256k1_ecmult_state_add(ctx, &st2, r2, pos, dbl);
+        } else if (dbl) {
+            secp256k1_gej_double_var(r2, r2, NULL);
         }
+    }
+    for (; i > 0; i--) {
+        secp256k1_gej_double_x2_var(r1, r1, r2, r2);
+    }
+
+    secp256k1_ecmult_state_finish(&st1, r1);
+    secp256k1_ecmult_state_finish(&st2, r2);
+}
+
+/** One term na*A of a multi-multiply: the affine odd multiples of A, and the
+ *  compact wnafs of na, consumed from the highest position down. */
+typedef struct {
+    secp256k1_ge pre_a[ECMULT_TABLE_SIZE(WINDOW_A)];
+#ifdef USE_ENDOMORPHISM
+    secp256k1_ge pre_a_lam[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_wnaf_entry wnaf_na_1[ECMULT_WNAF_COMPACT_SIZE(130, WINDOW_A)];
+    secp256k1_wnaf_entry wnaf_na_lam[ECMULT_WNAF_COMPACT_SIZE(130, WINDOW_A)];
+    int n_na_1;
+    int n_na_lam;
 #else
-        if (i < bits_na && (n = wnaf_na[i])) {
-            ECMULT_TABLE_GET_GE(&tmpa, pre_a, n, WINDOW_A);
-            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+    secp256k1_wnaf_entry wnaf_na[ECMULT_WNAF_COMPACT_SIZE(256, WINDOW_A)];
+    int n_na;
+#endif
+} secp256k1_ecmult_multi_term;
+
+/** If the next entry of the compact wnaf is at position pos, add its multiple
+ *  from the affine table pre to r. */
+#define ECMULT_MULTI_ADD(r,pre,wnaf,n,pos) do { \
+    if ((n) >= 0 && (wnaf)[n].pos == (pos)) { \
+        secp256k1_ge add; \
+        int digit = (wnaf)[(n)--].digit; \
+        ECMULT_TABLE_GET_GE(&add, (pre), digit, WINDOW_A); \
+        secp256k1_gej_add_ge_var((r), (r), &add, NULL); \
+    } \
+} while(0)
+
+#define ECMULT_MULTI_ADD_G(r,pre,wnaf,n,pos) do { \
+    if ((n) >= 0 && (wnaf)[n].pos == (pos)) { \
+        secp256k1_ge add; \
+        int digit = (wnaf)[(n)--].digit; \
+        ECMULT_TABLE_GET_GE_STORAGE(&add, (pre), digit, WINDOW_G); \
+        secp256k1_gej_add_ge_var((r), (r), &add, NULL); \
+    } \
+} while(0)
+
+static void secp256k1_ecmult_multi_var(const secp256k1_ecmult_context *ctx, secp256k1_gej *r, const secp256k1_ge *a, const secp256k1_scalar *na, size_t n, const secp256k1_scalar *ng, const secp256k1_callback *cb) {
+    secp256k1_ecmult_multi_term *terms = NULL;
+    secp256k1_fe *z = NULL, *zinv = NULL;
+    secp256k1_gej prej[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_fe zr[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_gej aj;
+    secp256k1_fe zi2, zi3;
+#ifdef USE_ENDOMORPHISM
+    secp256k1_scalar na_1, na_lam;
+    secp256k1_scalar ng_1, ng_128;
+    secp256k1_wnaf_entry wnaf_ng_1[ECMULT_WNAF_COMPACT_SIZE(129, WINDOW_G)];
+    secp256k1_wnaf_entry wnaf_ng_128[ECMULT_WNAF_COMPACT_SIZE(129, WINDOW_G)];
+    int n_ng_1, n_ng_128;
+#else
+    secp256k1_wnaf_entry wnaf_ng[ECMULT_WNAF_COMPACT_SIZE(256, WINDOW_G)];
+    int n_ng;
+#endif
+    size_t i, m = 0;
+    int j;
+    int pos = -1;
+
+    SECP256K1_STATS_INC(ecmult);
+    if (n > 0) {
+        terms = (secp256k1_ecmult_multi_term*)checked_malloc(cb, sizeof(secp256k1_ecmult_multi_term) * n);
+        z = (secp256k1_fe*)checked_malloc(cb, sizeof(secp256k1_fe) * 2 * n);
+        zinv = z + n;
+    }
+
+    /* Recode the scalars, and build the tables of odd multiples, each on the
+     * Z of its last entry. Terms that add nothing are left out. */
+    for (i = 0; i < n; i++) {
+        secp256k1_ecmult_multi_term *t = &terms[m];
+        if (a[i].infinity || secp256k1_scalar_is_zero(&na[i])) {
+            continue;
         }
-        if (i < bits_ng && (n = wnaf_ng[i])) {
-            ECMULT_TABLE_GET_GE_STORAGE(&tmpa, *ctx->pre_g, n, WINDOW_G);
-            secp256k1_gej_add_zinv_var(r, r, &tmpa, &Z);
+#ifdef USE_ENDOMORPHISM
+        /* A scalar below 2^128 is as short as its split would be. */
+        secp256k1_scalar_split_128(&na_1, &na_lam, &na[i]);
+        if (secp256k1_scalar_is_zero(&na_lam)) {
+            t->n_na_1 = secp256k1_ecmult_wnaf_compact(t->wnaf_na_1, 130, &na_1, WINDOW_A) - 1;
+            t->n_na_lam = -1;
+        } else {
+            secp256k1_scalar_split_lambda(&na_1, &na_lam, &na[i]);
+            t->n_na_1   = secp256k1_ecmult_wnaf_compact(t->wnaf_na_1,   130, &na_1,   WINDOW_A) - 1;
+            t->n_na_lam = secp256k1_ecmult_wnaf_compact(t->wnaf_na_lam, 130, &na_lam, WINDOW_A) - 1;
         }
+        pos = secp256k1_ecmult_wnaf_top(t->wnaf_na_1, t->n_na_1, pos);
+        pos = secp256k1_ecmult_wnaf_top(t->wnaf_na_lam, t->n_na_lam, pos);
+#else
+        t->n_na = secp256k1_ecmult_wnaf_compact(t->wnaf_na, 256, &na[i], WINDOW_A) - 1;
+        pos = secp256k1_ecmult_wnaf_top(t->wnaf_na, t->n_na, pos);
 #endif
+        secp256k1_gej_set_ge(&aj, &a[i]);
+        secp256k1_ecmult_odd_multiples_table(ECMULT_TABLE_SIZE(WINDOW_A), prej, zr, &aj);
+        secp256k1_ge_globalz_set_table_gej(ECMULT_TABLE_SIZE(WINDOW_A), t->pre_a, &z[m], prej, zr);
+        m++;
     }
 
-    if (!r->infinity) {
-        secp256k1_fe_mul(&r->z, &r->z, &Z);
+    /* Make all tables affine with one shared inversion, so that no term needs
+     * its own isomorphism in the main loop. */
+    secp256k1_fe_inv_all_var(zinv, z, m);
+    for (i = 0; i < m; i++) {
+        secp256k1_fe_sqr(&zi2, &zinv[i]);
+        secp256k1_fe_mul(&zi3, &zi2, &zinv[i]);
+        for (j = 0; j < ECMULT_TABLE_SIZE(WINDOW_A); j++) {
+            secp256k1_fe_mul(&terms[i].pre_a[j].x, &terms[i].pre_a[j].x, &zi2);
+            secp256k1_fe_mul(&terms[i].pre_a[j].y, &terms[i].pre_a[j].y, &zi3);
+#ifdef USE_ENDOMORPHISM
+            secp256k1_ge_mul_lambda(&terms[i].pre_a_lam[j], &terms[i].pre_a[j]);
+#endif
+        }
+    }
+
+#ifdef USE_ENDOMORPHISM
+    secp256k1_scalar_split_128(&ng_1, &ng_128, ng);
+    n_ng_1   = secp256k1_ecmult_wnaf_compact(wnaf_ng_1,   129, &ng_1,   WINDOW_G) - 1;
+    n_ng_128 = secp256k1_ecmult_wnaf_compact(wnaf_ng_128, 129, &ng_128, WINDOW_G) - 1;
+    pos = secp256k1_ecmult_wnaf_top(wnaf_ng_1, n_ng_1, pos);
+    pos = secp256k1_ecmult_wnaf_top(wnaf_ng_128, n_ng_128, pos);
+#else
+    n_ng = secp256k1_ecmult_wnaf_compact(wnaf_ng, 256, ng, WINDOW_G) - 1;
+    pos = secp256k1_ecmult_wnaf_top(wnaf_ng, n_ng, pos);
+#endif
+
+    secp256k1_gej_set_infinity(r);
+    for (; pos >= 0; pos--) {
+        secp256k1_gej_double_var(r, r, NULL);
+        for (i = 0; i < m; i++) {
+            secp256k1_ecmult_multi_term *t = &terms[i];
+#ifdef USE_ENDOMORPHISM
+            ECMULT_MULTI_ADD(r, t->pre_a, t->wnaf_na_1, t->n_na_1, pos);
+            ECMULT_MULTI_ADD(r, t->pre_a_lam, t->wnaf_na_lam, t->n_na_lam, pos);
+#else
+            ECMULT_MULTI_ADD(r, t->pre_a, t->wnaf_na, t->n_na, pos);
+#endif
+        }
+#ifdef USE_ENDOMORPHISM
+        ECMULT_MULTI_ADD_G(r, *ctx->pre_g, wnaf_ng_1, n_ng_1, pos);
+        ECMULT_MULTI_ADD_G(r, *ctx->pre_g_128, wnaf_ng_128, n_ng_128, pos);
+#else
+        ECMULT_MULTI_ADD_G(r, *ctx->pre_g, wnaf_ng, n_ng, pos);
+#endif
     }
+
+    free(terms);
+    free(z);
 }
 
 #endif
@@ -117,6 +117,9 @@ static void secp256k1_fe_inv_var(secp256k1_fe *r, const secp256k1_fe *a);
  *  outputs must not overlap in memory. */
 static void secp256k1_fe_inv_all_var(secp256k1_fe *r, const secp256k1_fe *a, size_t len);
 
+/** Constant-time version of secp256k1_fe_inv_all_var. All inputs must be nonzero. */
+static void secp256k1_fe_inv_all(secp256k1_fe *r, const secp256k1_fe *a, size_t len);
+
 /** Convert a field element to the storage type. */
 static void secp256k1_fe_to_storage(secp256k1_fe_storage *r, const secp256k1_fe *a);
 
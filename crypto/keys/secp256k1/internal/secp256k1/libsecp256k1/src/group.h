@@ -67,6 +67,13 @@ static void secp256k1_ge_set_gej(secp256k1_ge *r, secp256k1_gej *a);
 /** Set a batch of group elements equal to the inputs given in jacobian coordinates */
 static void secp256k1_ge_set_all_gej_var(secp256k1_ge *r, const secp256k1_gej *a, size_t len, const secp256k1_callback *cb);
 
+/** Set r equal to the sum of the n points in a (none of them infinity). While
+ *  there are many points, they are added in pairs in affine coordinates, with
+ *  one shared inversion per round. a is overwritten, and scratch must have
+ *  room for n field elements. Returns 0 (and leaves r unset) if the sum is
+ *  infinity. Variable time. */
+static int secp256k1_ge_sum_var(secp256k1_ge *r, secp256k1_ge *a, secp256k1_fe *scratch, size_t n);
+
 /** Set a batch of group elements equal to the inputs given in jacobian
  *  coordinates (with known z-ratios). zr must contain the known z-ratios such
  *  that mul(a[i].z, zr[i+1]) == a[i+1].z. zr[0] is ignored. */
@@ -104,6 +111,10 @@ static void secp256k1_gej_double_nonzero(secp256k1_gej *r, const secp256k1_gej *
 /** Set r equal to the double of a. If rzr is not-NULL, r->z = a->z * *rzr (where infinity means an implicit z = 0). */
 static void secp256k1_gej_double_var(secp256k1_gej *r, const secp256k1_gej *a, secp256k1_fe *rzr);
 
+/** Set r1 equal to the double of a1 and r2 equal to the double of a2, with the
+ *  work for the two interleaved. r1 and r2 must not alias a2 and a1 respectively. */
+static void secp256k1_gej_double_x2_var(secp256k1_gej *r1, const secp256k1_gej *a1, secp256k1_gej *r2, const secp256k1_gej *a2);
+
 /** Set r equal to the sum of a and b. If rzr is non-NULL, r->z = a->z * *rzr (a cannot be infinity in that case). */
 static void secp256k1_gej_add_var(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_gej *b, secp256k1_fe *rzr);
 
@@ -118,6 +129,27 @@ static void secp256k1_gej_add_ge_var(secp256k1_gej *r, const secp256k1_gej *a, c
 /** Set r equal to the sum of a and b (with the inverse of b's Z coordinate passed as bzinv). */
 static void secp256k1_gej_add_zinv_var(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_ge *b, const secp256k1_fe *bzinv);
 
+/** Set r equal to 2*a + b (with b given in affine coordinates). Gives the same
+ *  result as secp256k1_gej_double_var followed by secp256k1_gej_add_ge_var, in
+ *  one step. */
+static void secp256k1_gej_double_add_ge_var(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_ge *b);
+
+/** Set r equal to 2*a + b (with the inverse of b's Z coordinate passed as bzinv). Gives
+ *  the same result as secp256k1_gej_double_var followed by secp256k1_gej_add_zinv_var. */
+static void secp256k1_gej_double_add_zinv_var(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_ge *b, const secp256k1_fe *bzinv);
+
+/** Co-Z doubling. The x and y coordinates of a are taken as a Jacobian point
+ *  with some implicit Z. Sets r to 2*a and ra to a, both on the common Z given
+ *  by Z*rzr. a may not be infinity; ra may alias a. */
+static void secp256k1_ge_dblu(secp256k1_ge *r, secp256k1_ge *ra, const secp256k1_ge *a, secp256k1_fe *rzr);
+
+/** Co-Z addition. a and b are taken as Jacobian points with the same implicit
+ *  Z. Sets r to a+b and ra to a, both on the common Z given by Z*rzr. Neither
+ *  input may be infinity, and a may not equal b or -b. ra may alias a, r may
+ *  alias b. The coordinates of a must have magnitude 1, those of b at most 5
+ *  (x) and 3 (y); r and ra satisfy the same bounds. */
+static void secp256k1_ge_zaddu_var(secp256k1_ge *r, secp256k1_ge *ra, const secp256k1_ge *a, const secp256k1_ge *b, secp256k1_fe *rzr);
+
 #ifdef USE_ENDOMORPHISM
 /** Set r to be equal to lambda times a, where lambda is chosen in a way such that this is very fast. */
 static void secp256k1_ge_mul_lambda(secp256k1_ge *r, const secp256k1_ge *a);
@@ -138,6 +170,13 @@ static void secp256k1_ge_from_storage(secp256k1_ge *r, const secp256k1_ge_storag
 /** If flag is true, set *r equal to *a; otherwise leave it. Constant-time. */
 static void secp256k1_ge_storage_cmov(secp256k1_ge_storage *r, const secp256k1_ge_storage *a, int flag);
 
+/** Set *r equal to table[idx], where 0 <= idx < n. All n entries are read, so
+ *  neither timing nor memory access depend on idx. Constant-time. */
+static void secp256k1_ge_storage_table_get(secp256k1_ge_storage *r, const secp256k1_ge_storage *table, int n, int idx);
+
+/** If flag is true, set *r equal to *a; otherwise leave it. Constant-time. */
+static void secp256k1_gej_cmov(secp256k1_gej *r, const secp256k1_gej *a, int flag);
+
 /** Rescale a jacobian point by b which must be non-zero. Constant-time. */
 static void secp256k1_gej_rescale(secp256k1_gej *r, const secp256k1_fe *b);
 
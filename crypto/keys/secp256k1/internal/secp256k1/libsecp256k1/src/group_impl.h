@@ -11,6 +11,13 @@
 #include "field.h"
 #include "group.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(HAVE_AVX2_DISPATCH)
+#include <immintrin.h>
+#endif
+
 /* These points can be generated in sage as follows:
  *
  * 0. Setup a worksheet with the following parameters.
@@ -152,6 +159,91 @@ static void secp256k1_ge_set_all_gej_var(secp256k1_ge *r, const secp256k1_gej *a
     free(azi);
 }
 
+static int secp256k1_ge_sum_var(secp256k1_ge *r, secp256k1_ge *a, secp256k1_fe *scratch, size_t n) {
+    secp256k1_gej sum;
+    size_t i;
+    for (i = 0; i < n; i++) {
+        secp256k1_fe_normalize_weak(&a[i].x);
+        secp256k1_fe_normalize_weak(&a[i].y);
+    }
+    /* A round saves about a third of the cost of each of its additions, but
+     * needs an inversion, so the last hundred or so points are added up
+     * in Jacobian coordinates instead. */
+    while (n >= 128) {
+        size_t pairs = n / 2;
+        size_t m = 0;
+        secp256k1_fe *den = scratch;
+        secp256k1_fe *inv = scratch + pairs;
+
+        /* The denominators of the slopes: x2 - x1, or 2*y1 to double a point.
+         * A pair of opposite points gets 1, and is dropped below. */
+        for (i = 0; i < pairs; i++) {
+            const secp256k1_ge *p = &a[2 * i];
+            const secp256k1_ge *q = &a[2 * i + 1];
+            secp256k1_fe_negate(&den[i], &p->x, 1);
+            secp256k1_fe_add(&den[i], &q->x);
+            if (secp256k1_fe_normalizes_to_zero_var(&den[i])) {
+                if (secp256k1_fe_equal_var(&p->y, &q->y)) {
+                    den[i] = p->y;
+                    secp256k1_fe_mul_int(&den[i], 2);
+                } else {
+                    secp256k1_fe_set_int(&den[i], 1);
+                }
+            }
+        }
+        secp256k1_fe_inv_all_var(inv, den, pairs);
+
+        for (i = 0; i < pairs; i++) {
+            secp256k1_ge p = a[2 * i];
+            secp256k1_ge q = a[2 * i + 1];
+            secp256k1_fe lambda, t;
+            secp256k1_fe_negate(&t, &p.x, 1);
+            secp256k1_fe_add(&t, &q.x);
+            if (!secp256k1_fe_normalizes_to_zero_var(&t)) {
+                /* lambda = (y2 - y1) / (x2 - x1) */
+                secp256k1_fe_negate(&lambda, &p.y, 1);
+                secp256k1_fe_add(&lambda, &q.y);
+            } else if (secp256k1_fe_equal_var(&p.y, &q.y)) {
+                /* lambda = 3*x1^2 / (2*y1) */
+                secp256k1_fe_sqr(&lambda, &p.x);
+                secp256k1_fe_mul_int(&lambda, 3);
+            } else {
+                continue;
+            }
+            secp256k1_fe_mul(&lambda, &lambda, &inv[i]);
+            /* x3 = lambda^2 - x1 - x2 */
+            t = p.x;
+            secp256k1_fe_add(&t, &q.x);
+            secp256k1_fe_negate(&t, &t, 2);
+            secp256k1_fe_sqr(&a[m].x, &lambda);
+            secp256k1_fe_add(&a[m].x, &t);
+            secp256k1_fe_normalize_weak(&a[m].x);
+            /* y3 = lambda*(x1 - x3) - y1 */
+            secp256k1_fe_negate(&t, &a[m].x, 1);
+            secp256k1_fe_add(&t, &p.x);
+            secp256k1_fe_mul(&a[m].y, &lambda, &t);
+            secp256k1_fe_negate(&t, &p.y, 1);
+            secp256k1_fe_add(&a[m].y, &t);
+            secp256k1_fe_normalize_weak(&a[m].y);
+            a[m].infinity = 0;
+            m++;
+        }
+        if (n & 1) {
+            a[m++] = a[n - 1];
+        }
+        n = m;
+    }
+    secp256k1_gej_set_infinity(&sum);
+    for (i = 0; i < n; i++) {
+        secp256k1_gej_add_ge_var(&sum, &sum, &a[i], NULL);
+    }
+    if (secp256k1_gej_is_infinity(&sum)) {
+        return 0;
+    }
+    secp256k1_ge_set_gej_var(r, &sum);
+    return 1;
+}
+
 static void secp256k1_ge_set_table_gej_var(secp256k1_ge *r, const secp256k1_gej *a, const secp256k1_fe *zr, size_t len) {
     size_t i = len - 1;
     secp256k1_fe zi;
@@ -353,6 +445,62 @@ static void secp256k1_gej_double_var(secp256k1_gej *r, const secp256k1_gej *a, s
     secp256k1_fe_add(&r->y, &t2);         /* Y' = 36*X^3*Y^2 - 27*X^6 - 8*Y^4 (4) */
 }
 
+static void secp256k1_gej_double_x2_var(secp256k1_gej *r1, const secp256k1_gej *a1, secp256k1_gej *r2, const secp256k1_gej *a2) {
+    /* The same formula as secp256k1_gej_double_var, with the steps for the two
+     * points interleaved: the operations on one only depend on each other
+     * through a long chain, so this gives the CPU two of them to overlap. */
+    secp256k1_fe t1,t2,t3,t4;
+    secp256k1_fe u1,u2,u3,u4;
+    if (a1->infinity || a2->infinity) {
+        secp256k1_gej_double_var(r1, a1, NULL);
+        secp256k1_gej_double_var(r2, a2, NULL);
+        return;
+    }
+    r1->infinity = 0;
+    r2->infinity = 0;
+
+    secp256k1_fe_mul(&r1->z, &a1->z, &a1->y);
+    secp256k1_fe_mul(&r2->z, &a2->z, &a2->y);
+    secp256k1_fe_mul_int(&r1->z, 2);
+    secp256k1_fe_mul_int(&r2->z, 2);
+    secp256k1_fe_sqr(&t1, &a1->x);
+    secp256k1_fe_sqr(&u1, &a2->x);
+    secp256k1_fe_mul_int(&t1, 3);
+    secp256k1_fe_mul_int(&u1, 3);
+    secp256k1_fe_sqr(&t2, &t1);
+    secp256k1_fe_sqr(&u2, &u1);
+    secp256k1_fe_sqr(&t3, &a1->y);
+    secp256k1_fe_sqr(&u3, &a2->y);
+    secp256k1_fe_mul_int(&t3, 2);
+    secp256k1_fe_mul_int(&u3, 2);
+    secp256k1_fe_sqr(&t4, &t3);
+    secp256k1_fe_sqr(&u4, &u3);
+    secp256k1_fe_mul_int(&t4, 2);
+    secp256k1_fe_mul_int(&u4, 2);
+    secp256k1_fe_mul(&t3, &t3, &a1->x);
+    secp256k1_fe_mul(&u3, &u3, &a2->x);
+    r1->x = t3;
+    r2->x = u3;
+    secp256k1_fe_mul_int(&r1->x, 4);
+    secp256k1_fe_mul_int(&r2->x, 4);
+    secp256k1_fe_negate(&r1->x, &r1->x, 4);
+    secp256k1_fe_negate(&r2->x, &r2->x, 4);
+    secp256k1_fe_add(&r1->x, &t2);
+    secp256k1_fe_add(&r2->x, &u2);
+    secp256k1_fe_negate(&t2, &t2, 1);
+    secp256k1_fe_negate(&u2, &u2, 1);
+    secp256k1_fe_mul_int(&t3, 6);
+    secp256k1_fe_mul_int(&u3, 6);
+    secp256k1_fe_add(&t3, &t2);
+    secp256k1_fe_add(&u3, &u2);
+    secp256k1_fe_mul(&r1->y, &t1, &t3);
+    secp256k1_fe_mul(&r2->y, &u1, &u3);
+    secp256k1_fe_negate(&t2, &t4, 2);
+    secp256k1_fe_negate(&u2, &u4, 2);
+    secp256k1_fe_add(&r1->y, &t2);
+    secp256k1_fe_add(&r2->y, &u2);
+}
+
 static SECP256K1_INLINE void secp256k1_gej_double_nonzero(secp256k1_gej *r, const secp256k1_gej *a, secp256k1_fe *rzr) {
     VERIFY_CHECK(!secp256k1_gej_is_infinity(a));
     secp256k1_gej_double_var(r, a, rzr);
@@ -650,6 +798,167 @@ static void secp256k1_gej_rescale(secp256k1_gej *r, const secp256k1_fe *s) {
     secp256k1_fe_mul(&r->z, &r->z, s);                  /* r->z *= s   */
 }
 
+/** Shared body of secp256k1_gej_double_add_ge_var and secp256k1_gej_double_add_zinv_var;
+ *  bzinv == NULL means b is affine. */
+static SECP256K1_INLINE void secp256k1_gej_double_add_var_impl(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_ge *b, const secp256k1_fe *bzinv) {
+    /* Operations: 11 mul (12 with bzinv), 7 sqr, 0 normalize, 17 mul_int/add/negate.
+     * The doubling of secp256k1_gej_double_var followed by the addition of
+     * secp256k1_gej_add_ge_var/secp256k1_gej_add_zinv_var. The intermediate
+     * point is known to be finite with fixed magnitudes, so the checks and
+     * weak normalizations the addition needs on arbitrary input go away. */
+    secp256k1_gej d;
+    secp256k1_fe t1, t2, t3, t4;
+    secp256k1_fe az, z12, u2, s2, h, i, i2, h2, h3, t;
+    if (a->infinity || b->infinity) {
+        secp256k1_gej_double_var(r, a, NULL);
+        if (bzinv == NULL) {
+            secp256k1_gej_add_ge_var(r, r, b, NULL);
+        } else {
+            secp256k1_gej_add_zinv_var(r, r, b, bzinv);
+        }
+        return;
+    }
+
+    /* d = 2*a, see secp256k1_gej_double_var. */
+    secp256k1_fe_mul(&d.z, &a->z, &a->y);
+    secp256k1_fe_mul_int(&d.z, 2);        /* Z' = 2*Y*Z (2) */
+    secp256k1_fe_sqr(&t1, &a->x);
+    secp256k1_fe_mul_int(&t1, 3);         /* T1 = 3*X^2 (3) */
+    secp256k1_fe_sqr(&t2, &t1);           /* T2 = 9*X^4 (1) */
+    secp256k1_fe_sqr(&t3, &a->y);
+    secp256k1_fe_mul_int(&t3, 2);         /* T3 = 2*Y^2 (2) */
+    secp256k1_fe_sqr(&t4, &t3);
+    secp256k1_fe_mul_int(&t4, 2);         /* T4 = 8*Y^4 (2) */
+    secp256k1_fe_mul(&t3, &t3, &a->x);    /* T3 = 2*X*Y^2 (1) */
+    d.x = t3;
+    secp256k1_fe_mul_int(&d.x, 4);        /* X' = 8*X*Y^2 (4) */
+    secp256k1_fe_negate(&d.x, &d.x, 4);   /* X' = -8*X*Y^2 (5) */
+    secp256k1_fe_add(&d.x, &t2);          /* X' = 9*X^4 - 8*X*Y^2 (6) */
+    secp256k1_fe_negate(&t2, &t2, 1);     /* T2 = -9*X^4 (2) */
+    secp256k1_fe_mul_int(&t3, 6);         /* T3 = 12*X*Y^2 (6) */
+    secp256k1_fe_add(&t3, &t2);           /* T3 = 12*X*Y^2 - 9*X^4 (8) */
+    secp256k1_fe_mul(&d.y, &t1, &t3);     /* Y' = 36*X^3*Y^2 - 27*X^6 (1) */
+    secp256k1_fe_negate(&t2, &t4, 2);     /* T2 = -8*Y^4 (3) */
+    secp256k1_fe_add(&d.y, &t2);          /* Y' = 36*X^3*Y^2 - 27*X^6 - 8*Y^4 (4) */
+
+    /* r = d + b, see secp256k1_gej_add_ge_var. */
+    if (bzinv == NULL) {
+        az = d.z;
+    } else {
+        secp256k1_fe_mul(&az, &d.z, bzinv);
+    }
+    secp256k1_fe_sqr(&z12, &az);
+    secp256k1_fe_mul(&u2, &b->x, &z12);
+    secp256k1_fe_mul(&s2, &b->y, &z12); secp256k1_fe_mul(&s2, &s2, &az);
+    secp256k1_fe_negate(&h, &d.x, 6); secp256k1_fe_add(&h, &u2);        /* H (8) */
+    secp256k1_fe_negate(&i, &d.y, 4); secp256k1_fe_add(&i, &s2);        /* I (6) */
+    if (secp256k1_fe_normalizes_to_zero_var(&h)) {
+        if (secp256k1_fe_normalizes_to_zero_var(&i)) {
+            d.infinity = 0;
+            secp256k1_gej_double_var(r, &d, NULL);
+        } else {
+            secp256k1_gej_set_infinity(r);
+        }
+        return;
+    }
+    r->infinity = 0;
+    secp256k1_fe_sqr(&i2, &i);
+    secp256k1_fe_sqr(&h2, &h);
+    secp256k1_fe_mul(&h3, &h, &h2);
+    secp256k1_fe_mul(&r->z, &d.z, &h);
+    secp256k1_fe_mul(&t, &d.x, &h2);
+    r->x = t; secp256k1_fe_mul_int(&r->x, 2); secp256k1_fe_add(&r->x, &h3); secp256k1_fe_negate(&r->x, &r->x, 3); secp256k1_fe_add(&r->x, &i2);
+    secp256k1_fe_negate(&r->y, &r->x, 5); secp256k1_fe_add(&r->y, &t); secp256k1_fe_mul(&r->y, &r->y, &i);
+    secp256k1_fe_mul(&h3, &h3, &d.y); secp256k1_fe_negate(&h3, &h3, 1);
+    secp256k1_fe_add(&r->y, &h3);
+}
+
+static void secp256k1_gej_double_add_ge_var(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_ge *b) {
+    secp256k1_gej_double_add_var_impl(r, a, b, NULL);
+}
+
+static void secp256k1_gej_double_add_zinv_var(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_ge *b, const secp256k1_fe *bzinv) {
+    secp256k1_gej_double_add_var_impl(r, a, b, bzinv);
+}
+
+static void secp256k1_ge_dblu(secp256k1_ge *r, secp256k1_ge *ra, const secp256k1_ge *a, secp256k1_fe *rzr) {
+    /* Operations: 2 mul, 4 sqr, 3 normalize, 9 mul_int/add/negate.
+     * Doubling of a point with Z = 1 that also returns the input on the Z of
+     * the result (Meloni's DBLU). X1^2 and Y1^2 are shared by both. */
+    secp256k1_fe b, e, l, s, m, t;
+    VERIFY_CHECK(!a->infinity);
+
+    secp256k1_fe_sqr(&b, &a->x);            /* B = X1^2 (1) */
+    secp256k1_fe_sqr(&e, &a->y);            /* E = Y1^2 (1) */
+    secp256k1_fe_sqr(&l, &e);               /* L = Y1^4 (1) */
+    secp256k1_fe_mul(&s, &a->x, &e);
+    secp256k1_fe_mul_int(&s, 4);            /* S = 4*X1*Y1^2 (4) */
+    m = b;
+    secp256k1_fe_mul_int(&m, 3);            /* M = 3*X1^2 (3) */
+    *rzr = a->y;
+    secp256k1_fe_normalize_weak(rzr);
+    secp256k1_fe_mul_int(rzr, 2);           /* Z3 = 2*Y1 (2) */
+
+    secp256k1_fe_sqr(&r->x, &m);            /* X3 = M^2 (1) */
+    t = s;
+    secp256k1_fe_mul_int(&t, 2);            /* T = 2*S (8) */
+    secp256k1_fe_negate(&t, &t, 8);         /* T = -2*S (9) */
+    secp256k1_fe_add(&r->x, &t);            /* X3 = M^2 - 2*S (10) */
+    secp256k1_fe_normalize_weak(&r->x);     /* X3 (1) */
+    secp256k1_fe_negate(&t, &r->x, 1);      /* T = -X3 (2) */
+    secp256k1_fe_add(&t, &s);               /* T = S - X3 (6) */
+    secp256k1_fe_mul(&r->y, &t, &m);        /* Y3 = M*(S - X3) (1) */
+    secp256k1_fe_mul_int(&l, 8);            /* L = 8*Y1^4 (8) */
+    secp256k1_fe_negate(&t, &l, 8);         /* T = -8*Y1^4 (9) */
+    secp256k1_fe_add(&r->y, &t);            /* Y3 = M*(S - X3) - 8*Y1^4 (10) */
+    secp256k1_fe_normalize_weak(&r->y);     /* Y3 (1) */
+    r->infinity = 0;
+
+    /* a with Z scaled by Z3: (X1*Z3^2, Y1*Z3^3) = (S, 8*Y1^4). */
+    ra->x = s;
+    ra->y = l;
+    secp256k1_fe_normalize_weak(&ra->y);
+    ra->infinity = 0;
+}
+
+static void secp256k1_ge_zaddu_var(secp256k1_ge *r, secp256k1_ge *ra, const secp256k1_ge *a, const secp256k1_ge *b, secp256k1_fe *rzr) {
+    /* Operations: 4 mul, 2 sqr, 0 normalize, 8 add/negate.
+     * Meloni's ZADDU: as both inputs share Z, the sum is on Z*(X1 - X2) and
+     * the products needed to bring a onto that Z fall out of the addition. */
+    secp256k1_fe h, c, w1, w2, dy, d, t;
+    VERIFY_CHECK(!a->infinity);
+    VERIFY_CHECK(!b->infinity);
+
+    secp256k1_fe_negate(&h, &b->x, 5);
+    secp256k1_fe_add(&h, &a->x);            /* H = X1 - X2 (7) */
+    VERIFY_CHECK(!secp256k1_fe_normalizes_to_zero_var(&h));
+    secp256k1_fe_negate(&dy, &b->y, 3);
+    secp256k1_fe_add(&dy, &a->y);           /* DY = Y1 - Y2 (5) */
+    secp256k1_fe_sqr(&c, &h);               /* C = H^2 (1) */
+    secp256k1_fe_mul(&w1, &a->x, &c);       /* W1 = X1*H^2 (1) */
+    secp256k1_fe_mul(&w2, &b->x, &c);       /* W2 = X2*H^2 (1) */
+    secp256k1_fe_sqr(&d, &dy);              /* D = DY^2 (1) */
+    secp256k1_fe_negate(&t, &w2, 1);
+    secp256k1_fe_add(&t, &w1);              /* T = W1 - W2 = H^3 (3) */
+    secp256k1_fe_mul(&ra->y, &a->y, &t);    /* A1 = Y1*H^3 (1) */
+    secp256k1_fe_negate(&t, &w1, 1);
+    r->x = d;
+    secp256k1_fe_add(&r->x, &t);
+    secp256k1_fe_negate(&t, &w2, 1);
+    secp256k1_fe_add(&r->x, &t);            /* X3 = D - W1 - W2 (5) */
+    secp256k1_fe_negate(&t, &r->x, 5);
+    secp256k1_fe_add(&t, &w1);              /* T = W1 - X3 (7) */
+    secp256k1_fe_mul(&r->y, &dy, &t);
+    secp256k1_fe_negate(&t, &ra->y, 1);
+    secp256k1_fe_add(&r->y, &t);            /* Y3 = DY*(W1 - X3) - A1 (3) */
+    r->infinity = 0;
+
+    ra->x = w1;
+    ra->infinity = 0;
+    *rzr = h;
+    secp256k1_fe_normalize_weak(rzr);
+}
+
 static void secp256k1_ge_to_storage(secp256k1_ge_storage *r, const secp256k1_ge *a) {
     secp256k1_fe x, y;
     VERIFY_CHECK(!a->infinity);
@@ -672,6 +981,78 @@ static SECP256K1_INLINE void secp256k1_ge_storage_cmov(secp256k1_ge_storage *r,
     secp256k1_fe_storage_cmov(&r->y, &a->y, flag);
 }
 
+static void secp256k1_ge_storage_table_get_portable(secp256k1_ge_storage *r, const secp256k1_ge_storage *table, int n, int idx) {
+    int i;
+    *r = table[0];
+    for (i = 1; i < n; i++) {
+        secp256k1_ge_storage_cmov(r, &table[i], i == idx);
+    }
+}
+
+/* The vector versions below mask and OR together whole 64-byte entries,
+ * comparing the index in vector registers as well, rather than moving one
+ * limb at a time. */
+#if defined(__SSE2__)
+static void secp256k1_ge_storage_table_get_sse2(secp256k1_ge_storage *r, const secp256k1_ge_storage *table, int n, int idx) {
+    const __m128i vidx = _mm_set1_epi32(idx);
+    __m128i r0 = _mm_setzero_si128(), r1 = _mm_setzero_si128();
+    __m128i r2 = _mm_setzero_si128(), r3 = _mm_setzero_si128();
+    int i;
+    for (i = 0; i < n; i++) {
+        const __m128i *p = (const __m128i *)&table[i];
+        const __m128i mask = _mm_cmpeq_epi32(_mm_set1_epi32(i), vidx);
+        r0 = _mm_or_si128(r0, _mm_and_si128(mask, _mm_loadu_si128(p)));
+        r1 = _mm_or_si128(r1, _mm_and_si128(mask, _mm_loadu_si128(p + 1)));
+        r2 = _mm_or_si128(r2, _mm_and_si128(mask, _mm_loadu_si128(p + 2)));
+        r3 = _mm_or_si128(r3, _mm_and_si128(mask, _mm_loadu_si128(p + 3)));
+    }
+    _mm_storeu_si128((__m128i *)r, r0);
+    _mm_storeu_si128((__m128i *)r + 1, r1);
+    _mm_storeu_si128((__m128i *)r + 2, r2);
+    _mm_storeu_si128((__m128i *)r + 3, r3);
+}
+#endif
+
+#if defined(HAVE_AVX2_DISPATCH)
+__attribute__((target("avx2")))
+static void secp256k1_ge_storage_table_get_avx2(secp256k1_ge_storage *r, const secp256k1_ge_storage *table, int n, int idx) {
+    const __m256i vidx = _mm256_set1_epi32(idx);
+    __m256i r0 = _mm256_setzero_si256(), r1 = _mm256_setzero_si256();
+    int i;
+    for (i = 0; i < n; i++) {
+        const __m256i *p = (const __m256i *)&table[i];
+        const __m256i mask = _mm256_cmpeq_epi32(_mm256_set1_epi32(i), vidx);
+        r0 = _mm256_or_si256(r0, _mm256_and_si256(mask, _mm256_loadu_si256(p)));
+        r1 = _mm256_or_si256(r1, _mm256_and_si256(mask, _mm256_loadu_si256(p + 1)));
+    }
+    _mm256_storeu_si256((__m256i *)r, r0);
+    _mm256_storeu_si256((__m256i *)r + 1, r1);
+}
+#endif
+
+static void secp256k1_ge_storage_table_get(secp256k1_ge_storage *r, const secp256k1_ge_storage *table, int n, int idx) {
+    VERIFY_CHECK(n > 0);
+    VERIFY_CHECK(idx >= 0 && idx < n);
+#if defined(HAVE_AVX2_DISPATCH)
+    if (__builtin_cpu_supports("avx2")) {
+        secp256k1_ge_storage_table_get_avx2(r, table, n, idx);
+        return;
+    }
+#endif
+#if defined(__SSE2__)
+    secp256k1_ge_storage_table_get_sse2(r, table, n, idx);
+#else
+    secp256k1_ge_storage_table_get_portable(r, table, n, idx);
+#endif
+}
+
+static SECP256K1_INLINE void secp256k1_gej_cmov(secp256k1_gej *r, const secp256k1_gej *a, int flag) {
+    secp256k1_fe_cmov(&r->x, &a->x, flag);
+    secp256k1_fe_cmov(&r->y, &a->y, flag);
+    secp256k1_fe_cmov(&r->z, &a->z, flag);
+    r->infinity ^= (r->infinity ^ a->infinity) & flag;
+}
+
 #ifdef USE_ENDOMORPHISM
 static void secp256k1_ge_mul_lambda(secp256k1_ge *r, const secp256k1_ge *a) {
     static const secp256k1_fe beta = SECP256K1_FE_CONST(
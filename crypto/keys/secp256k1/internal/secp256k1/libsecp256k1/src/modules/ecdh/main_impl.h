@@ -10,12 +10,35 @@
 #include "include/secp256k1_ecdh.h"
 #include "ecmult_const_impl.h"
 
+/** Most shared secrets secp256k1_ecdh_batch computes at once. */
+#define SECP256K1_ECDH_BATCH 32
+
+/** Set result to the SHA256 hash of pt in compressed form, the ECDH secret. */
+static void secp256k1_ecdh_hash_point(unsigned char *result, secp256k1_ge *pt) {
+    unsigned char x[32];
+    unsigned char y[1];
+    secp256k1_sha256_t sha;
+
+    /* Note we cannot use secp256k1_eckey_pubkey_serialize here since it does not
+     * expect its output to be secret and has a timing sidechannel. */
+    secp256k1_fe_normalize(&pt->x);
+    secp256k1_fe_normalize(&pt->y);
+    secp256k1_fe_get_b32(x, &pt->x);
+    y[0] = 0x02 | secp256k1_fe_is_odd(&pt->y);
+
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, y, sizeof(y));
+    secp256k1_sha256_write(&sha, x, sizeof(x));
+    secp256k1_sha256_finalize(&sha, result);
+}
+
 int secp256k1_ecdh(const secp256k1_context* ctx, unsigned char *result, const secp256k1_pubkey *point, const unsigned char *scalar) {
     int ret = 0;
     int overflow = 0;
     secp256k1_gej res;
     secp256k1_ge pt;
     secp256k1_scalar s;
+    SECP256K1_TRACE_ENTRY(ecdh, ctx, 0);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(result != NULL);
     ARG_CHECK(point != NULL);
@@ -26,28 +49,144 @@ int secp256k1_ecdh(const secp256k1_context* ctx, unsigned char *result, const se
     if (overflow || secp256k1_scalar_is_zero(&s)) {
         ret = 0;
     } else {
-        unsigned char x[32];
-        unsigned char y[1];
-        secp256k1_sha256_t sha;
-
         secp256k1_ecmult_const(&res, &pt, &s);
         secp256k1_ge_set_gej(&pt, &res);
-        /* Compute a hash of the point in compressed form
-         * Note we cannot use secp256k1_eckey_pubkey_serialize here since it does not
-         * expect its output to be secret and has a timing sidechannel. */
-        secp256k1_fe_normalize(&pt.x);
-        secp256k1_fe_normalize(&pt.y);
-        secp256k1_fe_get_b32(x, &pt.x);
-        y[0] = 0x02 | secp256k1_fe_is_odd(&pt.y);
-
-        secp256k1_sha256_initialize(&sha);
-        secp256k1_sha256_write(&sha, y, sizeof(y));
-        secp256k1_sha256_write(&sha, x, sizeof(x));
-        secp256k1_sha256_finalize(&sha, result);
+        secp256k1_ecdh_hash_point(result, &pt);
         ret = 1;
     }
 
     secp256k1_scalar_clear(&s);
+    SECP256K1_TRACE_RETURN(ecdh, ret);
+    return ret;
+}
+
+int secp256k1_ecdh_batch(const secp256k1_context* ctx, unsigned char *results, const secp256k1_pubkey *pubkeys, size_t n, const unsigned char *privkey) {
+    int ret = 0;
+    int overflow = 0;
+    int ok[SECP256K1_ECDH_BATCH];
+    secp256k1_gej res[SECP256K1_ECDH_BATCH];
+    secp256k1_fe z[SECP256K1_ECDH_BATCH];
+    secp256k1_fe zi[SECP256K1_ECDH_BATCH];
+    secp256k1_ecmult_const_recoding rec;
+    secp256k1_fe blind;
+    secp256k1_ge pt;
+    secp256k1_scalar s;
+    size_t i, j;
+    SECP256K1_TRACE_ENTRY(ecdh_batch, ctx, n);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(results != NULL);
+    ARG_CHECK(pubkeys != NULL);
+    ARG_CHECK(privkey != NULL);
+
+    secp256k1_scalar_set_b32(&s, privkey, &overflow);
+    if (overflow || secp256k1_scalar_is_zero(&s)) {
+        memset(results, 0, 32 * n);
+    } else {
+        ret = 1;
+        secp256k1_ecmult_const_recode(&rec, &s);
+        for (i = 0; i < n; i += SECP256K1_ECDH_BATCH) {
+            size_t len = n - i < SECP256K1_ECDH_BATCH ? n - i : SECP256K1_ECDH_BATCH;
+            unsigned char buf[32];
+            secp256k1_sha256_t sha;
+
+            for (j = 0; j < len; j++) {
+                ok[j] = secp256k1_pubkey_load(ctx, &pt, &pubkeys[i + j]);
+                if (!ok[j]) {
+                    /* Keep the chunk's inversion well-defined; the output is zeroed below. */
+                    pt = secp256k1_ge_const_g;
+                }
+                secp256k1_ecmult_const_recoded(&res[j], &pt, &rec);
+                z[j] = res[j].z;
+            }
+
+            /* The scalar is nonzero, so no result is infinity and no z is zero. The
+             * product that gets inverted is blinded by a secret derived from the
+             * key and the first z, which cancels out of the first inverse. */
+            secp256k1_fe_normalize(&z[0]);
+            secp256k1_fe_get_b32(buf, &z[0]);
+            secp256k1_sha256_initialize(&sha);
+            secp256k1_sha256_write(&sha, privkey, 32);
+            secp256k1_sha256_write(&sha, buf, 32);
+            secp256k1_sha256_finalize(&sha, buf);
+            if (!secp256k1_fe_set_b32(&blind, buf) || secp256k1_fe_is_zero(&blind)) {
+                secp256k1_fe_set_int(&blind, 1);
+            }
+            secp256k1_fe_mul(&z[0], &z[0], &blind);
+            secp256k1_fe_inv_all(zi, z, len);
+            secp256k1_fe_mul(&zi[0], &zi[0], &blind);
+
+            for (j = 0; j < len; j++) {
+                if (ok[j]) {
+                    secp256k1_ge_set_gej_zinv(&pt, &res[j], &zi[j]);
+                    secp256k1_ecdh_hash_point(&results[32 * (i + j)], &pt);
+                } else {
+                    memset(&results[32 * (i + j)], 0, 32);
+                    ret = 0;
+                }
+            }
+            memset(buf, 0, sizeof(buf));
+        }
+    }
+
+    secp256k1_scalar_clear(&s);
+    secp256k1_ge_clear(&pt);
+    secp256k1_fe_clear(&blind);
+    memset(&rec, 0, sizeof(rec));
+    memset(res, 0, sizeof(res));
+    memset(z, 0, sizeof(z));
+    memset(zi, 0, sizeof(zi));
+    SECP256K1_TRACE_RETURN(ecdh_batch, ret);
+    return ret;
+}
+
+int secp256k1_ecdh_precomp(const secp256k1_context* ctx, unsigned char *result, const secp256k1_point_precomp *precomp, const unsigned char *privkey) {
+    int ret = 0;
+    int overflow = 0;
+    secp256k1_gej res;
+    secp256k1_ge pt;
+    secp256k1_scalar s;
+    SECP256K1_TRACE_ENTRY(ecdh_precomp, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(result != NULL);
+    ARG_CHECK(precomp != NULL);
+    ARG_CHECK(privkey != NULL);
+
+    secp256k1_scalar_set_b32(&s, privkey, &overflow);
+    if (!overflow && !secp256k1_scalar_is_zero(&s)) {
+        secp256k1_ecmult_const_precomp(&res, precomp->prec, &s);
+        secp256k1_ge_set_gej(&pt, &res);
+        secp256k1_ecdh_hash_point(result, &pt);
+        ret = 1;
+    }
+
+    secp256k1_scalar_clear(&s);
+    SECP256K1_TRACE_RETURN(ecdh_precomp, ret);
+    return ret;
+}
+
+int secp256k1_ecdh_xonly(const secp256k1_context* ctx, unsigned char *output32, const unsigned char *input32, const unsigned char *privkey) {
+    int ret = 0;
+    int overflow = 0;
+    secp256k1_fe x;
+    secp256k1_scalar s;
+    SECP256K1_TRACE_ENTRY(ecdh_xonly, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(output32 != NULL);
+    ARG_CHECK(input32 != NULL);
+    ARG_CHECK(privkey != NULL);
+
+    secp256k1_scalar_set_b32(&s, privkey, &overflow);
+    if (!overflow && !secp256k1_scalar_is_zero(&s) && secp256k1_fe_set_b32(&x, input32)) {
+        ret = secp256k1_ecmult_const_xonly(&x, &x, &s, 0);
+    }
+    if (ret) {
+        secp256k1_fe_get_b32(output32, &x);
+    } else {
+        memset(output32, 0, 32);
+    }
+
+    secp256k1_scalar_clear(&s);
+    SECP256K1_TRACE_RETURN(ecdh_xonly, ret);
     return ret;
 }
 
@@ -31,6 +31,20 @@ void test_ecdh_api(void) {
     CHECK(ecount == 3);
     CHECK(secp256k1_ecdh(tctx, res, &point, s_one) == 1);
     CHECK(ecount == 3);
+    CHECK(secp256k1_ecdh_xonly(tctx, NULL, res, s_one) == 0);
+    CHECK(ecount == 4);
+    CHECK(secp256k1_ecdh_xonly(tctx, res, NULL, s_one) == 0);
+    CHECK(ecount == 5);
+    CHECK(secp256k1_ecdh_xonly(tctx, res, res, NULL) == 0);
+    CHECK(ecount == 6);
+    CHECK(secp256k1_ecdh_batch(tctx, res, &point, 1, s_one) == 1);
+    CHECK(ecount == 6);
+    CHECK(secp256k1_ecdh_batch(tctx, NULL, &point, 1, s_one) == 0);
+    CHECK(ecount == 7);
+    CHECK(secp256k1_ecdh_batch(tctx, res, NULL, 1, s_one) == 0);
+    CHECK(ecount == 8);
+    CHECK(secp256k1_ecdh_batch(tctx, res, &point, 1, NULL) == 0);
+    CHECK(ecount == 9);
 
     /* Cleanup */
     secp256k1_context_destroy(tctx);
@@ -96,10 +110,139 @@ void test_bad_scalar(void) {
     CHECK(secp256k1_ecdh(ctx, output, &point, s_overflow) == 1);
 }
 
+void test_ecdh_xonly(void) {
+    unsigned char s_b32[2][32];
+    unsigned char point_ser[2][33];
+    unsigned char output[2][32];
+    unsigned char bad_x[32];
+    secp256k1_pubkey point[2];
+    secp256k1_scalar s;
+    size_t len;
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        random_scalar_order(&s);
+        secp256k1_scalar_get_b32(s_b32[i], &s);
+        CHECK(secp256k1_ec_pubkey_create(ctx, &point[i], s_b32[i]) == 1);
+        len = sizeof(point_ser[i]);
+        CHECK(secp256k1_ec_pubkey_serialize(ctx, point_ser[i], &len, &point[i], SECP256K1_EC_COMPRESSED) == 1);
+    }
+
+    /* Both sides get the same X, which is that of the shared point. */
+    CHECK(secp256k1_ecdh_xonly(ctx, output[0], point_ser[1] + 1, s_b32[0]) == 1);
+    CHECK(secp256k1_ecdh_xonly(ctx, output[1], point_ser[0] + 1, s_b32[1]) == 1);
+    CHECK(memcmp(output[0], output[1], 32) == 0);
+    CHECK(secp256k1_ec_pubkey_tweak_mul(ctx, &point[1], s_b32[0]) == 1);
+    len = sizeof(point_ser[1]);
+    CHECK(secp256k1_ec_pubkey_serialize(ctx, point_ser[1], &len, &point[1], SECP256K1_EC_COMPRESSED) == 1);
+    CHECK(memcmp(output[0], point_ser[1] + 1, 32) == 0);
+
+    /* X coordinates off the curve, or not below p, are refused. */
+    memset(bad_x, 0, 32);
+    bad_x[31] = 5;
+    CHECK(secp256k1_ecdh_xonly(ctx, output[0], bad_x, s_b32[0]) == 0);
+    memset(bad_x, 0xFF, 32);
+    CHECK(secp256k1_ecdh_xonly(ctx, output[0], bad_x, s_b32[0]) == 0);
+    memset(s_b32[0], 0, 32);
+    CHECK(secp256k1_ecdh_xonly(ctx, output[0], point_ser[0] + 1, s_b32[0]) == 0);
+}
+
+void test_ecdh_batch(void) {
+    secp256k1_pubkey pubkeys[2 * SECP256K1_ECDH_BATCH + 3];
+    unsigned char results[32 * (2 * SECP256K1_ECDH_BATCH + 3)];
+    unsigned char single[32];
+    unsigned char s_b32[32];
+    unsigned char zeros[32] = { 0 };
+    size_t n = secp256k1_rand_int(sizeof(pubkeys) / sizeof(pubkeys[0]) + 1);
+    size_t i, bad;
+    int32_t ecount = 0;
+    secp256k1_scalar s;
+
+    for (i = 0; i < n; i++) {
+        random_scalar_order(&s);
+        secp256k1_scalar_get_b32(s_b32, &s);
+        CHECK(secp256k1_ec_pubkey_create(ctx, &pubkeys[i], s_b32) == 1);
+    }
+    random_scalar_order(&s);
+    secp256k1_scalar_get_b32(s_b32, &s);
+
+    /* Every secret is the one secp256k1_ecdh gives, across chunk boundaries. */
+    CHECK(secp256k1_ecdh_batch(ctx, results, pubkeys, n, s_b32) == 1);
+    for (i = 0; i < n; i++) {
+        CHECK(secp256k1_ecdh(ctx, single, &pubkeys[i], s_b32) == 1);
+        CHECK(memcmp(single, &results[32 * i], 32) == 0);
+    }
+
+    /* An invalid public key zeroes its own secret only. */
+    if (n > 0) {
+        bad = secp256k1_rand_int(n);
+        memset(&pubkeys[bad], 0, sizeof(pubkeys[bad]));
+        secp256k1_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+        CHECK(secp256k1_ecdh_batch(ctx, results, pubkeys, n, s_b32) == 0);
+        CHECK(ecount == 1);
+        secp256k1_context_set_illegal_callback(ctx, NULL, NULL);
+        for (i = 0; i < n; i++) {
+            if (i == bad) {
+                CHECK(memcmp(zeros, &results[32 * i], 32) == 0);
+            } else {
+                CHECK(secp256k1_ecdh(ctx, single, &pubkeys[i], s_b32) == 1);
+                CHECK(memcmp(single, &results[32 * i], 32) == 0);
+            }
+        }
+    }
+
+    /* A zero or overflowing scalar zeroes all of them. */
+    memset(s_b32, 0, sizeof(s_b32));
+    CHECK(secp256k1_ecdh_batch(ctx, results, pubkeys, n, s_b32) == 0);
+    memset(s_b32, 0xFF, sizeof(s_b32));
+    CHECK(secp256k1_ecdh_batch(ctx, results, pubkeys, n, s_b32) == 0);
+    for (i = 0; i < n; i++) {
+        CHECK(memcmp(zeros, &results[32 * i], 32) == 0);
+    }
+}
+
+void test_ecdh_precomp(void) {
+    secp256k1_point_precomp *precomp;
+    secp256k1_pubkey point;
+    unsigned char s_b32[32];
+    unsigned char out[32], expected[32];
+    int32_t ecount = 0;
+    secp256k1_scalar s;
+    int i;
+
+    random_scalar_order(&s);
+    secp256k1_scalar_get_b32(s_b32, &s);
+    CHECK(secp256k1_ec_pubkey_create(ctx, &point, s_b32) == 1);
+    precomp = secp256k1_point_precomp_create(ctx, &point);
+    CHECK(precomp != NULL);
+    for (i = 0; i < count; i++) {
+        random_scalar_order(&s);
+        secp256k1_scalar_get_b32(s_b32, &s);
+        CHECK(secp256k1_ecdh(ctx, expected, &point, s_b32) == 1);
+        CHECK(secp256k1_ecdh_precomp(ctx, out, precomp, s_b32) == 1);
+        CHECK(memcmp(out, expected, sizeof(out)) == 0);
+    }
+    memset(s_b32, 0, sizeof(s_b32));
+    CHECK(secp256k1_ecdh_precomp(ctx, out, precomp, s_b32) == 0);
+
+    secp256k1_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    CHECK(secp256k1_ecdh_precomp(ctx, NULL, precomp, s_b32) == 0);
+    CHECK(ecount == 1);
+    CHECK(secp256k1_ecdh_precomp(ctx, out, NULL, s_b32) == 0);
+    CHECK(ecount == 2);
+    CHECK(secp256k1_ecdh_precomp(ctx, out, precomp, NULL) == 0);
+    CHECK(ecount == 3);
+    secp256k1_context_set_illegal_callback(ctx, NULL, NULL);
+    secp256k1_point_precomp_destroy(precomp);
+}
+
 void run_ecdh_tests(void) {
     test_ecdh_api();
     test_ecdh_generator_basepoint();
     test_bad_scalar();
+    test_ecdh_xonly();
+    test_ecdh_batch();
+    test_ecdh_precomp();
 }
 
 #endif
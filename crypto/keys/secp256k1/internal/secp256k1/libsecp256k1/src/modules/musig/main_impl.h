@@ -0,0 +1,676 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_MUSIG_MAIN_
+#define _SECP256K1_MODULE_MUSIG_MAIN_
+
+#include "include/secp256k1_musig.h"
+#include "modules/schnorrsig/main_impl.h"
+#include "hash_impl.h"
+
+/* The first four bytes of each structure of this module say what it holds, so
+ * that one which was never filled in, or was cleared after use, is caught. */
+static const unsigned char secp256k1_musig_keyagg_cache_magic[4] = { 0xf4, 0xad, 0xbb, 0xdf };
+static const unsigned char secp256k1_musig_secnonce_magic[4] = { 0x22, 0x0e, 0xdc, 0xf1 };
+static const unsigned char secp256k1_musig_pubnonce_magic[4] = { 0xf5, 0x7a, 0x3d, 0xa0 };
+static const unsigned char secp256k1_musig_aggnonce_magic[4] = { 0xa8, 0xb7, 0xe4, 0x67 };
+static const unsigned char secp256k1_musig_session_magic[4] = { 0x9d, 0xed, 0xe9, 0x17 };
+static const unsigned char secp256k1_musig_partial_sig_magic[4] = { 0xeb, 0xfb, 0x1a, 0x32 };
+
+/* The states of SHA256 after it has consumed SHA256(tag) || SHA256(tag), for
+ * the tags of the BIP327 tagged hashes. */
+static const uint32_t secp256k1_musig_midstate_keyagg_list[8] = {
+    0xb399d5e0ul, 0xc8fff302ul, 0x6badac71ul, 0x07c5b7f1ul,
+    0x9701e2eful, 0x2a72ecf8ul, 0x201a4c7bul, 0xab148a38ul
+};
+
+static const uint32_t secp256k1_musig_midstate_keyagg_coef[8] = {
+    0x6ef02c5aul, 0x06a480deul, 0x1f298665ul, 0x1d1134f2ul,
+    0x56a0b063ul, 0x52da4147ul, 0xf280d9d4ul, 0x4484be15ul
+};
+
+static const uint32_t secp256k1_musig_midstate_aux[8] = {
+    0xa19e884bul, 0xf463fe7eul, 0x2f18f9a2ul, 0xbeb0f9fful,
+    0x0f37e8b0ul, 0x06ebd26ful, 0xe3b243d2ul, 0x522fb150ul
+};
+
+static const uint32_t secp256k1_musig_midstate_nonce[8] = {
+    0x07101b64ul, 0x18003414ul, 0x0391bc43ul, 0x0e6258eeul,
+    0x29d26b72ul, 0x8343937eul, 0xb7a0a4fbul, 0xff568a30ul
+};
+
+static const uint32_t secp256k1_musig_midstate_noncecoef[8] = {
+    0x2c7d5a45ul, 0x06bf7e53ul, 0x89be68a6ul, 0x971254c0ul,
+    0x60ac12d2ul, 0x72846dcdul, 0x6c81212ful, 0xde7a2500ul
+};
+
+/** What secp256k1_musig_keyagg_cache holds. */
+typedef struct {
+    secp256k1_ge pk;                /* the aggregated key, with its real Y */
+    unsigned char pk_hash[32];      /* hash_KeyAgg list of all keys */
+    unsigned char second_pk[33];    /* the first key unlike the first one, or zeros */
+} secp256k1_musig_keyagg;
+
+/* Points are stored as X || Y, with the point at infinity as 64 zero bytes. */
+static void secp256k1_musig_ge_save(unsigned char *data, secp256k1_ge *ge) {
+    if (secp256k1_ge_is_infinity(ge)) {
+        memset(data, 0, 64);
+    } else {
+        secp256k1_fe_normalize_var(&ge->x);
+        secp256k1_fe_normalize_var(&ge->y);
+        secp256k1_fe_get_b32(data, &ge->x);
+        secp256k1_fe_get_b32(data + 32, &ge->y);
+    }
+}
+
+static void secp256k1_musig_ge_load(secp256k1_ge *ge, const unsigned char *data) {
+    secp256k1_fe x, y;
+    secp256k1_fe_set_b32(&x, data);
+    secp256k1_fe_set_b32(&y, data + 32);
+    secp256k1_ge_set_xy(ge, &x, &y);
+    ge->infinity = secp256k1_fe_is_zero(&x) && secp256k1_fe_is_zero(&y);
+}
+
+/* Serialize a point in compressed form, or the point at infinity as 33 zero
+ * bytes. */
+static void secp256k1_musig_ge_serialize_ext(unsigned char *out33, secp256k1_ge *ge) {
+    size_t size = 33;
+    if (secp256k1_ge_is_infinity(ge)) {
+        memset(out33, 0, 33);
+    } else {
+        secp256k1_eckey_pubkey_serialize(ge, out33, &size, 1);
+    }
+}
+
+static void secp256k1_musig_keyagg_cache_save(secp256k1_musig_keyagg_cache *cache, secp256k1_musig_keyagg *ka) {
+    memcpy(cache->data, secp256k1_musig_keyagg_cache_magic, 4);
+    secp256k1_musig_ge_save(cache->data + 4, &ka->pk);
+    memcpy(cache->data + 68, ka->pk_hash, 32);
+    memcpy(cache->data + 100, ka->second_pk, 33);
+}
+
+static int secp256k1_musig_keyagg_cache_load(const secp256k1_context* ctx, secp256k1_musig_keyagg *ka, const secp256k1_musig_keyagg_cache *cache) {
+    ARG_CHECK(memcmp(cache->data, secp256k1_musig_keyagg_cache_magic, 4) == 0);
+    secp256k1_musig_ge_load(&ka->pk, cache->data + 4);
+    memcpy(ka->pk_hash, cache->data + 68, 32);
+    memcpy(ka->second_pk, cache->data + 100, 33);
+    return 1;
+}
+
+/** a = 1 for the second distinct key, and
+ *  int(hash_KeyAgg coefficient(pk_hash || pk33)) mod n for the others. */
+static void secp256k1_musig_keyaggcoef(secp256k1_scalar *a, const secp256k1_musig_keyagg *ka, const unsigned char *pk33) {
+    secp256k1_sha256_t sha;
+    unsigned char buf[32];
+
+    if (memcmp(pk33, ka->second_pk, 33) == 0) {
+        secp256k1_scalar_set_int(a, 1);
+    } else {
+        secp256k1_schnorrsig_sha256_tagged(&sha, secp256k1_musig_midstate_keyagg_coef);
+        secp256k1_sha256_write(&sha, ka->pk_hash, 32);
+        secp256k1_sha256_write(&sha, pk33, 33);
+        secp256k1_sha256_finalize(&sha, buf);
+        secp256k1_scalar_set_b32(a, buf, NULL);
+    }
+}
+
+/* A secret nonce is k1 || k2 || the signer's public key; a public or an
+ * aggregate nonce is R1 || R2. */
+static void secp256k1_musig_nonce_save(unsigned char *data, const unsigned char *magic, secp256k1_ge *r) {
+    memcpy(data, magic, 4);
+    secp256k1_musig_ge_save(data + 4, &r[0]);
+    secp256k1_musig_ge_save(data + 68, &r[1]);
+}
+
+static int secp256k1_musig_nonce_load(const secp256k1_context* ctx, secp256k1_ge *r, const unsigned char *data, const unsigned char *magic) {
+    ARG_CHECK(memcmp(data, magic, 4) == 0);
+    secp256k1_musig_ge_load(&r[0], data + 4);
+    secp256k1_musig_ge_load(&r[1], data + 68);
+    return 1;
+}
+
+/* A session is the parity of the final nonce R || R.x || b || e. */
+static int secp256k1_musig_session_load(const secp256k1_context* ctx, int *r_odd, unsigned char *rx, secp256k1_scalar *b, secp256k1_scalar *e, const secp256k1_musig_session *session) {
+    ARG_CHECK(memcmp(session->data, secp256k1_musig_session_magic, 4) == 0);
+    *r_odd = session->data[4];
+    memcpy(rx, session->data + 5, 32);
+    secp256k1_scalar_set_b32(b, session->data + 37, NULL);
+    secp256k1_scalar_set_b32(e, session->data + 69, NULL);
+    return 1;
+}
+
+static int secp256k1_musig_partial_sig_load(const secp256k1_context* ctx, secp256k1_scalar *s, const secp256k1_musig_partial_sig *sig) {
+    ARG_CHECK(memcmp(sig->data, secp256k1_musig_partial_sig_magic, 4) == 0);
+    secp256k1_scalar_set_b32(s, sig->data + 4, NULL);
+    return 1;
+}
+
+int secp256k1_musig_pubnonce_parse(const secp256k1_context* ctx, secp256k1_musig_pubnonce* nonce, const unsigned char *in66) {
+    secp256k1_ge r[2];
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(musig_pubnonce_parse, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(nonce != NULL);
+    memset(nonce, 0, sizeof(*nonce));
+    ARG_CHECK(in66 != NULL);
+
+    if (secp256k1_eckey_pubkey_parse(&r[0], in66, 33) && secp256k1_eckey_pubkey_parse(&r[1], in66 + 33, 33)) {
+        secp256k1_musig_nonce_save(nonce->data, secp256k1_musig_pubnonce_magic, r);
+        ret = 1;
+    }
+    SECP256K1_TRACE_RETURN(musig_pubnonce_parse, ret);
+    return ret;
+}
+
+int secp256k1_musig_pubnonce_serialize(const secp256k1_context* ctx, unsigned char *out66, const secp256k1_musig_pubnonce* nonce) {
+    secp256k1_ge r[2];
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(musig_pubnonce_serialize, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(out66 != NULL);
+    memset(out66, 0, 66);
+    ARG_CHECK(nonce != NULL);
+
+    if (secp256k1_musig_nonce_load(ctx, r, nonce->data, secp256k1_musig_pubnonce_magic)) {
+        secp256k1_musig_ge_serialize_ext(out66, &r[0]);
+        secp256k1_musig_ge_serialize_ext(out66 + 33, &r[1]);
+        ret = 1;
+    }
+    SECP256K1_TRACE_RETURN(musig_pubnonce_serialize, ret);
+    return ret;
+}
+
+int secp256k1_musig_aggnonce_parse(const secp256k1_context* ctx, secp256k1_musig_aggnonce* nonce, const unsigned char *in66) {
+    static const unsigned char zero33[33] = { 0 };
+    secp256k1_ge r[2];
+    int i;
+    int ret = 1;
+    SECP256K1_TRACE_ENTRY(musig_aggnonce_parse, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(nonce != NULL);
+    memset(nonce, 0, sizeof(*nonce));
+    ARG_CHECK(in66 != NULL);
+
+    for (i = 0; i < 2; i++) {
+        if (memcmp(in66 + 33 * i, zero33, 33) == 0) {
+            r[i].infinity = 1;
+        } else {
+            ret &= secp256k1_eckey_pubkey_parse(&r[i], in66 + 33 * i, 33);
+        }
+    }
+    if (ret) {
+        secp256k1_musig_nonce_save(nonce->data, secp256k1_musig_aggnonce_magic, r);
+    }
+    SECP256K1_TRACE_RETURN(musig_aggnonce_parse, ret);
+    return ret;
+}
+
+int secp256k1_musig_aggnonce_serialize(const secp256k1_context* ctx, unsigned char *out66, const secp256k1_musig_aggnonce* nonce) {
+    secp256k1_ge r[2];
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(musig_aggnonce_serialize, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(out66 != NULL);
+    memset(out66, 0, 66);
+    ARG_CHECK(nonce != NULL);
+
+    if (secp256k1_musig_nonce_load(ctx, r, nonce->data, secp256k1_musig_aggnonce_magic)) {
+        secp256k1_musig_ge_serialize_ext(out66, &r[0]);
+        secp256k1_musig_ge_serialize_ext(out66 + 33, &r[1]);
+        ret = 1;
+    }
+    SECP256K1_TRACE_RETURN(musig_aggnonce_serialize, ret);
+    return ret;
+}
+
+int secp256k1_musig_partial_sig_parse(const secp256k1_context* ctx, secp256k1_musig_partial_sig* sig, const unsigned char *in32) {
+    secp256k1_scalar s;
+    int overflow;
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(musig_partial_sig_parse, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(sig != NULL);
+    memset(sig, 0, sizeof(*sig));
+    ARG_CHECK(in32 != NULL);
+
+    secp256k1_scalar_set_b32(&s, in32, &overflow);
+    if (!overflow) {
+        memcpy(sig->data, secp256k1_musig_partial_sig_magic, 4);
+        secp256k1_scalar_get_b32(sig->data + 4, &s);
+        ret = 1;
+    }
+    SECP256K1_TRACE_RETURN(musig_partial_sig_parse, ret);
+    return ret;
+}
+
+int secp256k1_musig_partial_sig_serialize(const secp256k1_context* ctx, unsigned char *out32, const secp256k1_musig_partial_sig* sig) {
+    int ret;
+    SECP256K1_TRACE_ENTRY(musig_partial_sig_serialize, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(out32 != NULL);
+    ARG_CHECK(sig != NULL);
+    ARG_CHECK(memcmp(sig->data, secp256k1_musig_partial_sig_magic, 4) == 0);
+
+    memcpy(out32, sig->data + 4, 32);
+    ret = 1;
+    SECP256K1_TRACE_RETURN(musig_partial_sig_serialize, ret);
+    return ret;
+}
+
+int secp256k1_musig_pubkey_agg(const secp256k1_context* ctx, secp256k1_xonly_pubkey *agg_pk, secp256k1_musig_keyagg_cache *keyagg_cache, const secp256k1_pubkey * const* pubkeys, size_t n) {
+    secp256k1_musig_keyagg ka;
+    secp256k1_ge *pts;
+    secp256k1_scalar *sc;
+    secp256k1_scalar zero;
+    secp256k1_gej qj;
+    secp256k1_sha256_t sha;
+    unsigned char *ser;
+    size_t size;
+    size_t i;
+    int ret;
+    SECP256K1_TRACE_ENTRY(musig_pubkey_agg, ctx, n);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
+    if (agg_pk != NULL) {
+        memset(agg_pk, 0, sizeof(*agg_pk));
+    }
+    if (keyagg_cache != NULL) {
+        memset(keyagg_cache, 0, sizeof(*keyagg_cache));
+    }
+    ARG_CHECK(pubkeys != NULL);
+    ARG_CHECK(n > 0);
+
+    pts = (secp256k1_ge *)checked_malloc(&ctx->error_callback, n * sizeof(secp256k1_ge));
+    sc = (secp256k1_scalar *)checked_malloc(&ctx->error_callback, n * sizeof(secp256k1_scalar));
+    ser = (unsigned char *)checked_malloc(&ctx->error_callback, n * 33);
+    /* Zero if an allocation failed and the error callback returned. */
+    ret = pts != NULL && sc != NULL && ser != NULL;
+
+    /* pk_hash = hash_KeyAgg list(pk_1 || ... || pk_n) */
+    secp256k1_schnorrsig_sha256_tagged(&sha, secp256k1_musig_midstate_keyagg_list);
+    for (i = 0; ret && i < n; i++) {
+        size = 33;
+        ret = secp256k1_pubkey_load(ctx, &pts[i], pubkeys[i]) &&
+              secp256k1_eckey_pubkey_serialize(&pts[i], ser + 33 * i, &size, 1);
+        if (ret) {
+            secp256k1_sha256_write(&sha, ser + 33 * i, 33);
+        }
+    }
+    if (ret) {
+        secp256k1_sha256_finalize(&sha, ka.pk_hash);
+        memset(ka.second_pk, 0, 33);
+        for (i = 1; i < n; i++) {
+            if (memcmp(ser + 33 * i, ser, 33) != 0) {
+                memcpy(ka.second_pk, ser + 33 * i, 33);
+                break;
+            }
+        }
+
+        /* Q = sum(a_i*P_i), in one multi-multiplication */
+        for (i = 0; i < n; i++) {
+            secp256k1_musig_keyaggcoef(&sc[i], &ka, ser + 33 * i);
+        }
+        secp256k1_scalar_clear(&zero);
+        secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, &qj, pts, sc, n, &zero, &ctx->error_callback);
+        secp256k1_ge_set_gej_var(&ka.pk, &qj);
+        ret = !secp256k1_ge_is_infinity(&ka.pk);
+    }
+    if (ret) {
+        if (keyagg_cache != NULL) {
+            secp256k1_musig_keyagg_cache_save(keyagg_cache, &ka);
+        }
+        if (agg_pk != NULL) {
+            secp256k1_fe_normalize_var(&ka.pk.y);
+            if (secp256k1_fe_is_odd(&ka.pk.y)) {
+                secp256k1_ge_neg(&ka.pk, &ka.pk);
+            }
+            secp256k1_xonly_pubkey_save(agg_pk, &ka.pk);
+        }
+    }
+
+    free(pts);
+    free(sc);
+    free(ser);
+    SECP256K1_TRACE_RETURN(musig_pubkey_agg, ret);
+    return ret;
+}
+
+int secp256k1_musig_nonce_gen(const secp256k1_context* ctx, secp256k1_musig_secnonce *secnonce, secp256k1_musig_pubnonce *pubnonce, unsigned char *session_secrand32, const unsigned char *seckey, const secp256k1_pubkey *pubkey, const unsigned char *msg32, const secp256k1_musig_keyagg_cache *keyagg_cache, const unsigned char *extra_input32) {
+    static const unsigned char zero32[32] = { 0 };
+    secp256k1_musig_keyagg ka;
+    secp256k1_scalar k[2];
+    secp256k1_gej rj;
+    secp256k1_ge pk, r[2];
+    secp256k1_sha256_t sha;
+    unsigned char rand[32];
+    unsigned char pk33[33];
+    unsigned char aggpk32[32];
+    unsigned char buf[32];
+    unsigned char len[8];
+    size_t size = 33;
+    int i;
+    int ret;
+    SECP256K1_TRACE_ENTRY(musig_nonce_gen, ctx, 1);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_gen_ready(ctx));
+    ARG_CHECK(secnonce != NULL);
+    memset(secnonce, 0, sizeof(*secnonce));
+    ARG_CHECK(pubnonce != NULL);
+    memset(pubnonce, 0, sizeof(*pubnonce));
+    ARG_CHECK(session_secrand32 != NULL);
+    /* All zeros is what a used session_secrand32 is cleared to. */
+    ARG_CHECK(memcmp(session_secrand32, zero32, 32) != 0);
+    ARG_CHECK(pubkey != NULL);
+
+    ret = secp256k1_pubkey_load(ctx, &pk, pubkey);
+    if (ret && keyagg_cache != NULL) {
+        ret = secp256k1_musig_keyagg_cache_load(ctx, &ka, keyagg_cache);
+    }
+    if (ret) {
+        /* rand = seckey xor hash_MuSig/aux(session_secrand32) */
+        if (seckey != NULL) {
+            secp256k1_schnorrsig_sha256_tagged(&sha, secp256k1_musig_midstate_aux);
+            secp256k1_sha256_write(&sha, session_secrand32, 32);
+            secp256k1_sha256_finalize(&sha, rand);
+            for (i = 0; i < 32; i++) {
+                rand[i] ^= seckey[i];
+            }
+        } else {
+            memcpy(rand, session_secrand32, 32);
+        }
+        memset(session_secrand32, 0, 32);
+
+        secp256k1_eckey_pubkey_serialize(&pk, pk33, &size, 1);
+        if (keyagg_cache != NULL) {
+            secp256k1_fe_normalize_var(&ka.pk.x);
+            secp256k1_fe_get_b32(aggpk32, &ka.pk.x);
+        }
+
+        /* k_i = int(hash_MuSig/nonce(rand || len(pk) || pk || len(aggpk) ||
+         *       aggpk || msg_prefixed || len(extra_in) || extra_in || i)) mod n,
+         * with the lengths in 1, 1, 8 (in msg_prefixed) and 4 bytes. */
+        for (i = 0; i < 2; i++) {
+            secp256k1_schnorrsig_sha256_tagged(&sha, secp256k1_musig_midstate_nonce);
+            secp256k1_sha256_write(&sha, rand, 32);
+            len[0] = 33;
+            secp256k1_sha256_write(&sha, len, 1);
+            secp256k1_sha256_write(&sha, pk33, 33);
+            len[0] = keyagg_cache != NULL ? 32 : 0;
+            secp256k1_sha256_write(&sha, len, 1);
+            if (keyagg_cache != NULL) {
+                secp256k1_sha256_write(&sha, aggpk32, 32);
+            }
+            len[0] = msg32 != NULL;
+            secp256k1_sha256_write(&sha, len, 1);
+            if (msg32 != NULL) {
+                memset(len, 0, 8);
+                len[7] = 32;
+                secp256k1_sha256_write(&sha, len, 8);
+                secp256k1_sha256_write(&sha, msg32, 32);
+            }
+            memset(len, 0, 4);
+            len[3] = extra_input32 != NULL ? 32 : 0;
+            secp256k1_sha256_write(&sha, len, 4);
+            if (extra_input32 != NULL) {
+                secp256k1_sha256_write(&sha, extra_input32, 32);
+            }
+            len[0] = (unsigned char)i;
+            secp256k1_sha256_write(&sha, len, 1);
+            secp256k1_sha256_finalize(&sha, buf);
+            secp256k1_scalar_set_b32(&k[i], buf, NULL);
+            /* k_i is only zero if SHA256 is broken. */
+            ret &= !secp256k1_scalar_is_zero(&k[i]);
+        }
+
+        if (ret) {
+            for (i = 0; i < 2; i++) {
+                secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &rj, &k[i]);
+                secp256k1_ge_set_gej(&r[i], &rj);
+                secp256k1_scalar_get_b32(secnonce->data + 4 + 32 * i, &k[i]);
+            }
+            secp256k1_musig_nonce_save(pubnonce->data, secp256k1_musig_pubnonce_magic, r);
+            memcpy(secnonce->data, secp256k1_musig_secnonce_magic, 4);
+            secp256k1_musig_ge_save(secnonce->data + 68, &pk);
+        }
+        secp256k1_scalar_clear(&k[0]);
+        secp256k1_scalar_clear(&k[1]);
+        memset(rand, 0, sizeof(rand));
+        memset(buf, 0, sizeof(buf));
+    }
+    SECP256K1_TRACE_RETURN(musig_nonce_gen, ret);
+    return ret;
+}
+
+int secp256k1_musig_nonce_agg(const secp256k1_context* ctx, secp256k1_musig_aggnonce *aggnonce, const secp256k1_musig_pubnonce * const* pubnonces, size_t n) {
+    secp256k1_gej rj[2];
+    secp256k1_ge r[2];
+    size_t i;
+    int j;
+    int ret = 1;
+    SECP256K1_TRACE_ENTRY(musig_nonce_agg, ctx, n);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(aggnonce != NULL);
+    memset(aggnonce, 0, sizeof(*aggnonce));
+    ARG_CHECK(pubnonces != NULL);
+    ARG_CHECK(n > 0);
+
+    secp256k1_gej_set_infinity(&rj[0]);
+    secp256k1_gej_set_infinity(&rj[1]);
+    for (i = 0; ret && i < n; i++) {
+        ret = secp256k1_musig_nonce_load(ctx, r, pubnonces[i]->data, secp256k1_musig_pubnonce_magic);
+        for (j = 0; ret && j < 2; j++) {
+            secp256k1_gej_add_ge_var(&rj[j], &rj[j], &r[j], NULL);
+        }
+    }
+    if (ret) {
+        secp256k1_ge_set_gej_var(&r[0], &rj[0]);
+        secp256k1_ge_set_gej_var(&r[1], &rj[1]);
+        secp256k1_musig_nonce_save(aggnonce->data, secp256k1_musig_aggnonce_magic, r);
+    }
+    SECP256K1_TRACE_RETURN(musig_nonce_agg, ret);
+    return ret;
+}
+
+int secp256k1_musig_nonce_process(const secp256k1_context* ctx, secp256k1_musig_session *session, const secp256k1_musig_aggnonce *aggnonce, const unsigned char *msg32, const secp256k1_musig_keyagg_cache *keyagg_cache) {
+    secp256k1_musig_keyagg ka;
+    secp256k1_scalar b, e, zero;
+    secp256k1_gej rj, r2j, tj;
+    secp256k1_ge r[2], fin;
+    secp256k1_sha256_t sha;
+    unsigned char agg66[66];
+    unsigned char qx[32];
+    unsigned char buf[32];
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(musig_nonce_process, ctx, 1);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
+    ARG_CHECK(session != NULL);
+    memset(session, 0, sizeof(*session));
+    ARG_CHECK(aggnonce != NULL);
+    ARG_CHECK(msg32 != NULL);
+    ARG_CHECK(keyagg_cache != NULL);
+
+    if (secp256k1_musig_nonce_load(ctx, r, aggnonce->data, secp256k1_musig_aggnonce_magic) &&
+        secp256k1_musig_keyagg_cache_load(ctx, &ka, keyagg_cache)) {
+        secp256k1_musig_ge_serialize_ext(agg66, &r[0]);
+        secp256k1_musig_ge_serialize_ext(agg66 + 33, &r[1]);
+        secp256k1_fe_normalize_var(&ka.pk.x);
+        secp256k1_fe_get_b32(qx, &ka.pk.x);
+
+        /* b = int(hash_MuSig/noncecoef(aggnonce || bytes(Q) || m)) mod n */
+        secp256k1_schnorrsig_sha256_tagged(&sha, secp256k1_musig_midstate_noncecoef);
+        secp256k1_sha256_write(&sha, agg66, 66);
+        secp256k1_sha256_write(&sha, qx, 32);
+        secp256k1_sha256_write(&sha, msg32, 32);
+        secp256k1_sha256_finalize(&sha, buf);
+        secp256k1_scalar_set_b32(&b, buf, NULL);
+
+        /* R = R1 + b*R2, or G if that is infinity. */
+        secp256k1_gej_set_ge(&rj, &r[0]);
+        if (!secp256k1_ge_is_infinity(&r[1])) {
+            secp256k1_scalar_clear(&zero);
+            secp256k1_gej_set_ge(&r2j, &r[1]);
+            secp256k1_ecmult(&ctx->ecmult_ctx, &tj, &r2j, &b, &zero);
+            secp256k1_gej_add_var(&rj, &rj, &tj, NULL);
+        }
+        secp256k1_ge_set_gej_var(&fin, &rj);
+        if (secp256k1_ge_is_infinity(&fin)) {
+            fin = secp256k1_ge_const_g;
+        }
+        secp256k1_fe_normalize_var(&fin.x);
+        secp256k1_fe_normalize_var(&fin.y);
+
+        memcpy(session->data, secp256k1_musig_session_magic, 4);
+        session->data[4] = secp256k1_fe_is_odd(&fin.y);
+        secp256k1_fe_get_b32(session->data + 5, &fin.x);
+        secp256k1_scalar_get_b32(session->data + 37, &b);
+        secp256k1_schnorrsig_challenge(&e, session->data + 5, qx, msg32);
+        secp256k1_scalar_get_b32(session->data + 69, &e);
+        ret = 1;
+    }
+    SECP256K1_TRACE_RETURN(musig_nonce_process, ret);
+    return ret;
+}
+
+int secp256k1_musig_partial_sign(const secp256k1_context* ctx, secp256k1_musig_partial_sig *partial_sig, secp256k1_musig_secnonce *secnonce, const unsigned char *seckey, const secp256k1_musig_keyagg_cache *keyagg_cache, const secp256k1_musig_session *session) {
+    secp256k1_musig_keyagg ka;
+    secp256k1_scalar sk, k1, k2, a, b, e;
+    secp256k1_gej pj;
+    secp256k1_ge pk;
+    unsigned char pk33[33];
+    unsigned char nonce_pk33[33];
+    unsigned char rx[32];
+    size_t size = 33;
+    int overflow;
+    int r_odd;
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(musig_partial_sign, ctx, 1);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_gen_ready(ctx));
+    ARG_CHECK(partial_sig != NULL);
+    memset(partial_sig, 0, sizeof(*partial_sig));
+    ARG_CHECK(secnonce != NULL);
+    /* A cleared secret nonce fails here, which catches most reuse. */
+    ARG_CHECK(memcmp(secnonce->data, secp256k1_musig_secnonce_magic, 4) == 0);
+    ARG_CHECK(seckey != NULL);
+    ARG_CHECK(keyagg_cache != NULL);
+    ARG_CHECK(session != NULL);
+
+    secp256k1_scalar_set_b32(&k1, secnonce->data + 4, NULL);
+    secp256k1_scalar_set_b32(&k2, secnonce->data + 36, NULL);
+    secp256k1_musig_ge_load(&pk, secnonce->data + 68);
+    secp256k1_eckey_pubkey_serialize(&pk, nonce_pk33, &size, 1);
+    memset(secnonce, 0, sizeof(*secnonce));
+
+    secp256k1_scalar_set_b32(&sk, seckey, &overflow);
+    if (!overflow && !secp256k1_scalar_is_zero(&sk) &&
+        secp256k1_musig_keyagg_cache_load(ctx, &ka, keyagg_cache) &&
+        secp256k1_musig_session_load(ctx, &r_odd, rx, &b, &e, session)) {
+        /* The secret nonce must have been made for this key. */
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pj, &sk);
+        secp256k1_ge_set_gej(&pk, &pj);
+        size = 33;
+        secp256k1_eckey_pubkey_serialize(&pk, pk33, &size, 1);
+        if (memcmp(pk33, nonce_pk33, 33) == 0) {
+            /* s = k1 + b*k2 + e*a*d, with d negated if Q has an odd Y and
+             * the k negated if R does. */
+            secp256k1_musig_keyaggcoef(&a, &ka, pk33);
+            secp256k1_fe_normalize_var(&ka.pk.y);
+            secp256k1_scalar_cond_negate(&sk, secp256k1_fe_is_odd(&ka.pk.y));
+            secp256k1_scalar_cond_negate(&k1, r_odd);
+            secp256k1_scalar_cond_negate(&k2, r_odd);
+            secp256k1_scalar_mul(&e, &e, &a);
+            secp256k1_scalar_mul(&e, &e, &sk);
+            secp256k1_scalar_mul(&k2, &k2, &b);
+            secp256k1_scalar_add(&k1, &k1, &k2);
+            secp256k1_scalar_add(&k1, &k1, &e);
+            memcpy(partial_sig->data, secp256k1_musig_partial_sig_magic, 4);
+            secp256k1_scalar_get_b32(partial_sig->data + 4, &k1);
+            ret = 1;
+        }
+    }
+    secp256k1_scalar_clear(&sk);
+    secp256k1_scalar_clear(&k1);
+    secp256k1_scalar_clear(&k2);
+    secp256k1_scalar_clear(&e);
+    SECP256K1_TRACE_RETURN(musig_partial_sign, ret);
+    return ret;
+}
+
+int secp256k1_musig_partial_sig_verify(const secp256k1_context* ctx, const secp256k1_musig_partial_sig *partial_sig, const secp256k1_musig_pubnonce *pubnonce, const secp256k1_pubkey *pubkey, const secp256k1_musig_keyagg_cache *keyagg_cache, const secp256k1_musig_session *session) {
+    secp256k1_musig_keyagg ka;
+    secp256k1_scalar s, a, b, e;
+    secp256k1_scalar sc[3];
+    secp256k1_ge pts[3];
+    secp256k1_gej rj;
+    unsigned char pk33[33];
+    unsigned char rx[32];
+    size_t size = 33;
+    int r_odd;
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(musig_partial_sig_verify, ctx, 1);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
+    ARG_CHECK(partial_sig != NULL);
+    ARG_CHECK(pubnonce != NULL);
+    ARG_CHECK(pubkey != NULL);
+    ARG_CHECK(keyagg_cache != NULL);
+    ARG_CHECK(session != NULL);
+
+    if (secp256k1_musig_partial_sig_load(ctx, &s, partial_sig) &&
+        secp256k1_musig_nonce_load(ctx, pts, pubnonce->data, secp256k1_musig_pubnonce_magic) &&
+        secp256k1_pubkey_load(ctx, &pts[2], pubkey) &&
+        secp256k1_musig_keyagg_cache_load(ctx, &ka, keyagg_cache) &&
+        secp256k1_musig_session_load(ctx, &r_odd, rx, &b, &e, session)) {
+        secp256k1_eckey_pubkey_serialize(&pts[2], pk33, &size, 1);
+        secp256k1_musig_keyaggcoef(&a, &ka, pk33);
+
+        /* s*G must equal +-(R1 + b*R2) + g*e*a*P, with g = -1 if Q has an
+         * odd Y, so check s*G - that is infinity. */
+        secp256k1_scalar_set_int(&sc[0], 1);
+        secp256k1_scalar_cond_negate(&sc[0], !r_odd);
+        secp256k1_scalar_mul(&sc[1], &sc[0], &b);
+        secp256k1_scalar_mul(&sc[2], &e, &a);
+        secp256k1_fe_normalize_var(&ka.pk.y);
+        secp256k1_scalar_cond_negate(&sc[2], !secp256k1_fe_is_odd(&ka.pk.y));
+        secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, &rj, pts, sc, 3, &s, &ctx->error_callback);
+        ret = secp256k1_gej_is_infinity(&rj);
+    }
+    SECP256K1_TRACE_RETURN(musig_partial_sig_verify, ret);
+    return ret;
+}
+
+int secp256k1_musig_partial_sig_agg(const secp256k1_context* ctx, unsigned char *sig64, const secp256k1_musig_session *session, const secp256k1_musig_partial_sig * const* partial_sigs, size_t n) {
+    secp256k1_scalar s, si, b, e;
+    size_t i;
+    int r_odd;
+    int ret;
+    SECP256K1_TRACE_ENTRY(musig_partial_sig_agg, ctx, n);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(sig64 != NULL);
+    memset(sig64, 0, 64);
+    ARG_CHECK(session != NULL);
+    ARG_CHECK(partial_sigs != NULL);
+    ARG_CHECK(n > 0);
+
+    ret = secp256k1_musig_session_load(ctx, &r_odd, sig64, &b, &e, session);
+    secp256k1_scalar_clear(&s);
+    for (i = 0; ret && i < n; i++) {
+        ret = secp256k1_musig_partial_sig_load(ctx, &si, partial_sigs[i]);
+        if (ret) {
+            secp256k1_scalar_add(&s, &s, &si);
+        }
+    }
+    if (ret) {
+        secp256k1_scalar_get_b32(sig64 + 32, &s);
+    } else {
+        memset(sig64, 0, 64);
+    }
+    SECP256K1_TRACE_RETURN(musig_partial_sig_agg, ret);
+    return ret;
+}
+
+#endif
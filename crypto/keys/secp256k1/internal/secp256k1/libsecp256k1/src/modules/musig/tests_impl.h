@@ -0,0 +1,382 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_MUSIG_TESTS_
+#define _SECP256K1_MODULE_MUSIG_TESTS_
+
+#define MUSIG_TEST_MAX 6
+
+/* The public keys of the BIP327 key aggregation test vectors, and the
+ * aggregates of keys 0,1,2; 2,1,0; 0,0,0 and 0,0,1,1. */
+static const unsigned char musig_keyagg_keys[3][33] = {
+    {0x02, 0xF9, 0x30, 0x8A, 0x01, 0x92, 0x58, 0xC3, 0x10, 0x49, 0x34, 0x4F, 0x85, 0xF8, 0x9D, 0x52,
+     0x29, 0xB5, 0x31, 0xC8, 0x45, 0x83, 0x6F, 0x99, 0xB0, 0x86, 0x01, 0xF1, 0x13, 0xBC, 0xE0, 0x36,
+     0xF9},
+    {0x03, 0xDF, 0xF1, 0xD7, 0x7F, 0x2A, 0x67, 0x1C, 0x5F, 0x36, 0x18, 0x37, 0x26, 0xDB, 0x23, 0x41,
+     0xBE, 0x58, 0xFE, 0xAE, 0x1D, 0xA2, 0xDE, 0xCE, 0xD8, 0x43, 0x24, 0x0F, 0x7B, 0x50, 0x2B, 0xA6,
+     0x59},
+    {0x02, 0x35, 0x90, 0xA9, 0x4E, 0x76, 0x8F, 0x8E, 0x18, 0x15, 0xC2, 0xF2, 0x4B, 0x4D, 0x80, 0xA8,
+     0xE3, 0x14, 0x93, 0x16, 0xC3, 0x51, 0x8C, 0xE7, 0xB7, 0xAD, 0x33, 0x83, 0x68, 0xD0, 0x38, 0xCA,
+     0x66}
+};
+
+static const size_t musig_keyagg_order[4][4] = {
+    {0, 1, 2}, {2, 1, 0}, {0, 0, 0}, {0, 0, 1, 1}
+};
+
+static const unsigned char musig_keyagg_expected[4][32] = {
+    {0x90, 0x53, 0x9E, 0xED, 0xE5, 0x65, 0xF5, 0xD0, 0x54, 0xF3, 0x2C, 0xC0, 0xC2, 0x20, 0x12, 0x68,
+     0x89, 0xED, 0x1E, 0x5D, 0x19, 0x3B, 0xAF, 0x15, 0xAE, 0xF3, 0x44, 0xFE, 0x59, 0xD4, 0x61, 0x0C},
+    {0x62, 0x04, 0xDE, 0x8B, 0x08, 0x34, 0x26, 0xDC, 0x6E, 0xAF, 0x95, 0x02, 0xD2, 0x70, 0x24, 0xD5,
+     0x3F, 0xC8, 0x26, 0xBF, 0x7D, 0x20, 0x12, 0x14, 0x8A, 0x05, 0x75, 0x43, 0x5D, 0xF5, 0x4B, 0x2B},
+    {0xB4, 0x36, 0xE3, 0xBA, 0xD6, 0x2B, 0x8C, 0xD4, 0x09, 0x96, 0x9A, 0x22, 0x47, 0x31, 0xC1, 0x93,
+     0xD0, 0x51, 0x16, 0x2D, 0x8C, 0x5A, 0xE8, 0xB1, 0x09, 0x30, 0x61, 0x27, 0xDA, 0x3A, 0xA9, 0x35},
+    {0x69, 0xBC, 0x22, 0xBF, 0xA5, 0xD1, 0x06, 0x30, 0x6E, 0x48, 0xA2, 0x06, 0x79, 0xDE, 0x1D, 0x73,
+     0x89, 0x38, 0x61, 0x24, 0xD0, 0x75, 0x71, 0xD0, 0xD8, 0x72, 0x68, 0x60, 0x28, 0xC2, 0x6A, 0x3E}
+};
+
+/* A three signer session whose aggregated key has an odd Y, worked through
+ * with the BIP327 reference algorithms: session_secrand32 is 32 bytes of
+ * 0x80 + i for signer i, the message is 0x00 0x01 ... 0x1F, the aggregated
+ * key is passed to nonce generation, and there is no extra input. */
+static const unsigned char musig_session_seckeys[3][32] = {
+    {0xBC, 0xC3, 0x74, 0x1C, 0x42, 0x34, 0x35, 0xE4, 0x84, 0x89, 0x12, 0xFE, 0xEB, 0x56, 0x8D, 0x5E,
+     0xC4, 0x9F, 0xD5, 0xF6, 0x8B, 0x0E, 0xD6, 0x5D, 0xA0, 0xF5, 0x99, 0x68, 0x0A, 0xB5, 0xC8, 0xC2},
+    {0xB3, 0xDA, 0xB3, 0x36, 0x75, 0xF4, 0xD8, 0xFE, 0x65, 0xDA, 0x07, 0xE9, 0xD2, 0xC9, 0x44, 0xBE,
+     0x9A, 0xC3, 0x79, 0x25, 0x54, 0x86, 0x58, 0xFC, 0x2C, 0x55, 0x06, 0xB6, 0xFD, 0xBA, 0xE1, 0x0A},
+    {0x6C, 0x98, 0x5C, 0x7C, 0xF5, 0x3E, 0xD7, 0x3C, 0x13, 0xEF, 0x90, 0xD4, 0x2B, 0x0E, 0xB4, 0xCF,
+     0x52, 0x4D, 0x7C, 0x80, 0xDE, 0x17, 0x35, 0xD5, 0xE4, 0x3F, 0xE1, 0x52, 0x2E, 0x43, 0x2D, 0xE7}
+};
+
+static const unsigned char musig_session_pubnonces[3][66] = {
+    {0x02, 0xE3, 0x22, 0xBF, 0xA9, 0xED, 0x0F, 0xED, 0xA7, 0xA6, 0x10, 0x00, 0xFE, 0x09, 0x16, 0xEF,
+     0xDC, 0x7A, 0xFB, 0x07, 0xEF, 0xED, 0x4A, 0xC4, 0x6A, 0xCB, 0xDA, 0x39, 0xA6, 0x9A, 0xDE, 0xE4,
+     0x50, 0x02, 0xB8, 0xF1, 0xC3, 0x8C, 0xC4, 0xD7, 0xD1, 0x50, 0x28, 0x2B, 0x67, 0x30, 0x84, 0x7F,
+     0xE3, 0x0F, 0x4A, 0x62, 0x45, 0x6C, 0x7C, 0x22, 0xD2, 0x48, 0x83, 0x04, 0x77, 0x07, 0xAA, 0x42,
+     0x02, 0xE9},
+    {0x02, 0xED, 0xCE, 0x69, 0x16, 0x96, 0x9F, 0x79, 0xF7, 0x5E, 0xB4, 0xA5, 0x01, 0xBB, 0x85, 0x2E,
+     0x71, 0x72, 0x23, 0x08, 0xBB, 0x1A, 0xCB, 0x46, 0xC5, 0x09, 0x96, 0x6F, 0x33, 0xA0, 0x5A, 0x08,
+     0x4A, 0x02, 0x03, 0x2A, 0xE2, 0xAA, 0x59, 0xF6, 0xD8, 0x29, 0x27, 0x3E, 0x0F, 0xA8, 0x96, 0xB6,
+     0x79, 0x46, 0x74, 0x46, 0x7B, 0x3B, 0x38, 0x89, 0x61, 0x3E, 0x2F, 0xEE, 0x59, 0x26, 0xAE, 0x40,
+     0x02, 0xA7},
+    {0x02, 0x27, 0xDD, 0x6F, 0xC3, 0xD3, 0x7B, 0x98, 0xF5, 0x41, 0x42, 0xAA, 0x35, 0x98, 0xEA, 0x2C,
+     0xCD, 0x04, 0xC7, 0xB6, 0x4C, 0x00, 0x32, 0xD0, 0x3F, 0x70, 0x16, 0x95, 0x76, 0x7C, 0xE6, 0xBB,
+     0x93, 0x02, 0x80, 0xF5, 0xB7, 0x9C, 0x66, 0xD2, 0xE2, 0x5A, 0x54, 0xC0, 0x0C, 0xAC, 0x38, 0xCD,
+     0x7A, 0x71, 0xC8, 0x85, 0xEB, 0xAC, 0x00, 0x22, 0x3B, 0x61, 0x87, 0x90, 0xF3, 0x6B, 0xE5, 0x0B,
+     0x2B, 0xB8}
+};
+
+static const unsigned char musig_session_aggnonce[66] = {
+    0x03, 0x82, 0x5A, 0xFF, 0xB1, 0x7F, 0xE0, 0x05, 0x2B, 0xF2, 0x3C, 0x42, 0x23, 0x8B, 0x05, 0xDF,
+    0x18, 0x8A, 0xE5, 0x0B, 0xE8, 0x88, 0x82, 0x22, 0xFF, 0x5A, 0xC3, 0xC0, 0x8F, 0x3C, 0xD4, 0xCE,
+    0x89, 0x03, 0x22, 0x97, 0x08, 0xC9, 0x9D, 0x11, 0x50, 0x58, 0x43, 0x91, 0xD3, 0xCC, 0x13, 0x33,
+    0xB9, 0xE9, 0x62, 0x8D, 0x21, 0x3D, 0x3B, 0xC3, 0xFF, 0xCF, 0x79, 0xA1, 0x03, 0xAC, 0x4F, 0x1D,
+    0xC7, 0x48
+};
+
+static const unsigned char musig_session_sig[64] = {
+    0xCF, 0xAE, 0x2C, 0xC5, 0x51, 0xEA, 0xD1, 0x7C, 0x31, 0x0C, 0x8F, 0x05, 0x9C, 0x19, 0xD8, 0x48,
+    0x78, 0xA1, 0x78, 0x96, 0x79, 0x4C, 0xE0, 0x6E, 0x87, 0xE7, 0x49, 0x61, 0x28, 0xB0, 0x3B, 0x88,
+    0x87, 0x7F, 0x84, 0xD0, 0x76, 0x0D, 0xFD, 0x4A, 0xF4, 0x98, 0x06, 0xEE, 0xEA, 0x9C, 0x05, 0xB9,
+    0x2D, 0x49, 0xA7, 0x31, 0x30, 0x2F, 0xEA, 0x24, 0x02, 0x0A, 0xB8, 0xD2, 0xC4, 0x7D, 0x18, 0x9B
+};
+
+static void musig_random_key(unsigned char *seckey, secp256k1_pubkey *pubkey) {
+    secp256k1_scalar key;
+    random_scalar_order_test(&key);
+    secp256k1_scalar_get_b32(seckey, &key);
+    CHECK(secp256k1_ec_pubkey_create(ctx, pubkey, seckey) == 1);
+}
+
+static void musig_random_secrand(unsigned char *secrand32) {
+    do {
+        secp256k1_rand256(secrand32);
+    } while (secrand32[0] == 0);
+}
+
+void test_musig_api(void) {
+    secp256k1_context *none = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+    secp256k1_context *sign = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
+    secp256k1_context *vrfy = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+    secp256k1_musig_keyagg_cache cache, zero_cache;
+    secp256k1_musig_secnonce secnonce;
+    secp256k1_musig_pubnonce pubnonce;
+    secp256k1_musig_aggnonce aggnonce;
+    secp256k1_musig_session session;
+    secp256k1_musig_partial_sig psig;
+    const secp256k1_musig_pubnonce *pubnonce_ptr = &pubnonce;
+    const secp256k1_musig_partial_sig *psig_ptr = &psig;
+    const secp256k1_pubkey *pubkey_ptr;
+    secp256k1_xonly_pubkey agg_pk;
+    secp256k1_pubkey pubkey;
+    unsigned char key[32];
+    unsigned char msg[32];
+    unsigned char secrand[32];
+    unsigned char buf[66];
+    unsigned char sig[64];
+    int32_t ecount = 0;
+
+    secp256k1_context_set_illegal_callback(none, counting_illegal_callback_fn, &ecount);
+    secp256k1_context_set_illegal_callback(sign, counting_illegal_callback_fn, &ecount);
+    secp256k1_context_set_illegal_callback(vrfy, counting_illegal_callback_fn, &ecount);
+    memset(&zero_cache, 0, sizeof(zero_cache));
+    musig_random_key(key, &pubkey);
+    pubkey_ptr = &pubkey;
+    secp256k1_rand256(msg);
+
+    /* key aggregation */
+    CHECK(secp256k1_musig_pubkey_agg(none, &agg_pk, &cache, &pubkey_ptr, 1) == 0);
+    CHECK(ecount == 1);
+    CHECK(secp256k1_musig_pubkey_agg(vrfy, &agg_pk, &cache, NULL, 1) == 0);
+    CHECK(ecount == 2);
+    CHECK(secp256k1_musig_pubkey_agg(vrfy, &agg_pk, &cache, &pubkey_ptr, 0) == 0);
+    CHECK(ecount == 3);
+    CHECK(memcmp(&cache, &zero_cache, sizeof(cache)) == 0);
+    CHECK(secp256k1_musig_pubkey_agg(vrfy, NULL, NULL, &pubkey_ptr, 1) == 1);
+    CHECK(secp256k1_musig_pubkey_agg(vrfy, &agg_pk, &cache, &pubkey_ptr, 1) == 1);
+    CHECK(ecount == 3);
+    {
+        /* Out of memory, with an error callback that returns: no allocation
+         * can hold this many points, so no key is ever read. */
+        int32_t errcount = 0;
+        secp256k1_musig_keyagg_cache oom_cache;
+        secp256k1_xonly_pubkey oom_agg_pk;
+        secp256k1_context_set_error_callback(vrfy, counting_illegal_callback_fn, &errcount);
+        CHECK(secp256k1_musig_pubkey_agg(vrfy, &oom_agg_pk, &oom_cache, &pubkey_ptr, ((size_t)-1) / 2 / sizeof(secp256k1_ge)) == 0);
+        CHECK(errcount >= 1);
+        CHECK(memcmp(&oom_cache, &zero_cache, sizeof(oom_cache)) == 0);
+        secp256k1_context_set_error_callback(vrfy, NULL, NULL);
+    }
+
+    /* nonce generation */
+    musig_random_secrand(secrand);
+    CHECK(secp256k1_musig_nonce_gen(vrfy, &secnonce, &pubnonce, secrand, key, &pubkey, msg, &cache, NULL) == 0);
+    CHECK(ecount == 4);
+    CHECK(secp256k1_musig_nonce_gen(sign, &secnonce, &pubnonce, secrand, key, &pubkey, msg, &zero_cache, NULL) == 0);
+    CHECK(ecount == 5);
+    CHECK(secp256k1_musig_nonce_gen(sign, &secnonce, &pubnonce, secrand, key, &pubkey, msg, &cache, NULL) == 1);
+    CHECK(ecount == 5);
+    /* session_secrand32 is cleared, so it cannot be used twice. */
+    CHECK(secp256k1_musig_nonce_gen(sign, &secnonce, &pubnonce, secrand, key, &pubkey, msg, &cache, NULL) == 0);
+    CHECK(ecount == 6);
+    musig_random_secrand(secrand);
+    CHECK(secp256k1_musig_nonce_gen(sign, &secnonce, &pubnonce, secrand, NULL, &pubkey, NULL, NULL, NULL) == 1);
+    CHECK(ecount == 6);
+
+    /* nonce aggregation and processing */
+    CHECK(secp256k1_musig_nonce_agg(none, &aggnonce, &pubnonce_ptr, 0) == 0);
+    CHECK(ecount == 7);
+    CHECK(secp256k1_musig_nonce_agg(none, &aggnonce, &pubnonce_ptr, 1) == 1);
+    CHECK(secp256k1_musig_nonce_process(none, &session, &aggnonce, msg, &cache) == 0);
+    CHECK(ecount == 8);
+    CHECK(secp256k1_musig_nonce_process(vrfy, &session, &aggnonce, msg, &zero_cache) == 0);
+    CHECK(ecount == 9);
+    CHECK(secp256k1_musig_nonce_process(vrfy, &session, &aggnonce, msg, &cache) == 1);
+    CHECK(ecount == 9);
+
+    /* partial signatures */
+    CHECK(secp256k1_musig_partial_sign(vrfy, &psig, &secnonce, key, &cache, &session) == 0);
+    CHECK(ecount == 10);
+    CHECK(secp256k1_musig_partial_sign(sign, &psig, &secnonce, key, &cache, &session) == 1);
+    CHECK(ecount == 10);
+    /* The secret nonce is cleared, so it cannot be used twice. */
+    CHECK(secp256k1_musig_partial_sign(sign, &psig, &secnonce, key, &cache, &session) == 0);
+    CHECK(ecount == 11);
+    /* That failure cleared psig; make it again. */
+    musig_random_secrand(secrand);
+    CHECK(secp256k1_musig_nonce_gen(sign, &secnonce, &pubnonce, secrand, key, &pubkey, msg, &cache, NULL) == 1);
+    CHECK(secp256k1_musig_nonce_agg(none, &aggnonce, &pubnonce_ptr, 1) == 1);
+    CHECK(secp256k1_musig_nonce_process(vrfy, &session, &aggnonce, msg, &cache) == 1);
+    CHECK(secp256k1_musig_partial_sign(sign, &psig, &secnonce, key, &cache, &session) == 1);
+    CHECK(secp256k1_musig_partial_sig_verify(sign, &psig, &pubnonce, &pubkey, &cache, &session) == 0);
+    CHECK(ecount == 12);
+    CHECK(secp256k1_musig_partial_sig_verify(vrfy, &psig, &pubnonce, &pubkey, &cache, &session) == 1);
+    CHECK(secp256k1_musig_partial_sig_agg(none, sig, &session, &psig_ptr, 0) == 0);
+    CHECK(ecount == 13);
+    CHECK(secp256k1_musig_partial_sig_agg(none, sig, &session, &psig_ptr, 1) == 1);
+    CHECK(ecount == 13);
+    CHECK(secp256k1_schnorrsig_verify(vrfy, sig, msg, &agg_pk) == 1);
+
+    /* serialization */
+    CHECK(secp256k1_musig_partial_sig_serialize(none, buf, &psig) == 1);
+    CHECK(secp256k1_musig_partial_sig_parse(none, &psig, buf) == 1);
+    memset(buf, 0xFF, 32);
+    CHECK(secp256k1_musig_partial_sig_parse(none, &psig, buf) == 0);
+    CHECK(secp256k1_musig_partial_sig_serialize(none, buf, &psig) == 0);
+    CHECK(ecount == 14);
+    CHECK(secp256k1_musig_pubnonce_serialize(none, buf, &pubnonce) == 1);
+    buf[33] = 0x04;
+    CHECK(secp256k1_musig_pubnonce_parse(none, &pubnonce, buf) == 0);
+    CHECK(secp256k1_musig_pubnonce_serialize(none, buf, &pubnonce) == 0);
+    CHECK(ecount == 15);
+    CHECK(secp256k1_musig_aggnonce_serialize(none, buf, &aggnonce) == 1);
+    CHECK(secp256k1_musig_aggnonce_parse(none, &aggnonce, NULL) == 0);
+    CHECK(ecount == 16);
+
+    secp256k1_context_destroy(none);
+    secp256k1_context_destroy(sign);
+    secp256k1_context_destroy(vrfy);
+}
+
+void test_musig_vectors(void) {
+    secp256k1_pubkey pubkeys[4];
+    const secp256k1_pubkey *pubkey_ptrs[4];
+    secp256k1_musig_keyagg_cache cache;
+    secp256k1_musig_secnonce secnonces[3];
+    secp256k1_musig_pubnonce pubnonces[3];
+    secp256k1_musig_aggnonce aggnonce;
+    secp256k1_musig_session session;
+    secp256k1_musig_partial_sig psigs[3];
+    const secp256k1_musig_pubnonce *pubnonce_ptrs[3];
+    const secp256k1_musig_partial_sig *psig_ptrs[3];
+    secp256k1_xonly_pubkey agg_pk;
+    unsigned char msg[32];
+    unsigned char secrand[32];
+    unsigned char buf[66];
+    int i, j;
+
+    for (i = 0; i < 4; i++) {
+        pubkey_ptrs[i] = &pubkeys[i];
+    }
+    for (i = 0; i < 4; i++) {
+        for (j = 0; j < 4; j++) {
+            CHECK(secp256k1_ec_pubkey_parse(ctx, &pubkeys[j], musig_keyagg_keys[musig_keyagg_order[i][j]], 33) == 1);
+        }
+        CHECK(secp256k1_musig_pubkey_agg(ctx, &agg_pk, NULL, pubkey_ptrs, i == 3 ? 4 : 3) == 1);
+        CHECK(secp256k1_xonly_pubkey_serialize(ctx, buf, &agg_pk) == 1);
+        CHECK(memcmp(buf, musig_keyagg_expected[i], 32) == 0);
+    }
+
+    for (i = 0; i < 32; i++) {
+        msg[i] = i;
+    }
+    for (i = 0; i < 3; i++) {
+        CHECK(secp256k1_ec_pubkey_create(ctx, &pubkeys[i], musig_session_seckeys[i]) == 1);
+        pubkey_ptrs[i] = &pubkeys[i];
+    }
+    CHECK(secp256k1_musig_pubkey_agg(ctx, &agg_pk, &cache, pubkey_ptrs, 3) == 1);
+    for (i = 0; i < 3; i++) {
+        memset(secrand, 0x80 + i, 32);
+        CHECK(secp256k1_musig_nonce_gen(ctx, &secnonces[i], &pubnonces[i], secrand, musig_session_seckeys[i], &pubkeys[i], msg, &cache, NULL) == 1);
+        CHECK(secp256k1_musig_pubnonce_serialize(ctx, buf, &pubnonces[i]) == 1);
+        CHECK(memcmp(buf, musig_session_pubnonces[i], 66) == 0);
+        pubnonce_ptrs[i] = &pubnonces[i];
+    }
+    CHECK(secp256k1_musig_nonce_agg(ctx, &aggnonce, pubnonce_ptrs, 3) == 1);
+    CHECK(secp256k1_musig_aggnonce_serialize(ctx, buf, &aggnonce) == 1);
+    CHECK(memcmp(buf, musig_session_aggnonce, 66) == 0);
+    CHECK(secp256k1_musig_nonce_process(ctx, &session, &aggnonce, msg, &cache) == 1);
+    for (i = 0; i < 3; i++) {
+        CHECK(secp256k1_musig_partial_sign(ctx, &psigs[i], &secnonces[i], musig_session_seckeys[i], &cache, &session) == 1);
+        CHECK(secp256k1_musig_partial_sig_verify(ctx, &psigs[i], &pubnonces[i], &pubkeys[i], &cache, &session) == 1);
+        psig_ptrs[i] = &psigs[i];
+    }
+    CHECK(secp256k1_musig_partial_sig_agg(ctx, buf, &session, psig_ptrs, 3) == 1);
+    CHECK(memcmp(buf, musig_session_sig, 64) == 0);
+    CHECK(secp256k1_schnorrsig_verify(ctx, buf, msg, &agg_pk) == 1);
+}
+
+void test_musig_sign_verify(void) {
+    unsigned char seckeys[MUSIG_TEST_MAX][32];
+    secp256k1_pubkey pubkeys[MUSIG_TEST_MAX];
+    const secp256k1_pubkey *pubkey_ptrs[MUSIG_TEST_MAX];
+    secp256k1_musig_keyagg_cache cache;
+    secp256k1_musig_secnonce secnonces[MUSIG_TEST_MAX];
+    secp256k1_musig_secnonce secnonce_copy;
+    secp256k1_musig_pubnonce pubnonces[MUSIG_TEST_MAX];
+    secp256k1_musig_aggnonce aggnonce;
+    secp256k1_musig_session session;
+    secp256k1_musig_partial_sig psigs[MUSIG_TEST_MAX];
+    const secp256k1_musig_pubnonce *pubnonce_ptrs[MUSIG_TEST_MAX];
+    const secp256k1_musig_partial_sig *psig_ptrs[MUSIG_TEST_MAX];
+    secp256k1_xonly_pubkey agg_pk;
+    unsigned char msg[32];
+    unsigned char secrand[32];
+    unsigned char buf[66];
+    unsigned char sig[64];
+    unsigned char gx[32];
+    secp256k1_ge g = secp256k1_ge_const_g;
+    int n = 1 + secp256k1_rand_int(MUSIG_TEST_MAX);
+    int i;
+
+    for (i = 0; i < MUSIG_TEST_MAX; i++) {
+        pubkey_ptrs[i] = &pubkeys[i];
+    }
+    for (i = 0; i < n; i++) {
+        /* Now and then a signer holds the same key as the previous one. */
+        if (i > 0 && secp256k1_rand_int(4) == 0) {
+            memcpy(seckeys[i], seckeys[i - 1], 32);
+            pubkeys[i] = pubkeys[i - 1];
+        } else {
+            musig_random_key(seckeys[i], &pubkeys[i]);
+        }
+    }
+    secp256k1_rand256(msg);
+    CHECK(secp256k1_musig_pubkey_agg(ctx, &agg_pk, &cache, pubkey_ptrs, n) == 1);
+
+    for (i = 0; i < n; i++) {
+        musig_random_secrand(secrand);
+        CHECK(secp256k1_musig_nonce_gen(ctx, &secnonces[i], &pubnonces[i], secrand, seckeys[i], &pubkeys[i], msg, &cache, NULL) == 1);
+        /* Public nonces travel serialized. */
+        CHECK(secp256k1_musig_pubnonce_serialize(ctx, buf, &pubnonces[i]) == 1);
+        CHECK(secp256k1_musig_pubnonce_parse(ctx, &pubnonces[i], buf) == 1);
+        pubnonce_ptrs[i] = &pubnonces[i];
+    }
+    CHECK(secp256k1_musig_nonce_agg(ctx, &aggnonce, pubnonce_ptrs, n) == 1);
+    CHECK(secp256k1_musig_aggnonce_serialize(ctx, buf, &aggnonce) == 1);
+    CHECK(secp256k1_musig_aggnonce_parse(ctx, &aggnonce, buf) == 1);
+    CHECK(secp256k1_musig_nonce_process(ctx, &session, &aggnonce, msg, &cache) == 1);
+
+    /* A secret nonce only signs for the key it was made for. */
+    if (n > 1 && memcmp(seckeys[0], seckeys[1], 32) != 0) {
+        secnonce_copy = secnonces[0];
+        CHECK(secp256k1_musig_partial_sign(ctx, &psigs[0], &secnonce_copy, seckeys[1], &cache, &session) == 0);
+    }
+    for (i = 0; i < n; i++) {
+        CHECK(secp256k1_musig_partial_sign(ctx, &psigs[i], &secnonces[i], seckeys[i], &cache, &session) == 1);
+        CHECK(secp256k1_musig_partial_sig_serialize(ctx, buf, &psigs[i]) == 1);
+        CHECK(secp256k1_musig_partial_sig_parse(ctx, &psigs[i], buf) == 1);
+        CHECK(secp256k1_musig_partial_sig_verify(ctx, &psigs[i], &pubnonces[i], &pubkeys[i], &cache, &session) == 1);
+        psig_ptrs[i] = &psigs[i];
+    }
+    CHECK(secp256k1_musig_partial_sig_agg(ctx, sig, &session, psig_ptrs, n) == 1);
+    CHECK(secp256k1_schnorrsig_verify(ctx, sig, msg, &agg_pk) == 1);
+
+    /* A wrong partial signature is caught, and blamed on its signer. */
+    i = secp256k1_rand_int(n);
+    CHECK(secp256k1_musig_partial_sig_serialize(ctx, buf, &psigs[i]) == 1);
+    buf[31] ^= 1;
+    CHECK(secp256k1_musig_partial_sig_parse(ctx, &psigs[i], buf) == 1);
+    CHECK(secp256k1_musig_partial_sig_verify(ctx, &psigs[i], &pubnonces[i], &pubkeys[i], &cache, &session) == 0);
+    if (n > 1) {
+        CHECK(secp256k1_musig_partial_sig_verify(ctx, &psigs[(i + 1) % n], &pubnonces[i], &pubkeys[i], &cache, &session) == 0);
+    }
+    CHECK(secp256k1_musig_partial_sig_agg(ctx, sig, &session, psig_ptrs, n) == 1);
+    CHECK(secp256k1_schnorrsig_verify(ctx, sig, msg, &agg_pk) == 0);
+
+    /* An aggregate nonce at infinity makes R = G. */
+    memset(buf, 0, 66);
+    CHECK(secp256k1_musig_aggnonce_parse(ctx, &aggnonce, buf) == 1);
+    CHECK(secp256k1_musig_aggnonce_serialize(ctx, buf, &aggnonce) == 1);
+    CHECK(memcmp(buf, buf + 33, 33) == 0 && buf[0] == 0);
+    CHECK(secp256k1_musig_nonce_process(ctx, &session, &aggnonce, msg, &cache) == 1);
+    CHECK(secp256k1_musig_partial_sig_agg(ctx, sig, &session, psig_ptrs, n) == 1);
+    secp256k1_fe_normalize_var(&g.x);
+    secp256k1_fe_get_b32(gx, &g.x);
+    CHECK(memcmp(sig, gx, 32) == 0);
+}
+
+void run_musig_tests(void) {
+    int i;
+
+    test_musig_api();
+    test_musig_vectors();
+    for (i = 0; i < count; i++) {
+        test_musig_sign_verify();
+    }
+}
+
+#endif
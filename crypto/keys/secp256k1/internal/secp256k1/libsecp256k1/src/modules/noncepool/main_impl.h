@@ -0,0 +1,364 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_NONCEPOOL_MAIN_
+#define _SECP256K1_MODULE_NONCEPOOL_MAIN_
+
+#include "include/secp256k1_noncepool.h"
+#include "hash_impl.h"
+
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+# include <sys/types.h>
+# include <unistd.h>
+# include <pthread.h>
+# include <sched.h>
+# define NONCEPOOL_HAVE_FORK 1
+# if defined(HAVE_SYS_MMAN_H) && defined(MAP_ANONYMOUS) && defined(MADV_WIPEONFORK)
+#  define NONCEPOOL_WIPEONFORK 1
+# endif
+#endif
+
+/* Every slot is claimed by flipping its state from EMPTY or READY to BUSY
+ * with a compare-and-swap, so a filler and any number of signers never work
+ * on the same slot, and a READY slot is taken by exactly one signer. The
+ * signer wipes the slot before releasing it as EMPTY. */
+#define NONCEPOOL_EMPTY 0
+#define NONCEPOOL_BUSY 1
+#define NONCEPOOL_READY 2
+
+typedef struct {
+    uint32_t state;
+    int recid;
+    secp256k1_scalar r;
+    secp256k1_scalar noncei;
+} secp256k1_noncepool_slot;
+
+struct secp256k1_noncepool_struct {
+    secp256k1_noncepool_slot *slots;
+    size_t nslots;
+    size_t mapped; /* length of the slot mapping, or 0 if slots came from calloc */
+    size_t fill_hint;
+    size_t take_hint;
+    uint32_t serial;
+    uint32_t counter;
+#ifdef NONCEPOOL_HAVE_FORK
+    pid_t owner;
+    uint32_t forks;
+#endif
+};
+
+/* The number of pools created by this process so far. Each pool gets the
+ * next one as its serial number, which tells its nonces apart from those of
+ * every other pool in the process even if they are filled with one seed. */
+static uint32_t secp256k1_noncepool_serial = 0;
+
+/* Take the next value of *ctr, or return 0 if it has run out: a counter that
+ * wrapped around would repeat DRBG keys. */
+static int secp256k1_noncepool_next(uint32_t *ctr, uint32_t *out) {
+    uint32_t cur = __atomic_load_n(ctr, __ATOMIC_RELAXED);
+    do {
+        if (cur == 0xFFFFFFFFUL) {
+            return 0;
+        }
+    } while (!__atomic_compare_exchange_n(ctr, &cur, cur + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    *out = cur;
+    return 1;
+}
+
+#ifdef NONCEPOOL_HAVE_FORK
+/* A fork leaves the child with a copy of every pool, entries included. Three
+ * guards keep the child from using them:
+ * - Where the kernel supports it, the slots are mapped MADV_WIPEONFORK, so
+ *   the child's copy reads as all EMPTY from the start.
+ * - A pthread_atfork child handler counts the forks the process descends
+ *   from; a pool created before the latest one is not the process's own.
+ * - The pool remembers the pid it was created in. This alone is not enough,
+ *   as the pid of an exited creator may be handed out again to a
+ *   grandchild, but it also catches forks that skip the atfork handlers. */
+static uint32_t secp256k1_noncepool_forks = 0;
+
+/* 0: the atfork handler is not registered, 1: it is being registered,
+ * 2: it is registered, 3: registering it failed. */
+static int secp256k1_noncepool_atfork_state = 0;
+
+static void secp256k1_noncepool_atfork_child(void) {
+    __atomic_fetch_add(&secp256k1_noncepool_forks, 1, __ATOMIC_RELAXED);
+}
+
+static int secp256k1_noncepool_atfork_register(void) {
+    int state = 0;
+    if (__atomic_compare_exchange_n(&secp256k1_noncepool_atfork_state, &state, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+        state = pthread_atfork(NULL, NULL, secp256k1_noncepool_atfork_child) == 0 ? 2 : 3;
+        __atomic_store_n(&secp256k1_noncepool_atfork_state, state, __ATOMIC_RELEASE);
+    }
+    while (state == 1) {
+        sched_yield();
+        state = __atomic_load_n(&secp256k1_noncepool_atfork_state, __ATOMIC_ACQUIRE);
+    }
+    return state == 2;
+}
+#endif
+
+static secp256k1_noncepool_slot *secp256k1_noncepool_slots_alloc(size_t n, size_t *mapped) {
+#ifdef NONCEPOOL_WIPEONFORK
+    if (n <= SIZE_MAX / sizeof(secp256k1_noncepool_slot)) {
+        size_t len = n * sizeof(secp256k1_noncepool_slot);
+        void *base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base != MAP_FAILED) {
+            /* Kernels before 4.14 do not know MADV_WIPEONFORK; the other
+             * guards still hold there. */
+            if (madvise(base, len, MADV_WIPEONFORK) == 0) {
+                *mapped = len;
+                return (secp256k1_noncepool_slot*)base;
+            }
+            munmap(base, len);
+        }
+    }
+#endif
+    *mapped = 0;
+    return (secp256k1_noncepool_slot*)calloc(n, sizeof(secp256k1_noncepool_slot));
+}
+
+static int secp256k1_noncepool_owned(const secp256k1_noncepool *pool) {
+#ifdef NONCEPOOL_HAVE_FORK
+    return pool->owner == getpid() && pool->forks == __atomic_load_n(&secp256k1_noncepool_forks, __ATOMIC_RELAXED);
+#else
+    (void)pool;
+    return 1;
+#endif
+}
+
+static void secp256k1_noncepool_wipe(secp256k1_noncepool *pool) {
+    size_t i;
+    for (i = 0; i < pool->nslots; i++) {
+        secp256k1_noncepool_slot *slot = &pool->slots[i];
+        uint32_t expected = NONCEPOOL_READY;
+        if (__atomic_compare_exchange_n(&slot->state, &expected, NONCEPOOL_BUSY, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            secp256k1_scalar_clear(&slot->r);
+            secp256k1_scalar_clear(&slot->noncei);
+            slot->recid = 0;
+            __atomic_store_n(&slot->state, NONCEPOOL_EMPTY, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+static int secp256k1_noncepool_take(secp256k1_noncepool *pool, secp256k1_scalar *r, secp256k1_scalar *noncei, int *recid) {
+    size_t start = __atomic_fetch_add(&pool->take_hint, 1, __ATOMIC_RELAXED);
+    size_t i;
+
+    if (!secp256k1_noncepool_owned(pool)) {
+        /* A forked child: the entries are the parent's too. */
+        secp256k1_noncepool_wipe(pool);
+        return 0;
+    }
+    for (i = 0; i < pool->nslots; i++) {
+        secp256k1_noncepool_slot *slot = &pool->slots[(start + i) % pool->nslots];
+        uint32_t expected = NONCEPOOL_READY;
+        if (__atomic_compare_exchange_n(&slot->state, &expected, NONCEPOOL_BUSY, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            *r = slot->r;
+            *noncei = slot->noncei;
+            *recid = slot->recid;
+            secp256k1_scalar_clear(&slot->r);
+            secp256k1_scalar_clear(&slot->noncei);
+            slot->recid = 0;
+            __atomic_store_n(&slot->state, NONCEPOOL_EMPTY, __ATOMIC_RELEASE);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+secp256k1_noncepool* secp256k1_noncepool_create(const secp256k1_context* ctx, size_t n) {
+    secp256k1_noncepool *ret;
+    SECP256K1_TRACE_ENTRY(noncepool_create, ctx, n);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(n >= 1);
+
+    ret = (secp256k1_noncepool*)checked_malloc(&ctx->error_callback, sizeof(secp256k1_noncepool));
+    if (ret == NULL) {
+        SECP256K1_TRACE_RETURN(noncepool_create, NULL);
+        return NULL;
+    }
+    if (!secp256k1_noncepool_next(&secp256k1_noncepool_serial, &ret->serial)) {
+        secp256k1_callback_call(&ctx->error_callback, "Out of nonce pool serial numbers");
+        free(ret);
+        SECP256K1_TRACE_RETURN(noncepool_create, NULL);
+        return NULL;
+    }
+#ifdef NONCEPOOL_HAVE_FORK
+    if (!secp256k1_noncepool_atfork_register()) {
+        secp256k1_callback_call(&ctx->error_callback, "Out of memory");
+        free(ret);
+        SECP256K1_TRACE_RETURN(noncepool_create, NULL);
+        return NULL;
+    }
+#endif
+    ret->nslots = n;
+    ret->slots = secp256k1_noncepool_slots_alloc(n, &ret->mapped);
+    SECP256K1_STATS_INC(alloc);
+    if (ret->slots == NULL) {
+        secp256k1_callback_call(&ctx->error_callback, "Out of memory");
+        free(ret);
+        SECP256K1_TRACE_RETURN(noncepool_create, NULL);
+        return NULL;
+    }
+    ret->fill_hint = 0;
+    ret->take_hint = 0;
+    ret->counter = 0;
+#ifdef NONCEPOOL_HAVE_FORK
+    ret->owner = getpid();
+    ret->forks = __atomic_load_n(&secp256k1_noncepool_forks, __ATOMIC_RELAXED);
+#endif
+    SECP256K1_TRACE_RETURN(noncepool_create, ret);
+    return ret;
+}
+
+void secp256k1_noncepool_destroy(secp256k1_noncepool* pool) {
+    SECP256K1_TRACE_ENTRY(noncepool_destroy, NULL, 0);
+    if (pool != NULL) {
+        memset(pool->slots, 0, pool->nslots * sizeof(secp256k1_noncepool_slot));
+#ifdef NONCEPOOL_WIPEONFORK
+        if (pool->mapped != 0) {
+            munmap(pool->slots, pool->mapped);
+            pool->slots = NULL;
+        }
+#endif
+        free(pool->slots);
+        free(pool);
+    }
+    SECP256K1_TRACE_RETURN(noncepool_destroy, 0);
+}
+
+size_t secp256k1_noncepool_fill(const secp256k1_context* ctx, secp256k1_noncepool *pool, const unsigned char *seed32) {
+    secp256k1_noncepool_slot *claimed[SECP256K1_ECDSA_SIGN_BATCH];
+    secp256k1_scalar nonce[SECP256K1_ECDSA_SIGN_BATCH];
+    secp256k1_scalar r[SECP256K1_ECDSA_SIGN_BATCH];
+    secp256k1_scalar noncei[SECP256K1_ECDSA_SIGN_BATCH];
+    int recid[SECP256K1_ECDSA_SIGN_BATCH];
+    secp256k1_rfc6979_hmac_sha256_t rng;
+    unsigned char keydata[48];
+    unsigned char nonce32[32];
+    uint64_t pid = 0;
+    uint32_t ctr;
+    size_t start, i, m = 0;
+    int overflow;
+    SECP256K1_TRACE_ENTRY(noncepool_fill, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_gen_ready(ctx));
+    ARG_CHECK(pool != NULL);
+    ARG_CHECK(seed32 != NULL);
+
+    if (!secp256k1_noncepool_owned(pool)) {
+        secp256k1_noncepool_wipe(pool);
+        SECP256K1_TRACE_RETURN(noncepool_fill, 0);
+        return 0;
+    }
+    /* Take the counter value first, so that an exhausted pool claims no slots. */
+    if (!secp256k1_noncepool_next(&pool->counter, &ctr)) {
+        SECP256K1_TRACE_RETURN(noncepool_fill, 0);
+        return 0;
+    }
+    start = __atomic_fetch_add(&pool->fill_hint, SECP256K1_ECDSA_SIGN_BATCH, __ATOMIC_RELAXED);
+    for (i = 0; i < pool->nslots && m < SECP256K1_ECDSA_SIGN_BATCH; i++) {
+        secp256k1_noncepool_slot *slot = &pool->slots[(start + i) % pool->nslots];
+        uint32_t expected = NONCEPOOL_EMPTY;
+        if (__atomic_compare_exchange_n(&slot->state, &expected, NONCEPOOL_BUSY, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            claimed[m++] = slot;
+        }
+    }
+    if (m == 0) {
+        SECP256K1_TRACE_RETURN(noncepool_fill, 0);
+        return 0;
+    }
+
+    /* The nonces come from an HMAC-DRBG keyed with
+     * seed32 || pid || serial || counter. */
+#ifdef NONCEPOOL_HAVE_FORK
+    pid = (uint64_t)pool->owner;
+#endif
+    memcpy(keydata, seed32, 32);
+    for (i = 0; i < 8; i++) {
+        keydata[32 + i] = pid >> (56 - 8 * i);
+    }
+    for (i = 0; i < 4; i++) {
+        keydata[40 + i] = pool->serial >> (24 - 8 * i);
+        keydata[44 + i] = ctr >> (24 - 8 * i);
+    }
+    secp256k1_rfc6979_hmac_sha256_initialize(&rng, keydata, sizeof(keydata));
+    memset(keydata, 0, sizeof(keydata));
+    for (i = 0; i < m; i++) {
+        do {
+            secp256k1_rfc6979_hmac_sha256_generate(&rng, nonce32, 32);
+            secp256k1_scalar_set_b32(&nonce[i], nonce32, &overflow);
+        } while (overflow || secp256k1_scalar_is_zero(&nonce[i]));
+    }
+    secp256k1_rfc6979_hmac_sha256_finalize(&rng);
+    memset(nonce32, 0, sizeof(nonce32));
+
+    secp256k1_ecdsa_sig_nonce_batch(&ctx->ecmult_gen_ctx, r, noncei, recid, nonce, m);
+    for (i = 0; i < m; i++) {
+        claimed[i]->r = r[i];
+        claimed[i]->noncei = noncei[i];
+        claimed[i]->recid = recid[i];
+        __atomic_store_n(&claimed[i]->state, NONCEPOOL_READY, __ATOMIC_RELEASE);
+    }
+    memset(nonce, 0, sizeof(nonce));
+    memset(r, 0, sizeof(r));
+    memset(noncei, 0, sizeof(noncei));
+    memset(recid, 0, sizeof(recid));
+    SECP256K1_TRACE_RETURN(noncepool_fill, m);
+    return m;
+}
+
+void secp256k1_noncepool_clear(secp256k1_noncepool *pool) {
+    SECP256K1_TRACE_ENTRY(noncepool_clear, NULL, 0);
+    VERIFY_CHECK(pool != NULL);
+    secp256k1_noncepool_wipe(pool);
+    SECP256K1_TRACE_RETURN(noncepool_clear, 0);
+}
+
+int secp256k1_ecdsa_sign_pooled(const secp256k1_context* ctx, secp256k1_noncepool *pool, secp256k1_ecdsa_signature *signature, int *recid, const unsigned char *msg32, const unsigned char *seckey) {
+    secp256k1_scalar r, s;
+    secp256k1_scalar sec, noncei, msg;
+    int rid = 0;
+    int ret = 0;
+    int overflow = 0;
+    SECP256K1_TRACE_ENTRY(ecdsa_sign_pooled, ctx, 1);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pool != NULL);
+    ARG_CHECK(msg32 != NULL);
+    ARG_CHECK(signature != NULL);
+    ARG_CHECK(seckey != NULL);
+
+    secp256k1_scalar_set_b32(&sec, seckey, &overflow);
+    /* Fail if the secret key is invalid, before an entry is used up. */
+    if (!overflow && !secp256k1_scalar_is_zero(&sec)) {
+        secp256k1_scalar_set_b32(&msg, msg32, NULL);
+        /* s is only zero if the entry's nonce happens to be the one nonce
+         * that fails for this key and message; take the next one then. */
+        while ((ret = secp256k1_noncepool_take(pool, &r, &noncei, &rid))) {
+            if (secp256k1_ecdsa_sig_sign_inv(&s, &r, &sec, &msg, &noncei, &rid)) {
+                break;
+            }
+        }
+        secp256k1_scalar_clear(&msg);
+        secp256k1_scalar_clear(&noncei);
+        secp256k1_scalar_clear(&sec);
+    }
+    if (ret) {
+        secp256k1_ecdsa_signature_save(signature, &r, &s);
+    } else {
+        memset(signature, 0, sizeof(*signature));
+        rid = 0;
+    }
+    if (recid != NULL) {
+        *recid = rid;
+    }
+    SECP256K1_TRACE_RETURN(ecdsa_sign_pooled, ret);
+    return ret;
+}
+
+#endif
@@ -0,0 +1,218 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_NONCEPOOL_TESTS_
+#define _SECP256K1_MODULE_NONCEPOOL_TESTS_
+
+#ifdef NONCEPOOL_HAVE_FORK
+# include <sys/wait.h>
+#endif
+
+static void noncepool_random_key(unsigned char *seckey, unsigned char *msg32, secp256k1_pubkey *pubkey) {
+    secp256k1_scalar key, msg;
+    random_scalar_order_test(&key);
+    random_scalar_order_test(&msg);
+    secp256k1_scalar_get_b32(seckey, &key);
+    secp256k1_scalar_get_b32(msg32, &msg);
+    CHECK(secp256k1_ec_pubkey_create(ctx, pubkey, seckey) == 1);
+}
+
+void test_noncepool_api(void) {
+    secp256k1_context *none = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+    secp256k1_noncepool *pool;
+    secp256k1_ecdsa_signature sig;
+    unsigned char seed[32] = { 0 };
+    unsigned char key[32];
+    unsigned char msg[32];
+    secp256k1_pubkey pubkey;
+    int32_t ecount = 0;
+
+    secp256k1_context_set_illegal_callback(none, counting_illegal_callback_fn, &ecount);
+    secp256k1_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    noncepool_random_key(key, msg, &pubkey);
+
+    CHECK(secp256k1_noncepool_create(none, 0) == NULL);
+    CHECK(ecount == 1);
+    pool = secp256k1_noncepool_create(none, 1);
+    CHECK(pool != NULL);
+
+    CHECK(secp256k1_noncepool_fill(none, pool, seed) == 0);
+    CHECK(ecount == 2);
+    CHECK(secp256k1_noncepool_fill(ctx, NULL, seed) == 0);
+    CHECK(ecount == 3);
+    CHECK(secp256k1_noncepool_fill(ctx, pool, NULL) == 0);
+    CHECK(ecount == 4);
+    CHECK(secp256k1_noncepool_fill(ctx, pool, seed) == 1);
+    CHECK(ecount == 4);
+
+    CHECK(secp256k1_ecdsa_sign_pooled(none, NULL, &sig, NULL, msg, key) == 0);
+    CHECK(ecount == 5);
+    CHECK(secp256k1_ecdsa_sign_pooled(none, pool, NULL, NULL, msg, key) == 0);
+    CHECK(ecount == 6);
+    CHECK(secp256k1_ecdsa_sign_pooled(none, pool, &sig, NULL, NULL, key) == 0);
+    CHECK(ecount == 7);
+    CHECK(secp256k1_ecdsa_sign_pooled(none, pool, &sig, NULL, msg, NULL) == 0);
+    CHECK(ecount == 8);
+    /* Signing needs no precomputation tables of its own. */
+    CHECK(secp256k1_ecdsa_sign_pooled(none, pool, &sig, NULL, msg, key) == 1);
+    CHECK(ecount == 8);
+    CHECK(secp256k1_ecdsa_verify(ctx, &sig, msg, &pubkey) == 1);
+
+    secp256k1_context_set_illegal_callback(ctx, NULL, NULL);
+    secp256k1_noncepool_destroy(pool);
+    secp256k1_noncepool_destroy(NULL);
+    secp256k1_context_destroy(none);
+}
+
+void test_noncepool_single_use(void) {
+    /* Every entry signs exactly once, with a nonce of its own. */
+    secp256k1_noncepool *pool = secp256k1_noncepool_create(ctx, 40);
+    secp256k1_ecdsa_signature sig[40];
+    secp256k1_ecdsa_signature zero;
+    secp256k1_pubkey pubkey;
+    secp256k1_scalar r[40], s;
+    unsigned char seed[32];
+    unsigned char key[32];
+    unsigned char msg[32];
+    int recid;
+    int i, j;
+
+    memset(&zero, 0, sizeof(zero));
+    noncepool_random_key(key, msg, &pubkey);
+    /* The same seed twice still gives distinct nonces. */
+    secp256k1_rand256(seed);
+    CHECK(secp256k1_noncepool_fill(ctx, pool, seed) == SECP256K1_ECDSA_SIGN_BATCH);
+    CHECK(secp256k1_noncepool_fill(ctx, pool, seed) == 40 - SECP256K1_ECDSA_SIGN_BATCH);
+    CHECK(secp256k1_noncepool_fill(ctx, pool, seed) == 0);
+
+    /* An invalid key leaves the pool alone. */
+    memset(seed, 0xFF, 32);
+    CHECK(secp256k1_ecdsa_sign_pooled(ctx, pool, &sig[0], NULL, msg, seed) == 0);
+
+    for (i = 0; i < 40; i++) {
+        CHECK(secp256k1_ecdsa_sign_pooled(ctx, pool, &sig[i], &recid, msg, key) == 1);
+        CHECK(secp256k1_ecdsa_verify(ctx, &sig[i], msg, &pubkey) == 1);
+#ifdef ENABLE_MODULE_RECOVERY
+        {
+            secp256k1_ecdsa_recoverable_signature rsig;
+            secp256k1_pubkey recpubkey;
+            unsigned char compact[64];
+            CHECK(secp256k1_ecdsa_signature_serialize_compact(ctx, compact, &sig[i]) == 1);
+            CHECK(secp256k1_ecdsa_recoverable_signature_parse_compact(ctx, &rsig, compact, recid) == 1);
+            CHECK(secp256k1_ecdsa_recover(ctx, &recpubkey, &rsig, msg) == 1);
+            CHECK(memcmp(&pubkey, &recpubkey, sizeof(pubkey)) == 0);
+        }
+#endif
+        secp256k1_ecdsa_signature_load(ctx, &r[i], &s, &sig[i]);
+        for (j = 0; j < i; j++) {
+            CHECK(!secp256k1_scalar_eq(&r[i], &r[j]));
+        }
+    }
+    CHECK(secp256k1_ecdsa_sign_pooled(ctx, pool, &sig[0], &recid, msg, key) == 0);
+    CHECK(memcmp(&sig[0], &zero, sizeof(zero)) == 0);
+
+    /* Cleared entries are gone. */
+    CHECK(secp256k1_noncepool_fill(ctx, pool, seed) == SECP256K1_ECDSA_SIGN_BATCH);
+    secp256k1_noncepool_clear(pool);
+    CHECK(secp256k1_ecdsa_sign_pooled(ctx, pool, &sig[0], NULL, msg, key) == 0);
+
+    secp256k1_noncepool_destroy(pool);
+}
+
+void test_noncepool_seed_reuse(void) {
+    /* Two pools filled with one seed still get distinct nonces. */
+    secp256k1_noncepool *pool1 = secp256k1_noncepool_create(ctx, 1);
+    secp256k1_noncepool *pool2 = secp256k1_noncepool_create(ctx, 1);
+    secp256k1_ecdsa_signature sig1, sig2;
+    secp256k1_pubkey pubkey;
+    secp256k1_scalar r1, r2, s;
+    unsigned char seed[32];
+    unsigned char key[32];
+    unsigned char msg[32];
+
+    noncepool_random_key(key, msg, &pubkey);
+    secp256k1_rand256(seed);
+    CHECK(pool1->serial != pool2->serial);
+    CHECK(secp256k1_noncepool_fill(ctx, pool1, seed) == 1);
+    CHECK(secp256k1_noncepool_fill(ctx, pool2, seed) == 1);
+    CHECK(secp256k1_ecdsa_sign_pooled(ctx, pool1, &sig1, NULL, msg, key) == 1);
+    CHECK(secp256k1_ecdsa_sign_pooled(ctx, pool2, &sig2, NULL, msg, key) == 1);
+    secp256k1_ecdsa_signature_load(ctx, &r1, &s, &sig1);
+    secp256k1_ecdsa_signature_load(ctx, &r2, &s, &sig2);
+    CHECK(!secp256k1_scalar_eq(&r1, &r2));
+
+    /* A pool whose fill counter has run out stays empty rather than start
+     * over with counter values it used before. */
+    pool1->counter = 0xFFFFFFFEUL;
+    CHECK(secp256k1_noncepool_fill(ctx, pool1, seed) == 1);
+    CHECK(secp256k1_ecdsa_sign_pooled(ctx, pool1, &sig1, NULL, msg, key) == 1);
+    CHECK(secp256k1_noncepool_fill(ctx, pool1, seed) == 0);
+    CHECK(pool1->counter == 0xFFFFFFFFUL);
+    CHECK(pool1->slots[0].state == NONCEPOOL_EMPTY);
+    CHECK(secp256k1_ecdsa_sign_pooled(ctx, pool1, &sig1, NULL, msg, key) == 0);
+
+    secp256k1_noncepool_destroy(pool1);
+    secp256k1_noncepool_destroy(pool2);
+}
+
+#ifdef NONCEPOOL_HAVE_FORK
+void test_noncepool_fork(void) {
+    /* A forked child must not sign with, or add to, its copy of the pool. */
+    secp256k1_noncepool *pool = secp256k1_noncepool_create(ctx, 4);
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey pubkey;
+    unsigned char seed[32];
+    unsigned char key[32];
+    unsigned char msg[32];
+    pid_t child;
+    int status;
+
+    noncepool_random_key(key, msg, &pubkey);
+    secp256k1_rand256(seed);
+    CHECK(secp256k1_noncepool_fill(ctx, pool, seed) == 4);
+    fflush(stdout);
+    child = fork();
+    CHECK(child >= 0);
+    if (child == 0) {
+        int ok = 1;
+#ifdef NONCEPOOL_WIPEONFORK
+        size_t i;
+        for (i = 0; i < pool->nslots && pool->mapped != 0; i++) {
+            ok = ok && pool->slots[i].state == NONCEPOOL_EMPTY;
+        }
+#endif
+        /* Not even with the pid the pool was created in, as a grandchild
+         * may get once its grandparent has exited. */
+        pool->owner = getpid();
+        ok = ok && secp256k1_ecdsa_sign_pooled(ctx, pool, &sig, NULL, msg, key) == 0;
+        secp256k1_noncepool_clear(pool);
+        ok = ok && secp256k1_noncepool_fill(ctx, pool, seed) == 0;
+        ok = ok && secp256k1_ecdsa_sign_pooled(ctx, pool, &sig, NULL, msg, key) == 0;
+        _exit(ok ? 0 : 1);
+    }
+    CHECK(waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    /* The parent's entries are untouched. */
+    CHECK(secp256k1_ecdsa_sign_pooled(ctx, pool, &sig, NULL, msg, key) == 1);
+    CHECK(secp256k1_ecdsa_verify(ctx, &sig, msg, &pubkey) == 1);
+
+    secp256k1_noncepool_destroy(pool);
+}
+#endif
+
+void run_noncepool_tests(void) {
+    int i;
+    test_noncepool_api();
+    for (i = 0; i < count; i++) {
+        test_noncepool_single_use();
+    }
+    test_noncepool_seed_reuse();
+#ifdef NONCEPOOL_HAVE_FORK
+    test_noncepool_fork();
+#endif
+}
+
+#endif
@@ -41,6 +41,7 @@ int secp256k1_ecdsa_recoverable_signature_parse_compact(const secp256k1_context*
     int overflow = 0;
 
     (void)ctx;
+    SECP256K1_TRACE_ENTRY(ecdsa_recoverable_signature_parse_compact, ctx, 64);
     ARG_CHECK(sig != NULL);
     ARG_CHECK(input64 != NULL);
     ARG_CHECK(recid >= 0 && recid <= 3);
@@ -54,6 +55,7 @@ int secp256k1_ecdsa_recoverable_signature_parse_compact(const secp256k1_context*
     } else {
         memset(sig, 0, sizeof(*sig));
     }
+    SECP256K1_TRACE_RETURN(ecdsa_recoverable_signature_parse_compact, ret);
     return ret;
 }
 
@@ -61,6 +63,7 @@ int secp256k1_ecdsa_recoverable_signature_serialize_compact(const secp256k1_cont
     secp256k1_scalar r, s;
 
     (void)ctx;
+    SECP256K1_TRACE_ENTRY(ecdsa_recoverable_signature_serialize_compact, ctx, 64);
     ARG_CHECK(output64 != NULL);
     ARG_CHECK(sig != NULL);
     ARG_CHECK(recid != NULL);
@@ -68,6 +71,7 @@ int secp256k1_ecdsa_recoverable_signature_serialize_compact(const secp256k1_cont
     secp256k1_ecdsa_recoverable_signature_load(ctx, &r, &s, recid, sig);
     secp256k1_scalar_get_b32(&output64[0], &r);
     secp256k1_scalar_get_b32(&output64[32], &s);
+    SECP256K1_TRACE_RETURN(ecdsa_recoverable_signature_serialize_compact, 1);
     return 1;
 }
 
@@ -76,11 +80,13 @@ int secp256k1_ecdsa_recoverable_signature_convert(const secp256k1_context* ctx,
     int recid;
 
     (void)ctx;
+    SECP256K1_TRACE_ENTRY(ecdsa_recoverable_signature_convert, ctx, 0);
     ARG_CHECK(sig != NULL);
     ARG_CHECK(sigin != NULL);
 
     secp256k1_ecdsa_recoverable_signature_load(ctx, &r, &s, &recid, sigin);
     secp256k1_ecdsa_signature_save(sig, &r, &s);
+    SECP256K1_TRACE_RETURN(ecdsa_recoverable_signature_convert, 1);
     return 1;
 }
 
@@ -126,8 +132,9 @@ int secp256k1_ecdsa_sign_recoverable(const secp256k1_context* ctx, secp256k1_ecd
     int recid;
     int ret = 0;
     int overflow = 0;
+    SECP256K1_TRACE_ENTRY(ecdsa_sign_recoverable, ctx, 1);
     VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(secp256k1_context_ecmult_gen_ready(ctx));
     ARG_CHECK(msg32 != NULL);
     ARG_CHECK(signature != NULL);
     ARG_CHECK(seckey != NULL);
@@ -164,6 +171,39 @@ int secp256k1_ecdsa_sign_recoverable(const secp256k1_context* ctx, secp256k1_ecd
     } else {
         memset(signature, 0, sizeof(*signature));
     }
+    SECP256K1_TRACE_RETURN(ecdsa_sign_recoverable, ret);
+    return ret;
+}
+
+int secp256k1_ecdsa_sign_recoverable_batch(const secp256k1_context* ctx, secp256k1_ecdsa_recoverable_signature *signatures, const unsigned char *msgs32, const unsigned char *seckeys, size_t n, secp256k1_nonce_function noncefp, const void* noncedata) {
+    secp256k1_scalar r[SECP256K1_ECDSA_SIGN_BATCH], s[SECP256K1_ECDSA_SIGN_BATCH];
+    int recid[SECP256K1_ECDSA_SIGN_BATCH];
+    int ok[SECP256K1_ECDSA_SIGN_BATCH];
+    size_t i, j;
+    int ret = 1;
+    SECP256K1_TRACE_ENTRY(ecdsa_sign_recoverable_batch, ctx, n);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_gen_ready(ctx));
+    ARG_CHECK(signatures != NULL);
+    ARG_CHECK(msgs32 != NULL);
+    ARG_CHECK(seckeys != NULL);
+    if (noncefp == NULL) {
+        noncefp = secp256k1_nonce_function_default;
+    }
+
+    for (i = 0; i < n; i += SECP256K1_ECDSA_SIGN_BATCH) {
+        size_t len = n - i < SECP256K1_ECDSA_SIGN_BATCH ? n - i : SECP256K1_ECDSA_SIGN_BATCH;
+        secp256k1_ecdsa_sign_batch_chunk(ctx, ok, r, s, recid, &msgs32[32 * i], &seckeys[32 * i], len, noncefp, noncedata);
+        for (j = 0; j < len; j++) {
+            if (ok[j]) {
+                secp256k1_ecdsa_recoverable_signature_save(&signatures[i + j], &r[j], &s[j], recid[j]);
+            } else {
+                memset(&signatures[i + j], 0, sizeof(signatures[i + j]));
+                ret = 0;
+            }
+        }
+    }
+    SECP256K1_TRACE_RETURN(ecdsa_sign_recoverable_batch, ret);
     return ret;
 }
 
@@ -172,8 +212,10 @@ int secp256k1_ecdsa_recover(const secp256k1_context* ctx, secp256k1_pubkey *pubk
     secp256k1_scalar r, s;
     secp256k1_scalar m;
     int recid;
+    int ret;
+    SECP256K1_TRACE_ENTRY(ecdsa_recover, ctx, 1);
     VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
     ARG_CHECK(msg32 != NULL);
     ARG_CHECK(signature != NULL);
     ARG_CHECK(pubkey != NULL);
@@ -181,13 +223,14 @@ int secp256k1_ecdsa_recover(const secp256k1_context* ctx, secp256k1_pubkey *pubk
     secp256k1_ecdsa_recoverable_signature_load(ctx, &r, &s, &recid, signature);
     VERIFY_CHECK(recid >= 0 && recid < 4);  /* should have been caught in parse_compact */
     secp256k1_scalar_set_b32(&m, msg32, NULL);
-    if (secp256k1_ecdsa_sig_recover(&ctx->ecmult_ctx, &r, &s, &q, &m, recid)) {
+    ret = secp256k1_ecdsa_sig_recover(&ctx->ecmult_ctx, &r, &s, &q, &m, recid);
+    if (ret) {
         secp256k1_pubkey_save(pubkey, &q);
-        return 1;
     } else {
         memset(pubkey, 0, sizeof(*pubkey));
-        return 0;
     }
+    SECP256K1_TRACE_RETURN(ecdsa_recover, ret);
+    return ret;
 }
 
 #endif
@@ -205,6 +205,40 @@ void test_ecdsa_recovery_end_to_end(void) {
           memcmp(&pubkey, &recpubkey, sizeof(pubkey)) != 0);
 }
 
+void test_ecdsa_recovery_sign_batch(void) {
+    unsigned char privkey[SIGN_BATCH_MAX][32];
+    unsigned char message[SIGN_BATCH_MAX][32];
+    secp256k1_ecdsa_recoverable_signature rsignature[SIGN_BATCH_MAX];
+    secp256k1_ecdsa_recoverable_signature single;
+    size_t n = secp256k1_rand_int(SIGN_BATCH_MAX) + 1;
+    size_t i;
+    int32_t ecount = 0;
+
+    for (i = 0; i < n; i++) {
+        secp256k1_scalar msg, key;
+        random_scalar_order_test(&msg);
+        random_scalar_order_test(&key);
+        secp256k1_scalar_get_b32(privkey[i], &key);
+        secp256k1_scalar_get_b32(message[i], &msg);
+    }
+
+    /* Signatures and recovery ids match secp256k1_ecdsa_sign_recoverable. */
+    CHECK(secp256k1_ecdsa_sign_recoverable_batch(ctx, rsignature, message[0], privkey[0], n, NULL, NULL) == 1);
+    for (i = 0; i < n; i++) {
+        CHECK(secp256k1_ecdsa_sign_recoverable(ctx, &single, message[i], privkey[i], NULL, NULL) == 1);
+        CHECK(memcmp(&single, &rsignature[i], sizeof(single)) == 0);
+    }
+
+    secp256k1_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    CHECK(secp256k1_ecdsa_sign_recoverable_batch(ctx, NULL, message[0], privkey[0], n, NULL, NULL) == 0);
+    CHECK(ecount == 1);
+    CHECK(secp256k1_ecdsa_sign_recoverable_batch(ctx, rsignature, NULL, privkey[0], n, NULL, NULL) == 0);
+    CHECK(ecount == 2);
+    CHECK(secp256k1_ecdsa_sign_recoverable_batch(ctx, rsignature, message[0], NULL, n, NULL, NULL) == 0);
+    CHECK(ecount == 3);
+    secp256k1_context_set_illegal_callback(ctx, NULL, NULL);
+}
+
 /* Tests several edge cases. */
 void test_ecdsa_recovery_edge_cases(void) {
     const unsigned char msg32[32] = {
@@ -387,6 +421,9 @@ void run_recovery_tests(void) {
     for (i = 0; i < 64*count; i++) {
         test_ecdsa_recovery_end_to_end();
     }
+    for (i = 0; i < 4*count; i++) {
+        test_ecdsa_recovery_sign_batch();
+    }
     test_ecdsa_recovery_edge_cases();
 }
 
@@ -0,0 +1,350 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_SCHNORRSIG_MAIN_
+#define _SECP256K1_MODULE_SCHNORRSIG_MAIN_
+
+#include "include/secp256k1_schnorrsig.h"
+#include "hash_impl.h"
+
+/** The number of signatures a batch verification combines into one
+ *  multi-multiplication. Larger chunks save little once the cost of the
+ *  doublings and of the G terms is spread over this many signatures. */
+#define SCHNORRSIG_BATCH 64
+
+/* The states of SHA256 after it has consumed SHA256(tag) || SHA256(tag), for
+ * the tags of the three BIP340 tagged hashes. */
+static const uint32_t secp256k1_schnorrsig_midstate_aux[8] = {
+    0x24dd3219ul, 0x4eba7e70ul, 0xca0fabb9ul, 0x0fa3166dul,
+    0x3afbe4b1ul, 0x4c44df97ul, 0x4aac2739ul, 0x249e850aul
+};
+
+static const uint32_t secp256k1_schnorrsig_midstate_nonce[8] = {
+    0x46615b35ul, 0xf4bfbff7ul, 0x9f8dc671ul, 0x83627ab3ul,
+    0x60217180ul, 0x57358661ul, 0x21a29e54ul, 0x68b07b4cul
+};
+
+static const uint32_t secp256k1_schnorrsig_midstate_challenge[8] = {
+    0x9cecba11ul, 0x23925381ul, 0x11679112ul, 0xd1627e0ful,
+    0x97c87550ul, 0x003cc765ul, 0x90f61164ul, 0x33e9b66aul
+};
+
+/** Start a tagged hash, SHA256(SHA256(tag) || SHA256(tag) || ...), from the
+ *  precomputed state after its first block. */
+static void secp256k1_schnorrsig_sha256_tagged(secp256k1_sha256_t *sha, const uint32_t *midstate) {
+    int i;
+    for (i = 0; i < 8; i++) {
+        sha->s[i] = midstate[i];
+    }
+    sha->bytes = 64;
+}
+
+/** e = int(hash_BIP0340/challenge(r32 || pk32 || msg32)) mod n */
+static void secp256k1_schnorrsig_challenge(secp256k1_scalar *e, const unsigned char *r32, const unsigned char *pk32, const unsigned char *msg32) {
+    secp256k1_sha256_t sha;
+    unsigned char buf[32];
+
+    secp256k1_schnorrsig_sha256_tagged(&sha, secp256k1_schnorrsig_midstate_challenge);
+    secp256k1_sha256_write(&sha, r32, 32);
+    secp256k1_sha256_write(&sha, pk32, 32);
+    secp256k1_sha256_write(&sha, msg32, 32);
+    secp256k1_sha256_finalize(&sha, buf);
+    secp256k1_scalar_set_b32(e, buf, NULL);
+}
+
+/* An x-only public key is stored as the point with that X and an even Y, in
+ * the same form as a secp256k1_pubkey. */
+static int secp256k1_xonly_pubkey_load(const secp256k1_context* ctx, secp256k1_ge *ge, const secp256k1_xonly_pubkey *pubkey) {
+    return secp256k1_pubkey_load(ctx, ge, (const secp256k1_pubkey *) pubkey);
+}
+
+static void secp256k1_xonly_pubkey_save(secp256k1_xonly_pubkey *pubkey, secp256k1_ge *ge) {
+    secp256k1_pubkey_save((secp256k1_pubkey *) pubkey, ge);
+}
+
+int secp256k1_xonly_pubkey_parse(const secp256k1_context* ctx, secp256k1_xonly_pubkey *pubkey, const unsigned char *input32) {
+    secp256k1_ge pk;
+    secp256k1_fe x;
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(xonly_pubkey_parse, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pubkey != NULL);
+    memset(pubkey, 0, sizeof(*pubkey));
+    ARG_CHECK(input32 != NULL);
+
+    if (secp256k1_fe_set_b32(&x, input32) && secp256k1_ge_set_xo_var(&pk, &x, 0)) {
+        secp256k1_xonly_pubkey_save(pubkey, &pk);
+        ret = 1;
+    }
+    SECP256K1_TRACE_RETURN(xonly_pubkey_parse, ret);
+    return ret;
+}
+
+int secp256k1_xonly_pubkey_serialize(const secp256k1_context* ctx, unsigned char *output32, const secp256k1_xonly_pubkey *pubkey) {
+    secp256k1_ge pk;
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(xonly_pubkey_serialize, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(output32 != NULL);
+    memset(output32, 0, 32);
+    ARG_CHECK(pubkey != NULL);
+
+    if (secp256k1_xonly_pubkey_load(ctx, &pk, pubkey)) {
+        secp256k1_fe_normalize_var(&pk.x);
+        secp256k1_fe_get_b32(output32, &pk.x);
+        ret = 1;
+    }
+    SECP256K1_TRACE_RETURN(xonly_pubkey_serialize, ret);
+    return ret;
+}
+
+int secp256k1_xonly_pubkey_from_pubkey(const secp256k1_context* ctx, secp256k1_xonly_pubkey *xonly_pubkey, int *pk_parity, const secp256k1_pubkey *pubkey) {
+    secp256k1_ge pk;
+    int odd;
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(xonly_pubkey_from_pubkey, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(xonly_pubkey != NULL);
+    memset(xonly_pubkey, 0, sizeof(*xonly_pubkey));
+    ARG_CHECK(pubkey != NULL);
+
+    if (secp256k1_pubkey_load(ctx, &pk, pubkey)) {
+        secp256k1_fe_normalize_var(&pk.y);
+        odd = secp256k1_fe_is_odd(&pk.y);
+        if (odd) {
+            secp256k1_ge_neg(&pk, &pk);
+        }
+        if (pk_parity != NULL) {
+            *pk_parity = odd;
+        }
+        secp256k1_xonly_pubkey_save(xonly_pubkey, &pk);
+        ret = 1;
+    }
+    SECP256K1_TRACE_RETURN(xonly_pubkey_from_pubkey, ret);
+    return ret;
+}
+
+int secp256k1_schnorrsig_sign(const secp256k1_context* ctx, unsigned char *sig64, const unsigned char *msg32, const unsigned char *seckey, const unsigned char *aux_rand32) {
+    static const unsigned char zero32[32] = { 0 };
+    secp256k1_scalar sk, k, e;
+    secp256k1_gej pj, rj;
+    secp256k1_ge pk, r;
+    secp256k1_sha256_t sha;
+    unsigned char pk32[32];
+    unsigned char t[32];
+    unsigned char buf[32];
+    int overflow;
+    int ret = 0;
+    int i;
+    SECP256K1_TRACE_ENTRY(schnorrsig_sign, ctx, 1);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_gen_ready(ctx));
+    ARG_CHECK(sig64 != NULL);
+    ARG_CHECK(msg32 != NULL);
+    ARG_CHECK(seckey != NULL);
+    if (aux_rand32 == NULL) {
+        aux_rand32 = zero32;
+    }
+
+    secp256k1_scalar_set_b32(&sk, seckey, &overflow);
+    if (!overflow && !secp256k1_scalar_is_zero(&sk)) {
+        /* Use the secret key whose public key has an even Y. */
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pj, &sk);
+        secp256k1_ge_set_gej(&pk, &pj);
+        secp256k1_fe_normalize(&pk.x);
+        secp256k1_fe_normalize(&pk.y);
+        secp256k1_scalar_cond_negate(&sk, secp256k1_fe_is_odd(&pk.y));
+        secp256k1_fe_get_b32(pk32, &pk.x);
+
+        /* t = bytes(d) xor hash_BIP0340/aux(aux_rand32) */
+        secp256k1_schnorrsig_sha256_tagged(&sha, secp256k1_schnorrsig_midstate_aux);
+        secp256k1_sha256_write(&sha, aux_rand32, 32);
+        secp256k1_sha256_finalize(&sha, buf);
+        secp256k1_scalar_get_b32(t, &sk);
+        for (i = 0; i < 32; i++) {
+            t[i] ^= buf[i];
+        }
+
+        /* k = int(hash_BIP0340/nonce(t || bytes(P) || m)) mod n */
+        secp256k1_schnorrsig_sha256_tagged(&sha, secp256k1_schnorrsig_midstate_nonce);
+        secp256k1_sha256_write(&sha, t, 32);
+        secp256k1_sha256_write(&sha, pk32, 32);
+        secp256k1_sha256_write(&sha, msg32, 32);
+        secp256k1_sha256_finalize(&sha, buf);
+        secp256k1_scalar_set_b32(&k, buf, NULL);
+
+        /* k is only zero if SHA256 is broken. */
+        if (!secp256k1_scalar_is_zero(&k)) {
+            secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &rj, &k);
+            secp256k1_ge_set_gej(&r, &rj);
+            secp256k1_fe_normalize(&r.x);
+            secp256k1_fe_normalize(&r.y);
+            secp256k1_scalar_cond_negate(&k, secp256k1_fe_is_odd(&r.y));
+            secp256k1_fe_get_b32(sig64, &r.x);
+
+            /* s = k + e*d */
+            secp256k1_schnorrsig_challenge(&e, sig64, pk32, msg32);
+            secp256k1_scalar_mul(&e, &e, &sk);
+            secp256k1_scalar_add(&e, &e, &k);
+            secp256k1_scalar_get_b32(sig64 + 32, &e);
+            ret = 1;
+        }
+        secp256k1_scalar_clear(&k);
+        memset(t, 0, sizeof(t));
+        memset(buf, 0, sizeof(buf));
+    }
+    if (!ret) {
+        memset(sig64, 0, 64);
+    }
+    secp256k1_scalar_clear(&sk);
+    SECP256K1_TRACE_RETURN(schnorrsig_sign, ret);
+    return ret;
+}
+
+/** Parse the r and s values of a signature, failing unless r < p and s < n. */
+static int secp256k1_schnorrsig_load(secp256k1_fe *rx, secp256k1_scalar *s, const unsigned char *sig64) {
+    int overflow;
+    if (!secp256k1_fe_set_b32(rx, sig64)) {
+        return 0;
+    }
+    secp256k1_scalar_set_b32(s, sig64 + 32, &overflow);
+    return !overflow;
+}
+
+int secp256k1_schnorrsig_verify(const secp256k1_context* ctx, const unsigned char *sig64, const unsigned char *msg32, const secp256k1_xonly_pubkey *pubkey) {
+    secp256k1_scalar s, e;
+    secp256k1_gej pkj, rj;
+    secp256k1_ge pk, r;
+    secp256k1_fe rx;
+    unsigned char pk32[32];
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(schnorrsig_verify, ctx, 1);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
+    ARG_CHECK(sig64 != NULL);
+    ARG_CHECK(msg32 != NULL);
+    ARG_CHECK(pubkey != NULL);
+
+    if (secp256k1_schnorrsig_load(&rx, &s, sig64) && secp256k1_xonly_pubkey_load(ctx, &pk, pubkey)) {
+        /* R = s*G - e*P must have an even Y and the X that was signed. */
+        secp256k1_fe_normalize_var(&pk.x);
+        secp256k1_fe_get_b32(pk32, &pk.x);
+        secp256k1_schnorrsig_challenge(&e, sig64, pk32, msg32);
+        secp256k1_scalar_negate(&e, &e);
+        secp256k1_gej_set_ge(&pkj, &pk);
+        secp256k1_ecmult(&ctx->ecmult_ctx, &rj, &pkj, &e, &s);
+
+        secp256k1_ge_set_gej_var(&r, &rj);
+        if (!secp256k1_ge_is_infinity(&r)) {
+            secp256k1_fe_normalize_var(&r.y);
+            ret = !secp256k1_fe_is_odd(&r.y) && secp256k1_fe_equal_var(&rx, &r.x);
+        }
+    }
+    SECP256K1_TRACE_RETURN(schnorrsig_verify, ret);
+    return ret;
+}
+
+/** Check signatures i..i+n-1 of a batch. With a_j the weight of signature j,
+ *  R_j its lifted r value and e_j its challenge, this checks that
+ *  sum(a_j*s_j)*G - sum(a_j*R_j) - sum(a_j*e_j*P_j) is infinity, which
+ *  (unless the weights can be predicted) only holds if every signature is
+ *  valid. */
+static int secp256k1_schnorrsig_verify_batch_chunk(const secp256k1_context* ctx, const secp256k1_sha256_t *seed, const unsigned char *sig64, const unsigned char *msg32, const secp256k1_xonly_pubkey *pubkeys, size_t i, size_t n) {
+    secp256k1_ge pts[2 * SCHNORRSIG_BATCH];
+    secp256k1_scalar sc[2 * SCHNORRSIG_BATCH];
+    secp256k1_scalar s, e, a, g;
+    secp256k1_gej rj;
+    secp256k1_fe rx;
+    secp256k1_sha256_t sha;
+    unsigned char pk32[32];
+    unsigned char buf[32];
+    uint64_t idx;
+    size_t j;
+    int k;
+
+    VERIFY_CHECK(n <= SCHNORRSIG_BATCH);
+    secp256k1_scalar_clear(&g);
+    for (j = 0; j < n; j++) {
+        const unsigned char *sig = sig64 + 64 * (i + j);
+        secp256k1_ge *r = &pts[2 * j];
+        secp256k1_ge *pk = &pts[2 * j + 1];
+
+        if (!secp256k1_schnorrsig_load(&rx, &s, sig) ||
+            !secp256k1_xonly_pubkey_load(ctx, pk, &pubkeys[i + j]) ||
+            !secp256k1_ge_set_xo_var(r, &rx, 0)) {
+            return 0;
+        }
+        secp256k1_fe_normalize_var(&pk->x);
+        secp256k1_fe_get_b32(pk32, &pk->x);
+        secp256k1_schnorrsig_challenge(&e, sig, pk32, msg32 + 32 * (i + j));
+
+        /* The first weight can be 1; the others are 128 bits of a hash of
+         * the batch and the index of the signature. That is as much as the
+         * 128-bit security level needs, and short weights let the R terms
+         * skip the endomorphism split. */
+        idx = i + j;
+        if (idx == 0) {
+            secp256k1_scalar_set_int(&a, 1);
+        } else {
+            sha = *seed;
+            for (k = 0; k < 8; k++) {
+                buf[k] = (idx >> (56 - 8 * k)) & 0xFF;
+            }
+            secp256k1_sha256_write(&sha, buf, 8);
+            secp256k1_sha256_finalize(&sha, buf);
+            memset(buf, 0, 16);
+            secp256k1_scalar_set_b32(&a, buf, NULL);
+        }
+
+        secp256k1_scalar_mul(&s, &s, &a);
+        secp256k1_scalar_add(&g, &g, &s);
+        secp256k1_ge_neg(r, r);
+        sc[2 * j] = a;
+        secp256k1_scalar_mul(&sc[2 * j + 1], &a, &e);
+        secp256k1_scalar_negate(&sc[2 * j + 1], &sc[2 * j + 1]);
+    }
+
+    secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, &rj, pts, sc, 2 * n, &g, &ctx->error_callback);
+    return secp256k1_gej_is_infinity(&rj);
+}
+
+int secp256k1_schnorrsig_verify_batch(const secp256k1_context* ctx, const unsigned char *sig64, const unsigned char *msg32, const secp256k1_xonly_pubkey *pubkeys, size_t n) {
+    secp256k1_sha256_t seed;
+    secp256k1_ge pk;
+    unsigned char pk32[32];
+    size_t i;
+    int ret = 1;
+    SECP256K1_TRACE_ENTRY(schnorrsig_verify_batch, ctx, n);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
+    ARG_CHECK(sig64 != NULL || n == 0);
+    ARG_CHECK(msg32 != NULL || n == 0);
+    ARG_CHECK(pubkeys != NULL || n == 0);
+
+    /* The weights are derived from a hash of the whole batch, so that they
+     * are fixed only once all signatures are. */
+    secp256k1_sha256_initialize(&seed);
+    for (i = 0; i < n; i++) {
+        if (!secp256k1_xonly_pubkey_load(ctx, &pk, &pubkeys[i])) {
+            SECP256K1_TRACE_RETURN(schnorrsig_verify_batch, 0);
+            return 0;
+        }
+        secp256k1_fe_normalize_var(&pk.x);
+        secp256k1_fe_get_b32(pk32, &pk.x);
+        secp256k1_sha256_write(&seed, sig64 + 64 * i, 64);
+        secp256k1_sha256_write(&seed, msg32 + 32 * i, 32);
+        secp256k1_sha256_write(&seed, pk32, 32);
+    }
+
+    for (i = 0; ret && i < n; i += SCHNORRSIG_BATCH) {
+        size_t m = n - i < SCHNORRSIG_BATCH ? n - i : SCHNORRSIG_BATCH;
+        ret = secp256k1_schnorrsig_verify_batch_chunk(ctx, &seed, sig64, msg32, pubkeys, i, m);
+    }
+    SECP256K1_TRACE_RETURN(schnorrsig_verify_batch, ret);
+    return ret;
+}
+
+#endif
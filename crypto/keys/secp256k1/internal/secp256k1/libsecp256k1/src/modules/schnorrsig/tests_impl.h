@@ -0,0 +1,313 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_SCHNORRSIG_TESTS_
+#define _SECP256K1_MODULE_SCHNORRSIG_TESTS_
+
+#define SCHNORRSIG_TEST_MAX (2 * SCHNORRSIG_BATCH + 3)
+
+/* The secret key, public key, aux_rand, message and signature of the first
+ * four test vectors of BIP340. The fourth public key has an odd Y. */
+static const unsigned char schnorrsig_vectors[4][5][64] = {
+    {
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+         0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03},
+        {0xF9, 0x30, 0x8A, 0x01, 0x92, 0x58, 0xC3, 0x10, 0x49, 0x34, 0x4F, 0x85, 0xF8, 0x9D, 0x52, 0x29,
+         0xB5, 0x31, 0xC8, 0x45, 0x83, 0x6F, 0x99, 0xB0, 0x86, 0x01, 0xF1, 0x13, 0xBC, 0xE0, 0x36, 0xF9},
+        {0x00},
+        {0x00},
+        {0xE9, 0x07, 0x83, 0x1F, 0x80, 0x84, 0x8D, 0x10, 0x69, 0xA5, 0x37, 0x1B, 0x40, 0x24, 0x10, 0x36,
+         0x4B, 0xDF, 0x1C, 0x5F, 0x83, 0x07, 0xB0, 0x08, 0x4C, 0x55, 0xF1, 0xCE, 0x2D, 0xCA, 0x82, 0x15,
+         0x25, 0xF6, 0x6A, 0x4A, 0x85, 0xEA, 0x8B, 0x71, 0xE4, 0x82, 0xA7, 0x4F, 0x38, 0x2D, 0x2C, 0xE5,
+         0xEB, 0xEE, 0xE8, 0xFD, 0xB2, 0x17, 0x2F, 0x47, 0x7D, 0xF4, 0x90, 0x0D, 0x31, 0x05, 0x36, 0xC0}
+    },
+    {
+        {0xB7, 0xE1, 0x51, 0x62, 0x8A, 0xED, 0x2A, 0x6A, 0xBF, 0x71, 0x58, 0x80, 0x9C, 0xF4, 0xF3, 0xC7,
+         0x62, 0xE7, 0x16, 0x0F, 0x38, 0xB4, 0xDA, 0x56, 0xA7, 0x84, 0xD9, 0x04, 0x51, 0x90, 0xCF, 0xEF},
+        {0xDF, 0xF1, 0xD7, 0x7F, 0x2A, 0x67, 0x1C, 0x5F, 0x36, 0x18, 0x37, 0x26, 0xDB, 0x23, 0x41, 0xBE,
+         0x58, 0xFE, 0xAE, 0x1D, 0xA2, 0xDE, 0xCE, 0xD8, 0x43, 0x24, 0x0F, 0x7B, 0x50, 0x2B, 0xA6, 0x59},
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+         0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01},
+        {0x24, 0x3F, 0x6A, 0x88, 0x85, 0xA3, 0x08, 0xD3, 0x13, 0x19, 0x8A, 0x2E, 0x03, 0x70, 0x73, 0x44,
+         0xA4, 0x09, 0x38, 0x22, 0x29, 0x9F, 0x31, 0xD0, 0x08, 0x2E, 0xFA, 0x98, 0xEC, 0x4E, 0x6C, 0x89},
+        {0x68, 0x96, 0xBD, 0x60, 0xEE, 0xAE, 0x29, 0x6D, 0xB4, 0x8A, 0x22, 0x9F, 0xF7, 0x1D, 0xFE, 0x07,
+         0x1B, 0xDE, 0x41, 0x3E, 0x6D, 0x43, 0xF9, 0x17, 0xDC, 0x8D, 0xCF, 0x8C, 0x78, 0xDE, 0x33, 0x41,
+         0x89, 0x06, 0xD1, 0x1A, 0xC9, 0x76, 0xAB, 0xCC, 0xB2, 0x0B, 0x09, 0x12, 0x92, 0xBF, 0xF4, 0xEA,
+         0x89, 0x7E, 0xFC, 0xB6, 0x39, 0xEA, 0x87, 0x1C, 0xFA, 0x95, 0xF6, 0xDE, 0x33, 0x9E, 0x4B, 0x0A}
+    },
+    {
+        {0xC9, 0x0F, 0xDA, 0xA2, 0x21, 0x68, 0xC2, 0x34, 0xC4, 0xC6, 0x62, 0x8B, 0x80, 0xDC, 0x1C, 0xD1,
+         0x29, 0x02, 0x4E, 0x08, 0x8A, 0x67, 0xCC, 0x74, 0x02, 0x0B, 0xBE, 0xA6, 0x3B, 0x14, 0xE5, 0xC9},
+        {0xDD, 0x30, 0x8A, 0xFE, 0xC5, 0x77, 0x7E, 0x13, 0x12, 0x1F, 0xA7, 0x2B, 0x9C, 0xC1, 0xB7, 0xCC,
+         0x01, 0x39, 0x71, 0x53, 0x09, 0xB0, 0x86, 0xC9, 0x60, 0xE1, 0x8F, 0xD9, 0x69, 0x77, 0x4E, 0xB8},
+        {0xC8, 0x7A, 0xA5, 0x38, 0x24, 0xB4, 0xD7, 0xAE, 0x2E, 0xB0, 0x35, 0xA2, 0xB5, 0xBB, 0xBC, 0xCC,
+         0x08, 0x0E, 0x76, 0xCD, 0xC6, 0xD1, 0x69, 0x2C, 0x4B, 0x0B, 0x62, 0xD7, 0x98, 0xE6, 0xD9, 0x06},
+        {0x7E, 0x2D, 0x58, 0xD8, 0xB3, 0xBC, 0xDF, 0x1A, 0xBA, 0xDE, 0xC7, 0x82, 0x90, 0x54, 0xF9, 0x0D,
+         0xDA, 0x98, 0x05, 0xAA, 0xB5, 0x6C, 0x77, 0x33, 0x30, 0x24, 0xB9, 0xD0, 0xA5, 0x08, 0xB7, 0x5C},
+        {0x58, 0x31, 0xAA, 0xEE, 0xD7, 0xB4, 0x4B, 0xB7, 0x4E, 0x5E, 0xAB, 0x94, 0xBA, 0x9D, 0x42, 0x94,
+         0xC4, 0x9B, 0xCF, 0x2A, 0x60, 0x72, 0x8D, 0x8B, 0x4C, 0x20, 0x0F, 0x50, 0xDD, 0x31, 0x3C, 0x1B,
+         0xAB, 0x74, 0x58, 0x79, 0xA5, 0xAD, 0x95, 0x4A, 0x72, 0xC4, 0x5A, 0x91, 0xC3, 0xA5, 0x1D, 0x3C,
+         0x7A, 0xDE, 0xA9, 0x8D, 0x82, 0xF8, 0x48, 0x1E, 0x0E, 0x1E, 0x03, 0x67, 0x4A, 0x6F, 0x3F, 0xB7}
+    },
+    {
+        {0x0B, 0x43, 0x2B, 0x26, 0x77, 0x93, 0x73, 0x81, 0xAE, 0xF0, 0x5B, 0xB0, 0x2A, 0x66, 0xEC, 0xD0,
+         0x12, 0x77, 0x30, 0x62, 0xCF, 0x3F, 0xA2, 0x54, 0x9E, 0x44, 0xF5, 0x8E, 0xD2, 0x40, 0x17, 0x10},
+        {0x25, 0xD1, 0xDF, 0xF9, 0x51, 0x05, 0xF5, 0x25, 0x3C, 0x40, 0x22, 0xF6, 0x28, 0xA9, 0x96, 0xAD,
+         0x3A, 0x0D, 0x95, 0xFB, 0xF2, 0x1D, 0x46, 0x8A, 0x1B, 0x33, 0xF8, 0xC1, 0x60, 0xD8, 0xF5, 0x17},
+        {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+         0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF},
+        {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+         0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF},
+        {0x7E, 0xB0, 0x50, 0x97, 0x57, 0xE2, 0x46, 0xF1, 0x94, 0x49, 0x88, 0x56, 0x51, 0x61, 0x1C, 0xB9,
+         0x65, 0xEC, 0xC1, 0xA1, 0x87, 0xDD, 0x51, 0xB6, 0x4F, 0xDA, 0x1E, 0xDC, 0x96, 0x37, 0xD5, 0xEC,
+         0x97, 0x58, 0x2B, 0x9C, 0xB1, 0x3D, 0xB3, 0x93, 0x37, 0x05, 0xB3, 0x2B, 0xA9, 0x82, 0xAF, 0x5A,
+         0xF2, 0x5F, 0xD7, 0x88, 0x81, 0xEB, 0xB3, 0x27, 0x71, 0xFC, 0x59, 0x22, 0xEF, 0xC6, 0x6E, 0xA3}
+    }
+};
+
+static void schnorrsig_random_key(unsigned char *seckey, secp256k1_xonly_pubkey *pubkey) {
+    secp256k1_scalar key;
+    secp256k1_pubkey pk;
+    random_scalar_order_test(&key);
+    secp256k1_scalar_get_b32(seckey, &key);
+    CHECK(secp256k1_ec_pubkey_create(ctx, &pk, seckey) == 1);
+    CHECK(secp256k1_xonly_pubkey_from_pubkey(ctx, pubkey, NULL, &pk) == 1);
+}
+
+void test_schnorrsig_api(void) {
+    secp256k1_context *none = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+    secp256k1_context *sign = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
+    secp256k1_context *vrfy = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+    secp256k1_xonly_pubkey xonly, zero_xonly;
+    secp256k1_pubkey pubkey;
+    unsigned char key[32];
+    unsigned char msg[32];
+    unsigned char sig[64];
+    unsigned char buf[32];
+    int parity;
+    int32_t ecount = 0;
+
+    secp256k1_context_set_illegal_callback(none, counting_illegal_callback_fn, &ecount);
+    secp256k1_context_set_illegal_callback(sign, counting_illegal_callback_fn, &ecount);
+    secp256k1_context_set_illegal_callback(vrfy, counting_illegal_callback_fn, &ecount);
+    memset(&zero_xonly, 0, sizeof(zero_xonly));
+    schnorrsig_random_key(key, &xonly);
+    secp256k1_rand256(msg);
+
+    /* x-only keys */
+    CHECK(secp256k1_xonly_pubkey_parse(none, NULL, msg) == 0);
+    CHECK(ecount == 1);
+    CHECK(secp256k1_xonly_pubkey_parse(none, &xonly, NULL) == 0);
+    CHECK(ecount == 2);
+    CHECK(memcmp(&xonly, &zero_xonly, sizeof(xonly)) == 0);
+    CHECK(secp256k1_xonly_pubkey_serialize(none, buf, &xonly) == 0);
+    CHECK(ecount == 3);
+    CHECK(secp256k1_xonly_pubkey_serialize(none, NULL, &xonly) == 0);
+    CHECK(ecount == 4);
+    CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey, key) == 1);
+    CHECK(secp256k1_xonly_pubkey_from_pubkey(none, &xonly, &parity, NULL) == 0);
+    CHECK(ecount == 5);
+    CHECK(secp256k1_xonly_pubkey_from_pubkey(none, &xonly, NULL, &pubkey) == 1);
+    CHECK(ecount == 5);
+
+    /* signing */
+    CHECK(secp256k1_schnorrsig_sign(none, sig, msg, key, NULL) == 0);
+    CHECK(ecount == 6);
+    CHECK(secp256k1_schnorrsig_sign(vrfy, sig, msg, key, NULL) == 0);
+    CHECK(ecount == 7);
+    CHECK(secp256k1_schnorrsig_sign(sign, NULL, msg, key, NULL) == 0);
+    CHECK(ecount == 8);
+    CHECK(secp256k1_schnorrsig_sign(sign, sig, NULL, key, NULL) == 0);
+    CHECK(ecount == 9);
+    CHECK(secp256k1_schnorrsig_sign(sign, sig, msg, NULL, NULL) == 0);
+    CHECK(ecount == 10);
+    CHECK(secp256k1_schnorrsig_sign(sign, sig, msg, key, NULL) == 1);
+    CHECK(ecount == 10);
+
+    /* verification */
+    CHECK(secp256k1_schnorrsig_verify(none, sig, msg, &xonly) == 0);
+    CHECK(ecount == 11);
+    CHECK(secp256k1_schnorrsig_verify(sign, sig, msg, &xonly) == 0);
+    CHECK(ecount == 12);
+    CHECK(secp256k1_schnorrsig_verify(vrfy, NULL, msg, &xonly) == 0);
+    CHECK(ecount == 13);
+    CHECK(secp256k1_schnorrsig_verify(vrfy, sig, NULL, &xonly) == 0);
+    CHECK(ecount == 14);
+    CHECK(secp256k1_schnorrsig_verify(vrfy, sig, msg, NULL) == 0);
+    CHECK(ecount == 15);
+    CHECK(secp256k1_schnorrsig_verify(vrfy, sig, msg, &zero_xonly) == 0);
+    CHECK(ecount == 16);
+    CHECK(secp256k1_schnorrsig_verify(vrfy, sig, msg, &xonly) == 1);
+    CHECK(ecount == 16);
+
+    /* batch verification */
+    CHECK(secp256k1_schnorrsig_verify_batch(sign, sig, msg, &xonly, 1) == 0);
+    CHECK(ecount == 17);
+    CHECK(secp256k1_schnorrsig_verify_batch(vrfy, NULL, msg, &xonly, 1) == 0);
+    CHECK(ecount == 18);
+    CHECK(secp256k1_schnorrsig_verify_batch(vrfy, sig, NULL, &xonly, 1) == 0);
+    CHECK(ecount == 19);
+    CHECK(secp256k1_schnorrsig_verify_batch(vrfy, sig, msg, NULL, 1) == 0);
+    CHECK(ecount == 20);
+    CHECK(secp256k1_schnorrsig_verify_batch(vrfy, sig, msg, &zero_xonly, 1) == 0);
+    CHECK(ecount == 21);
+    CHECK(secp256k1_schnorrsig_verify_batch(vrfy, NULL, NULL, NULL, 0) == 1);
+    CHECK(secp256k1_schnorrsig_verify_batch(vrfy, sig, msg, &xonly, 1) == 1);
+    CHECK(ecount == 21);
+
+    secp256k1_context_destroy(none);
+    secp256k1_context_destroy(sign);
+    secp256k1_context_destroy(vrfy);
+}
+
+void test_schnorrsig_vectors(void) {
+    /* x = p, and an x with no point on the curve */
+    static const unsigned char bad_x[2][32] = {
+        {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+         0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFC, 0x2F},
+        {0xEE, 0xFD, 0xEA, 0x4C, 0xDB, 0x67, 0x77, 0x50, 0xA4, 0x20, 0xFE, 0xE8, 0x07, 0xEA, 0xCF, 0x21,
+         0xEB, 0x98, 0x98, 0xAE, 0x79, 0xB9, 0x76, 0x87, 0x66, 0xE4, 0xFA, 0xA0, 0x4A, 0x2D, 0x4A, 0x34}
+    };
+    static const unsigned char order[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+        0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48, 0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41
+    };
+    secp256k1_xonly_pubkey pubkey;
+    secp256k1_pubkey full;
+    secp256k1_scalar s;
+    unsigned char sig[64];
+    unsigned char buf[32];
+    int parity;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        const unsigned char (*v)[64] = schnorrsig_vectors[i];
+        CHECK(secp256k1_ec_pubkey_create(ctx, &full, v[0]) == 1);
+        CHECK(secp256k1_xonly_pubkey_from_pubkey(ctx, &pubkey, &parity, &full) == 1);
+        CHECK(parity == (i == 3));
+        CHECK(secp256k1_xonly_pubkey_serialize(ctx, buf, &pubkey) == 1);
+        CHECK(memcmp(buf, v[1], 32) == 0);
+        CHECK(secp256k1_xonly_pubkey_parse(ctx, &pubkey, v[1]) == 1);
+        CHECK(secp256k1_schnorrsig_sign(ctx, sig, v[3], v[0], v[2]) == 1);
+        CHECK(memcmp(sig, v[4], 64) == 0);
+        CHECK(secp256k1_schnorrsig_verify(ctx, sig, v[3], &pubkey) == 1);
+        CHECK(secp256k1_schnorrsig_verify_batch(ctx, sig, v[3], &pubkey, 1) == 1);
+
+        /* -s, s = n and r = p all fail. */
+        secp256k1_scalar_set_b32(&s, sig + 32, NULL);
+        secp256k1_scalar_negate(&s, &s);
+        secp256k1_scalar_get_b32(sig + 32, &s);
+        CHECK(secp256k1_schnorrsig_verify(ctx, sig, v[3], &pubkey) == 0);
+        CHECK(secp256k1_schnorrsig_verify_batch(ctx, sig, v[3], &pubkey, 1) == 0);
+        memcpy(sig + 32, order, 32);
+        CHECK(secp256k1_schnorrsig_verify(ctx, sig, v[3], &pubkey) == 0);
+        CHECK(secp256k1_schnorrsig_verify_batch(ctx, sig, v[3], &pubkey, 1) == 0);
+        memcpy(sig, v[4], 64);
+        memcpy(sig, bad_x[0], 32);
+        CHECK(secp256k1_schnorrsig_verify(ctx, sig, v[3], &pubkey) == 0);
+        CHECK(secp256k1_schnorrsig_verify_batch(ctx, sig, v[3], &pubkey, 1) == 0);
+    }
+    CHECK(secp256k1_xonly_pubkey_parse(ctx, &pubkey, bad_x[0]) == 0);
+    CHECK(secp256k1_xonly_pubkey_parse(ctx, &pubkey, bad_x[1]) == 0);
+
+    /* No aux_rand is the same as 32 zero bytes. */
+    CHECK(secp256k1_schnorrsig_sign(ctx, sig, schnorrsig_vectors[0][3], schnorrsig_vectors[0][0], NULL) == 1);
+    CHECK(memcmp(sig, schnorrsig_vectors[0][4], 64) == 0);
+}
+
+void test_schnorrsig_sign_verify(void) {
+    unsigned char key[32];
+    unsigned char msg[32];
+    unsigned char aux[32];
+    unsigned char sig[64];
+    unsigned char buf[32];
+    secp256k1_xonly_pubkey pubkey;
+    secp256k1_xonly_pubkey parsed;
+    int i;
+
+    schnorrsig_random_key(key, &pubkey);
+    secp256k1_rand256_test(msg);
+    secp256k1_rand256(aux);
+    CHECK(secp256k1_xonly_pubkey_serialize(ctx, buf, &pubkey) == 1);
+    CHECK(secp256k1_xonly_pubkey_parse(ctx, &parsed, buf) == 1);
+    CHECK(memcmp(&parsed, &pubkey, sizeof(pubkey)) == 0);
+
+    CHECK(secp256k1_schnorrsig_sign(ctx, sig, msg, key, aux) == 1);
+    CHECK(secp256k1_schnorrsig_verify(ctx, sig, msg, &pubkey) == 1);
+    i = secp256k1_rand_int(64);
+    sig[i] ^= 1 << secp256k1_rand_int(8);
+    CHECK(secp256k1_schnorrsig_verify(ctx, sig, msg, &pubkey) == 0);
+    sig[i] = 0;
+    msg[secp256k1_rand_int(32)] ^= 1 << secp256k1_rand_int(8);
+    CHECK(secp256k1_schnorrsig_sign(ctx, sig, msg, key, aux) == 1);
+    CHECK(secp256k1_schnorrsig_verify(ctx, sig, msg, &pubkey) == 1);
+
+    /* An invalid key does not sign. */
+    memset(key, 0, 32);
+    CHECK(secp256k1_schnorrsig_sign(ctx, sig, msg, key, aux) == 0);
+    memset(buf, 0, 32);
+    CHECK(memcmp(sig, buf, 32) == 0 && memcmp(sig + 32, buf, 32) == 0);
+}
+
+void test_schnorrsig_verify_batch(void) {
+    static unsigned char sigs[SCHNORRSIG_TEST_MAX][64];
+    static unsigned char msgs[SCHNORRSIG_TEST_MAX][32];
+    static secp256k1_xonly_pubkey pubkeys[SCHNORRSIG_TEST_MAX];
+    secp256k1_scalar s, one;
+    unsigned char key[32];
+    size_t n = 1 + secp256k1_rand_int(SCHNORRSIG_TEST_MAX);
+    size_t i, j;
+    int bit;
+
+    for (i = 0; i < n; i++) {
+        /* Some keys sign more than once. */
+        if (i == 0 || secp256k1_rand_int(4)) {
+            schnorrsig_random_key(key, &pubkeys[i]);
+        } else {
+            pubkeys[i] = pubkeys[i - 1];
+        }
+        secp256k1_rand256_test(msgs[i]);
+        CHECK(secp256k1_schnorrsig_sign(ctx, sigs[i], msgs[i], key, NULL) == 1);
+    }
+    CHECK(secp256k1_schnorrsig_verify_batch(ctx, sigs[0], msgs[0], pubkeys, n) == 1);
+    secp256k1_scalar_set_int(&one, 1);
+
+    /* Any one bad signature fails the batch. */
+    i = secp256k1_rand_int(n);
+    j = secp256k1_rand_int(64);
+    bit = 1 << secp256k1_rand_int(8);
+    sigs[i][j] ^= bit;
+    CHECK(secp256k1_schnorrsig_verify(ctx, sigs[i], msgs[i], &pubkeys[i]) == 0);
+    CHECK(secp256k1_schnorrsig_verify_batch(ctx, sigs[0], msgs[0], pubkeys, n) == 0);
+    sigs[i][j] ^= bit;
+    CHECK(secp256k1_schnorrsig_verify_batch(ctx, sigs[0], msgs[0], pubkeys, n) == 1);
+
+    /* Two bad signatures whose errors cancel out without the weights. */
+    if (n >= 2) {
+        secp256k1_scalar_set_b32(&s, sigs[0] + 32, NULL);
+        secp256k1_scalar_add(&s, &s, &one);
+        secp256k1_scalar_get_b32(sigs[0] + 32, &s);
+        secp256k1_scalar_set_b32(&s, sigs[1] + 32, NULL);
+        secp256k1_scalar_negate(&one, &one);
+        secp256k1_scalar_add(&s, &s, &one);
+        secp256k1_scalar_get_b32(sigs[1] + 32, &s);
+        CHECK(secp256k1_schnorrsig_verify_batch(ctx, sigs[0], msgs[0], pubkeys, n) == 0);
+    }
+}
+
+void run_schnorrsig_tests(void) {
+    int i;
+    test_schnorrsig_api();
+    test_schnorrsig_vectors();
+    for (i = 0; i < count; i++) {
+        test_schnorrsig_sign_verify();
+    }
+    for (i = 0; i < count / 8 + 1; i++) {
+        test_schnorrsig_verify_batch();
+    }
+}
+
+#endif
@@ -0,0 +1,223 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_SCHNORRSIG_HALFAGG_MAIN_
+#define _SECP256K1_MODULE_SCHNORRSIG_HALFAGG_MAIN_
+
+#include "include/secp256k1_schnorrsig_halfagg.h"
+#include "modules/schnorrsig/main_impl.h"
+#include "hash_impl.h"
+
+/* The state of SHA256 after it has consumed SHA256(tag) || SHA256(tag), for
+ * the tag "HalfAgg/randomizer". */
+static const uint32_t secp256k1_schnorrsig_halfagg_midstate_randomizer[8] = {
+    0xd11f5532ul, 0xfa57f70ful, 0x5db0d728ul, 0xf806ffe1ul,
+    0x1d4db069ul, 0xb4d587e1ul, 0x50451c2aul, 0x10fb63e9ul
+};
+
+/** The largest number of signatures whose aggregate size, 32*(n+1), fits in a
+ *  size_t. */
+#define SCHNORRSIG_HALFAGG_MAX (((size_t)-1) / 32 - 1)
+
+/** Add r32 || pk32 || msg32 of signature i to the running randomizer hash and
+ *  set z to the weight of that signature: 1 for the first, and
+ *  int(hash_HalfAgg/randomizer(r_0 || pk_0 || m_0 || ... || r_i || pk_i || m_i)) mod n
+ *  for the others. */
+static void secp256k1_schnorrsig_halfagg_randomizer(secp256k1_scalar *z, secp256k1_sha256_t *sha, size_t i, const unsigned char *r32, const unsigned char *pk32, const unsigned char *msg32) {
+    secp256k1_sha256_t sha_i;
+    unsigned char buf[32];
+
+    secp256k1_sha256_write(sha, r32, 32);
+    secp256k1_sha256_write(sha, pk32, 32);
+    secp256k1_sha256_write(sha, msg32, 32);
+    if (i == 0) {
+        secp256k1_scalar_set_int(z, 1);
+    } else {
+        sha_i = *sha;
+        secp256k1_sha256_finalize(&sha_i, buf);
+        secp256k1_scalar_set_b32(z, buf, NULL);
+    }
+}
+
+/** Load an x-only public key and serialize it, as the hashes need it. */
+static int secp256k1_schnorrsig_halfagg_pubkey(const secp256k1_context* ctx, secp256k1_ge *pk, unsigned char *pk32, const secp256k1_xonly_pubkey *pubkey) {
+    if (!secp256k1_xonly_pubkey_load(ctx, pk, pubkey)) {
+        return 0;
+    }
+    secp256k1_fe_normalize_var(&pk->x);
+    secp256k1_fe_get_b32(pk32, &pk->x);
+    return 1;
+}
+
+/** Add signatures n_before..n_before+n_new-1 to the aggregate whose s value is
+ *  s, and write the R values of the new signatures and the new s value to
+ *  aggsig. Nothing is written unless all of them can be added. */
+static int secp256k1_schnorrsig_halfagg_add(const secp256k1_context* ctx, unsigned char *aggsig, secp256k1_scalar *s, const secp256k1_xonly_pubkey *pubkeys, const unsigned char *msgs32, const unsigned char *new_sigs64, size_t n_before, size_t n_new) {
+    secp256k1_sha256_t sha;
+    secp256k1_scalar si, z;
+    secp256k1_ge pk;
+    unsigned char pk32[32];
+    size_t i;
+    int overflow;
+
+    /* The weights of the new signatures depend on all earlier signatures,
+     * so the hash runs over the aggregated ones too. */
+    secp256k1_schnorrsig_sha256_tagged(&sha, secp256k1_schnorrsig_halfagg_midstate_randomizer);
+    for (i = 0; i < n_before + n_new; i++) {
+        const unsigned char *r32 = i < n_before ? aggsig + 32 * i : new_sigs64 + 64 * (i - n_before);
+        if (!secp256k1_schnorrsig_halfagg_pubkey(ctx, &pk, pk32, &pubkeys[i])) {
+            return 0;
+        }
+        secp256k1_schnorrsig_halfagg_randomizer(&z, &sha, i, r32, pk32, msgs32 + 32 * i);
+        if (i >= n_before) {
+            secp256k1_scalar_set_b32(&si, r32 + 32, &overflow);
+            if (overflow) {
+                return 0;
+            }
+            secp256k1_scalar_mul(&si, &si, &z);
+            secp256k1_scalar_add(s, s, &si);
+        }
+    }
+
+    for (i = 0; i < n_new; i++) {
+        memcpy(aggsig + 32 * (n_before + i), new_sigs64 + 64 * i, 32);
+    }
+    secp256k1_scalar_get_b32(aggsig + 32 * (n_before + n_new), s);
+    return 1;
+}
+
+int secp256k1_schnorrsig_aggregate(const secp256k1_context* ctx, unsigned char *aggsig, size_t *aggsig_len, const secp256k1_xonly_pubkey *pubkeys, const unsigned char *msgs32, const unsigned char *sigs64, size_t n) {
+    secp256k1_scalar s;
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(schnorrsig_aggregate, ctx, n);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(aggsig != NULL);
+    ARG_CHECK(aggsig_len != NULL);
+    ARG_CHECK(pubkeys != NULL || n == 0);
+    ARG_CHECK(msgs32 != NULL || n == 0);
+    ARG_CHECK(sigs64 != NULL || n == 0);
+    ARG_CHECK(n <= SCHNORRSIG_HALFAGG_MAX);
+
+    if (*aggsig_len >= 32 * (n + 1)) {
+        secp256k1_scalar_clear(&s);
+        ret = secp256k1_schnorrsig_halfagg_add(ctx, aggsig, &s, pubkeys, msgs32, sigs64, 0, n);
+    }
+    if (ret) {
+        *aggsig_len = 32 * (n + 1);
+    }
+    SECP256K1_TRACE_RETURN(schnorrsig_aggregate, ret);
+    return ret;
+}
+
+int secp256k1_schnorrsig_inc_aggregate(const secp256k1_context* ctx, unsigned char *aggsig, size_t *aggsig_len, const secp256k1_xonly_pubkey *pubkeys, const unsigned char *msgs32, const unsigned char *new_sigs64, size_t n_before, size_t n_new) {
+    secp256k1_scalar s;
+    int overflow;
+    int ret = 0;
+    SECP256K1_TRACE_ENTRY(schnorrsig_inc_aggregate, ctx, n_new);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(aggsig != NULL);
+    ARG_CHECK(aggsig_len != NULL);
+    ARG_CHECK(n_before <= SCHNORRSIG_HALFAGG_MAX && n_new <= SCHNORRSIG_HALFAGG_MAX - n_before);
+    ARG_CHECK(pubkeys != NULL || n_before + n_new == 0);
+    ARG_CHECK(msgs32 != NULL || n_before + n_new == 0);
+    ARG_CHECK(new_sigs64 != NULL || n_new == 0);
+
+    if (*aggsig_len >= 32 * (n_before + n_new + 1)) {
+        secp256k1_scalar_set_b32(&s, aggsig + 32 * n_before, &overflow);
+        if (!overflow) {
+            ret = secp256k1_schnorrsig_halfagg_add(ctx, aggsig, &s, pubkeys, msgs32, new_sigs64, n_before, n_new);
+        }
+    }
+    if (ret) {
+        *aggsig_len = 32 * (n_before + n_new + 1);
+    }
+    SECP256K1_TRACE_RETURN(schnorrsig_inc_aggregate, ret);
+    return ret;
+}
+
+/** Add the terms of signatures i..i+n-1 of an aggregate to acc: with R_j the
+ *  lifted r value of signature j, e_j its challenge and z_j its weight, add
+ *  -sum(z_j*R_j) - sum(z_j*e_j*P_j) + g*G. The aggregate is valid if the sum
+ *  over all signatures, with g = s for one chunk and 0 for the others, is
+ *  infinity. */
+static int secp256k1_schnorrsig_aggverify_chunk(const secp256k1_context* ctx, secp256k1_gej *acc, secp256k1_sha256_t *sha, const secp256k1_xonly_pubkey *pubkeys, const unsigned char *msgs32, const unsigned char *aggsig, size_t i, size_t n, const secp256k1_scalar *g) {
+    secp256k1_ge pts[2 * SCHNORRSIG_BATCH];
+    secp256k1_scalar sc[2 * SCHNORRSIG_BATCH];
+    secp256k1_scalar e;
+    secp256k1_gej rj;
+    secp256k1_fe rx;
+    unsigned char pk32[32];
+    size_t j;
+
+    VERIFY_CHECK(n <= SCHNORRSIG_BATCH);
+    for (j = 0; j < n; j++) {
+        const unsigned char *r32 = aggsig + 32 * (i + j);
+        const unsigned char *msg32 = msgs32 + 32 * (i + j);
+        secp256k1_ge *r = &pts[2 * j];
+        secp256k1_ge *pk = &pts[2 * j + 1];
+
+        if (!secp256k1_schnorrsig_halfagg_pubkey(ctx, pk, pk32, &pubkeys[i + j]) ||
+            !secp256k1_fe_set_b32(&rx, r32) ||
+            !secp256k1_ge_set_xo_var(r, &rx, 0)) {
+            return 0;
+        }
+        secp256k1_schnorrsig_challenge(&e, r32, pk32, msg32);
+        secp256k1_schnorrsig_halfagg_randomizer(&sc[2 * j], sha, i + j, r32, pk32, msg32);
+        secp256k1_scalar_mul(&sc[2 * j + 1], &sc[2 * j], &e);
+        secp256k1_scalar_negate(&sc[2 * j + 1], &sc[2 * j + 1]);
+        secp256k1_ge_neg(r, r);
+    }
+
+    secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, &rj, pts, sc, 2 * n, g, &ctx->error_callback);
+    secp256k1_gej_add_var(acc, acc, &rj, NULL);
+    return 1;
+}
+
+int secp256k1_schnorrsig_aggverify(const secp256k1_context* ctx, const secp256k1_xonly_pubkey *pubkeys, const unsigned char *msgs32, size_t n, const unsigned char *aggsig, size_t aggsig_len) {
+    secp256k1_sha256_t sha;
+    secp256k1_scalar s, zero;
+    secp256k1_gej acc;
+    size_t i;
+    int overflow;
+    int ret = 1;
+    SECP256K1_TRACE_ENTRY(schnorrsig_aggverify, ctx, n);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
+    ARG_CHECK(pubkeys != NULL || n == 0);
+    ARG_CHECK(msgs32 != NULL || n == 0);
+    ARG_CHECK(aggsig != NULL);
+
+    if (n > SCHNORRSIG_HALFAGG_MAX || aggsig_len != 32 * (n + 1)) {
+        SECP256K1_TRACE_RETURN(schnorrsig_aggverify, 0);
+        return 0;
+    }
+    secp256k1_scalar_set_b32(&s, aggsig + 32 * n, &overflow);
+    if (overflow) {
+        SECP256K1_TRACE_RETURN(schnorrsig_aggverify, 0);
+        return 0;
+    }
+
+    /* Check s*G = sum(z_i*(R_i + e_i*P_i)). The aggregate is not one
+     * multi-multiplication but one per SCHNORRSIG_BATCH signatures, which
+     * costs a few doublings per signature more and keeps the tables on the
+     * stack. The first chunk carries the s*G term. */
+    secp256k1_scalar_clear(&zero);
+    secp256k1_gej_set_infinity(&acc);
+    secp256k1_schnorrsig_sha256_tagged(&sha, secp256k1_schnorrsig_halfagg_midstate_randomizer);
+    for (i = 0; ret && i < n; i += SCHNORRSIG_BATCH) {
+        size_t m = n - i < SCHNORRSIG_BATCH ? n - i : SCHNORRSIG_BATCH;
+        ret = secp256k1_schnorrsig_aggverify_chunk(ctx, &acc, &sha, pubkeys, msgs32, aggsig, i, m, i == 0 ? &s : &zero);
+    }
+    if (n == 0) {
+        ret = secp256k1_scalar_is_zero(&s);
+    } else if (ret) {
+        ret = secp256k1_gej_is_infinity(&acc);
+    }
+    SECP256K1_TRACE_RETURN(schnorrsig_aggverify, ret);
+    return ret;
+}
+
+#endif
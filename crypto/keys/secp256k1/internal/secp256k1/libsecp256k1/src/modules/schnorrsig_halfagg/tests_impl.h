@@ -0,0 +1,242 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_SCHNORRSIG_HALFAGG_TESTS_
+#define _SECP256K1_MODULE_SCHNORRSIG_HALFAGG_TESTS_
+
+/* Enough signatures for aggregate verification to take more than one chunk. */
+#define HALFAGG_TEST_MAX (SCHNORRSIG_BATCH + 8)
+
+/* Three BIP340 signatures (made with no aux randomness) of the keys
+ * SHA256("halfagg key " || i) on the messages SHA256("halfagg msg " || i),
+ * and their aggregate, worked out with the half-aggregation reference
+ * algorithms. */
+static const unsigned char halfagg_pubkeys[3][32] = {
+    {0x8F, 0x67, 0xB1, 0x7B, 0xE5, 0xAE, 0xAC, 0xD7, 0x9F, 0x63, 0xB6, 0xA1, 0x4F, 0xAF, 0xE8, 0x18,
+     0x0D, 0x63, 0xAC, 0x31, 0x1A, 0x62, 0xD9, 0xDC, 0x1A, 0xC0, 0xD9, 0xCC, 0x34, 0x6B, 0x3B, 0x44},
+    {0x8E, 0xC8, 0xCD, 0xC0, 0x7B, 0x20, 0x7F, 0xAB, 0x06, 0x1A, 0xA8, 0x34, 0x6B, 0x4C, 0x13, 0x46,
+     0xA2, 0x57, 0x3F, 0x17, 0x25, 0x84, 0xFF, 0xEE, 0x8C, 0x1F, 0xCF, 0x9C, 0x19, 0x5B, 0x4C, 0xE5},
+    {0x76, 0x43, 0x90, 0x80, 0xA2, 0x11, 0x6C, 0xDE, 0xF2, 0x0E, 0x6C, 0x90, 0xE6, 0x5B, 0xA5, 0x01,
+     0x95, 0x23, 0x9D, 0x73, 0x55, 0x16, 0x9A, 0x51, 0x42, 0xD6, 0x84, 0x26, 0x39, 0x36, 0x4A, 0x75}
+};
+
+static const unsigned char halfagg_msgs[3 * 32] = {
+    0x00, 0x97, 0x64, 0xA3, 0xE4, 0xC0, 0x7D, 0x9A, 0x41, 0x87, 0xCA, 0xF6, 0xDD, 0xB3, 0x9A, 0x32,
+    0xBA, 0xDB, 0x39, 0xA3, 0x60, 0x80, 0x4E, 0xBC, 0x9E, 0x51, 0xB5, 0xB7, 0x6F, 0xD7, 0xFB, 0xDC,
+    0x4A, 0x0A, 0x03, 0xC8, 0xCC, 0xEB, 0x77, 0x0F, 0x20, 0x69, 0x81, 0xC4, 0x05, 0xC2, 0x90, 0xD1,
+    0x28, 0xF5, 0xA3, 0x34, 0x5A, 0xE4, 0x51, 0xA9, 0xD4, 0x08, 0xDE, 0xE2, 0x5F, 0x0A, 0xCE, 0x02,
+    0xAF, 0xA8, 0x67, 0xA3, 0x19, 0x65, 0x4A, 0xF2, 0x1D, 0xF6, 0xC2, 0xC8, 0xCC, 0x26, 0x11, 0xCA,
+    0x9B, 0x5C, 0xFE, 0x1F, 0x36, 0xAE, 0xD3, 0xDF, 0x61, 0x3E, 0x5F, 0x64, 0x66, 0x68, 0xD2, 0x92
+};
+
+static const unsigned char halfagg_sigs[3 * 64] = {
+    0xAB, 0x3C, 0x5E, 0xEA, 0xD7, 0x2C, 0x88, 0x4B, 0x37, 0x06, 0xE4, 0x12, 0x61, 0x12, 0xA2, 0xED,
+    0xE0, 0x88, 0x65, 0xE2, 0x97, 0xD1, 0x00, 0x74, 0xE4, 0x58, 0xCA, 0x86, 0x1F, 0xB6, 0x12, 0x9A,
+    0x09, 0xC6, 0xCE, 0x16, 0x75, 0xF1, 0x9C, 0x5C, 0x0B, 0xC8, 0x55, 0x3D, 0x1A, 0xA1, 0xB8, 0x91,
+    0xB1, 0x40, 0xDC, 0xF7, 0xCA, 0xCA, 0xF9, 0xE8, 0x69, 0xC8, 0xF1, 0x08, 0x89, 0xF1, 0x15, 0x7C,
+    0x00, 0x4D, 0xF7, 0x62, 0xF3, 0x01, 0xF6, 0xCB, 0x9C, 0xE2, 0x2C, 0xF1, 0xCF, 0xB5, 0x5D, 0x76,
+    0x2F, 0x64, 0x1A, 0xBE, 0xFF, 0x1F, 0x5D, 0xDF, 0x56, 0xA3, 0x6C, 0x1A, 0x86, 0x48, 0xDF, 0xA1,
+    0x7B, 0x65, 0x90, 0x50, 0x55, 0x6A, 0x13, 0xDA, 0xE1, 0x66, 0xDA, 0x35, 0x91, 0xF4, 0x60, 0xC6,
+    0x80, 0x54, 0x9C, 0xCB, 0x1F, 0x76, 0xAC, 0x1A, 0x86, 0x65, 0x9A, 0x47, 0xC5, 0xAF, 0x42, 0x1B,
+    0xC3, 0xCB, 0x29, 0x03, 0x00, 0xE9, 0xFE, 0x21, 0x9A, 0x9F, 0x00, 0x98, 0x75, 0x7D, 0x61, 0xED,
+    0x10, 0x2F, 0xEB, 0xFC, 0x4F, 0xF4, 0x05, 0xD1, 0x01, 0xC8, 0x4B, 0x4F, 0x65, 0x11, 0xD0, 0x4A,
+    0xDA, 0xF1, 0x26, 0x3B, 0x6D, 0xE4, 0x39, 0x8F, 0x6C, 0xAB, 0x10, 0x8A, 0xF1, 0x10, 0x71, 0x80,
+    0x2B, 0x6E, 0x38, 0xBA, 0x5C, 0x04, 0xF8, 0x34, 0x38, 0xA4, 0x0E, 0x72, 0x83, 0x74, 0x77, 0x8B
+};
+
+static const unsigned char halfagg_aggsig[4 * 32] = {
+    0xAB, 0x3C, 0x5E, 0xEA, 0xD7, 0x2C, 0x88, 0x4B, 0x37, 0x06, 0xE4, 0x12, 0x61, 0x12, 0xA2, 0xED,
+    0xE0, 0x88, 0x65, 0xE2, 0x97, 0xD1, 0x00, 0x74, 0xE4, 0x58, 0xCA, 0x86, 0x1F, 0xB6, 0x12, 0x9A,
+    0x00, 0x4D, 0xF7, 0x62, 0xF3, 0x01, 0xF6, 0xCB, 0x9C, 0xE2, 0x2C, 0xF1, 0xCF, 0xB5, 0x5D, 0x76,
+    0x2F, 0x64, 0x1A, 0xBE, 0xFF, 0x1F, 0x5D, 0xDF, 0x56, 0xA3, 0x6C, 0x1A, 0x86, 0x48, 0xDF, 0xA1,
+    0xC3, 0xCB, 0x29, 0x03, 0x00, 0xE9, 0xFE, 0x21, 0x9A, 0x9F, 0x00, 0x98, 0x75, 0x7D, 0x61, 0xED,
+    0x10, 0x2F, 0xEB, 0xFC, 0x4F, 0xF4, 0x05, 0xD1, 0x01, 0xC8, 0x4B, 0x4F, 0x65, 0x11, 0xD0, 0x4A,
+    0xCD, 0x5C, 0xFA, 0x25, 0x5E, 0x8E, 0x3D, 0xF6, 0xB4, 0x02, 0x44, 0xAC, 0x19, 0xE9, 0x5B, 0xEC,
+    0xC3, 0xF2, 0xC6, 0xB8, 0x55, 0xD8, 0xFA, 0x3C, 0xD6, 0xBD, 0x77, 0xBE, 0x42, 0x21, 0x35, 0xA7
+};
+
+void test_schnorrsig_halfagg_api(void) {
+    secp256k1_context *none = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+    secp256k1_context *vrfy = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+    secp256k1_xonly_pubkey pubkeys[3];
+    unsigned char aggsig[4 * 32];
+    size_t aggsig_len;
+    int32_t ecount = 0;
+    int i;
+
+    secp256k1_context_set_illegal_callback(none, counting_illegal_callback_fn, &ecount);
+    secp256k1_context_set_illegal_callback(vrfy, counting_illegal_callback_fn, &ecount);
+    for (i = 0; i < 3; i++) {
+        CHECK(secp256k1_xonly_pubkey_parse(none, &pubkeys[i], halfagg_pubkeys[i]) == 1);
+    }
+
+    aggsig_len = sizeof(aggsig);
+    CHECK(secp256k1_schnorrsig_aggregate(none, aggsig, NULL, pubkeys, halfagg_msgs, halfagg_sigs, 3) == 0);
+    CHECK(ecount == 1);
+    CHECK(secp256k1_schnorrsig_aggregate(none, aggsig, &aggsig_len, NULL, halfagg_msgs, halfagg_sigs, 3) == 0);
+    CHECK(ecount == 2);
+    CHECK(secp256k1_schnorrsig_aggregate(none, aggsig, &aggsig_len, pubkeys, halfagg_msgs, NULL, 3) == 0);
+    CHECK(ecount == 3);
+    CHECK(secp256k1_schnorrsig_aggregate(none, aggsig, &aggsig_len, pubkeys, halfagg_msgs, halfagg_sigs, ((size_t)-1) / 32) == 0);
+    CHECK(ecount == 4);
+    /* Too small an output buffer is not an illegal argument. */
+    aggsig_len = sizeof(aggsig) - 1;
+    CHECK(secp256k1_schnorrsig_aggregate(none, aggsig, &aggsig_len, pubkeys, halfagg_msgs, halfagg_sigs, 3) == 0);
+    CHECK(aggsig_len == sizeof(aggsig) - 1);
+    CHECK(ecount == 4);
+    /* Nothing aggregates to an s value of 0. */
+    aggsig_len = sizeof(aggsig);
+    CHECK(secp256k1_schnorrsig_aggregate(none, aggsig, &aggsig_len, NULL, NULL, NULL, 0) == 1);
+    CHECK(aggsig_len == 32);
+    CHECK(secp256k1_schnorrsig_aggverify(vrfy, NULL, NULL, 0, aggsig, 32) == 1);
+    CHECK(ecount == 4);
+
+    aggsig_len = sizeof(aggsig);
+    CHECK(secp256k1_schnorrsig_inc_aggregate(none, aggsig, &aggsig_len, pubkeys, halfagg_msgs, NULL, 0, 3) == 0);
+    CHECK(ecount == 5);
+    CHECK(secp256k1_schnorrsig_inc_aggregate(none, aggsig, &aggsig_len, pubkeys, NULL, halfagg_sigs, 0, 3) == 0);
+    CHECK(ecount == 6);
+    CHECK(secp256k1_schnorrsig_inc_aggregate(none, aggsig, &aggsig_len, pubkeys, halfagg_msgs, halfagg_sigs, 2, ((size_t)-1) / 32 - 2) == 0);
+    CHECK(ecount == 7);
+    CHECK(secp256k1_schnorrsig_inc_aggregate(none, aggsig, &aggsig_len, pubkeys, halfagg_msgs, halfagg_sigs, 0, 3) == 1);
+    CHECK(aggsig_len == sizeof(aggsig));
+    CHECK(ecount == 7);
+
+    CHECK(secp256k1_schnorrsig_aggverify(none, pubkeys, halfagg_msgs, 3, aggsig, aggsig_len) == 0);
+    CHECK(ecount == 8);
+    CHECK(secp256k1_schnorrsig_aggverify(vrfy, NULL, halfagg_msgs, 3, aggsig, aggsig_len) == 0);
+    CHECK(ecount == 9);
+    CHECK(secp256k1_schnorrsig_aggverify(vrfy, pubkeys, halfagg_msgs, 3, NULL, aggsig_len) == 0);
+    CHECK(ecount == 10);
+    CHECK(secp256k1_schnorrsig_aggverify(vrfy, pubkeys, halfagg_msgs, 3, aggsig, aggsig_len - 32) == 0);
+    CHECK(secp256k1_schnorrsig_aggverify(vrfy, pubkeys, halfagg_msgs, 3, aggsig, aggsig_len) == 1);
+    CHECK(ecount == 10);
+
+    secp256k1_context_destroy(none);
+    secp256k1_context_destroy(vrfy);
+}
+
+void test_schnorrsig_halfagg_vectors(void) {
+    secp256k1_xonly_pubkey pubkeys[3];
+    unsigned char aggsig[4 * 32];
+    unsigned char seckey[32];
+    unsigned char sig[64];
+    unsigned char buf[16];
+    secp256k1_sha256_t sha;
+    size_t aggsig_len;
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        CHECK(secp256k1_xonly_pubkey_parse(ctx, &pubkeys[i], halfagg_pubkeys[i]) == 1);
+        memcpy(buf, "halfagg key ", 12);
+        buf[12] = '0' + i;
+        secp256k1_sha256_initialize(&sha);
+        secp256k1_sha256_write(&sha, buf, 13);
+        secp256k1_sha256_finalize(&sha, seckey);
+        CHECK(secp256k1_schnorrsig_sign(ctx, sig, &halfagg_msgs[32 * i], seckey, NULL) == 1);
+        CHECK(memcmp(sig, &halfagg_sigs[64 * i], 64) == 0);
+    }
+
+    aggsig_len = sizeof(aggsig);
+    CHECK(secp256k1_schnorrsig_aggregate(ctx, aggsig, &aggsig_len, pubkeys, halfagg_msgs, halfagg_sigs, 3) == 1);
+    CHECK(aggsig_len == sizeof(aggsig));
+    CHECK(memcmp(aggsig, halfagg_aggsig, sizeof(aggsig)) == 0);
+    CHECK(secp256k1_schnorrsig_aggverify(ctx, pubkeys, halfagg_msgs, 3, aggsig, aggsig_len) == 1);
+
+    /* Adding the signatures one at a time gives the same aggregate. */
+    aggsig_len = sizeof(aggsig);
+    CHECK(secp256k1_schnorrsig_aggregate(ctx, aggsig, &aggsig_len, pubkeys, halfagg_msgs, halfagg_sigs, 0) == 1);
+    for (i = 0; i < 3; i++) {
+        aggsig_len = sizeof(aggsig);
+        CHECK(secp256k1_schnorrsig_inc_aggregate(ctx, aggsig, &aggsig_len, pubkeys, halfagg_msgs, &halfagg_sigs[64 * i], i, 1) == 1);
+        CHECK(aggsig_len == 32 * (size_t)(i + 2));
+        CHECK(secp256k1_schnorrsig_aggverify(ctx, pubkeys, halfagg_msgs, i + 1, aggsig, aggsig_len) == 1);
+    }
+    CHECK(memcmp(aggsig, halfagg_aggsig, sizeof(aggsig)) == 0);
+}
+
+void test_schnorrsig_halfagg_random(void) {
+    unsigned char seckey[32];
+    secp256k1_xonly_pubkey pubkeys[HALFAGG_TEST_MAX];
+    secp256k1_xonly_pubkey pubkey_tmp;
+    secp256k1_pubkey pubkey;
+    secp256k1_scalar key;
+    unsigned char msgs[HALFAGG_TEST_MAX * 32];
+    unsigned char sigs[HALFAGG_TEST_MAX * 64];
+    unsigned char aggsig[(HALFAGG_TEST_MAX + 1) * 32];
+    unsigned char aggsig2[(HALFAGG_TEST_MAX + 1) * 32];
+    size_t aggsig_len, aggsig2_len;
+    size_t n = 1 + secp256k1_rand_int(HALFAGG_TEST_MAX);
+    size_t k = secp256k1_rand_int(n + 1);
+    size_t i, j;
+
+    for (i = 0; i < n; i++) {
+        random_scalar_order_test(&key);
+        secp256k1_scalar_get_b32(seckey, &key);
+        CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey, seckey) == 1);
+        CHECK(secp256k1_xonly_pubkey_from_pubkey(ctx, &pubkeys[i], NULL, &pubkey) == 1);
+        secp256k1_rand256(&msgs[32 * i]);
+        CHECK(secp256k1_schnorrsig_sign(ctx, &sigs[64 * i], &msgs[32 * i], seckey, NULL) == 1);
+    }
+
+    aggsig_len = sizeof(aggsig);
+    CHECK(secp256k1_schnorrsig_aggregate(ctx, aggsig, &aggsig_len, pubkeys, msgs, sigs, n) == 1);
+    CHECK(aggsig_len == 32 * (n + 1));
+    CHECK(secp256k1_schnorrsig_aggverify(ctx, pubkeys, msgs, n, aggsig, aggsig_len) == 1);
+
+    /* Aggregating the first k, then adding the rest, gives the same. */
+    aggsig2_len = sizeof(aggsig2);
+    CHECK(secp256k1_schnorrsig_aggregate(ctx, aggsig2, &aggsig2_len, pubkeys, msgs, sigs, k) == 1);
+    aggsig2_len = sizeof(aggsig2);
+    CHECK(secp256k1_schnorrsig_inc_aggregate(ctx, aggsig2, &aggsig2_len, pubkeys, msgs, &sigs[64 * k], k, n - k) == 1);
+    CHECK(aggsig2_len == aggsig_len);
+    CHECK(memcmp(aggsig, aggsig2, aggsig_len) == 0);
+
+    /* Any change to a message, a key, an R value or s is caught. */
+    i = secp256k1_rand_int(n);
+    msgs[32 * i] ^= 1;
+    CHECK(secp256k1_schnorrsig_aggverify(ctx, pubkeys, msgs, n, aggsig, aggsig_len) == 0);
+    msgs[32 * i] ^= 1;
+    j = secp256k1_rand_int(n);
+    pubkey_tmp = pubkeys[i];
+    pubkeys[i] = pubkeys[j];
+    CHECK(secp256k1_schnorrsig_aggverify(ctx, pubkeys, msgs, n, aggsig, aggsig_len) == (i == j));
+    pubkeys[i] = pubkey_tmp;
+    aggsig[32 * i + 31] ^= 1;
+    CHECK(secp256k1_schnorrsig_aggverify(ctx, pubkeys, msgs, n, aggsig, aggsig_len) == 0);
+    aggsig[32 * i + 31] ^= 1;
+    aggsig[32 * n + 31] ^= 1;
+    CHECK(secp256k1_schnorrsig_aggverify(ctx, pubkeys, msgs, n, aggsig, aggsig_len) == 0);
+    memset(&aggsig[32 * n], 0xFF, 32);
+    CHECK(secp256k1_schnorrsig_aggverify(ctx, pubkeys, msgs, n, aggsig, aggsig_len) == 0);
+
+    /* So is an invalid signature, even though aggregating it works, and so is
+     * leaving a signature out. */
+    sigs[64 * i + 63] ^= 1;
+    aggsig_len = sizeof(aggsig);
+    CHECK(secp256k1_schnorrsig_aggregate(ctx, aggsig, &aggsig_len, pubkeys, msgs, sigs, n) == 1);
+    CHECK(secp256k1_schnorrsig_aggverify(ctx, pubkeys, msgs, n, aggsig, aggsig_len) == 0);
+    sigs[64 * i + 63] ^= 1;
+    if (n > 1) {
+        aggsig_len = sizeof(aggsig);
+        CHECK(secp256k1_schnorrsig_aggregate(ctx, aggsig, &aggsig_len, pubkeys, msgs, sigs, n - 1) == 1);
+        memcpy(&aggsig[32 * n], &aggsig[32 * (n - 1)], 32);
+        memcpy(&aggsig[32 * (n - 1)], &sigs[64 * (n - 1)], 32);
+        CHECK(secp256k1_schnorrsig_aggverify(ctx, pubkeys, msgs, n, aggsig, aggsig_len + 32) == 0);
+    }
+}
+
+void run_schnorrsig_halfagg_tests(void) {
+    int i;
+
+    test_schnorrsig_halfagg_api();
+    test_schnorrsig_halfagg_vectors();
+    for (i = 0; i < count; i++) {
+        test_schnorrsig_halfagg_random();
+    }
+}
+
+#endif
@@ -0,0 +1,200 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_SIGCACHE_MAIN_
+#define _SECP256K1_MODULE_SIGCACHE_MAIN_
+
+#include "include/secp256k1_sigcache.h"
+#include "hash_impl.h"
+
+/* The table is a cuckoo hash: every entry can live in one of
+ * SIGCACHE_WAYS slots, picked by successive 64-bit pieces of the (salted,
+ * hence unpredictable) entry itself. An insertion that finds all of its
+ * slots taken evicts a random one and moves the evicted entry to one of its
+ * other slots, up to SIGCACHE_MAX_DEPTH times; whatever is displaced last
+ * is dropped.
+ *
+ * Slots are read and written word by word with relaxed atomics and no
+ * locks. A reader racing a writer may see a slot that mixes words of the
+ * old and the new entry; that can make it miss, but not match a key that
+ * was never inserted, since that would need the attacker-unknown hashes to
+ * agree word for word. Entries in flight during an eviction can likewise
+ * be missed briefly. A miss only costs a full verification. */
+
+#define SIGCACHE_WORDS 8
+#define SIGCACHE_WAYS 4
+#define SIGCACHE_MAX_DEPTH 8
+
+typedef struct {
+    uint32_t w[SIGCACHE_WORDS]; /* all zero for an empty slot */
+} secp256k1_sigcache_entry;
+
+struct secp256k1_sigcache_struct {
+    secp256k1_sigcache_entry *slots;
+    size_t nslots;
+    secp256k1_sha256_t salted; /* SHA256 state after absorbing the salt */
+    uint32_t rng;
+};
+
+static void secp256k1_sigcache_key(const secp256k1_sigcache *cache, secp256k1_sigcache_entry *key, const secp256k1_ecdsa_signature *sig, const unsigned char *msg32, const secp256k1_pubkey *pubkey) {
+    secp256k1_sha256_t sha = cache->salted;
+    unsigned char h[32];
+    int i;
+
+    secp256k1_sha256_write(&sha, pubkey->data, sizeof(pubkey->data));
+    secp256k1_sha256_write(&sha, msg32, 32);
+    secp256k1_sha256_write(&sha, sig->data, sizeof(sig->data));
+    secp256k1_sha256_finalize(&sha, h);
+    for (i = 0; i < SIGCACHE_WORDS; i++) {
+        key->w[i] = (uint32_t)h[4 * i] << 24 | (uint32_t)h[4 * i + 1] << 16 | (uint32_t)h[4 * i + 2] << 8 | h[4 * i + 3];
+    }
+}
+
+static SECP256K1_INLINE size_t secp256k1_sigcache_pos(const secp256k1_sigcache *cache, const secp256k1_sigcache_entry *key, int way) {
+    return (size_t)((((uint64_t)key->w[2 * way]) << 32 | key->w[2 * way + 1]) % cache->nslots);
+}
+
+static SECP256K1_INLINE void secp256k1_sigcache_load(secp256k1_sigcache_entry *out, const secp256k1_sigcache_entry *slot) {
+    int i;
+    for (i = 0; i < SIGCACHE_WORDS; i++) {
+        out->w[i] = __atomic_load_n(&slot->w[i], __ATOMIC_RELAXED);
+    }
+}
+
+static SECP256K1_INLINE void secp256k1_sigcache_store(secp256k1_sigcache_entry *slot, const secp256k1_sigcache_entry *in) {
+    int i;
+    for (i = 0; i < SIGCACHE_WORDS; i++) {
+        __atomic_store_n(&slot->w[i], in->w[i], __ATOMIC_RELAXED);
+    }
+}
+
+static SECP256K1_INLINE int secp256k1_sigcache_entry_equal(const secp256k1_sigcache_entry *a, const secp256k1_sigcache_entry *b) {
+    return memcmp(a->w, b->w, sizeof(a->w)) == 0;
+}
+
+static SECP256K1_INLINE int secp256k1_sigcache_entry_is_empty(const secp256k1_sigcache_entry *a) {
+    uint32_t acc = 0;
+    int i;
+    for (i = 0; i < SIGCACHE_WORDS; i++) {
+        acc |= a->w[i];
+    }
+    return acc == 0;
+}
+
+static int secp256k1_sigcache_lookup(const secp256k1_sigcache *cache, const secp256k1_sigcache_entry *key) {
+    secp256k1_sigcache_entry cur;
+    int way;
+    for (way = 0; way < SIGCACHE_WAYS; way++) {
+        secp256k1_sigcache_load(&cur, &cache->slots[secp256k1_sigcache_pos(cache, key, way)]);
+        if (secp256k1_sigcache_entry_equal(&cur, key)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void secp256k1_sigcache_insert(secp256k1_sigcache *cache, const secp256k1_sigcache_entry *key) {
+    secp256k1_sigcache_entry ins = *key;
+    secp256k1_sigcache_entry cur;
+    size_t from = cache->nslots;
+    int depth;
+
+    for (depth = 0; depth < SIGCACHE_MAX_DEPTH; depth++) {
+        size_t pos;
+        uint32_t r;
+        int way;
+        for (way = 0; way < SIGCACHE_WAYS; way++) {
+            pos = secp256k1_sigcache_pos(cache, &ins, way);
+            secp256k1_sigcache_load(&cur, &cache->slots[pos]);
+            if (secp256k1_sigcache_entry_equal(&cur, &ins)) {
+                return;
+            }
+            if (secp256k1_sigcache_entry_is_empty(&cur)) {
+                secp256k1_sigcache_store(&cache->slots[pos], &ins);
+                return;
+            }
+        }
+        /* All candidate slots are taken: evict a random resident, other than
+         * the slot the entry being placed was itself just evicted from. */
+        r = __atomic_fetch_add(&cache->rng, 0x9E3779B9, __ATOMIC_RELAXED);
+        r ^= r >> 16;
+        r *= 0x7FEB352D;
+        r ^= r >> 15;
+        way = r % SIGCACHE_WAYS;
+        pos = secp256k1_sigcache_pos(cache, &ins, way);
+        if (pos == from) {
+            pos = secp256k1_sigcache_pos(cache, &ins, (way + 1) % SIGCACHE_WAYS);
+        }
+        secp256k1_sigcache_load(&cur, &cache->slots[pos]);
+        secp256k1_sigcache_store(&cache->slots[pos], &ins);
+        ins = cur;
+        from = pos;
+    }
+}
+
+secp256k1_sigcache* secp256k1_sigcache_create(const secp256k1_context* ctx, size_t size, const unsigned char *salt32) {
+    secp256k1_sigcache *ret;
+    SECP256K1_TRACE_ENTRY(sigcache_create, ctx, size);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(size >= SIGCACHE_WAYS * sizeof(secp256k1_sigcache_entry));
+    ARG_CHECK(salt32 != NULL);
+
+    ret = (secp256k1_sigcache*)checked_malloc(&ctx->error_callback, sizeof(secp256k1_sigcache));
+    if (ret == NULL) {
+        SECP256K1_TRACE_RETURN(sigcache_create, NULL);
+        return NULL;
+    }
+    ret->nslots = size / sizeof(secp256k1_sigcache_entry);
+    /* Zeroed pages are only backed once touched, so a large cache that is
+     * mostly empty costs little memory. */
+    ret->slots = (secp256k1_sigcache_entry*)calloc(ret->nslots, sizeof(secp256k1_sigcache_entry));
+    SECP256K1_STATS_INC(alloc);
+    if (ret->slots == NULL) {
+        secp256k1_callback_call(&ctx->error_callback, "Out of memory");
+        free(ret);
+        SECP256K1_TRACE_RETURN(sigcache_create, NULL);
+        return NULL;
+    }
+    secp256k1_sha256_initialize(&ret->salted);
+    secp256k1_sha256_write(&ret->salted, salt32, 32);
+    ret->rng = 0;
+    SECP256K1_TRACE_RETURN(sigcache_create, ret);
+    return ret;
+}
+
+void secp256k1_sigcache_destroy(secp256k1_sigcache* cache) {
+    SECP256K1_TRACE_ENTRY(sigcache_destroy, NULL, 0);
+    if (cache != NULL) {
+        free(cache->slots);
+        free(cache);
+    }
+    SECP256K1_TRACE_RETURN(sigcache_destroy, 0);
+}
+
+int secp256k1_ecdsa_verify_cached(const secp256k1_context* ctx, secp256k1_sigcache *cache, const secp256k1_ecdsa_signature *sig, const unsigned char *msg32, const secp256k1_pubkey *pubkey) {
+    secp256k1_sigcache_entry key;
+    int ret;
+    SECP256K1_TRACE_ENTRY(ecdsa_verify_cached, ctx, 1);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
+    ARG_CHECK(cache != NULL);
+    ARG_CHECK(msg32 != NULL);
+    ARG_CHECK(sig != NULL);
+    ARG_CHECK(pubkey != NULL);
+
+    secp256k1_sigcache_key(cache, &key, sig, msg32, pubkey);
+    ret = secp256k1_sigcache_lookup(cache, &key);
+    if (!ret) {
+        ret = secp256k1_ecdsa_verify(ctx, sig, msg32, pubkey);
+        if (ret) {
+            secp256k1_sigcache_insert(cache, &key);
+        }
+    }
+    SECP256K1_TRACE_RETURN(ecdsa_verify_cached, ret);
+    return ret;
+}
+
+#endif
@@ -0,0 +1,153 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_MODULE_SIGCACHE_TESTS_
+#define _SECP256K1_MODULE_SIGCACHE_TESTS_
+
+static void sigcache_random_signature(secp256k1_ecdsa_signature *sig, unsigned char *msg32, secp256k1_pubkey *pubkey) {
+    unsigned char seckey[32];
+    do {
+        secp256k1_rand256_test(seckey);
+    } while (!secp256k1_ec_seckey_verify(ctx, seckey));
+    secp256k1_rand256_test(msg32);
+    CHECK(secp256k1_ec_pubkey_create(ctx, pubkey, seckey) == 1);
+    CHECK(secp256k1_ecdsa_sign(ctx, sig, msg32, seckey, NULL, NULL) == 1);
+}
+
+static int sigcache_contains(const secp256k1_sigcache *cache, const secp256k1_ecdsa_signature *sig, const unsigned char *msg32, const secp256k1_pubkey *pubkey) {
+    secp256k1_sigcache_entry key;
+    secp256k1_sigcache_key(cache, &key, sig, msg32, pubkey);
+    return secp256k1_sigcache_lookup(cache, &key);
+}
+
+void test_sigcache_api(void) {
+    secp256k1_context *none = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+    secp256k1_context *vrfy = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+    secp256k1_sigcache *cache;
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey pubkey;
+    unsigned char msg[32];
+    unsigned char salt[32] = { 0 };
+    int32_t ecount = 0;
+
+    secp256k1_context_set_illegal_callback(none, counting_illegal_callback_fn, &ecount);
+    secp256k1_context_set_illegal_callback(vrfy, counting_illegal_callback_fn, &ecount);
+    sigcache_random_signature(&sig, msg, &pubkey);
+
+    CHECK(secp256k1_sigcache_create(vrfy, 4 * 32 - 1, salt) == NULL);
+    CHECK(ecount == 1);
+    CHECK(secp256k1_sigcache_create(vrfy, 4 * 32, NULL) == NULL);
+    CHECK(ecount == 2);
+    cache = secp256k1_sigcache_create(vrfy, 4 * 32, salt);
+    CHECK(cache != NULL);
+    CHECK(ecount == 2);
+
+    CHECK(secp256k1_ecdsa_verify_cached(none, cache, &sig, msg, &pubkey) == 0);
+    CHECK(ecount == 3);
+    CHECK(secp256k1_ecdsa_verify_cached(vrfy, NULL, &sig, msg, &pubkey) == 0);
+    CHECK(ecount == 4);
+    CHECK(secp256k1_ecdsa_verify_cached(vrfy, cache, NULL, msg, &pubkey) == 0);
+    CHECK(ecount == 5);
+    CHECK(secp256k1_ecdsa_verify_cached(vrfy, cache, &sig, NULL, &pubkey) == 0);
+    CHECK(ecount == 6);
+    CHECK(secp256k1_ecdsa_verify_cached(vrfy, cache, &sig, msg, NULL) == 0);
+    CHECK(ecount == 7);
+    CHECK(secp256k1_ecdsa_verify_cached(vrfy, cache, &sig, msg, &pubkey) == 1);
+    CHECK(ecount == 7);
+
+    secp256k1_sigcache_destroy(cache);
+    secp256k1_sigcache_destroy(NULL);
+    secp256k1_context_destroy(none);
+    secp256k1_context_destroy(vrfy);
+}
+
+void test_sigcache_hits(void) {
+    secp256k1_sigcache *cache;
+    secp256k1_sigcache *other;
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey pubkey;
+    unsigned char msg[32];
+    unsigned char salt[32];
+
+    secp256k1_rand256(salt);
+    cache = secp256k1_sigcache_create(ctx, 1024 * 32, salt);
+    salt[0] ^= 1;
+    other = secp256k1_sigcache_create(ctx, 1024 * 32, salt);
+    sigcache_random_signature(&sig, msg, &pubkey);
+
+    /* A valid signature is remembered after its first verification. */
+    CHECK(!sigcache_contains(cache, &sig, msg, &pubkey));
+    CHECK(secp256k1_ecdsa_verify_cached(ctx, cache, &sig, msg, &pubkey) == 1);
+    CHECK(sigcache_contains(cache, &sig, msg, &pubkey));
+    CHECK(secp256k1_ecdsa_verify_cached(ctx, cache, &sig, msg, &pubkey) == 1);
+    /* ... only in the cache it went through, which a different salt keys
+     * differently. */
+    CHECK(!sigcache_contains(other, &sig, msg, &pubkey));
+
+    /* An invalid one is rejected every time and never stored. */
+    msg[0] ^= 1;
+    CHECK(secp256k1_ecdsa_verify_cached(ctx, cache, &sig, msg, &pubkey) == 0);
+    CHECK(!sigcache_contains(cache, &sig, msg, &pubkey));
+    CHECK(secp256k1_ecdsa_verify_cached(ctx, cache, &sig, msg, &pubkey) == 0);
+    msg[0] ^= 1;
+
+    /* Nor is the high-S form of a valid signature, which verify rejects. */
+    {
+        secp256k1_ecdsa_signature high;
+        secp256k1_scalar r, s;
+        secp256k1_ecdsa_signature_load(ctx, &r, &s, &sig);
+        secp256k1_scalar_negate(&s, &s);
+        secp256k1_ecdsa_signature_save(&high, &r, &s);
+        CHECK(secp256k1_ecdsa_verify_cached(ctx, cache, &high, msg, &pubkey) == 0);
+        CHECK(!sigcache_contains(cache, &high, msg, &pubkey));
+    }
+
+    secp256k1_sigcache_destroy(cache);
+    secp256k1_sigcache_destroy(other);
+}
+
+void test_sigcache_eviction(void) {
+    /* Many more signatures than slots: results must stay exact while
+     * entries get evicted, and the table must keep (some of) them. */
+    secp256k1_sigcache *cache;
+    secp256k1_ecdsa_signature sig[64];
+    secp256k1_pubkey pubkey[64];
+    unsigned char msg[64][32];
+    unsigned char salt[32];
+    int i, j;
+    int present = 0;
+
+    secp256k1_rand256(salt);
+    cache = secp256k1_sigcache_create(ctx, 16 * 32, salt);
+    for (i = 0; i < 64; i++) {
+        sigcache_random_signature(&sig[i], msg[i], &pubkey[i]);
+    }
+    for (j = 0; j < 3; j++) {
+        for (i = 0; i < 64; i++) {
+            CHECK(secp256k1_ecdsa_verify_cached(ctx, cache, &sig[i], msg[i], &pubkey[i]) == 1);
+            msg[i][31] ^= 0x80;
+            CHECK(secp256k1_ecdsa_verify_cached(ctx, cache, &sig[i], msg[i], &pubkey[i]) == 0);
+            msg[i][31] ^= 0x80;
+        }
+    }
+    for (i = 0; i < 64; i++) {
+        present += sigcache_contains(cache, &sig[i], msg[i], &pubkey[i]);
+    }
+    CHECK(present > 0 && present <= 16);
+
+    secp256k1_sigcache_destroy(cache);
+}
+
+void run_sigcache_tests(void) {
+    int i;
+    test_sigcache_api();
+    for (i = 0; i < count; i++) {
+        test_sigcache_hits();
+    }
+    test_sigcache_eviction();
+}
+
+#endif
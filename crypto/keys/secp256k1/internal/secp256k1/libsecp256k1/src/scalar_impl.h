@@ -55,6 +55,7 @@ static void secp256k1_scalar_order_get_num(secp256k1_num *r) {
 static void secp256k1_scalar_inverse(secp256k1_scalar *r, const secp256k1_scalar *x) {
 #if defined(EXHAUSTIVE_TEST_ORDER)
     int i;
+    SECP256K1_STATS_INC(scalar_inv);
     *r = 0;
     for (i = 0; i < EXHAUSTIVE_TEST_ORDER; i++)
         if ((i * *x) % EXHAUSTIVE_TEST_ORDER == 1)
@@ -69,6 +70,7 @@ static void secp256k1_scalar_inverse(secp256k1_scalar *r, const secp256k1_scalar
     /* First compute x ^ (2^N - 1) for some values of N. */
     secp256k1_scalar x2, x3, x4, x6, x7, x8, x15, x30, x60, x120, x127;
 
+    SECP256K1_STATS_INC(scalar_inv);
     secp256k1_scalar_sqr(&x2,  x);
     secp256k1_scalar_mul(&x2, &x2,  x);
 
@@ -266,6 +268,7 @@ static void secp256k1_scalar_inverse_var(secp256k1_scalar *r, const secp256k1_sc
     unsigned char b[32];
     secp256k1_num n, m;
     secp256k1_scalar t = *x;
+    SECP256K1_STATS_INC(scalar_inv);
     secp256k1_scalar_get_b32(b, &t);
     secp256k1_num_set_bin(&n, b, 32);
     secp256k1_scalar_order_get_num(&m);
@@ -280,6 +283,34 @@ static void secp256k1_scalar_inverse_var(secp256k1_scalar *r, const secp256k1_sc
 #endif
 }
 
+static void secp256k1_scalar_inverse_all(secp256k1_scalar *r, const secp256k1_scalar *a, size_t len) {
+    secp256k1_scalar u;
+    size_t i;
+    if (len < 1) {
+        return;
+    }
+
+    VERIFY_CHECK((r + len <= a) || (a + len <= r));
+
+    r[0] = a[0];
+
+    i = 0;
+    while (++i < len) {
+        secp256k1_scalar_mul(&r[i], &r[i - 1], &a[i]);
+    }
+
+    secp256k1_scalar_inverse(&u, &r[--i]);
+
+    while (i > 0) {
+        size_t j = i--;
+        secp256k1_scalar_mul(&r[j], &r[i], &u);
+        secp256k1_scalar_mul(&u, &u, &a[j]);
+    }
+
+    r[0] = u;
+    secp256k1_scalar_clear(&u);
+}
+
 #ifdef USE_ENDOMORPHISM
 #if defined(EXHAUSTIVE_TEST_ORDER)
 /**
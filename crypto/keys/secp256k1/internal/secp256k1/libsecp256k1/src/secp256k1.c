@@ -17,9 +17,16 @@
 #include "ecdsa_impl.h"
 #include "eckey_impl.h"
 #include "hash_impl.h"
+#include "trace.h"
+
+#if defined(HAVE_ATOMIC_BUILTINS) && (defined(__unix__) || (defined(__APPLE__) && defined(__MACH__)))
+# include <sched.h>
+# define SECP256K1_HAVE_SCHED_YIELD 1
+#endif
 
 #define ARG_CHECK(cond) do { \
     if (EXPECT(!(cond), 0)) { \
+        SECP256K1_TRACE_ILLEGAL(ctx, #cond); \
         secp256k1_callback_call(&ctx->illegal_callback, #cond); \
         return 0; \
     } \
@@ -51,14 +58,113 @@ struct secp256k1_context_struct {
     secp256k1_ecmult_gen_context ecmult_gen_ctx;
     secp256k1_callback illegal_callback;
     secp256k1_callback error_callback;
+    unsigned int lazy; /* SECP256K1_FLAGS_BIT_CONTEXT_SIGN/VERIFY for tables left for first use */
+    unsigned int lock; /* held while publishing one of those */
+    int hugepages;
 };
 
+static void secp256k1_context_lock(const secp256k1_context* ctx) {
+#ifdef HAVE_ATOMIC_BUILTINS
+    secp256k1_context *c = (secp256k1_context *)ctx;
+    unsigned int spins = 0;
+    while (__atomic_exchange_n(&c->lock, 1, __ATOMIC_ACQUIRE)) {
+        /* The lock is only held for a few stores, but its holder may have
+         * been descheduled: spin briefly, then give the CPU away. */
+        while (__atomic_load_n(&c->lock, __ATOMIC_RELAXED)) {
+#ifdef SECP256K1_HAVE_SCHED_YIELD
+            if (++spins >= 64) {
+                sched_yield();
+                continue;
+            }
+#endif
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+            __builtin_ia32_pause();
+#elif defined(__GNUC__) && defined(__aarch64__)
+            __asm__ __volatile__("yield");
+#endif
+        }
+    }
+#else
+    (void)ctx;
+#endif
+}
+
+static void secp256k1_context_unlock(const secp256k1_context* ctx) {
+#ifdef HAVE_ATOMIC_BUILTINS
+    __atomic_store_n(&((secp256k1_context *)ctx)->lock, 0, __ATOMIC_RELEASE);
+#else
+    (void)ctx;
+#endif
+}
+
+/* Build the tables among flags that were left for first use. The context
+ * stays logically const: a table is built outside the lock, so that the
+ * error callback (which may not return) is never called with the lock held,
+ * and then published under the lock by storing it and clearing its bit in
+ * lazy with release ordering. Threads that race for the same table each
+ * build one; the first to publish wins and the others free theirs. Once
+ * published, a table never changes. Without atomics nothing is ever left
+ * for later, and this does nothing. */
+static void secp256k1_context_build(const secp256k1_context* ctx, unsigned int flags) {
+#ifdef HAVE_ATOMIC_BUILTINS
+    secp256k1_context *c = (secp256k1_context *)ctx;
+    unsigned int todo = __atomic_load_n(&c->lazy, __ATOMIC_ACQUIRE) & flags;
+    if (EXPECT(todo == 0, 1)) {
+        return;
+    }
+    if (todo & SECP256K1_FLAGS_BIT_CONTEXT_SIGN) {
+        secp256k1_ecmult_gen_context gen_ctx;
+        secp256k1_ecmult_gen_context_init(&gen_ctx);
+        secp256k1_ecmult_gen_context_build(&gen_ctx, c->hugepages, &c->error_callback);
+        secp256k1_context_lock(c);
+        if (c->lazy & SECP256K1_FLAGS_BIT_CONTEXT_SIGN) {
+            c->ecmult_gen_ctx = gen_ctx;
+            __atomic_store_n(&c->lazy, c->lazy & ~SECP256K1_FLAGS_BIT_CONTEXT_SIGN, __ATOMIC_RELEASE);
+            secp256k1_ecmult_gen_context_init(&gen_ctx);
+        }
+        secp256k1_context_unlock(c);
+        secp256k1_ecmult_gen_context_clear(&gen_ctx);
+    }
+    if (todo & SECP256K1_FLAGS_BIT_CONTEXT_VERIFY) {
+        secp256k1_ecmult_context ecmult_ctx;
+        secp256k1_ecmult_context_init(&ecmult_ctx);
+        secp256k1_ecmult_context_build(&ecmult_ctx, c->hugepages, &c->error_callback);
+        secp256k1_context_lock(c);
+        if (c->lazy & SECP256K1_FLAGS_BIT_CONTEXT_VERIFY) {
+            c->ecmult_ctx = ecmult_ctx;
+            __atomic_store_n(&c->lazy, c->lazy & ~SECP256K1_FLAGS_BIT_CONTEXT_VERIFY, __ATOMIC_RELEASE);
+            secp256k1_ecmult_context_init(&ecmult_ctx);
+        }
+        secp256k1_context_unlock(c);
+        secp256k1_ecmult_context_clear(&ecmult_ctx);
+    }
+#else
+    (void)ctx;
+    (void)flags;
+#endif
+}
+
+/* Whether ctx can sign, building its table first if it was left for later. */
+static int secp256k1_context_ecmult_gen_ready(const secp256k1_context* ctx) {
+    secp256k1_context_build(ctx, SECP256K1_FLAGS_BIT_CONTEXT_SIGN);
+    return secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx);
+}
+
+/* Whether ctx can verify, building its tables first if they were left for later. */
+static int secp256k1_context_ecmult_ready(const secp256k1_context* ctx) {
+    secp256k1_context_build(ctx, SECP256K1_FLAGS_BIT_CONTEXT_VERIFY);
+    return secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx);
+}
+
 secp256k1_context* secp256k1_context_create(unsigned int flags) {
-    secp256k1_context* ret = (secp256k1_context*)checked_malloc(&default_error_callback, sizeof(secp256k1_context));
+    secp256k1_context* ret;
+    SECP256K1_TRACE_ENTRY(context_create, NULL, flags);
+    ret = (secp256k1_context*)checked_malloc(&default_error_callback, sizeof(secp256k1_context));
     ret->illegal_callback = default_illegal_callback;
     ret->error_callback = default_error_callback;
 
     if (EXPECT((flags & SECP256K1_FLAGS_TYPE_MASK) != SECP256K1_FLAGS_TYPE_CONTEXT, 0)) {
+            SECP256K1_TRACE_ILLEGAL(NULL, "Invalid flags");
             secp256k1_callback_call(&ret->illegal_callback,
                                     "Invalid flags");
             free(ret);
@@ -67,49 +173,94 @@ secp256k1_context* secp256k1_context_create(unsigned int flags) {
 
     secp256k1_ecmult_context_init(&ret->ecmult_ctx);
     secp256k1_ecmult_gen_context_init(&ret->ecmult_gen_ctx);
-
+    ret->lazy = 0;
+    ret->lock = 0;
+    ret->hugepages = !!(flags & SECP256K1_FLAGS_BIT_CONTEXT_HUGEPAGES);
+
+#ifdef HAVE_ATOMIC_BUILTINS
+    if (flags & SECP256K1_FLAGS_BIT_CONTEXT_LAZY) {
+        ret->lazy = flags & (SECP256K1_FLAGS_BIT_CONTEXT_SIGN | SECP256K1_FLAGS_BIT_CONTEXT_VERIFY);
+        SECP256K1_TRACE_RETURN(context_create, ret);
+        return ret;
+    }
+#endif
     if (flags & SECP256K1_FLAGS_BIT_CONTEXT_SIGN) {
-        secp256k1_ecmult_gen_context_build(&ret->ecmult_gen_ctx, &ret->error_callback);
+        secp256k1_ecmult_gen_context_build(&ret->ecmult_gen_ctx, ret->hugepages, &ret->error_callback);
     }
     if (flags & SECP256K1_FLAGS_BIT_CONTEXT_VERIFY) {
-        secp256k1_ecmult_context_build(&ret->ecmult_ctx, &ret->error_callback);
+        secp256k1_ecmult_context_build(&ret->ecmult_ctx, ret->hugepages, &ret->error_callback);
     }
 
+    SECP256K1_TRACE_RETURN(context_create, ret);
     return ret;
 }
 
 secp256k1_context* secp256k1_context_clone(const secp256k1_context* ctx) {
-    secp256k1_context* ret = (secp256k1_context*)checked_malloc(&ctx->error_callback, sizeof(secp256k1_context));
+    secp256k1_context* ret;
+    SECP256K1_TRACE_ENTRY(context_clone, ctx, 0);
+    ret = (secp256k1_context*)checked_malloc(&ctx->error_callback, sizeof(secp256k1_context));
     ret->illegal_callback = ctx->illegal_callback;
     ret->error_callback = ctx->error_callback;
-    secp256k1_ecmult_context_clone(&ret->ecmult_ctx, &ctx->ecmult_ctx, &ctx->error_callback);
-    secp256k1_ecmult_gen_context_clone(&ret->ecmult_gen_ctx, &ctx->ecmult_gen_ctx, &ctx->error_callback);
+    /* Tables still left for first use stay that way in the clone. Only
+     * published tables are read, and those never change, so this takes no
+     * lock (and calls the error callback without holding one). */
+#ifdef HAVE_ATOMIC_BUILTINS
+    ret->lazy = __atomic_load_n(&ctx->lazy, __ATOMIC_ACQUIRE);
+#else
+    ret->lazy = ctx->lazy;
+#endif
+    if (ret->lazy & SECP256K1_FLAGS_BIT_CONTEXT_VERIFY) {
+        secp256k1_ecmult_context_init(&ret->ecmult_ctx);
+    } else {
+        secp256k1_ecmult_context_clone(&ret->ecmult_ctx, &ctx->ecmult_ctx, &ctx->error_callback);
+    }
+    if (ret->lazy & SECP256K1_FLAGS_BIT_CONTEXT_SIGN) {
+        secp256k1_ecmult_gen_context_init(&ret->ecmult_gen_ctx);
+    } else {
+        secp256k1_ecmult_gen_context_clone(&ret->ecmult_gen_ctx, &ctx->ecmult_gen_ctx, &ctx->error_callback);
+    }
+    ret->hugepages = ctx->hugepages;
+    ret->lock = 0;
+    SECP256K1_TRACE_RETURN(context_clone, ret);
     return ret;
 }
 
 void secp256k1_context_destroy(secp256k1_context* ctx) {
+    SECP256K1_TRACE_ENTRY(context_destroy, ctx, 0);
     if (ctx != NULL) {
         secp256k1_ecmult_context_clear(&ctx->ecmult_ctx);
         secp256k1_ecmult_gen_context_clear(&ctx->ecmult_gen_ctx);
 
         free(ctx);
     }
+    SECP256K1_TRACE_RETURN(context_destroy, 0);
+}
+
+void secp256k1_context_warmup(const secp256k1_context* ctx) {
+    SECP256K1_TRACE_ENTRY(context_warmup, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    secp256k1_context_build(ctx, SECP256K1_FLAGS_BIT_CONTEXT_SIGN | SECP256K1_FLAGS_BIT_CONTEXT_VERIFY);
+    SECP256K1_TRACE_RETURN(context_warmup, 0);
 }
 
 void secp256k1_context_set_illegal_callback(secp256k1_context* ctx, void (*fun)(const char* message, void* data), const void* data) {
+    SECP256K1_TRACE_ENTRY(context_set_illegal_callback, ctx, 0);
     if (fun == NULL) {
         fun = default_illegal_callback_fn;
     }
     ctx->illegal_callback.fn = fun;
     ctx->illegal_callback.data = data;
+    SECP256K1_TRACE_RETURN(context_set_illegal_callback, 0);
 }
 
 void secp256k1_context_set_error_callback(secp256k1_context* ctx, void (*fun)(const char* message, void* data), const void* data) {
+    SECP256K1_TRACE_ENTRY(context_set_error_callback, ctx, 0);
     if (fun == NULL) {
         fun = default_error_callback_fn;
     }
     ctx->error_callback.fn = fun;
     ctx->error_callback.data = data;
+    SECP256K1_TRACE_RETURN(context_set_error_callback, 0);
 }
 
 static int secp256k1_pubkey_load(const secp256k1_context* ctx, secp256k1_ge* ge, const secp256k1_pubkey* pubkey) {
@@ -148,15 +299,18 @@ static void secp256k1_pubkey_save(secp256k1_pubkey* pubkey, secp256k1_ge* ge) {
 int secp256k1_ec_pubkey_parse(const secp256k1_context* ctx, secp256k1_pubkey* pubkey, const unsigned char *input, size_t inputlen) {
     secp256k1_ge Q;
 
+    SECP256K1_TRACE_ENTRY(ec_pubkey_parse, ctx, inputlen);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(pubkey != NULL);
     memset(pubkey, 0, sizeof(*pubkey));
     ARG_CHECK(input != NULL);
     if (!secp256k1_eckey_pubkey_parse(&Q, input, inputlen)) {
+        SECP256K1_TRACE_RETURN(ec_pubkey_parse, 0);
         return 0;
     }
     secp256k1_pubkey_save(pubkey, &Q);
     secp256k1_ge_clear(&Q);
+    SECP256K1_TRACE_RETURN(ec_pubkey_parse, 1);
     return 1;
 }
 
@@ -165,6 +319,7 @@ int secp256k1_ec_pubkey_serialize(const secp256k1_context* ctx, unsigned char *o
     size_t len;
     int ret = 0;
 
+    SECP256K1_TRACE_ENTRY(ec_pubkey_serialize, ctx, flags);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(outputlen != NULL);
     ARG_CHECK(*outputlen >= ((flags & SECP256K1_FLAGS_BIT_COMPRESSION) ? 33 : 65));
@@ -180,6 +335,7 @@ int secp256k1_ec_pubkey_serialize(const secp256k1_context* ctx, unsigned char *o
             *outputlen = len;
         }
     }
+    SECP256K1_TRACE_RETURN(ec_pubkey_serialize, ret);
     return ret;
 }
 
@@ -209,18 +365,21 @@ static void secp256k1_ecdsa_signature_save(secp256k1_ecdsa_signature* sig, const
 
 int secp256k1_ecdsa_signature_parse_der(const secp256k1_context* ctx, secp256k1_ecdsa_signature* sig, const unsigned char *input, size_t inputlen) {
     secp256k1_scalar r, s;
+    int ret;
 
+    SECP256K1_TRACE_ENTRY(ecdsa_signature_parse_der, ctx, inputlen);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(sig != NULL);
     ARG_CHECK(input != NULL);
 
-    if (secp256k1_ecdsa_sig_parse(&r, &s, input, inputlen)) {
+    ret = secp256k1_ecdsa_sig_parse(&r, &s, input, inputlen);
+    if (ret) {
         secp256k1_ecdsa_signature_save(sig, &r, &s);
-        return 1;
     } else {
         memset(sig, 0, sizeof(*sig));
-        return 0;
     }
+    SECP256K1_TRACE_RETURN(ecdsa_signature_parse_der, ret);
+    return ret;
 }
 
 int secp256k1_ecdsa_signature_parse_compact(const secp256k1_context* ctx, secp256k1_ecdsa_signature* sig, const unsigned char *input64) {
@@ -228,6 +387,7 @@ int secp256k1_ecdsa_signature_parse_compact(const secp256k1_context* ctx, secp25
     int ret = 1;
     int overflow = 0;
 
+    SECP256K1_TRACE_ENTRY(ecdsa_signature_parse_compact, ctx, 64);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(sig != NULL);
     ARG_CHECK(input64 != NULL);
@@ -241,24 +401,30 @@ int secp256k1_ecdsa_signature_parse_compact(const secp256k1_context* ctx, secp25
     } else {
         memset(sig, 0, sizeof(*sig));
     }
+    SECP256K1_TRACE_RETURN(ecdsa_signature_parse_compact, ret);
     return ret;
 }
 
 int secp256k1_ecdsa_signature_serialize_der(const secp256k1_context* ctx, unsigned char *output, size_t *outputlen, const secp256k1_ecdsa_signature* sig) {
     secp256k1_scalar r, s;
+    int ret;
 
+    SECP256K1_TRACE_ENTRY(ecdsa_signature_serialize_der, ctx, outputlen != NULL ? *outputlen : 0);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(output != NULL);
     ARG_CHECK(outputlen != NULL);
     ARG_CHECK(sig != NULL);
 
     secp256k1_ecdsa_signature_load(ctx, &r, &s, sig);
-    return secp256k1_ecdsa_sig_serialize(output, outputlen, &r, &s);
+    ret = secp256k1_ecdsa_sig_serialize(output, outputlen, &r, &s);
+    SECP256K1_TRACE_RETURN(ecdsa_signature_serialize_der, ret);
+    return ret;
 }
 
 int secp256k1_ecdsa_signature_serialize_compact(const secp256k1_context* ctx, unsigned char *output64, const secp256k1_ecdsa_signature* sig) {
     secp256k1_scalar r, s;
 
+    SECP256K1_TRACE_ENTRY(ecdsa_signature_serialize_compact, ctx, 64);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(output64 != NULL);
     ARG_CHECK(sig != NULL);
@@ -266,6 +432,7 @@ int secp256k1_ecdsa_signature_serialize_compact(const secp256k1_context* ctx, un
     secp256k1_ecdsa_signature_load(ctx, &r, &s, sig);
     secp256k1_scalar_get_b32(&output64[0], &r);
     secp256k1_scalar_get_b32(&output64[32], &s);
+    SECP256K1_TRACE_RETURN(ecdsa_signature_serialize_compact, 1);
     return 1;
 }
 
@@ -273,6 +440,7 @@ int secp256k1_ecdsa_signature_normalize(const secp256k1_context* ctx, secp256k1_
     secp256k1_scalar r, s;
     int ret = 0;
 
+    SECP256K1_TRACE_ENTRY(ecdsa_signature_normalize, ctx, 0);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(sigin != NULL);
 
@@ -285,6 +453,7 @@ int secp256k1_ecdsa_signature_normalize(const secp256k1_context* ctx, secp256k1_
         secp256k1_ecdsa_signature_save(sigout, &r, &s);
     }
 
+    SECP256K1_TRACE_RETURN(ecdsa_signature_normalize, ret);
     return ret;
 }
 
@@ -292,17 +461,51 @@ int secp256k1_ecdsa_verify(const secp256k1_context* ctx, const secp256k1_ecdsa_s
     secp256k1_ge q;
     secp256k1_scalar r, s;
     secp256k1_scalar m;
+    int ret;
+    SECP256K1_TRACE_ENTRY(ecdsa_verify, ctx, 1);
     VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
     ARG_CHECK(msg32 != NULL);
     ARG_CHECK(sig != NULL);
     ARG_CHECK(pubkey != NULL);
 
     secp256k1_scalar_set_b32(&m, msg32, NULL);
     secp256k1_ecdsa_signature_load(ctx, &r, &s, sig);
-    return (!secp256k1_scalar_is_high(&s) &&
-            secp256k1_pubkey_load(ctx, &q, pubkey) &&
-            secp256k1_ecdsa_sig_verify(&ctx->ecmult_ctx, &r, &s, &q, &m));
+    ret = (!secp256k1_scalar_is_high(&s) &&
+           secp256k1_pubkey_load(ctx, &q, pubkey) &&
+           secp256k1_ecdsa_sig_verify(&ctx->ecmult_ctx, &r, &s, &q, &m));
+    SECP256K1_TRACE_RETURN(ecdsa_verify, ret);
+    return ret;
+}
+
+int secp256k1_ecdsa_verify_x2(const secp256k1_context* ctx, int *results, const secp256k1_ecdsa_signature *sig1, const unsigned char *msg1_32, const secp256k1_pubkey *pubkey1, const secp256k1_ecdsa_signature *sig2, const unsigned char *msg2_32, const secp256k1_pubkey *pubkey2) {
+    secp256k1_ge q[2];
+    secp256k1_scalar r[2], s[2];
+    secp256k1_scalar m[2];
+    int ok[2];
+    SECP256K1_TRACE_ENTRY(ecdsa_verify_x2, ctx, 2);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
+    ARG_CHECK(msg1_32 != NULL);
+    ARG_CHECK(sig1 != NULL);
+    ARG_CHECK(pubkey1 != NULL);
+    ARG_CHECK(msg2_32 != NULL);
+    ARG_CHECK(sig2 != NULL);
+    ARG_CHECK(pubkey2 != NULL);
+
+    secp256k1_scalar_set_b32(&m[0], msg1_32, NULL);
+    secp256k1_ecdsa_signature_load(ctx, &r[0], &s[0], sig1);
+    ok[0] = !secp256k1_scalar_is_high(&s[0]) && secp256k1_pubkey_load(ctx, &q[0], pubkey1);
+    secp256k1_scalar_set_b32(&m[1], msg2_32, NULL);
+    secp256k1_ecdsa_signature_load(ctx, &r[1], &s[1], sig2);
+    ok[1] = !secp256k1_scalar_is_high(&s[1]) && secp256k1_pubkey_load(ctx, &q[1], pubkey2);
+    secp256k1_ecdsa_sig_verify_x2(&ctx->ecmult_ctx, ok, r, s, q, m);
+    if (results != NULL) {
+        results[0] = ok[0];
+        results[1] = ok[1];
+    }
+    SECP256K1_TRACE_RETURN(ecdsa_verify_x2, ok[0] && ok[1]);
+    return ok[0] && ok[1];
 }
 
 static int nonce_function_rfc6979(unsigned char *nonce32, const unsigned char *msg32, const unsigned char *key32, const unsigned char *algo16, void *data, unsigned int counter) {
@@ -345,8 +548,9 @@ int secp256k1_ecdsa_sign(const secp256k1_context* ctx, secp256k1_ecdsa_signature
     secp256k1_scalar sec, non, msg;
     int ret = 0;
     int overflow = 0;
+    SECP256K1_TRACE_ENTRY(ecdsa_sign, ctx, 1);
     VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(secp256k1_context_ecmult_gen_ready(ctx));
     ARG_CHECK(msg32 != NULL);
     ARG_CHECK(signature != NULL);
     ARG_CHECK(seckey != NULL);
@@ -383,6 +587,109 @@ int secp256k1_ecdsa_sign(const secp256k1_context* ctx, secp256k1_ecdsa_signature
     } else {
         memset(signature, 0, sizeof(*signature));
     }
+    SECP256K1_TRACE_RETURN(ecdsa_sign, ret);
+    return ret;
+}
+
+/* Signs len <= SECP256K1_ECDSA_SIGN_BATCH consecutive (msg32, seckey) pairs. All nonces are derived up front, so
+ * the HMAC chains run back to back before any point arithmetic, and the signatures are then created together.
+ * An entry the batch leaves without a signature (s == 0, which is cryptographically unreachable) retries with
+ * the following nonces on its own, so every entry ends up exactly as secp256k1_ecdsa_sign leaves it. ret[i]
+ * receives what secp256k1_ecdsa_sign would return for entry i. */
+static void secp256k1_ecdsa_sign_batch_chunk(const secp256k1_context* ctx, int *ret, secp256k1_scalar *r, secp256k1_scalar *s, int *recid, const unsigned char *msgs32, const unsigned char *seckeys, size_t len, secp256k1_nonce_function noncefp, const void* noncedata) {
+    secp256k1_scalar sec[SECP256K1_ECDSA_SIGN_BATCH], msg[SECP256K1_ECDSA_SIGN_BATCH], non[SECP256K1_ECDSA_SIGN_BATCH];
+    secp256k1_scalar br[SECP256K1_ECDSA_SIGN_BATCH], bs[SECP256K1_ECDSA_SIGN_BATCH];
+    int brecid[SECP256K1_ECDSA_SIGN_BATCH];
+    int ok[SECP256K1_ECDSA_SIGN_BATCH];
+    unsigned int count[SECP256K1_ECDSA_SIGN_BATCH];
+    size_t idx[SECP256K1_ECDSA_SIGN_BATCH];
+    unsigned char nonce32[32];
+    size_t i, j, m = 0;
+    int overflow;
+
+    for (i = 0; i < len; i++) {
+        const unsigned char *msg32 = &msgs32[32 * i];
+        const unsigned char *seckey = &seckeys[32 * i];
+        ret[i] = 0;
+        overflow = 0;
+        secp256k1_scalar_set_b32(&sec[m], seckey, &overflow);
+        /* Fail if the secret key is invalid. */
+        if (overflow || secp256k1_scalar_is_zero(&sec[m])) {
+            continue;
+        }
+        secp256k1_scalar_set_b32(&msg[m], msg32, NULL);
+        count[m] = 0;
+        while (1) {
+            ret[i] = noncefp(nonce32, msg32, seckey, NULL, (void*)noncedata, count[m]);
+            if (!ret[i]) {
+                break;
+            }
+            secp256k1_scalar_set_b32(&non[m], nonce32, &overflow);
+            if (!overflow && !secp256k1_scalar_is_zero(&non[m])) {
+                break;
+            }
+            count[m]++;
+        }
+        if (ret[i]) {
+            idx[m++] = i;
+        }
+    }
+
+    secp256k1_ecdsa_sig_sign_batch(&ctx->ecmult_gen_ctx, ok, br, bs, sec, msg, non, recid ? brecid : NULL, m);
+
+    for (j = 0; j < m; j++) {
+        i = idx[j];
+        r[i] = br[j];
+        s[i] = bs[j];
+        if (recid) {
+            recid[i] = brecid[j];
+        }
+        while (!ok[j]) {
+            count[j]++;
+            ret[i] = noncefp(nonce32, &msgs32[32 * i], &seckeys[32 * i], NULL, (void*)noncedata, count[j]);
+            if (!ret[i]) {
+                break;
+            }
+            secp256k1_scalar_set_b32(&non[j], nonce32, &overflow);
+            if (!overflow && !secp256k1_scalar_is_zero(&non[j])) {
+                ok[j] = secp256k1_ecdsa_sig_sign(&ctx->ecmult_gen_ctx, &r[i], &s[i], &sec[j], &msg[j], &non[j], recid ? &recid[i] : NULL);
+            }
+        }
+    }
+    memset(nonce32, 0, 32);
+    memset(sec, 0, sizeof(sec));
+    memset(msg, 0, sizeof(msg));
+    memset(non, 0, sizeof(non));
+}
+
+int secp256k1_ecdsa_sign_batch(const secp256k1_context* ctx, secp256k1_ecdsa_signature *signatures, const unsigned char *msgs32, const unsigned char *seckeys, size_t n, secp256k1_nonce_function noncefp, const void* noncedata) {
+    secp256k1_scalar r[SECP256K1_ECDSA_SIGN_BATCH], s[SECP256K1_ECDSA_SIGN_BATCH];
+    int ok[SECP256K1_ECDSA_SIGN_BATCH];
+    size_t i, j;
+    int ret = 1;
+    SECP256K1_TRACE_ENTRY(ecdsa_sign_batch, ctx, n);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_ecmult_gen_ready(ctx));
+    ARG_CHECK(signatures != NULL);
+    ARG_CHECK(msgs32 != NULL);
+    ARG_CHECK(seckeys != NULL);
+    if (noncefp == NULL) {
+        noncefp = secp256k1_nonce_function_default;
+    }
+
+    for (i = 0; i < n; i += SECP256K1_ECDSA_SIGN_BATCH) {
+        size_t len = n - i < SECP256K1_ECDSA_SIGN_BATCH ? n - i : SECP256K1_ECDSA_SIGN_BATCH;
+        secp256k1_ecdsa_sign_batch_chunk(ctx, ok, r, s, NULL, &msgs32[32 * i], &seckeys[32 * i], len, noncefp, noncedata);
+        for (j = 0; j < len; j++) {
+            if (ok[j]) {
+                secp256k1_ecdsa_signature_save(&signatures[i + j], &r[j], &s[j]);
+            } else {
+                memset(&signatures[i + j], 0, sizeof(signatures[i + j]));
+                ret = 0;
+            }
+        }
+    }
+    SECP256K1_TRACE_RETURN(ecdsa_sign_batch, ret);
     return ret;
 }
 
@@ -390,12 +697,14 @@ int secp256k1_ec_seckey_verify(const secp256k1_context* ctx, const unsigned char
     secp256k1_scalar sec;
     int ret;
     int overflow;
+    SECP256K1_TRACE_ENTRY(ec_seckey_verify, ctx, 0);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(seckey != NULL);
 
     secp256k1_scalar_set_b32(&sec, seckey, &overflow);
     ret = !overflow && !secp256k1_scalar_is_zero(&sec);
     secp256k1_scalar_clear(&sec);
+    SECP256K1_TRACE_RETURN(ec_seckey_verify, ret);
     return ret;
 }
 
@@ -405,10 +714,11 @@ int secp256k1_ec_pubkey_create(const secp256k1_context* ctx, secp256k1_pubkey *p
     secp256k1_scalar sec;
     int overflow;
     int ret = 0;
+    SECP256K1_TRACE_ENTRY(ec_pubkey_create, ctx, 0);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(pubkey != NULL);
     memset(pubkey, 0, sizeof(*pubkey));
-    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(secp256k1_context_ecmult_gen_ready(ctx));
     ARG_CHECK(seckey != NULL);
 
     secp256k1_scalar_set_b32(&sec, seckey, &overflow);
@@ -419,6 +729,7 @@ int secp256k1_ec_pubkey_create(const secp256k1_context* ctx, secp256k1_pubkey *p
         secp256k1_pubkey_save(pubkey, &p);
     }
     secp256k1_scalar_clear(&sec);
+    SECP256K1_TRACE_RETURN(ec_pubkey_create, ret);
     return ret;
 }
 
@@ -427,6 +738,7 @@ int secp256k1_ec_privkey_tweak_add(const secp256k1_context* ctx, unsigned char *
     secp256k1_scalar sec;
     int ret = 0;
     int overflow = 0;
+    SECP256K1_TRACE_ENTRY(ec_privkey_tweak_add, ctx, 0);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(seckey != NULL);
     ARG_CHECK(tweak != NULL);
@@ -442,6 +754,7 @@ int secp256k1_ec_privkey_tweak_add(const secp256k1_context* ctx, unsigned char *
 
     secp256k1_scalar_clear(&sec);
     secp256k1_scalar_clear(&term);
+    SECP256K1_TRACE_RETURN(ec_privkey_tweak_add, ret);
     return ret;
 }
 
@@ -450,8 +763,9 @@ int secp256k1_ec_pubkey_tweak_add(const secp256k1_context* ctx, secp256k1_pubkey
     secp256k1_scalar term;
     int ret = 0;
     int overflow = 0;
+    SECP256K1_TRACE_ENTRY(ec_pubkey_tweak_add, ctx, 0);
     VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
     ARG_CHECK(pubkey != NULL);
     ARG_CHECK(tweak != NULL);
 
@@ -466,6 +780,7 @@ int secp256k1_ec_pubkey_tweak_add(const secp256k1_context* ctx, secp256k1_pubkey
         }
     }
 
+    SECP256K1_TRACE_RETURN(ec_pubkey_tweak_add, ret);
     return ret;
 }
 
@@ -474,6 +789,7 @@ int secp256k1_ec_privkey_tweak_mul(const secp256k1_context* ctx, unsigned char *
     secp256k1_scalar sec;
     int ret = 0;
     int overflow = 0;
+    SECP256K1_TRACE_ENTRY(ec_privkey_tweak_mul, ctx, 0);
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(seckey != NULL);
     ARG_CHECK(tweak != NULL);
@@ -488,6 +804,7 @@ int secp256k1_ec_privkey_tweak_mul(const secp256k1_context* ctx, unsigned char *
 
     secp256k1_scalar_clear(&sec);
     secp256k1_scalar_clear(&factor);
+    SECP256K1_TRACE_RETURN(ec_privkey_tweak_mul, ret);
     return ret;
 }
 
@@ -496,8 +813,9 @@ int secp256k1_ec_pubkey_tweak_mul(const secp256k1_context* ctx, secp256k1_pubkey
     secp256k1_scalar factor;
     int ret = 0;
     int overflow = 0;
+    SECP256K1_TRACE_ENTRY(ec_pubkey_tweak_mul, ctx, 0);
     VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(secp256k1_context_ecmult_ready(ctx));
     ARG_CHECK(pubkey != NULL);
     ARG_CHECK(tweak != NULL);
 
@@ -512,48 +830,164 @@ int secp256k1_ec_pubkey_tweak_mul(const secp256k1_context* ctx, secp256k1_pubkey
         }
     }
 
+    SECP256K1_TRACE_RETURN(ec_pubkey_tweak_mul, ret);
+    return ret;
+}
+
+struct secp256k1_point_precomp_struct {
+    secp256k1_ge_storage *prec; /* 64 rows of 16 */
+};
+
+secp256k1_point_precomp* secp256k1_point_precomp_create(const secp256k1_context* ctx, const secp256k1_pubkey *pubkey) {
+    secp256k1_point_precomp *ret = NULL;
+    secp256k1_ge p;
+    SECP256K1_TRACE_ENTRY(point_precomp_create, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pubkey != NULL);
+
+    if (secp256k1_pubkey_load(ctx, &p, pubkey)) {
+        ret = (secp256k1_point_precomp*)checked_malloc(&ctx->error_callback, sizeof(secp256k1_point_precomp));
+        if (ret != NULL) {
+            ret->prec = (secp256k1_ge_storage*)checked_table_malloc(&ctx->error_callback, sizeof(secp256k1_ge_storage) * 1024, 0);
+            if (ret->prec == NULL || !secp256k1_ecmult_const_precomp_build(ret->prec, &p, &ctx->error_callback)) {
+                table_free(ret->prec);
+                free(ret);
+                ret = NULL;
+            }
+        }
+    }
+    SECP256K1_TRACE_RETURN(point_precomp_create, ret);
+    return ret;
+}
+
+void secp256k1_point_precomp_destroy(secp256k1_point_precomp* precomp) {
+    SECP256K1_TRACE_ENTRY(point_precomp_destroy, NULL, 0);
+    if (precomp != NULL) {
+        table_free(precomp->prec);
+        free(precomp);
+    }
+    SECP256K1_TRACE_RETURN(point_precomp_destroy, 0);
+}
+
+int secp256k1_point_precomp_mul(const secp256k1_context* ctx, secp256k1_pubkey *pubkey, const secp256k1_point_precomp *precomp, const unsigned char *scalar) {
+    secp256k1_gej res;
+    secp256k1_ge p;
+    secp256k1_scalar s;
+    int ret = 0;
+    int overflow = 0;
+    SECP256K1_TRACE_ENTRY(point_precomp_mul, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pubkey != NULL);
+    ARG_CHECK(precomp != NULL);
+    ARG_CHECK(scalar != NULL);
+
+    memset(pubkey, 0, sizeof(*pubkey));
+    secp256k1_scalar_set_b32(&s, scalar, &overflow);
+    if (!overflow && !secp256k1_scalar_is_zero(&s)) {
+        secp256k1_ecmult_const_precomp(&res, precomp->prec, &s);
+        secp256k1_ge_set_gej(&p, &res);
+        secp256k1_pubkey_save(pubkey, &p);
+        ret = 1;
+    }
+    secp256k1_scalar_clear(&s);
+    SECP256K1_TRACE_RETURN(point_precomp_mul, ret);
     return ret;
 }
 
 int secp256k1_context_randomize(secp256k1_context* ctx, const unsigned char *seed32) {
+    SECP256K1_TRACE_ENTRY(context_randomize, ctx, seed32 != NULL ? 32 : 0);
     VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(secp256k1_context_ecmult_gen_ready(ctx));
     secp256k1_ecmult_gen_blind(&ctx->ecmult_gen_ctx, seed32);
+    SECP256K1_TRACE_RETURN(context_randomize, 1);
     return 1;
 }
 
+/* From this many keys on, combine them with secp256k1_ge_sum_var, which adds
+ * smaller numbers of points one by one anyway. */
+#define SECP256K1_EC_PUBKEY_COMBINE_SUM_MIN 128
+
 int secp256k1_ec_pubkey_combine(const secp256k1_context* ctx, secp256k1_pubkey *pubnonce, const secp256k1_pubkey * const *pubnonces, size_t n) {
     size_t i;
     secp256k1_gej Qj;
     secp256k1_ge Q;
 
+    SECP256K1_TRACE_ENTRY(ec_pubkey_combine, ctx, n);
     ARG_CHECK(pubnonce != NULL);
     memset(pubnonce, 0, sizeof(*pubnonce));
     ARG_CHECK(n >= 1);
     ARG_CHECK(pubnonces != NULL);
 
-    secp256k1_gej_set_infinity(&Qj);
-
-    for (i = 0; i < n; i++) {
-        secp256k1_pubkey_load(ctx, &Q, pubnonces[i]);
-        secp256k1_gej_add_ge(&Qj, &Qj, &Q);
-    }
-    if (secp256k1_gej_is_infinity(&Qj)) {
-        return 0;
+    /* Public keys are public, so this is all variable time. */
+    if (n >= SECP256K1_EC_PUBKEY_COMBINE_SUM_MIN) {
+        secp256k1_ge *a = (secp256k1_ge *)checked_malloc(&ctx->error_callback, sizeof(secp256k1_ge) * n);
+        secp256k1_fe *scratch = (secp256k1_fe *)checked_malloc(&ctx->error_callback, sizeof(secp256k1_fe) * n);
+        int ret = 1;
+        for (i = 0; i < n && ret; i++) {
+            ret = secp256k1_pubkey_load(ctx, &a[i], pubnonces[i]);
+        }
+        ret = ret && secp256k1_ge_sum_var(&Q, a, scratch, n);
+        free(scratch);
+        free(a);
+        if (!ret) {
+            SECP256K1_TRACE_RETURN(ec_pubkey_combine, 0);
+            return 0;
+        }
+    } else {
+        secp256k1_gej_set_infinity(&Qj);
+        for (i = 0; i < n; i++) {
+            if (!secp256k1_pubkey_load(ctx, &Q, pubnonces[i])) {
+                SECP256K1_TRACE_RETURN(ec_pubkey_combine, 0);
+                return 0;
+            }
+            secp256k1_gej_add_ge_var(&Qj, &Qj, &Q, NULL);
+        }
+        if (secp256k1_gej_is_infinity(&Qj)) {
+            SECP256K1_TRACE_RETURN(ec_pubkey_combine, 0);
+            return 0;
+        }
+        secp256k1_ge_set_gej_var(&Q, &Qj);
     }
-    secp256k1_ge_set_gej(&Q, &Qj);
     secp256k1_pubkey_save(pubnonce, &Q);
+    SECP256K1_TRACE_RETURN(ec_pubkey_combine, 1);
+    return 1;
+}
+
+#ifdef ENABLE_STATS
+int secp256k1_context_get_stats(const secp256k1_context* ctx, secp256k1_stats *stats) {
+    SECP256K1_TRACE_ENTRY(context_get_stats, ctx, 0);
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(stats != NULL);
+    secp256k1_stats_sum(stats);
+    SECP256K1_TRACE_RETURN(context_get_stats, 1);
     return 1;
 }
+#endif
 
 #ifdef ENABLE_MODULE_ECDH
 # include "modules/ecdh/main_impl.h"
 #endif
 
-#ifdef ENABLE_MODULE_SCHNORR
-# include "modules/schnorr/main_impl.h"
+#ifdef ENABLE_MODULE_SCHNORRSIG
+# include "modules/schnorrsig/main_impl.h"
+#endif
+
+#ifdef ENABLE_MODULE_MUSIG
+# include "modules/musig/main_impl.h"
+#endif
+
+#ifdef ENABLE_MODULE_SCHNORRSIG_HALFAGG
+# include "modules/schnorrsig_halfagg/main_impl.h"
 #endif
 
 #ifdef ENABLE_MODULE_RECOVERY
 # include "modules/recovery/main_impl.h"
 #endif
+
+#ifdef ENABLE_MODULE_SIGCACHE
+# include "modules/sigcache/main_impl.h"
+#endif
+
+#ifdef ENABLE_MODULE_NONCEPOOL
+# include "modules/noncepool/main_impl.h"
+#endif
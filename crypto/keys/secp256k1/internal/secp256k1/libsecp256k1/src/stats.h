@@ -0,0 +1,85 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_STATS_H_
+#define _SECP256K1_STATS_H_
+
+/* Operation counters for secp256k1_context_get_stats, compiled in with
+ * --enable-stats; otherwise SECP256K1_STATS_INC expands to nothing. */
+
+#ifdef ENABLE_STATS
+
+#include <string.h>
+
+#include "include/secp256k1_stats.h"
+
+/* Each thread counts into its own block, so the hot paths do a plain
+ * increment without contention. A block is allocated on the first count of
+ * a thread and pushed onto a global list, which readers walk to sum them up.
+ * Blocks are never freed: counts of threads that exited are kept. */
+typedef struct secp256k1_stats_block_struct {
+    secp256k1_stats stats;
+    struct secp256k1_stats_block_struct *next;
+} secp256k1_stats_block;
+
+static __thread secp256k1_stats_block *secp256k1_stats_local;
+static secp256k1_stats_block *secp256k1_stats_list;
+
+static secp256k1_stats *secp256k1_stats_register(void) {
+    secp256k1_stats_block *b = (secp256k1_stats_block *)calloc(1, sizeof(secp256k1_stats_block));
+    if (b == NULL) {
+        /* Out of memory; these counts are lost rather than reported. */
+        static secp256k1_stats_block fallback;
+        secp256k1_stats_local = &fallback;
+        return &fallback.stats;
+    }
+    b->next = __atomic_load_n(&secp256k1_stats_list, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&secp256k1_stats_list, &b->next, b, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    secp256k1_stats_local = b;
+    return &b->stats;
+}
+
+static SECP256K1_INLINE secp256k1_stats *secp256k1_stats_thread(void) {
+    secp256k1_stats_block *b = secp256k1_stats_local;
+    if (EXPECT(b == NULL, 0)) {
+        return secp256k1_stats_register();
+    }
+    return &b->stats;
+}
+
+/* Only the owning thread writes a counter; the relaxed atomic load and store
+ * compile to an ordinary increment but make concurrent reads well defined. */
+#define SECP256K1_STATS_ADD(name, n) do { \
+    uint64_t *secp256k1_stats_c = &secp256k1_stats_thread()->name; \
+    __atomic_store_n(secp256k1_stats_c, __atomic_load_n(secp256k1_stats_c, __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED); \
+} while(0)
+
+/** Sum the counters of all threads into r. */
+static void secp256k1_stats_sum(secp256k1_stats *r) {
+    const secp256k1_stats_block *b = __atomic_load_n(&secp256k1_stats_list, __ATOMIC_ACQUIRE);
+    memset(r, 0, sizeof(*r));
+    for (; b != NULL; b = b->next) {
+        r->field_mul += __atomic_load_n(&b->stats.field_mul, __ATOMIC_RELAXED);
+        r->field_sqr += __atomic_load_n(&b->stats.field_sqr, __ATOMIC_RELAXED);
+        r->field_inv += __atomic_load_n(&b->stats.field_inv, __ATOMIC_RELAXED);
+        r->field_sqrt += __atomic_load_n(&b->stats.field_sqrt, __ATOMIC_RELAXED);
+        r->scalar_inv += __atomic_load_n(&b->stats.scalar_inv, __ATOMIC_RELAXED);
+        r->ecmult += __atomic_load_n(&b->stats.ecmult, __ATOMIC_RELAXED);
+        r->ecmult_const += __atomic_load_n(&b->stats.ecmult_const, __ATOMIC_RELAXED);
+        r->ecmult_gen += __atomic_load_n(&b->stats.ecmult_gen, __ATOMIC_RELAXED);
+        r->alloc += __atomic_load_n(&b->stats.alloc, __ATOMIC_RELAXED);
+    }
+}
+
+#else
+
+#define SECP256K1_STATS_ADD(name, n) do { } while(0)
+
+#endif
+
+#define SECP256K1_STATS_INC(name) SECP256K1_STATS_ADD(name, 1)
+
+#endif
@@ -211,8 +211,8 @@ void run_context_tests(void) {
     secp256k1_context_set_illegal_callback(sign, NULL, NULL);
 
     /* This shouldn't leak memory, due to already-set tests. */
-    secp256k1_ecmult_gen_context_build(&sign->ecmult_gen_ctx, NULL);
-    secp256k1_ecmult_context_build(&vrfy->ecmult_ctx, NULL);
+    secp256k1_ecmult_gen_context_build(&sign->ecmult_gen_ctx, 0, NULL);
+    secp256k1_ecmult_context_build(&vrfy->ecmult_ctx, 0, NULL);
 
     /* obtain a working nonce */
     do {
@@ -236,6 +236,114 @@ void run_context_tests(void) {
     secp256k1_context_destroy(NULL);
 }
 
+void run_context_hugepages_tests(void) {
+    secp256k1_context *huge = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_HUGEPAGES);
+    secp256k1_context *copy = secp256k1_context_clone(huge);
+    secp256k1_context *hugevrfy = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_HUGEPAGES);
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey pubkey;
+    unsigned char key[32];
+    unsigned char msg[32];
+
+    /* The tables are cache line aligned and identical to those of a regular context. */
+    CHECK(((uintptr_t)huge->ecmult_ctx.pre_g & (SECP256K1_TABLE_ALIGN - 1)) == 0);
+    CHECK(((uintptr_t)copy->ecmult_ctx.pre_g & (SECP256K1_TABLE_ALIGN - 1)) == 0);
+    CHECK(huge->ecmult_ctx.hugepages && copy->ecmult_ctx.hugepages);
+    CHECK(memcmp(huge->ecmult_ctx.pre_g, ctx->ecmult_ctx.pre_g, sizeof((*ctx->ecmult_ctx.pre_g)[0]) * ECMULT_G_TABLES_SIZE) == 0);
+    CHECK(memcmp(copy->ecmult_ctx.pre_g, ctx->ecmult_ctx.pre_g, sizeof((*ctx->ecmult_ctx.pre_g)[0]) * ECMULT_G_TABLES_SIZE) == 0);
+#ifndef USE_ECMULT_STATIC_PRECOMPUTATION
+    CHECK(((uintptr_t)huge->ecmult_gen_ctx.prec & (SECP256K1_TABLE_ALIGN - 1)) == 0);
+    CHECK(((uintptr_t)copy->ecmult_gen_ctx.prec & (SECP256K1_TABLE_ALIGN - 1)) == 0);
+#endif
+    CHECK(memcmp(huge->ecmult_gen_ctx.prec, ctx->ecmult_gen_ctx.prec, sizeof(*ctx->ecmult_gen_ctx.prec)) == 0);
+    CHECK(memcmp(copy->ecmult_gen_ctx.prec, ctx->ecmult_gen_ctx.prec, sizeof(*ctx->ecmult_gen_ctx.prec)) == 0);
+    CHECK(!secp256k1_ecmult_gen_context_is_built(&hugevrfy->ecmult_gen_ctx));
+
+    /* And they work. */
+    secp256k1_rand256_test(msg);
+    memset(key, 0, sizeof(key));
+    key[31] = 1;
+    CHECK(secp256k1_ec_pubkey_create(huge, &pubkey, key) == 1);
+    CHECK(secp256k1_ecdsa_sign(copy, &sig, msg, key, NULL, NULL) == 1);
+    CHECK(secp256k1_ecdsa_verify(huge, &sig, msg, &pubkey) == 1);
+    CHECK(secp256k1_ecdsa_verify(copy, &sig, msg, &pubkey) == 1);
+    CHECK(secp256k1_ecdsa_verify(hugevrfy, &sig, msg, &pubkey) == 1);
+
+    secp256k1_context_destroy(huge);
+    secp256k1_context_destroy(copy);
+    secp256k1_context_destroy(hugevrfy);
+}
+
+void run_context_lazy_tests(void) {
+    secp256k1_context *lazy = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_LAZY);
+    secp256k1_context *lazyvrfy = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_LAZY);
+    secp256k1_context *copy, *half;
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey pubkey;
+    unsigned char key[32];
+    unsigned char msg[32];
+    int ecount = 0;
+
+#ifdef HAVE_ATOMIC_BUILTINS
+    /* Nothing is built until it is needed. */
+    CHECK(!secp256k1_ecmult_gen_context_is_built(&lazy->ecmult_gen_ctx));
+    CHECK(!secp256k1_ecmult_context_is_built(&lazy->ecmult_ctx));
+#endif
+    copy = secp256k1_context_clone(lazy);
+
+    /* Signing builds the signing table only. */
+    secp256k1_rand256_test(msg);
+    memset(key, 0, sizeof(key));
+    key[31] = 1;
+    CHECK(secp256k1_ec_pubkey_create(lazy, &pubkey, key) == 1);
+    CHECK(secp256k1_ecmult_gen_context_is_built(&lazy->ecmult_gen_ctx));
+#ifdef HAVE_ATOMIC_BUILTINS
+    CHECK(!secp256k1_ecmult_context_is_built(&lazy->ecmult_ctx));
+#endif
+    CHECK(lazy->lock == 0);
+
+    /* A clone takes the tables built so far, and leaves the rest for later. */
+    half = secp256k1_context_clone(lazy);
+    CHECK(secp256k1_ecmult_gen_context_is_built(&half->ecmult_gen_ctx));
+    CHECK(memcmp(half->ecmult_gen_ctx.prec, ctx->ecmult_gen_ctx.prec, sizeof(*ctx->ecmult_gen_ctx.prec)) == 0);
+#ifdef HAVE_ATOMIC_BUILTINS
+    CHECK(!secp256k1_ecmult_context_is_built(&half->ecmult_ctx));
+#endif
+    CHECK(secp256k1_ec_pubkey_create(half, &pubkey, key) == 1);
+    secp256k1_context_destroy(half);
+
+    CHECK(secp256k1_ecdsa_sign(lazy, &sig, msg, key, NULL, NULL) == 1);
+    CHECK(secp256k1_ecdsa_verify(lazy, &sig, msg, &pubkey) == 1);
+    CHECK(memcmp(lazy->ecmult_ctx.pre_g, ctx->ecmult_ctx.pre_g, sizeof((*ctx->ecmult_ctx.pre_g)[0]) * ECMULT_G_TABLES_SIZE) == 0);
+    CHECK(memcmp(lazy->ecmult_gen_ctx.prec, ctx->ecmult_gen_ctx.prec, sizeof(*ctx->ecmult_gen_ctx.prec)) == 0);
+
+    /* The clone was made before, and builds its own tables. */
+#ifdef HAVE_ATOMIC_BUILTINS
+    CHECK(!secp256k1_ecmult_gen_context_is_built(&copy->ecmult_gen_ctx));
+    CHECK(!secp256k1_ecmult_context_is_built(&copy->ecmult_ctx));
+#endif
+    secp256k1_context_warmup(copy);
+    CHECK(memcmp(copy->ecmult_ctx.pre_g, ctx->ecmult_ctx.pre_g, sizeof((*ctx->ecmult_ctx.pre_g)[0]) * ECMULT_G_TABLES_SIZE) == 0);
+    CHECK(memcmp(copy->ecmult_gen_ctx.prec, ctx->ecmult_gen_ctx.prec, sizeof(*ctx->ecmult_gen_ctx.prec)) == 0);
+    CHECK(secp256k1_ecdsa_verify(copy, &sig, msg, &pubkey) == 1);
+    secp256k1_context_warmup(copy);
+    secp256k1_context_warmup(ctx);
+    CHECK(copy->lock == 0);
+
+    /* A context left to verify still cannot sign. */
+    secp256k1_context_set_illegal_callback(lazyvrfy, counting_illegal_callback_fn, &ecount);
+    CHECK(secp256k1_ecdsa_sign(lazyvrfy, &sig, msg, key, NULL, NULL) == 0);
+    CHECK(ecount == 1);
+    CHECK(!secp256k1_ecmult_gen_context_is_built(&lazyvrfy->ecmult_gen_ctx));
+    CHECK(secp256k1_ecdsa_sign(ctx, &sig, msg, key, NULL, NULL) == 1);
+    CHECK(secp256k1_ecdsa_verify(lazyvrfy, &sig, msg, &pubkey) == 1);
+    CHECK(ecount == 1);
+
+    secp256k1_context_destroy(lazy);
+    secp256k1_context_destroy(lazyvrfy);
+    secp256k1_context_destroy(copy);
+}
+
 /***** HASH TESTS *****/
 
 void run_sha256_tests(void) {
@@ -1536,6 +1644,29 @@ void run_scalar_tests(void) {
     }
 }
 
+void run_scalar_inverse_all(void) {
+    secp256k1_scalar x[16], xi[16], xii[16], t;
+    int i;
+    /* Check it's safe to call for 0 elements */
+    secp256k1_scalar_inverse_all(xi, x, 0);
+    for (i = 0; i < count; i++) {
+        size_t j;
+        size_t len = secp256k1_rand_int(15) + 1;
+        for (j = 0; j < len; j++) {
+            random_scalar_order_test(&x[j]);
+        }
+        secp256k1_scalar_inverse_all(xi, x, len);
+        for (j = 0; j < len; j++) {
+            secp256k1_scalar_inverse(&t, &x[j]);
+            CHECK(secp256k1_scalar_eq(&t, &xi[j]));
+        }
+        secp256k1_scalar_inverse_all(xii, xi, len);
+        for (j = 0; j < len; j++) {
+            CHECK(secp256k1_scalar_eq(&x[j], &xii[j]));
+        }
+    }
+}
+
 /***** FIELD TESTS *****/
 
 void random_fe(secp256k1_fe *x) {
@@ -1751,6 +1882,28 @@ void run_field_inv_all_var(void) {
     }
 }
 
+void run_field_inv_all(void) {
+    secp256k1_fe x[16], xi[16], xii[16];
+    int i;
+    /* Check it's safe to call for 0 elements */
+    secp256k1_fe_inv_all(xi, x, 0);
+    for (i = 0; i < count; i++) {
+        size_t j;
+        size_t len = secp256k1_rand_int(15) + 1;
+        for (j = 0; j < len; j++) {
+            random_fe_non_zero(&x[j]);
+        }
+        secp256k1_fe_inv_all(xi, x, len);
+        for (j = 0; j < len; j++) {
+            CHECK(check_fe_inverse(&x[j], &xi[j]));
+        }
+        secp256k1_fe_inv_all(xii, xi, len);
+        for (j = 0; j < len; j++) {
+            CHECK(check_fe_equal(&x[j], &xii[j]));
+        }
+    }
+}
+
 void run_sqr(void) {
     secp256k1_fe x, s;
 
@@ -1966,6 +2119,27 @@ void test_ge(void) {
                 CHECK(secp256k1_fe_equal_var(&zrz, &resj.z));
             }
 
+            /* Test 2*gej + ge (var), plain and with additional Z factor. */
+            {
+                secp256k1_gej dbl, drefj;
+                secp256k1_ge dref;
+                secp256k1_ge ge2_zfi = ge[i2];
+                secp256k1_gej_double_var(&dbl, &gej[i1], NULL);
+                secp256k1_gej_add_ge_var(&drefj, &dbl, &ge[i2], NULL);
+                secp256k1_ge_set_gej_var(&dref, &drefj);
+                secp256k1_gej_double_add_ge_var(&resj, &gej[i1], &ge[i2]);
+                ge_equals_gej(&dref, &resj);
+                secp256k1_fe_mul(&ge2_zfi.x, &ge2_zfi.x, &zfi2);
+                secp256k1_fe_mul(&ge2_zfi.y, &ge2_zfi.y, &zfi3);
+                random_field_element_magnitude(&ge2_zfi.x);
+                random_field_element_magnitude(&ge2_zfi.y);
+                secp256k1_gej_double_add_zinv_var(&resj, &gej[i1], &ge2_zfi, &zf);
+                ge_equals_gej(&dref, &resj);
+                resj = gej[i1];
+                secp256k1_gej_double_add_ge_var(&resj, &resj, &ge[i2]);
+                ge_equals_gej(&dref, &resj);
+            }
+
             /* Test gej + ge (var, with additional Z factor). */
             {
                 secp256k1_ge ge2_zfi = ge[i2]; /* the second term with x and y rescaled for z = 1/zf */
@@ -2136,10 +2310,104 @@ void test_add_neg_y_diff_x(void) {
     ge_equals_gej(&res, &sumj);
 }
 
+void test_ge_double_add_edge(void) {
+    /* 2*a + b where b is 2*a or -2*a, which the addition step must catch. */
+    secp256k1_ge a, b, ref;
+    secp256k1_gej aj, dj, resj;
+    random_group_element_test(&a);
+    random_group_element_jacobian_test(&aj, &a);
+    secp256k1_gej_double_var(&dj, &aj, NULL);
+    secp256k1_ge_set_gej_var(&b, &dj);
+
+    secp256k1_gej_double_var(&dj, &dj, NULL);
+    secp256k1_ge_set_gej_var(&ref, &dj);
+    secp256k1_gej_double_add_ge_var(&resj, &aj, &b);
+    ge_equals_gej(&ref, &resj);
+
+    secp256k1_ge_neg(&b, &b);
+    secp256k1_gej_double_add_ge_var(&resj, &aj, &b);
+    CHECK(secp256k1_gej_is_infinity(&resj));
+}
+
+void test_ge_storage_table_get(void) {
+    secp256k1_ge_storage table[16];
+    secp256k1_ge_storage r;
+    secp256k1_ge ge;
+    int n = 1 + secp256k1_rand_int(16);
+    int i;
+
+    for (i = 0; i < n; i++) {
+        random_group_element_test(&ge);
+        secp256k1_ge_to_storage(&table[i], &ge);
+    }
+    /* Every implementation that is compiled in picks the same entry. */
+    for (i = 0; i < n; i++) {
+        memset(&r, 0, sizeof(r));
+        secp256k1_ge_storage_table_get(&r, table, n, i);
+        CHECK(memcmp(&r, &table[i], sizeof(r)) == 0);
+        memset(&r, 0, sizeof(r));
+        secp256k1_ge_storage_table_get_portable(&r, table, n, i);
+        CHECK(memcmp(&r, &table[i], sizeof(r)) == 0);
+#if defined(__SSE2__)
+        memset(&r, 0, sizeof(r));
+        secp256k1_ge_storage_table_get_sse2(&r, table, n, i);
+        CHECK(memcmp(&r, &table[i], sizeof(r)) == 0);
+#endif
+#if defined(HAVE_AVX2_DISPATCH)
+        if (__builtin_cpu_supports("avx2")) {
+            memset(&r, 0, sizeof(r));
+            secp256k1_ge_storage_table_get_avx2(&r, table, n, i);
+            CHECK(memcmp(&r, &table[i], sizeof(r)) == 0);
+        }
+#endif
+    }
+}
+
+void test_ge_sum_var(void) {
+    secp256k1_ge a[256], b[256], r;
+    secp256k1_fe scratch[256];
+    secp256k1_gej sum;
+    int n = 1 + secp256k1_rand_int(256);
+    int i;
+    secp256k1_gej_set_infinity(&sum);
+    for (i = 0; i < n; i++) {
+        /* Some points repeat or cancel the one before, so that pairs need
+         * doubling or drop out. */
+        int choice = secp256k1_rand_int(4);
+        if (i > 0 && choice == 0) {
+            a[i] = a[i - 1];
+        } else if (i > 0 && choice == 1) {
+            secp256k1_ge_neg(&a[i], &a[i - 1]);
+        } else {
+            random_group_element_test(&a[i]);
+        }
+        secp256k1_gej_add_ge_var(&sum, &sum, &a[i], NULL);
+    }
+    memcpy(b, a, sizeof(a));
+    if (secp256k1_ge_sum_var(&r, b, scratch, n)) {
+        CHECK(!secp256k1_gej_is_infinity(&sum));
+        ge_equals_gej(&r, &sum);
+    } else {
+        CHECK(secp256k1_gej_is_infinity(&sum));
+    }
+
+    /* Points followed by their negations cancel out in the first round. */
+    for (i = 0; i < 128; i++) {
+        random_group_element_test(&a[2 * i]);
+        secp256k1_ge_neg(&a[2 * i + 1], &a[2 * i]);
+    }
+    CHECK(secp256k1_ge_sum_var(&r, a, scratch, 256) == 0);
+}
+
 void run_ge(void) {
     int i;
     for (i = 0; i < count * 32; i++) {
         test_ge();
+        test_ge_double_add_edge();
+    }
+    for (i = 0; i < count; i++) {
+        test_ge_storage_table_get();
+        test_ge_sum_var();
     }
     test_add_neg_y_diff_x();
 }
@@ -2169,11 +2437,63 @@ void test_ec_combine(void) {
     }
 }
 
+void test_ec_combine_many(void) {
+    secp256k1_pubkey data[260];
+    const secp256k1_pubkey* d[260];
+    secp256k1_pubkey sd;
+    secp256k1_pubkey sd2;
+    secp256k1_scalar s;
+    secp256k1_gej Qj;
+    secp256k1_gej sumj;
+    secp256k1_ge Q;
+    int n = 128 + secp256k1_rand_int(133);
+    int i;
+    secp256k1_gej_set_infinity(&sumj);
+    for (i = 0; i < n; i++) {
+        /* Some keys repeat or cancel one of the few before them. */
+        int choice = secp256k1_rand_int(8);
+        if (i > 3 && choice == 0) {
+            data[i] = data[i - 1 - secp256k1_rand_int(4)];
+        } else if (i > 3 && choice == 1) {
+            secp256k1_pubkey_load(ctx, &Q, &data[i - 1 - secp256k1_rand_int(4)]);
+            secp256k1_ge_neg(&Q, &Q);
+            secp256k1_pubkey_save(&data[i], &Q);
+        } else {
+            random_scalar_order_test(&s);
+            secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &Qj, &s);
+            secp256k1_ge_set_gej(&Q, &Qj);
+            secp256k1_pubkey_save(&data[i], &Q);
+        }
+        d[i] = &data[i];
+        secp256k1_pubkey_load(ctx, &Q, &data[i]);
+        secp256k1_gej_add_ge(&sumj, &sumj, &Q);
+    }
+    if (secp256k1_gej_is_infinity(&sumj)) {
+        CHECK(secp256k1_ec_pubkey_combine(ctx, &sd2, d, n) == 0);
+    } else {
+        secp256k1_ge_set_gej(&Q, &sumj);
+        secp256k1_pubkey_save(&sd, &Q);
+        CHECK(secp256k1_ec_pubkey_combine(ctx, &sd2, d, n) == 1);
+        CHECK(memcmp(&sd, &sd2, sizeof(sd)) == 0);
+    }
+
+    /* Keys that all cancel out. */
+    for (i = 0; i < 128; i += 2) {
+        secp256k1_pubkey_load(ctx, &Q, &data[i]);
+        secp256k1_ge_neg(&Q, &Q);
+        secp256k1_pubkey_save(&data[i + 1], &Q);
+    }
+    CHECK(secp256k1_ec_pubkey_combine(ctx, &sd2, d, 128) == 0);
+}
+
 void run_ec_combine(void) {
     int i;
     for (i = 0; i < count * 8; i++) {
          test_ec_combine();
     }
+    for (i = 0; i < count; i++) {
+         test_ec_combine_many();
+    }
 }
 
 void test_group_decompress(const secp256k1_fe* x) {
@@ -2350,6 +2670,175 @@ void test_point_times_order(const secp256k1_gej *point) {
     ge_equals_ge(&res3, &secp256k1_ge_const_g);
 }
 
+void test_ecmult_odd_multiples(int n) {
+    secp256k1_ge a;
+    secp256k1_gej aj, mul, d, ref;
+    secp256k1_gej prej[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_fe zr[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_ge pre[ECMULT_TABLE_SIZE(WINDOW_A)];
+    secp256k1_fe globalz;
+    int i;
+
+    random_group_element_test(&a);
+    random_group_element_jacobian_test(&aj, &a);
+    secp256k1_gej_double_var(&d, &aj, NULL);
+
+    /* Against repeated additions, converted to affine via the z ratios. */
+    secp256k1_ecmult_odd_multiples_table(n, prej, zr, &aj);
+    secp256k1_ge_set_table_gej_var(pre, prej, zr, n);
+    mul = aj;
+    for (i = 0; i < n; i++) {
+        ge_equals_gej(&pre[i], &mul);
+        secp256k1_gej_add_var(&mul, &mul, &d, NULL);
+    }
+
+    /* And on a global Z. */
+    secp256k1_ecmult_odd_multiples_table(n, prej, zr, &aj);
+    secp256k1_ge_globalz_set_table_gej(n, pre, &globalz, prej, zr);
+    mul = aj;
+    for (i = 0; i < n; i++) {
+        ref.x = pre[i].x;
+        ref.y = pre[i].y;
+        ref.z = globalz;
+        ref.infinity = 0;
+        CHECK(secp256k1_gej_is_valid_var(&ref));
+        secp256k1_gej_neg(&ref, &ref);
+        secp256k1_gej_add_var(&ref, &ref, &mul, NULL);
+        CHECK(secp256k1_gej_is_infinity(&ref));
+        secp256k1_gej_add_var(&mul, &mul, &d, NULL);
+    }
+}
+
+void run_ecmult_odd_multiples(void) {
+    int i;
+    for (i = 0; i < count; i++) {
+        test_ecmult_odd_multiples(1);
+        test_ecmult_odd_multiples(2);
+        test_ecmult_odd_multiples(ECMULT_TABLE_SIZE(WINDOW_A));
+    }
+}
+
+void test_ecmult_x2(void) {
+    secp256k1_ge ge[2];
+    secp256k1_gej a[2], r[2], d[2], ref;
+    secp256k1_scalar na[2], ng[2];
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        random_group_element_test(&ge[i]);
+        random_group_element_jacobian_test(&a[i], &ge[i]);
+        random_scalar_order_test(&na[i]);
+        random_scalar_order_test(&ng[i]);
+    }
+
+    /* Paired doubling, in place and not. */
+    secp256k1_gej_double_x2_var(&d[0], &a[0], &d[1], &a[1]);
+    for (i = 0; i < 2; i++) {
+        secp256k1_gej_double_var(&ref, &a[i], NULL);
+        secp256k1_gej_neg(&ref, &ref);
+        secp256k1_gej_add_var(&ref, &ref, &d[i], NULL);
+        CHECK(secp256k1_gej_is_infinity(&ref));
+    }
+    d[0] = a[0];
+    secp256k1_gej_set_infinity(&d[1]);
+    secp256k1_gej_double_x2_var(&d[0], &d[0], &d[1], &d[1]);
+    CHECK(secp256k1_gej_is_infinity(&d[1]));
+    secp256k1_gej_double_var(&ref, &a[0], NULL);
+    secp256k1_gej_neg(&ref, &ref);
+    secp256k1_gej_add_var(&ref, &ref, &d[0], NULL);
+    CHECK(secp256k1_gej_is_infinity(&ref));
+
+    /* Random multiplies, and with one side much shorter or zero. */
+    for (i = 0; i < 4; i++) {
+        int j;
+        if (i == 1) {
+            secp256k1_scalar_set_int(&na[1], 3);
+        } else if (i == 2) {
+            secp256k1_scalar_set_int(&ng[0], 0);
+            secp256k1_scalar_set_int(&na[0], 0);
+        } else if (i == 3) {
+            secp256k1_scalar_set_int(&ng[1], 1);
+        }
+        secp256k1_ecmult_x2(&ctx->ecmult_ctx, &r[0], &a[0], &na[0], &ng[0], &r[1], &a[1], &na[1], &ng[1]);
+        for (j = 0; j < 2; j++) {
+            secp256k1_ecmult(&ctx->ecmult_ctx, &ref, &a[j], &na[j], &ng[j]);
+            secp256k1_gej_neg(&ref, &ref);
+            secp256k1_gej_add_var(&ref, &ref, &r[j], NULL);
+            CHECK(secp256k1_gej_is_infinity(&ref));
+        }
+    }
+    CHECK(secp256k1_gej_is_infinity(&r[0]));
+}
+
+void run_ecmult_x2(void) {
+    int i;
+    for (i = 0; i < 2*count; i++) {
+        test_ecmult_x2();
+    }
+}
+
+void test_ecmult_multi(size_t n) {
+    secp256k1_ge a[8];
+    secp256k1_scalar na[8], ng, zero;
+    secp256k1_gej r, ref, tmp;
+    unsigned char b32[32];
+    size_t i;
+
+    CHECK(n <= 8);
+    secp256k1_scalar_set_int(&zero, 0);
+    random_scalar_order_test(&ng);
+    secp256k1_gej_set_ge(&tmp, &secp256k1_ge_const_g);
+    secp256k1_ecmult(&ctx->ecmult_ctx, &ref, &tmp, &zero, &ng);
+    for (i = 0; i < n; i++) {
+        random_group_element_test(&a[i]);
+        random_scalar_order_test(&na[i]);
+        switch (secp256k1_rand_int(8)) {
+        case 0:
+            secp256k1_scalar_set_int(&na[i], 0);
+            break;
+        case 1:
+            a[i].infinity = 1;
+            break;
+        case 2:
+            /* A scalar below 2^128. */
+            secp256k1_rand256(b32);
+            memset(b32, 0, 16);
+            secp256k1_scalar_set_b32(&na[i], b32, NULL);
+            break;
+        case 3:
+            /* Cancel an earlier term. */
+            if (i > 0) {
+                a[i] = a[i - 1];
+                secp256k1_scalar_negate(&na[i], &na[i - 1]);
+            }
+            break;
+        }
+        if (!a[i].infinity) {
+            secp256k1_gej_set_ge(&tmp, &a[i]);
+            secp256k1_ecmult(&ctx->ecmult_ctx, &tmp, &tmp, &na[i], &zero);
+            secp256k1_gej_add_var(&ref, &ref, &tmp, NULL);
+        }
+    }
+    secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, &r, a, na, n, &ng, &ctx->error_callback);
+    secp256k1_gej_neg(&ref, &ref);
+    secp256k1_gej_add_var(&ref, &ref, &r, NULL);
+    CHECK(secp256k1_gej_is_infinity(&ref));
+
+    /* A sum that is infinity: x*G + (-x)*G. */
+    a[0] = secp256k1_ge_const_g;
+    random_scalar_order_test(&na[0]);
+    secp256k1_scalar_negate(&ng, &na[0]);
+    secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, &r, a, na, 1, &ng, &ctx->error_callback);
+    CHECK(secp256k1_gej_is_infinity(&r));
+}
+
+void run_ecmult_multi(void) {
+    int i;
+    for (i = 0; i < 2*count; i++) {
+        test_ecmult_multi(secp256k1_rand_int(9));
+    }
+}
+
 void run_point_times_order(void) {
     int i;
     secp256k1_fe x = SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 2);
@@ -2468,11 +2957,122 @@ void ecmult_const_chain_multiply(void) {
     ge_equals_gej(&res, &expected_point);
 }
 
+void ecmult_const_xonly(void) {
+    int i;
+    for (i = 0; i < 2 * count; i++) {
+        secp256k1_ge a, b;
+        secp256k1_gej bj;
+        secp256k1_scalar q;
+        secp256k1_fe x, g, c;
+
+        /* x(q*A) from x(A) alone matches ecmult_const, checked or not. */
+        random_group_element_test(&a);
+        random_scalar_order_test(&q);
+        secp256k1_ecmult_const(&bj, &a, &q);
+        secp256k1_ge_set_gej(&b, &bj);
+        secp256k1_fe_normalize(&b.x);
+        CHECK(secp256k1_ecmult_const_xonly(&x, &a.x, &q, i & 1) == 1);
+        CHECK(secp256k1_fe_equal_var(&x, &b.x));
+
+        /* An X that is not on the curve is refused. */
+        do {
+            random_field_element_test(&x);
+            secp256k1_fe_sqr(&g, &x);
+            secp256k1_fe_mul(&g, &g, &x);
+            secp256k1_fe_set_int(&c, CURVE_B);
+            secp256k1_fe_add(&g, &c);
+        } while (secp256k1_fe_is_quad_var(&g));
+        CHECK(secp256k1_ecmult_const_xonly(&x, &x, &q, 0) == 0);
+    }
+}
+
+void ecmult_const_precomp(void) {
+    secp256k1_ge_storage *prec = (secp256k1_ge_storage*)checked_malloc(&ctx->error_callback, sizeof(secp256k1_ge_storage) * 1024);
+    secp256k1_scalar q;
+    secp256k1_gej rj;
+    secp256k1_ge a, r, expected;
+    int i;
+
+    /* Matches ecmult_const, including the scalars 0, 1 and -1. */
+    random_group_element_test(&a);
+    CHECK(secp256k1_ecmult_const_precomp_build(prec, &a, &ctx->error_callback) == 1);
+    for (i = 0; i < 4 * count + 3; i++) {
+        if (i == 0) {
+            secp256k1_scalar_set_int(&q, 0);
+        } else if (i <= 2) {
+            secp256k1_scalar_set_int(&q, 1);
+            if (i == 2) {
+                secp256k1_scalar_negate(&q, &q);
+            }
+        } else {
+            random_scalar_order_test(&q);
+        }
+        secp256k1_ecmult_const(&rj, &a, &q);
+        secp256k1_ge_set_gej(&expected, &rj);
+        secp256k1_ecmult_const_precomp(&rj, prec, &q);
+        secp256k1_ge_set_gej(&r, &rj);
+        CHECK(r.infinity == expected.infinity);
+        if (!r.infinity) {
+            ge_equals_ge(&r, &expected);
+        }
+    }
+    free(prec);
+}
+
 void run_ecmult_const_tests(void) {
     ecmult_const_mult_zero_one();
     ecmult_const_random_mult();
     ecmult_const_commutativity();
     ecmult_const_chain_multiply();
+    ecmult_const_xonly();
+    ecmult_const_precomp();
+}
+
+void run_point_precomp_tests(void) {
+    secp256k1_point_precomp *precomp;
+    secp256k1_pubkey pubkey, expected, result;
+    unsigned char seckey[32], scalar[32];
+    secp256k1_scalar s;
+    int32_t ecount = 0;
+    int i;
+
+    random_scalar_order_test(&s);
+    secp256k1_scalar_get_b32(seckey, &s);
+    CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey, seckey) == 1);
+    precomp = secp256k1_point_precomp_create(ctx, &pubkey);
+    CHECK(precomp != NULL);
+
+    /* The same keys as secp256k1_ec_pubkey_tweak_mul. */
+    for (i = 0; i < count; i++) {
+        random_scalar_order_test(&s);
+        secp256k1_scalar_get_b32(scalar, &s);
+        expected = pubkey;
+        CHECK(secp256k1_ec_pubkey_tweak_mul(ctx, &expected, scalar) == 1);
+        CHECK(secp256k1_point_precomp_mul(ctx, &result, precomp, scalar) == 1);
+        CHECK(memcmp(&expected, &result, sizeof(result)) == 0);
+    }
+
+    /* Zero and overflowing scalars are refused and zero the result. */
+    memset(scalar, 0, sizeof(scalar));
+    CHECK(secp256k1_point_precomp_mul(ctx, &result, precomp, scalar) == 0);
+    memset(&expected, 0, sizeof(expected));
+    CHECK(memcmp(&expected, &result, sizeof(result)) == 0);
+    memset(scalar, 0xFF, sizeof(scalar));
+    CHECK(secp256k1_point_precomp_mul(ctx, &result, precomp, scalar) == 0);
+
+    secp256k1_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    CHECK(secp256k1_point_precomp_create(ctx, NULL) == NULL);
+    CHECK(ecount == 1);
+    CHECK(secp256k1_point_precomp_mul(ctx, NULL, precomp, scalar) == 0);
+    CHECK(ecount == 2);
+    CHECK(secp256k1_point_precomp_mul(ctx, &result, NULL, scalar) == 0);
+    CHECK(ecount == 3);
+    CHECK(secp256k1_point_precomp_mul(ctx, &result, precomp, NULL) == 0);
+    CHECK(ecount == 4);
+    secp256k1_context_set_illegal_callback(ctx, NULL, NULL);
+
+    secp256k1_point_precomp_destroy(precomp);
+    secp256k1_point_precomp_destroy(NULL);
 }
 
 void test_wnaf(const secp256k1_scalar *number, int w) {
@@ -2509,6 +3109,28 @@ void test_wnaf(const secp256k1_scalar *number, int w) {
     CHECK(secp256k1_scalar_eq(&x, number)); /* check that wnaf represents number */
 }
 
+void test_wnaf_compact(const secp256k1_scalar *number, int len, int w) {
+    int wnaf[256];
+    secp256k1_wnaf_entry compact[256];
+    int i, j;
+    int bits, n;
+    bits = secp256k1_ecmult_wnaf(wnaf, len, number, w);
+    n = secp256k1_ecmult_wnaf_compact(compact, len, number, w);
+    CHECK(n <= ECMULT_WNAF_COMPACT_SIZE(len, w));
+    /* The compact form lists exactly the non-zero digits of the dense one, in order. */
+    j = 0;
+    for (i = 0; i < bits; i++) {
+        if (wnaf[i] != 0) {
+            CHECK(j < n);
+            CHECK(compact[j].pos == i);
+            CHECK(compact[j].digit == wnaf[i]);
+            j++;
+        }
+    }
+    CHECK(j == n);
+    CHECK(n == 0 || compact[n - 1].pos == bits - 1);
+}
+
 void test_constant_wnaf_negate(const secp256k1_scalar *number) {
     secp256k1_scalar neg1 = *number;
     secp256k1_scalar neg2 = *number;
@@ -2563,6 +3185,22 @@ void test_constant_wnaf(const secp256k1_scalar *number, int w) {
     CHECK(secp256k1_scalar_eq(&x, &num));
 }
 
+void run_ctz(void) {
+    int i, j;
+    for (i = 0; i < 32; i++) {
+        CHECK(secp256k1_ctz32_var((uint32_t)1 << i) == i);
+        CHECK(secp256k1_ctz32_var(~(uint32_t)0 << i) == i);
+    }
+    for (i = 0; i < count * 16; i++) {
+        uint32_t x = secp256k1_rand32() | 0x80000000UL;
+        j = 0;
+        while (((x >> j) & 1) == 0) {
+            j++;
+        }
+        CHECK(secp256k1_ctz32_var(x) == j);
+    }
+}
+
 void run_wnaf(void) {
     int i;
     secp256k1_scalar n = {{0}};
@@ -2577,9 +3215,31 @@ void run_wnaf(void) {
     for (i = 0; i < count; i++) {
         random_scalar_order(&n);
         test_wnaf(&n, 4+(i%10));
+        test_wnaf_compact(&n, 256, 2 + (i % 15));
+#ifdef USE_ENDOMORPHISM
+        {
+            secp256k1_scalar n1, n2;
+            secp256k1_scalar_split_lambda(&n1, &n2, &n);
+            test_wnaf_compact(&n1, 130, WINDOW_A);
+            test_wnaf_compact(&n2, 130, WINDOW_A);
+            secp256k1_scalar_split_128(&n1, &n2, &n);
+            test_wnaf_compact(&n1, 129, WINDOW_G);
+            test_wnaf_compact(&n2, 129, WINDOW_G);
+        }
+#endif
         test_constant_wnaf_negate(&n);
         test_constant_wnaf(&n, 4 + (i % 10));
     }
+    /* Runs of ones and zeroes longer than what the recoder skips at once. */
+    secp256k1_scalar_set_int(&n, 0);
+    test_wnaf_compact(&n, 256, 5);
+    secp256k1_scalar_set_int(&n, 1);
+    secp256k1_scalar_negate(&n, &n);
+    test_wnaf_compact(&n, 256, 5);
+    secp256k1_scalar_set_int(&n, 0x80000001UL);
+    test_wnaf_compact(&n, 256, 16);
+    secp256k1_scalar_set_int(&n, 0x7FFFFFFFUL);
+    test_wnaf_compact(&n, 256, 3);
     secp256k1_scalar_set_int(&n, 0);
     CHECK(secp256k1_scalar_cond_negate(&n, 1) == -1);
     CHECK(secp256k1_scalar_is_zero(&n));
@@ -3614,6 +4274,185 @@ void run_random_pubkeys(void) {
     }
 }
 
+void test_ecdsa_verify_x2(void) {
+    unsigned char privkey[2][32];
+    unsigned char message[2][32];
+    secp256k1_ecdsa_signature signature[2];
+    secp256k1_ecdsa_signature high;
+    secp256k1_pubkey pubkey[2];
+    secp256k1_pubkey bad;
+    secp256k1_scalar key, msg, r, s;
+    int results[2];
+    int ecount = 0;
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        random_scalar_order_test(&msg);
+        random_scalar_order_test(&key);
+        secp256k1_scalar_get_b32(privkey[i], &key);
+        secp256k1_scalar_get_b32(message[i], &msg);
+        CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey[i], privkey[i]) == 1);
+        CHECK(secp256k1_ecdsa_sign(ctx, &signature[i], message[i], privkey[i], NULL, NULL) == 1);
+    }
+
+    CHECK(secp256k1_ecdsa_verify_x2(ctx, NULL, &signature[0], message[0], &pubkey[0], &signature[1], message[1], &pubkey[1]) == 1);
+    CHECK(secp256k1_ecdsa_verify_x2(ctx, results, &signature[0], message[0], &pubkey[0], &signature[1], message[1], &pubkey[1]) == 1);
+    CHECK(results[0] == 1 && results[1] == 1);
+    /* Swapped keys fail for both. */
+    CHECK(secp256k1_ecdsa_verify_x2(ctx, results, &signature[0], message[0], &pubkey[1], &signature[1], message[1], &pubkey[0]) == 0);
+    CHECK(results[0] == 0 && results[1] == 0);
+    /* The same signature twice. */
+    CHECK(secp256k1_ecdsa_verify_x2(ctx, results, &signature[1], message[1], &pubkey[1], &signature[1], message[1], &pubkey[1]) == 1);
+    CHECK(results[0] == 1 && results[1] == 1);
+
+    /* A high-S signature fails on its own, the other one still verifies. */
+    secp256k1_ecdsa_signature_load(ctx, &r, &s, &signature[0]);
+    secp256k1_scalar_negate(&s, &s);
+    secp256k1_ecdsa_signature_save(&high, &r, &s);
+    CHECK(secp256k1_ecdsa_verify_x2(ctx, results, &high, message[0], &pubkey[0], &signature[1], message[1], &pubkey[1]) == 0);
+    CHECK(results[0] == 0 && results[1] == 1);
+    /* So does a modified message. */
+    message[1][0] ^= 1;
+    CHECK(secp256k1_ecdsa_verify_x2(ctx, results, &signature[0], message[0], &pubkey[0], &signature[1], message[1], &pubkey[1]) == 0);
+    CHECK(results[0] == 1 && results[1] == 0);
+    message[1][0] ^= 1;
+
+    /* An invalid public key is an illegal argument, reported for its own entry only. */
+    secp256k1_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    memset(&bad, 0, sizeof(bad));
+    CHECK(secp256k1_ecdsa_verify_x2(ctx, results, &signature[0], message[0], &bad, &signature[1], message[1], &pubkey[1]) == 0);
+    CHECK(ecount == 1);
+    CHECK(results[0] == 0 && results[1] == 1);
+    CHECK(secp256k1_ecdsa_verify_x2(ctx, results, NULL, message[0], &pubkey[0], &signature[1], message[1], &pubkey[1]) == 0);
+    CHECK(ecount == 2);
+    CHECK(secp256k1_ecdsa_verify_x2(ctx, results, &signature[0], message[0], &pubkey[0], &signature[1], NULL, &pubkey[1]) == 0);
+    CHECK(ecount == 3);
+    CHECK(secp256k1_ecdsa_verify_x2(ctx, results, &signature[0], message[0], &pubkey[0], &signature[1], message[1], NULL) == 0);
+    CHECK(ecount == 4);
+    secp256k1_context_set_illegal_callback(ctx, NULL, NULL);
+}
+
+void run_ecdsa_verify_x2(void) {
+    int i;
+    for (i = 0; i < 4*count; i++) {
+        test_ecdsa_verify_x2();
+    }
+}
+
+static int nonce_function_test_precomputed_first(unsigned char *nonce32, const unsigned char *msg32, const unsigned char *key32, const unsigned char *algo16, void *data, unsigned int counter) {
+   /* Dummy nonce generator that uses a precomputed nonce first, and RFC6979 nonces after it. */
+   if (counter == 0) {
+       memcpy(nonce32, data, 32);
+       return 1;
+   }
+   return nonce_function_rfc6979(nonce32, msg32, key32, algo16, NULL, counter - 1);
+}
+
+#define SIGN_BATCH_MAX (2 * SECP256K1_ECDSA_SIGN_BATCH + 6)
+
+void test_ecdsa_sign_batch(void) {
+    unsigned char privkey[SIGN_BATCH_MAX][32];
+    unsigned char message[SIGN_BATCH_MAX][32];
+    unsigned char extra[32];
+    secp256k1_ecdsa_signature signature[SIGN_BATCH_MAX];
+    secp256k1_ecdsa_signature single;
+    secp256k1_ecdsa_signature zero;
+    secp256k1_scalar key, msg;
+    size_t n = secp256k1_rand_int(SIGN_BATCH_MAX) + 1;
+    size_t bad = secp256k1_rand_int(n);
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        random_scalar_order_test(&msg);
+        random_scalar_order_test(&key);
+        secp256k1_scalar_get_b32(privkey[i], &key);
+        secp256k1_scalar_get_b32(message[i], &msg);
+    }
+    secp256k1_rand256_test(extra);
+    memset(&zero, 0, sizeof(zero));
+
+    /* Every signature matches the one secp256k1_ecdsa_sign creates. */
+    CHECK(secp256k1_ecdsa_sign_batch(ctx, signature, message[0], privkey[0], n, NULL, NULL) == 1);
+    for (i = 0; i < n; i++) {
+        CHECK(secp256k1_ecdsa_sign(ctx, &single, message[i], privkey[i], NULL, NULL) == 1);
+        CHECK(memcmp(&single, &signature[i], sizeof(single)) == 0);
+    }
+    CHECK(secp256k1_ecdsa_sign_batch(ctx, signature, message[0], privkey[0], n, NULL, extra) == 1);
+    for (i = 0; i < n; i++) {
+        CHECK(secp256k1_ecdsa_sign(ctx, &single, message[i], privkey[i], NULL, extra) == 1);
+        CHECK(memcmp(&single, &signature[i], sizeof(single)) == 0);
+    }
+
+    /* An invalid key only fails its own entry. */
+    memset(privkey[bad], 0xFF, 32);
+    CHECK(secp256k1_ecdsa_sign_batch(ctx, signature, message[0], privkey[0], n, NULL, NULL) == 0);
+    for (i = 0; i < n; i++) {
+        if (i == bad) {
+            CHECK(memcmp(&zero, &signature[i], sizeof(zero)) == 0);
+        } else {
+            CHECK(secp256k1_ecdsa_sign(ctx, &single, message[i], privkey[i], NULL, NULL) == 1);
+            CHECK(memcmp(&single, &signature[i], sizeof(single)) == 0);
+        }
+    }
+}
+
+void run_ecdsa_sign_batch(void) {
+    int i;
+    int32_t ecount = 0;
+    secp256k1_context *vrfy = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+    secp256k1_ecdsa_signature signature[3];
+    secp256k1_ecdsa_signature single;
+    unsigned char privkey[3][32];
+    unsigned char message[3][32];
+    /* Key 1 with nonce 1 makes s zero for the middle message, which has to
+     * fall back to the next nonce on its own. */
+    static const unsigned char nonce[32] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    };
+    static const unsigned char zero_s_msg[32] = {
+        0x86, 0x41, 0x99, 0x81, 0x06, 0x23, 0x44, 0x53,
+        0xaa, 0x5f, 0x9d, 0x6a, 0x31, 0x78, 0xf4, 0xf7,
+        0xb8, 0x12, 0xe0, 0x0b, 0x81, 0x7a, 0x77, 0x62,
+        0x65, 0xdf, 0xdd, 0x31, 0xb9, 0x3e, 0x29, 0xa9,
+    };
+
+    for (i = 0; i < 16*count; i++) {
+        test_ecdsa_sign_batch();
+    }
+
+    memset(privkey, 0, sizeof(privkey));
+    for (i = 0; i < 3; i++) {
+        privkey[i][31] = 1;
+        secp256k1_rand256_test(message[i]);
+    }
+    memcpy(message[1], zero_s_msg, 32);
+    CHECK(secp256k1_ecdsa_sign_batch(ctx, signature, message[0], privkey[0], 3, nonce_function_test_precomputed_first, (void*)nonce) == 1);
+    for (i = 0; i < 3; i++) {
+        CHECK(secp256k1_ecdsa_sign(ctx, &single, message[i], privkey[i], nonce_function_test_precomputed_first, (void*)nonce) == 1);
+        CHECK(memcmp(&single, &signature[i], sizeof(single)) == 0);
+    }
+    CHECK(secp256k1_ecdsa_sign(ctx, &single, message[1], privkey[1], precomputed_nonce_function, (void*)nonce) == 0);
+
+    /* Nothing to sign. */
+    CHECK(secp256k1_ecdsa_sign_batch(ctx, signature, message[0], privkey[0], 0, NULL, NULL) == 1);
+
+    secp256k1_context_set_illegal_callback(vrfy, counting_illegal_callback_fn, &ecount);
+    CHECK(secp256k1_ecdsa_sign_batch(vrfy, signature, message[0], privkey[0], 3, NULL, NULL) == 0);
+    CHECK(ecount == 1);
+    secp256k1_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    CHECK(secp256k1_ecdsa_sign_batch(ctx, NULL, message[0], privkey[0], 3, NULL, NULL) == 0);
+    CHECK(ecount == 2);
+    CHECK(secp256k1_ecdsa_sign_batch(ctx, signature, NULL, privkey[0], 3, NULL, NULL) == 0);
+    CHECK(ecount == 3);
+    CHECK(secp256k1_ecdsa_sign_batch(ctx, signature, message[0], NULL, 3, NULL, NULL) == 0);
+    CHECK(ecount == 4);
+    secp256k1_context_set_illegal_callback(ctx, NULL, NULL);
+    secp256k1_context_destroy(vrfy);
+}
+
 void run_ecdsa_end_to_end(void) {
     int i;
     for (i = 0; i < 64*count; i++) {
@@ -4379,18 +5218,89 @@ void run_ecdsa_openssl(void) {
 }
 #endif
 
+#ifdef ENABLE_STATS
+void run_stats_tests(void) {
+    secp256k1_stats before, after;
+    secp256k1_context *ctx2;
+    secp256k1_scalar key;
+    secp256k1_pubkey pubkey;
+    secp256k1_ecdsa_signature sig;
+    unsigned char seckey[32];
+    unsigned char msg[32];
+    unsigned char pubkeyc[33];
+    size_t pubkeylen = sizeof(pubkeyc);
+    int ecount = 0;
+
+    random_scalar_order_test(&key);
+    secp256k1_scalar_get_b32(seckey, &key);
+    secp256k1_rand256_test(msg);
+
+    /* Key generation and signing: one a*G each, and the inversion of the nonce. */
+    CHECK(secp256k1_context_get_stats(ctx, &before) == 1);
+    CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey, seckey) == 1);
+    CHECK(secp256k1_ecdsa_sign(ctx, &sig, msg, seckey, NULL, NULL) == 1);
+    CHECK(secp256k1_context_get_stats(ctx, &after) == 1);
+    CHECK(after.ecmult_gen == before.ecmult_gen + 2);
+    CHECK(after.ecmult == before.ecmult);
+    CHECK(after.ecmult_const == before.ecmult_const);
+    CHECK(after.scalar_inv > before.scalar_inv);
+    CHECK(after.field_inv > before.field_inv);
+    CHECK(after.field_mul > before.field_mul);
+    CHECK(after.field_sqr > before.field_sqr);
+    CHECK(after.field_sqrt == before.field_sqrt);
+
+    /* Parsing a compressed key takes a square root, verification one ecmult. */
+    CHECK(secp256k1_ec_pubkey_serialize(ctx, pubkeyc, &pubkeylen, &pubkey, SECP256K1_EC_COMPRESSED) == 1);
+    before = after;
+    CHECK(secp256k1_ec_pubkey_parse(ctx, &pubkey, pubkeyc, pubkeylen) == 1);
+    CHECK(secp256k1_ecdsa_verify(ctx, &sig, msg, &pubkey) == 1);
+    CHECK(secp256k1_context_get_stats(ctx, &after) == 1);
+    CHECK(after.field_sqrt == before.field_sqrt + 1);
+    CHECK(after.ecmult == before.ecmult + 1);
+    CHECK(after.ecmult_gen == before.ecmult_gen);
+
+    /* Cloning a context allocates. */
+    before = after;
+    ctx2 = secp256k1_context_clone(ctx);
+    CHECK(secp256k1_context_get_stats(ctx, &after) == 1);
+    CHECK(after.alloc > before.alloc);
+    secp256k1_context_destroy(ctx2);
+
+    secp256k1_context_set_illegal_callback(ctx, counting_illegal_callback_fn, &ecount);
+    CHECK(secp256k1_context_get_stats(ctx, NULL) == 0);
+    CHECK(ecount == 1);
+    secp256k1_context_set_illegal_callback(ctx, NULL, NULL);
+}
+#endif
+
 #ifdef ENABLE_MODULE_ECDH
 # include "modules/ecdh/tests_impl.h"
 #endif
 
-#ifdef ENABLE_MODULE_SCHNORR
-# include "modules/schnorr/tests_impl.h"
+#ifdef ENABLE_MODULE_SCHNORRSIG
+# include "modules/schnorrsig/tests_impl.h"
+#endif
+
+#ifdef ENABLE_MODULE_MUSIG
+# include "modules/musig/tests_impl.h"
+#endif
+
+#ifdef ENABLE_MODULE_SCHNORRSIG_HALFAGG
+# include "modules/schnorrsig_halfagg/tests_impl.h"
 #endif
 
 #ifdef ENABLE_MODULE_RECOVERY
 # include "modules/recovery/tests_impl.h"
 #endif
 
+#ifdef ENABLE_MODULE_SIGCACHE
+# include "modules/sigcache/tests_impl.h"
+#endif
+
+#ifdef ENABLE_MODULE_NONCEPOOL
+# include "modules/noncepool/tests_impl.h"
+#endif
+
 int main(int argc, char **argv) {
     unsigned char seed16[16] = {0};
     unsigned char run32[32] = {0};
@@ -4440,6 +5350,8 @@ int main(int argc, char **argv) {
         secp256k1_rand256(run32);
         CHECK(secp256k1_context_randomize(ctx, secp256k1_rand_bits(1) ? run32 : NULL));
     }
+    run_context_hugepages_tests();
+    run_context_lazy_tests();
 
     run_rand_bits();
     run_rand_int();
@@ -4455,11 +5367,13 @@ int main(int argc, char **argv) {
 
     /* scalar tests */
     run_scalar_tests();
+    run_scalar_inverse_all();
 
     /* field tests */
     run_field_inv();
     run_field_inv_var();
     run_field_inv_all_var();
+    run_field_inv_all();
     run_field_misc();
     run_field_convert();
     run_sqr();
@@ -4470,12 +5384,17 @@ int main(int argc, char **argv) {
     run_group_decompress();
 
     /* ecmult tests */
+    run_ctz();
     run_wnaf();
     run_point_times_order();
     run_ecmult_chain();
+    run_ecmult_odd_multiples();
+    run_ecmult_x2();
+    run_ecmult_multi();
     run_ecmult_constants();
     run_ecmult_gen_blind();
     run_ecmult_const_tests();
+    run_point_precomp_tests();
     run_ec_combine();
 
     /* endomorphism tests */
@@ -4499,14 +5418,26 @@ int main(int argc, char **argv) {
     run_ecdsa_der_parse();
     run_ecdsa_sign_verify();
     run_ecdsa_end_to_end();
+    run_ecdsa_verify_x2();
+    run_ecdsa_sign_batch();
     run_ecdsa_edge_cases();
 #ifdef ENABLE_OPENSSL_TESTS
     run_ecdsa_openssl();
 #endif
 
-#ifdef ENABLE_MODULE_SCHNORR
-    /* Schnorr tests */
-    run_schnorr_tests();
+#ifdef ENABLE_MODULE_SCHNORRSIG
+    /* BIP340 Schnorr signature tests */
+    run_schnorrsig_tests();
+#endif
+
+#ifdef ENABLE_MODULE_MUSIG
+    /* MuSig2 multi-signature tests */
+    run_musig_tests();
+#endif
+
+#ifdef ENABLE_MODULE_SCHNORRSIG_HALFAGG
+    /* Schnorr signature half-aggregation tests */
+    run_schnorrsig_halfagg_tests();
 #endif
 
 #ifdef ENABLE_MODULE_RECOVERY
@@ -4514,6 +5445,21 @@ int main(int argc, char **argv) {
     run_recovery_tests();
 #endif
 
+#ifdef ENABLE_MODULE_SIGCACHE
+    /* signature cache tests */
+    run_sigcache_tests();
+#endif
+
+#ifdef ENABLE_MODULE_NONCEPOOL
+    /* signing nonce pool tests */
+    run_noncepool_tests();
+#endif
+
+#ifdef ENABLE_STATS
+    /* operation counter tests */
+    run_stats_tests();
+#endif
+
     secp256k1_rand256(run32);
     printf("random run = %02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x\n", run32[0], run32[1], run32[2], run32[3], run32[4], run32[5], run32[6], run32[7], run32[8], run32[9], run32[10], run32[11], run32[12], run32[13], run32[14], run32[15]);
 
@@ -0,0 +1,37 @@
+/**********************************************************************
+ * Copyright (c) 2026 Cosmos SDK Developers                           *
+ * Distributed under the MIT software license, see the accompanying   *
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.*
+ **********************************************************************/
+
+#ifndef _SECP256K1_TRACE_H_
+#define _SECP256K1_TRACE_H_
+
+/* USDT tracepoints around the public API, compiled in with --enable-usdt;
+ * otherwise all of these expand to nothing.
+ *
+ * Every exported function fires secp256k1:<name>__entry with the context
+ * and a size (input length, element count or flags, 0 where there is
+ * none), and secp256k1:<name>__return with its result (0 for functions
+ * returning void, the pointer for those returning one). A call rejected by
+ * ARG_CHECK fires secp256k1:illegal_argument with the context and the
+ * failed condition instead of a return probe. A probe nobody is attached
+ * to costs a nop. */
+
+#ifdef ENABLE_USDT
+
+#include <sys/sdt.h>
+
+#define SECP256K1_TRACE_ENTRY(fn, ctx, size) DTRACE_PROBE2(secp256k1, fn##__entry, (ctx), (size_t)(size))
+#define SECP256K1_TRACE_RETURN(fn, ret) DTRACE_PROBE1(secp256k1, fn##__return, (ret))
+#define SECP256K1_TRACE_ILLEGAL(ctx, cond) DTRACE_PROBE2(secp256k1, illegal_argument, (ctx), (cond))
+
+#else
+
+#define SECP256K1_TRACE_ENTRY(fn, ctx, size) do { } while(0)
+#define SECP256K1_TRACE_RETURN(fn, ret) do { } while(0)
+#define SECP256K1_TRACE_ILLEGAL(ctx, cond) do { } while(0)
+
+#endif
+
+#endif
@@ -15,6 +15,10 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#if defined(HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#endif
+
 typedef struct {
     void (*fn)(const char *text, void* data);
     const void* data;
@@ -42,6 +46,13 @@ static SECP256K1_INLINE void secp256k1_callback_call(const secp256k1_callback *
 #define EXPECT(x,c) (x)
 #endif
 
+/* Hint that the cache line at p will be read soon. Never faults, even for invalid p. */
+#ifdef HAVE_BUILTIN_PREFETCH
+#define PREFETCH(p) __builtin_prefetch((p), 0, 3)
+#else
+#define PREFETCH(p) ((void)(p))
+#endif
+
 #ifdef DETERMINISTIC
 #define CHECK(cond) do { \
     if (EXPECT(!(cond), 0)) { \
@@ -68,14 +79,111 @@ static SECP256K1_INLINE void secp256k1_callback_call(const secp256k1_callback *
 #define VERIFY_SETUP(stmt)
 #endif
 
+#include "stats.h"
+
 static SECP256K1_INLINE void *checked_malloc(const secp256k1_callback* cb, size_t size) {
     void *ret = malloc(size);
+    SECP256K1_STATS_INC(alloc);
     if (ret == NULL) {
         secp256k1_callback_call(cb, "Out of memory");
     }
     return ret;
 }
 
+/** Return the number of trailing zero bits of a non-zero x. */
+static SECP256K1_INLINE int secp256k1_ctz32_var(uint32_t x) {
+#if SECP256K1_GNUC_PREREQ(3,4)
+    return __builtin_ctz(x);
+#else
+    /* De Bruijn multiplication on the isolated lowest set bit. */
+    static const unsigned char debruijn[32] = {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+    return debruijn[(uint32_t)((x & -x) * 0x077CB531U) >> 27];
+#endif
+}
+
+/** Alignment of precomputed tables, one cache line. */
+#define SECP256K1_TABLE_ALIGN 64
+
+/** Size of the (transparent or explicit) hugepages tables are placed on. */
+#define SECP256K1_HUGEPAGE_SIZE ((size_t)2 << 20)
+
+/* Bookkeeping stored in front of every table allocation. */
+typedef struct {
+    void *base;    /* start of the underlying malloc block or mapping */
+    size_t mapped; /* length of the mapping, or 0 if base came from malloc */
+} secp256k1_table_header;
+
+/** Allocate a precomputed table of size bytes, aligned to SECP256K1_TABLE_ALIGN.
+ *  If hugepages is set, try to back it with 2 MiB pages: explicit ones
+ *  (MAP_HUGETLB) if the system has them reserved, otherwise an aligned mapping
+ *  with MADV_HUGEPAGE so transparent hugepages can be used. Falls back to the
+ *  heap when neither works. The result must be freed with table_free. */
+static void *checked_table_malloc(const secp256k1_callback* cb, size_t size, int hugepages) {
+    secp256k1_table_header *hdr;
+    unsigned char *ret;
+    void *base;
+#if defined(HAVE_SYS_MMAN_H) && defined(MAP_ANONYMOUS)
+    if (hugepages) {
+        size_t len = (size + SECP256K1_TABLE_ALIGN + SECP256K1_HUGEPAGE_SIZE - 1) & ~(SECP256K1_HUGEPAGE_SIZE - 1);
+#ifdef MAP_HUGETLB
+        base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base != MAP_FAILED) {
+            SECP256K1_STATS_INC(alloc);
+            ret = (unsigned char *)base + SECP256K1_TABLE_ALIGN;
+            hdr = (secp256k1_table_header *)ret - 1;
+            hdr->base = base;
+            hdr->mapped = len;
+            return ret;
+        }
+#endif
+        /* Over-map by one hugepage so a hugepage-aligned range of len bytes
+         * exists inside; the kernel only backs what gets touched. */
+        base = mmap(NULL, len + SECP256K1_HUGEPAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base != MAP_FAILED) {
+            unsigned char *aligned = (unsigned char *)(((uintptr_t)base + SECP256K1_HUGEPAGE_SIZE - 1) & ~(uintptr_t)(SECP256K1_HUGEPAGE_SIZE - 1));
+#ifdef MADV_HUGEPAGE
+            madvise(aligned, len, MADV_HUGEPAGE);
+#endif
+            SECP256K1_STATS_INC(alloc);
+            ret = aligned + SECP256K1_TABLE_ALIGN;
+            hdr = (secp256k1_table_header *)ret - 1;
+            hdr->base = base;
+            hdr->mapped = len + SECP256K1_HUGEPAGE_SIZE;
+            return ret;
+        }
+    }
+#else
+    (void)hugepages;
+#endif
+    base = checked_malloc(cb, size + 2 * SECP256K1_TABLE_ALIGN - 1);
+    if (base == NULL) {
+        return NULL;
+    }
+    ret = (unsigned char *)(((uintptr_t)base + 2 * SECP256K1_TABLE_ALIGN - 1) & ~(uintptr_t)(SECP256K1_TABLE_ALIGN - 1));
+    hdr = (secp256k1_table_header *)ret - 1;
+    hdr->base = base;
+    hdr->mapped = 0;
+    return ret;
+}
+
+static void table_free(void *ptr) {
+    const secp256k1_table_header *hdr;
+    if (ptr == NULL) {
+        return;
+    }
+    hdr = (const secp256k1_table_header *)ptr - 1;
+#if defined(HAVE_SYS_MMAN_H) && defined(MAP_ANONYMOUS)
+    if (hdr->mapped != 0) {
+        munmap(hdr->base, hdr->mapped);
+        return;
+    }
+#endif
+    free(hdr->base);
+}
+
 /* Macro for restrict, when available and not in a VERIFY build. */
 #if defined(SECP256K1_BUILD) && defined(VERIFY)
 # define SECP256K1_RESTRICT
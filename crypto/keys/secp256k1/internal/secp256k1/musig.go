@@ -0,0 +1,208 @@
+//go:build !gofuzz && cgo
+// +build !gofuzz,cgo
+
+package secp256k1
+
+/*
+#include "libsecp256k1/include/secp256k1.h"
+#include "libsecp256k1/include/secp256k1_musig.h"
+
+extern int secp256k1_ext_musig_pubkey_agg(const secp256k1_context* ctx, secp256k1_xonly_pubkey *agg_pk, secp256k1_musig_keyagg_cache *cache, const unsigned char *pubkeydata, size_t n);
+extern int secp256k1_ext_musig_nonce_agg(const secp256k1_context* ctx, secp256k1_musig_aggnonce *aggnonce, const unsigned char *noncedata, size_t n);
+extern int secp256k1_ext_musig_partial_sig_agg(const secp256k1_context* ctx, unsigned char *sig64, const secp256k1_musig_session *session, const unsigned char *sigdata, size_t n);
+*/
+import "C"
+
+import (
+	"crypto/rand"
+	"errors"
+	"sync/atomic"
+	"unsafe"
+)
+
+var (
+	ErrInvalidMusigKeys  = errors.New("invalid or no public keys to aggregate")
+	ErrInvalidMusigNonce = errors.New("invalid or no public nonces to aggregate")
+	ErrInvalidPartialSig = errors.New("invalid partial signature")
+	ErrMusigNonceUsed    = errors.New("musig nonce already used")
+	ErrMusigSession      = errors.New("cannot start musig session")
+)
+
+// MusigKey is a MuSig2 (BIP327) aggregate of compressed public keys, together
+// with what signing and verifying with it need to know about them. Making one
+// costs a multi-scalar multiplication over all keys, so a multisig account
+// should make it once and keep it; signatures for it are then checked with a
+// single SchnorrVerify however many keys there are.
+type MusigKey struct {
+	cache  C.secp256k1_musig_keyagg_cache
+	pubkey []byte
+}
+
+// NewMusigKey aggregates 33-byte compressed public keys. The order of the
+// keys matters.
+func NewMusigKey(pubkeys [][]byte) (*MusigKey, error) {
+	n := len(pubkeys)
+	if n == 0 {
+		return nil, ErrInvalidMusigKeys
+	}
+	keybuf := make([]byte, 33*n)
+	for i, pubkey := range pubkeys {
+		if len(pubkey) != 33 {
+			return nil, ErrInvalidMusigKeys
+		}
+		copy(keybuf[33*i:], pubkey)
+	}
+	var (
+		k     = new(MusigKey)
+		xonly C.secp256k1_xonly_pubkey
+	)
+	if C.secp256k1_ext_musig_pubkey_agg(context, &xonly, &k.cache, (*C.uchar)(unsafe.Pointer(&keybuf[0])), C.size_t(n)) == 0 {
+		return nil, ErrInvalidMusigKeys
+	}
+	k.pubkey = make([]byte, 32)
+	C.secp256k1_xonly_pubkey_serialize(context, (*C.uchar)(unsafe.Pointer(&k.pubkey[0])), &xonly)
+	return k, nil
+}
+
+// PubKey returns the 32-byte x-only aggregated public key.
+func (k *MusigKey) PubKey() []byte {
+	return k.pubkey
+}
+
+// MusigNonce is one signer's nonce for one signing session. PubNonce is sent
+// to the other signers; the secret part is used up by PartialSign, which
+// goroutines may race for safely. A MusigNonce must not be copied.
+type MusigNonce struct {
+	secnonce C.secp256k1_musig_secnonce
+	used     atomic.Bool
+	PubNonce []byte
+}
+
+// NewNonce generates the nonce of the signer with seckey for signing msg with
+// the aggregated key.
+func (k *MusigKey) NewNonce(seckey, msg []byte) (*MusigNonce, error) {
+	if len(msg) != 32 {
+		return nil, ErrInvalidMsgLen
+	}
+	if len(seckey) != 32 {
+		return nil, ErrInvalidKey
+	}
+	var pubkey C.secp256k1_pubkey
+	if C.secp256k1_ec_pubkey_create(context, &pubkey, (*C.uchar)(unsafe.Pointer(&seckey[0]))) != 1 {
+		return nil, ErrInvalidKey
+	}
+	// Unlike the aux randomness of SchnorrSign this must not be left out:
+	// the same randomness twice reveals the secret key.
+	secrand := make([]byte, 32)
+	if _, err := rand.Read(secrand); err != nil {
+		return nil, err
+	}
+	nonce := &MusigNonce{PubNonce: make([]byte, 66)}
+	var (
+		secranddata = (*C.uchar)(unsafe.Pointer(&secrand[0]))
+		keydata     = (*C.uchar)(unsafe.Pointer(&seckey[0]))
+		msgdata     = (*C.uchar)(unsafe.Pointer(&msg[0]))
+		pubnonce    C.secp256k1_musig_pubnonce
+	)
+	if C.secp256k1_musig_nonce_gen(context, &nonce.secnonce, &pubnonce, secranddata, keydata, &pubkey, msgdata, &k.cache, nil) != 1 {
+		return nil, ErrInvalidKey
+	}
+	C.secp256k1_musig_pubnonce_serialize(context, (*C.uchar)(unsafe.Pointer(&nonce.PubNonce[0])), &pubnonce)
+	return nonce, nil
+}
+
+// MusigSession holds what the signers need to sign msg with the aggregated
+// key, once all their public nonces are known.
+type MusigSession struct {
+	key     *MusigKey
+	session C.secp256k1_musig_session
+}
+
+// NewSession starts a session for signing msg from the 66-byte public nonces
+// of all signers.
+func (k *MusigKey) NewSession(pubnonces [][]byte, msg []byte) (*MusigSession, error) {
+	if len(msg) != 32 {
+		return nil, ErrInvalidMsgLen
+	}
+	n := len(pubnonces)
+	if n == 0 {
+		return nil, ErrInvalidMusigNonce
+	}
+	noncebuf := make([]byte, 66*n)
+	for i, pubnonce := range pubnonces {
+		if len(pubnonce) != 66 {
+			return nil, ErrInvalidMusigNonce
+		}
+		copy(noncebuf[66*i:], pubnonce)
+	}
+	var aggnonce C.secp256k1_musig_aggnonce
+	if C.secp256k1_ext_musig_nonce_agg(context, &aggnonce, (*C.uchar)(unsafe.Pointer(&noncebuf[0])), C.size_t(n)) == 0 {
+		return nil, ErrInvalidMusigNonce
+	}
+	s := &MusigSession{key: k}
+	if C.secp256k1_musig_nonce_process(context, &s.session, &aggnonce, (*C.uchar)(unsafe.Pointer(&msg[0])), &k.cache) != 1 {
+		return nil, ErrMusigSession
+	}
+	return s, nil
+}
+
+// PartialSign creates the 32-byte partial signature of the signer with seckey,
+// using up nonce, which must have been made for seckey.
+func (s *MusigSession) PartialSign(nonce *MusigNonce, seckey []byte) ([]byte, error) {
+	if len(seckey) != 32 {
+		return nil, ErrInvalidKey
+	}
+	// Claim the nonce before touching it: signing with it twice, even in two
+	// sessions, reveals seckey.
+	if !nonce.used.CompareAndSwap(false, true) {
+		return nil, ErrMusigNonceUsed
+	}
+	var psig C.secp256k1_musig_partial_sig
+	if C.secp256k1_musig_partial_sign(context, &psig, &nonce.secnonce, (*C.uchar)(unsafe.Pointer(&seckey[0])), &s.key.cache, &s.session) != 1 {
+		return nil, ErrInvalidKey
+	}
+	out := make([]byte, 32)
+	C.secp256k1_musig_partial_sig_serialize(context, (*C.uchar)(unsafe.Pointer(&out[0])), &psig)
+	return out, nil
+}
+
+// PartialVerify checks the partial signature of the signer with the given
+// compressed public key and public nonce. Aggregate does not need it; it is
+// for finding out who to blame when the aggregated signature is invalid.
+func (s *MusigSession) PartialVerify(partialSig, pubnonce, pubkey []byte) bool {
+	if len(partialSig) != 32 || len(pubnonce) != 66 || len(pubkey) != 33 {
+		return false
+	}
+	var (
+		psig  C.secp256k1_musig_partial_sig
+		nonce C.secp256k1_musig_pubnonce
+		pk    C.secp256k1_pubkey
+	)
+	if C.secp256k1_musig_partial_sig_parse(context, &psig, (*C.uchar)(unsafe.Pointer(&partialSig[0]))) != 1 ||
+		C.secp256k1_musig_pubnonce_parse(context, &nonce, (*C.uchar)(unsafe.Pointer(&pubnonce[0]))) != 1 ||
+		C.secp256k1_ec_pubkey_parse(context, &pk, (*C.uchar)(unsafe.Pointer(&pubkey[0])), 33) != 1 {
+		return false
+	}
+	return C.secp256k1_musig_partial_sig_verify(context, &psig, &nonce, &pk, &s.key.cache, &s.session) == 1
+}
+
+// Aggregate combines the partial signatures of all signers into a 64-byte
+// BIP340 signature for the aggregated key.
+func (s *MusigSession) Aggregate(partialSigs [][]byte) ([]byte, error) {
+	n := len(partialSigs)
+	if n == 0 {
+		return nil, ErrInvalidPartialSig
+	}
+	sigbuf := make([]byte, 32*n)
+	for i, psig := range partialSigs {
+		if len(psig) != 32 {
+			return nil, ErrInvalidPartialSig
+		}
+		copy(sigbuf[32*i:], psig)
+	}
+	sig := make([]byte, 64)
+	if C.secp256k1_ext_musig_partial_sig_agg(context, (*C.uchar)(unsafe.Pointer(&sig[0])), &s.session, (*C.uchar)(unsafe.Pointer(&sigbuf[0])), C.size_t(n)) == 0 {
+		return nil, ErrInvalidPartialSig
+	}
+	return sig, nil
+}
@@ -0,0 +1,142 @@
+//go:build !gofuzz && cgo
+// +build !gofuzz,cgo
+
+package secp256k1
+
+/*
+#include "libsecp256k1/include/secp256k1.h"
+#include "libsecp256k1/include/secp256k1_noncepool.h"
+*/
+import "C"
+
+import (
+	"crypto/rand"
+	"errors"
+	"sync"
+	"time"
+	"unsafe"
+)
+
+var (
+	ErrInvalidNoncePoolSize = errors.New("nonce pool size must be positive")
+	ErrNoncePoolAlloc       = errors.New("cannot allocate nonce pool")
+)
+
+// NoncePool signs with nonces that background goroutines compute ahead of
+// time, which takes the point multiplication out of the latency of Sign.
+// It is safe for concurrent use.
+//
+// Pooled signatures use random nonces rather than the deterministic RFC6979
+// ones of the package level Sign, so two signatures of the same message
+// differ. Every precomputed nonce is used at most once; see
+// secp256k1_noncepool.h for how reuse is ruled out.
+type NoncePool struct {
+	mu   sync.RWMutex // held for writing only to destroy pool
+	pool *C.secp256k1_noncepool
+	wake chan struct{}
+	done chan struct{}
+	wg   sync.WaitGroup
+}
+
+// NewNoncePool creates a pool of size precomputed nonces, kept full by
+// workers goroutines.
+func NewNoncePool(size, workers int) (*NoncePool, error) {
+	if size <= 0 {
+		return nil, ErrInvalidNoncePoolSize
+	}
+	if workers <= 0 {
+		workers = 1
+	}
+	pool := C.secp256k1_noncepool_create(context, C.size_t(size))
+	if pool == nil {
+		return nil, ErrNoncePoolAlloc
+	}
+	p := &NoncePool{
+		pool: pool,
+		wake: make(chan struct{}, 1),
+		done: make(chan struct{}),
+	}
+	p.wg.Add(workers)
+	for i := 0; i < workers; i++ {
+		go p.refill()
+	}
+	return p, nil
+}
+
+func (p *NoncePool) refill() {
+	defer p.wg.Done()
+	seed := make([]byte, 32)
+	for {
+		added := C.size_t(0)
+		if _, err := rand.Read(seed); err == nil {
+			p.mu.RLock()
+			if p.pool != nil {
+				added = C.secp256k1_noncepool_fill(context, p.pool, (*C.uchar)(unsafe.Pointer(&seed[0])))
+			}
+			p.mu.RUnlock()
+		}
+		if added == 0 {
+			// Full (or out of randomness): wait for Sign to use some up.
+			select {
+			case <-p.wake:
+			case <-time.After(time.Second):
+			case <-p.done:
+				return
+			}
+		}
+	}
+}
+
+// Sign is like the package level Sign, but takes the nonce from the pool.
+// When the pool has run dry, or after Close, it falls back to Sign.
+func (p *NoncePool) Sign(msg, seckey []byte) ([]byte, error) {
+	if len(msg) != 32 {
+		return nil, ErrInvalidMsgLen
+	}
+	if len(seckey) != 32 {
+		return nil, ErrInvalidKey
+	}
+	seckeydata := (*C.uchar)(unsafe.Pointer(&seckey[0]))
+	if C.secp256k1_ec_seckey_verify(context, seckeydata) != 1 {
+		return nil, ErrInvalidKey
+	}
+
+	var (
+		msgdata   = (*C.uchar)(unsafe.Pointer(&msg[0]))
+		sigstruct C.secp256k1_ecdsa_signature
+		recid     C.int
+		ok        C.int
+	)
+	p.mu.RLock()
+	if p.pool != nil {
+		ok = C.secp256k1_ecdsa_sign_pooled(context, p.pool, &sigstruct, &recid, msgdata, seckeydata)
+	}
+	p.mu.RUnlock()
+	select {
+	case p.wake <- struct{}{}:
+	default:
+	}
+	if ok == 0 {
+		return Sign(msg, seckey)
+	}
+
+	sig := make([]byte, 65)
+	C.secp256k1_ecdsa_signature_serialize_compact(context, (*C.uchar)(unsafe.Pointer(&sig[0])), &sigstruct)
+	sig[64] = byte(recid) // add back recid to get 65 bytes sig
+	return sig, nil
+}
+
+// Close stops the workers and wipes the pool. Sign keeps working, without
+// the pool.
+func (p *NoncePool) Close() {
+	p.mu.Lock()
+	if p.pool == nil {
+		p.mu.Unlock()
+		return
+	}
+	close(p.done)
+	C.secp256k1_noncepool_destroy(p.pool)
+	p.pool = nil
+	p.mu.Unlock()
+	p.wg.Wait()
+}
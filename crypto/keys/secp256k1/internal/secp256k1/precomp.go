@@ -0,0 +1,82 @@
+//go:build !gofuzz && cgo
+// +build !gofuzz,cgo
+
+package secp256k1
+
+/*
+#include "libsecp256k1/include/secp256k1.h"
+#include "libsecp256k1/include/secp256k1_ecdh.h"
+*/
+import "C"
+
+import (
+	"errors"
+	"runtime"
+	"unsafe"
+)
+
+var ErrPrecomputedPointAlloc = errors.New("cannot allocate precomputed point table")
+
+// PrecomputedPoint holds a 64 KiB table of multiples of one public key, which
+// makes multiplying that key by a secret scalar about 1.7 times as fast.
+// Building it costs about as much as eight multiplications, so it pays off
+// for keys that are used over and over, like a server's ECDH key. It is safe
+// for concurrent use.
+type PrecomputedPoint struct {
+	precomp *C.secp256k1_point_precomp
+}
+
+// NewPrecomputedPoint builds the table for pubkey, given in any format
+// ECDH accepts.
+func NewPrecomputedPoint(pubkey []byte) (*PrecomputedPoint, error) {
+	if len(pubkey) == 0 {
+		return nil, ErrInvalidPubkey
+	}
+	var point C.secp256k1_pubkey
+	if C.secp256k1_ec_pubkey_parse(context, &point, (*C.uchar)(unsafe.Pointer(&pubkey[0])), C.size_t(len(pubkey))) != 1 {
+		return nil, ErrInvalidPubkey
+	}
+	precomp := C.secp256k1_point_precomp_create(context, &point)
+	if precomp == nil {
+		return nil, ErrPrecomputedPointAlloc
+	}
+	p := &PrecomputedPoint{precomp: precomp}
+	runtime.SetFinalizer(p, func(p *PrecomputedPoint) {
+		C.secp256k1_point_precomp_destroy(p.precomp)
+	})
+	return p, nil
+}
+
+// ECDH is like the package level ECDH with the precomputed public key.
+func (p *PrecomputedPoint) ECDH(seckey []byte) ([]byte, error) {
+	if len(seckey) != 32 {
+		return nil, ErrInvalidKey
+	}
+	secret := make([]byte, 32)
+	res := C.secp256k1_ecdh_precomp(context, (*C.uchar)(unsafe.Pointer(&secret[0])), p.precomp, (*C.uchar)(unsafe.Pointer(&seckey[0])))
+	runtime.KeepAlive(p)
+	if res != 1 {
+		return nil, ErrInvalidKey
+	}
+	return secret, nil
+}
+
+// Mul returns scalar times the precomputed public key as a 65-byte
+// uncompressed public key. The scalar may be secret.
+func (p *PrecomputedPoint) Mul(scalar []byte) ([]byte, error) {
+	if len(scalar) != 32 {
+		return nil, ErrInvalidKey
+	}
+	var point C.secp256k1_pubkey
+	res := C.secp256k1_point_precomp_mul(context, &point, p.precomp, (*C.uchar)(unsafe.Pointer(&scalar[0])))
+	runtime.KeepAlive(p)
+	if res != 1 {
+		return nil, ErrInvalidKey
+	}
+	var (
+		out    = make([]byte, 65)
+		outlen = C.size_t(len(out))
+	)
+	C.secp256k1_ec_pubkey_serialize(context, (*C.uchar)(unsafe.Pointer(&out[0])), &outlen, &point, C.SECP256K1_EC_UNCOMPRESSED)
+	return out, nil
+}
@@ -0,0 +1,244 @@
+//go:build !gofuzz && cgo
+// +build !gofuzz,cgo
+
+package secp256k1
+
+/*
+#include "libsecp256k1/include/secp256k1.h"
+#include "libsecp256k1/include/secp256k1_sigcache.h"
+
+extern unsigned int secp256k1_ext_pubkey_layout(void);
+extern int secp256k1_ext_pubkey_check(const secp256k1_context* ctx, const unsigned char *pubkeydata, const secp256k1_pubkey *pubkey);
+extern int secp256k1_ext_ecdsa_verify_parsed(const secp256k1_context* ctx, secp256k1_sigcache *cache, const unsigned char *sigdata, const unsigned char *msgdata, const secp256k1_pubkey *pubkey);
+*/
+import "C"
+
+import (
+	"encoding/binary"
+	"errors"
+	"hash/crc32"
+	"io"
+	"os"
+	"runtime"
+	"sync"
+	"unsafe"
+)
+
+// A pubkey cache file keeps compressed public keys next to the form
+// secp256k1_ec_pubkey_parse turns them into, so that the square root that
+// decompression costs is paid once per key and node rather than once per
+// signature. Layout:
+//
+//	header:  "SECPPKC1" | parsed key layout (uint32 LE) | reserved (uint32 LE, 0)
+//	records: compressed key (33) | secp256k1_pubkey (64) | CRC-32C of the 97 bytes before (uint32 LE)
+//
+// The file is only ever appended to. On open every record is checked: its
+// checksum, and that the parsed key is the canonical one for the compressed
+// key (a cheap curve equation check, no square root). The file is cut at the
+// first record that fails, which also drops a record torn by a crash. A file
+// written by a build with a different key layout is started over.
+//
+// Only keys that a valid signature was verified against are recorded, and at
+// most maxKeys of them: once the cache is full, further keys are parsed for
+// every signature as if there was no cache. Records past maxKeys, left by an
+// earlier run with a larger limit, are cut off on open.
+//
+// The checked records are read into memory, so that nothing written to the
+// file later can change a key after it was checked, and the file is locked
+// for as long as the cache is open.
+const (
+	pubkeyCacheMagic      = "SECPPKC1"
+	pubkeyCacheHeaderSize = 16
+	pubkeyCacheRecordSize = 33 + 64 + 4
+)
+
+var (
+	crc32c = crc32.MakeTable(crc32.Castagnoli)
+
+	ErrPubkeyCacheClosed      = errors.New("pubkey cache is closed")
+	ErrPubkeyCacheLocked      = errors.New("pubkey cache file is in use")
+	ErrInvalidPubkeyCacheSize = errors.New("pubkey cache must hold at least one key")
+)
+
+// PubkeyCache is a persistent cache of parsed compressed public keys, backed
+// by a file. It is safe for concurrent use.
+type PubkeyCache struct {
+	mu      sync.RWMutex
+	f       *os.File
+	keys    map[[33]byte][]byte // parsed keys
+	end     int64               // where the next record goes
+	maxKeys int
+}
+
+// OpenPubkeyCache opens the pubkey cache file at path, creating it if needed.
+// The cache holds up to maxKeys keys, each taking pubkeyCacheRecordSize (101)
+// bytes on disk and about as much again in memory.
+func OpenPubkeyCache(path string, maxKeys int) (*PubkeyCache, error) {
+	if maxKeys <= 0 {
+		return nil, ErrInvalidPubkeyCacheSize
+	}
+	f, err := os.OpenFile(path, os.O_RDWR|os.O_CREATE, 0o600)
+	if err != nil {
+		return nil, err
+	}
+	if err := lockFile(f); err != nil {
+		f.Close()
+		return nil, err
+	}
+	c := &PubkeyCache{f: f, keys: make(map[[33]byte][]byte), maxKeys: maxKeys}
+	if err := c.load(); err != nil {
+		c.Close()
+		return nil, err
+	}
+	return c, nil
+}
+
+func (c *PubkeyCache) load() error {
+	st, err := c.f.Stat()
+	if err != nil {
+		return err
+	}
+	header := make([]byte, pubkeyCacheHeaderSize)
+	copy(header, pubkeyCacheMagic)
+	binary.LittleEndian.PutUint32(header[8:], uint32(C.secp256k1_ext_pubkey_layout()))
+
+	if st.Size() >= pubkeyCacheHeaderSize {
+		data := make([]byte, st.Size())
+		if _, err := io.ReadFull(io.NewSectionReader(c.f, 0, st.Size()), data); err != nil {
+			return err
+		}
+		if string(data[:pubkeyCacheHeaderSize]) == string(header) {
+			c.end = c.scan(data)
+			if c.end != st.Size() {
+				return c.f.Truncate(c.end)
+			}
+			return nil
+		}
+	}
+	// New, unrecognised or foreign file: start over.
+	if err := c.f.Truncate(0); err != nil {
+		return err
+	}
+	if _, err := c.f.WriteAt(header, 0); err != nil {
+		return err
+	}
+	c.end = pubkeyCacheHeaderSize
+	return nil
+}
+
+// scan indexes the valid records of the file contents in data, up to
+// maxKeys, and returns the offset just past the last of them. The parsed
+// keys in the index point into data.
+func (c *PubkeyCache) scan(data []byte) int64 {
+	off := pubkeyCacheHeaderSize
+	for ; off+pubkeyCacheRecordSize <= len(data) && len(c.keys) < c.maxKeys; off += pubkeyCacheRecordSize {
+		rec := data[off : off+pubkeyCacheRecordSize]
+		if crc32.Checksum(rec[:97], crc32c) != binary.LittleEndian.Uint32(rec[97:]) {
+			break
+		}
+		if C.secp256k1_ext_pubkey_check(context, (*C.uchar)(unsafe.Pointer(&rec[0])), (*C.secp256k1_pubkey)(unsafe.Pointer(&rec[33]))) != 1 {
+			break
+		}
+		c.keys[[33]byte(rec[:33])] = rec[33:97:97]
+	}
+	return int64(off)
+}
+
+// Len returns the number of keys in the cache.
+func (c *PubkeyCache) Len() int {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	return len(c.keys)
+}
+
+// Close releases the file and its lock. Keys added since opening stay on
+// disk for the next OpenPubkeyCache.
+func (c *PubkeyCache) Close() error {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if c.f == nil {
+		return ErrPubkeyCacheClosed
+	}
+	err := c.f.Close()
+	c.f = nil
+	c.keys = nil
+	return err
+}
+
+// record parses a 33-byte compressed key into a cache record, or returns nil
+// if the key is invalid.
+func record(pubkey []byte) []byte {
+	var parsed C.secp256k1_pubkey
+	if C.secp256k1_ec_pubkey_parse(context, &parsed, (*C.uchar)(unsafe.Pointer(&pubkey[0])), 33) == 0 {
+		return nil
+	}
+	rec := make([]byte, pubkeyCacheRecordSize)
+	copy(rec, pubkey)
+	copy(rec[33:97], (*[64]byte)(unsafe.Pointer(&parsed.data[0]))[:])
+	binary.LittleEndian.PutUint32(rec[97:], crc32.Checksum(rec[:97], crc32c))
+	return rec
+}
+
+// add appends a record to the cache, if it is still open and not full.
+func (c *PubkeyCache) add(rec []byte) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if _, ok := c.keys[[33]byte(rec[:33])]; ok || c.f == nil || len(c.keys) >= c.maxKeys {
+		return
+	}
+	// A failed write only means the key gets parsed again after a restart.
+	if _, err := c.f.WriteAt(rec, c.end); err == nil {
+		c.end += pubkeyCacheRecordSize
+	}
+	c.keys[[33]byte(rec[:33])] = rec[33:97:97]
+}
+
+// VerifySignature is like the package level VerifySignature, but takes the
+// parsed form of 33-byte compressed keys from the cache, and goes through
+// sigs if it is not nil.
+func (c *PubkeyCache) VerifySignature(sigs *SigCache, pubkey, msg, signature []byte) bool {
+	if len(msg) != 32 || len(signature) != 64 {
+		return false
+	}
+	var cache *C.secp256k1_sigcache
+	if sigs != nil {
+		cache = sigs.cache
+	}
+	sigdata := (*C.uchar)(unsafe.Pointer(&signature[0]))
+	msgdata := (*C.uchar)(unsafe.Pointer(&msg[0]))
+
+	var (
+		pk   []byte
+		open bool
+	)
+	if len(pubkey) == 33 {
+		c.mu.RLock()
+		open = c.f != nil
+		pk = c.keys[[33]byte(pubkey)]
+		c.mu.RUnlock()
+	}
+	if !open {
+		if sigs != nil {
+			return sigs.VerifySignature(pubkey, msg, signature)
+		}
+		return VerifySignature(pubkey, msg, signature)
+	}
+	if pk != nil {
+		res := C.secp256k1_ext_ecdsa_verify_parsed(context, cache, sigdata, msgdata, (*C.secp256k1_pubkey)(unsafe.Pointer(&pk[0]))) != 0
+		runtime.KeepAlive(sigs)
+		return res
+	}
+
+	// Keep the key only once a signature checked out against it: anybody can
+	// make up keys that no valid signature comes with.
+	rec := record(pubkey)
+	if rec == nil {
+		return false
+	}
+	res := C.secp256k1_ext_ecdsa_verify_parsed(context, cache, sigdata, msgdata, (*C.secp256k1_pubkey)(unsafe.Pointer(&rec[33]))) != 0
+	runtime.KeepAlive(sigs)
+	if res {
+		c.add(rec)
+	}
+	return res
+}
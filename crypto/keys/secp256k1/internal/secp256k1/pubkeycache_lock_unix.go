@@ -0,0 +1,18 @@
+//go:build !gofuzz && cgo && unix
+
+package secp256k1
+
+import (
+	"errors"
+	"os"
+	"syscall"
+)
+
+// lockFile takes an exclusive lock on f, held until f is closed.
+func lockFile(f *os.File) error {
+	err := syscall.Flock(int(f.Fd()), syscall.LOCK_EX|syscall.LOCK_NB)
+	if errors.Is(err, syscall.EWOULDBLOCK) {
+		return ErrPubkeyCacheLocked
+	}
+	return err
+}
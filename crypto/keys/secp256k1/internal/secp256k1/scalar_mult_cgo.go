@@ -13,6 +13,7 @@ package secp256k1
 #include "libsecp256k1/include/secp256k1.h"
 
 extern int secp256k1_ext_scalar_mul(const secp256k1_context* ctx, const unsigned char *point, const unsigned char *scalar);
+extern int secp256k1_ext_scalar_mul_xonly(const secp256k1_context* ctx, unsigned char *point, const unsigned char *scalar);
 
 */
 import "C"
@@ -56,3 +57,39 @@ func (BitCurve *BitCurve) ScalarMult(Bx, By *big.Int, scalar []byte) (*big.Int,
 	}
 	return x, y
 }
+
+// ScalarMultX returns the X coordinate of scalar*B, where B is the point with
+// X coordinate Bx. Which of the two points with that X coordinate is meant
+// does not matter, and skipping Y makes it a little cheaper than ScalarMult,
+// e.g. for ECDH. It returns nil if Bx is not on the curve or the scalar is
+// zero or not below the group order.
+func (BitCurve *BitCurve) ScalarMultX(Bx *big.Int, scalar []byte) *big.Int {
+	if len(scalar) > 32 {
+		panic("can't handle scalars > 256 bits")
+	}
+	if Bx.Sign() < 0 || Bx.BitLen() > 256 {
+		return nil
+	}
+	padded := make([]byte, 32)
+	copy(padded[32-len(scalar):], scalar)
+	scalar = padded
+
+	point := make([]byte, 32)
+	readBits(Bx, point)
+
+	pointPtr := (*C.uchar)(unsafe.Pointer(&point[0]))
+	scalarPtr := (*C.uchar)(unsafe.Pointer(&scalar[0]))
+	res := C.secp256k1_ext_scalar_mul_xonly(context, pointPtr, scalarPtr)
+
+	x := new(big.Int).SetBytes(point)
+	for i := range point {
+		point[i] = 0
+	}
+	for i := range padded {
+		scalar[i] = 0
+	}
+	if res != 1 {
+		return nil
+	}
+	return x
+}
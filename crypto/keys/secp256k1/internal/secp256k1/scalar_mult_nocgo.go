@@ -13,3 +13,7 @@ import "math/big"
 func (BitCurve *BitCurve) ScalarMult(Bx, By *big.Int, scalar []byte) (*big.Int, *big.Int) {
 	panic("ScalarMult is not available when secp256k1 is built without cgo")
 }
+
+func (BitCurve *BitCurve) ScalarMultX(Bx *big.Int, scalar []byte) *big.Int {
+	panic("ScalarMultX is not available when secp256k1 is built without cgo")
+}
@@ -0,0 +1,174 @@
+//go:build !gofuzz && cgo
+// +build !gofuzz,cgo
+
+package secp256k1
+
+/*
+#include "libsecp256k1/include/secp256k1.h"
+#include "libsecp256k1/include/secp256k1_schnorrsig.h"
+#include "libsecp256k1/include/secp256k1_schnorrsig_halfagg.h"
+*/
+import "C"
+
+import (
+	"crypto/rand"
+	"errors"
+	"unsafe"
+)
+
+var ErrInvalidSchnorrSig = errors.New("invalid schnorr signature")
+
+// SchnorrPubkey returns the 32-byte x-only public key of seckey, which is what
+// BIP340 signatures are checked against.
+func SchnorrPubkey(seckey []byte) ([]byte, error) {
+	if len(seckey) != 32 {
+		return nil, ErrInvalidKey
+	}
+	var (
+		pubkey C.secp256k1_pubkey
+		xonly  C.secp256k1_xonly_pubkey
+	)
+	if C.secp256k1_ec_pubkey_create(context, &pubkey, (*C.uchar)(unsafe.Pointer(&seckey[0]))) != 1 {
+		return nil, ErrInvalidKey
+	}
+	C.secp256k1_xonly_pubkey_from_pubkey(context, &xonly, nil, &pubkey)
+	out := make([]byte, 32)
+	C.secp256k1_xonly_pubkey_serialize(context, (*C.uchar)(unsafe.Pointer(&out[0])), &xonly)
+	return out, nil
+}
+
+// SchnorrSign creates a 64-byte BIP340 signature of msg.
+//
+// As with Sign, msg should be the 32-byte hash of the actual message. The
+// nonce mixes in fresh randomness, so two signatures of the same message
+// differ; a failing random source only makes them deterministic.
+func SchnorrSign(msg, seckey []byte) ([]byte, error) {
+	if len(msg) != 32 {
+		return nil, ErrInvalidMsgLen
+	}
+	if len(seckey) != 32 {
+		return nil, ErrInvalidKey
+	}
+	var auxdata *C.uchar
+	aux := make([]byte, 32)
+	if _, err := rand.Read(aux); err == nil {
+		auxdata = (*C.uchar)(unsafe.Pointer(&aux[0]))
+	}
+	sig := make([]byte, 64)
+	if C.secp256k1_schnorrsig_sign(context, (*C.uchar)(unsafe.Pointer(&sig[0])), (*C.uchar)(unsafe.Pointer(&msg[0])), (*C.uchar)(unsafe.Pointer(&seckey[0])), auxdata) != 1 {
+		return nil, ErrInvalidKey
+	}
+	return sig, nil
+}
+
+// SchnorrVerify checks that signature is a BIP340 signature of msg by the
+// 32-byte x-only public key pubkey.
+func SchnorrVerify(pubkey, msg, signature []byte) bool {
+	if len(pubkey) != 32 || len(msg) != 32 || len(signature) != 64 {
+		return false
+	}
+	var xonly C.secp256k1_xonly_pubkey
+	if C.secp256k1_xonly_pubkey_parse(context, &xonly, (*C.uchar)(unsafe.Pointer(&pubkey[0]))) != 1 {
+		return false
+	}
+	return C.secp256k1_schnorrsig_verify(context, (*C.uchar)(unsafe.Pointer(&signature[0])), (*C.uchar)(unsafe.Pointer(&msg[0])), &xonly) == 1
+}
+
+// SchnorrVerifyBatch reports whether signatures[i] is a valid signature of
+// msgs[i] by pubkeys[i] for every i, as SchnorrVerify would. Checking a batch
+// at once saves about a third of the time per signature, but does not tell
+// which signature is invalid if one is.
+func SchnorrVerifyBatch(pubkeys, msgs, signatures [][]byte) bool {
+	n := len(pubkeys)
+	if len(msgs) != n || len(signatures) != n {
+		return false
+	}
+	if n == 0 {
+		return true
+	}
+	var (
+		xonly  = make([]C.secp256k1_xonly_pubkey, n)
+		msgbuf = make([]byte, 32*n)
+		sigbuf = make([]byte, 64*n)
+	)
+	for i := 0; i < n; i++ {
+		if len(pubkeys[i]) != 32 || len(msgs[i]) != 32 || len(signatures[i]) != 64 {
+			return false
+		}
+		if C.secp256k1_xonly_pubkey_parse(context, &xonly[i], (*C.uchar)(unsafe.Pointer(&pubkeys[i][0]))) != 1 {
+			return false
+		}
+		copy(msgbuf[32*i:], msgs[i])
+		copy(sigbuf[64*i:], signatures[i])
+	}
+	return C.secp256k1_schnorrsig_verify_batch(context, (*C.uchar)(unsafe.Pointer(&sigbuf[0])), (*C.uchar)(unsafe.Pointer(&msgbuf[0])), &xonly[0], C.size_t(n)) == 1
+}
+
+// schnorrAggInputs parses the x-only public keys and packs the messages of an
+// aggregate signature for the C library. Both have room for one more entry,
+// so that there is a first element to point to when there are no signatures.
+func schnorrAggInputs(pubkeys, msgs [][]byte) ([]C.secp256k1_xonly_pubkey, []byte, error) {
+	n := len(pubkeys)
+	if len(msgs) != n {
+		return nil, nil, ErrBatchLen
+	}
+	var (
+		xonly  = make([]C.secp256k1_xonly_pubkey, n+1)
+		msgbuf = make([]byte, 32*(n+1))
+	)
+	for i := 0; i < n; i++ {
+		if len(msgs[i]) != 32 {
+			return nil, nil, ErrInvalidMsgLen
+		}
+		if len(pubkeys[i]) != 32 || C.secp256k1_xonly_pubkey_parse(context, &xonly[i], (*C.uchar)(unsafe.Pointer(&pubkeys[i][0]))) != 1 {
+			return nil, nil, ErrInvalidPubkey
+		}
+		copy(msgbuf[32*i:], msgs[i])
+	}
+	return xonly, msgbuf, nil
+}
+
+// SchnorrAggregate half-aggregates the BIP340 signatures signatures[i] of
+// msgs[i] by pubkeys[i] into one signature of 32*(n+1) bytes, which
+// SchnorrAggVerify checks against the same keys and messages in the same
+// order. The signatures are not verified.
+func SchnorrAggregate(pubkeys, msgs, signatures [][]byte) ([]byte, error) {
+	n := len(signatures)
+	if len(pubkeys) != n {
+		return nil, ErrBatchLen
+	}
+	xonly, msgbuf, err := schnorrAggInputs(pubkeys, msgs)
+	if err != nil {
+		return nil, err
+	}
+	sigbuf := make([]byte, 64*(n+1))
+	for i, sig := range signatures {
+		if len(sig) != 64 {
+			return nil, ErrInvalidSignatureLen
+		}
+		copy(sigbuf[64*i:], sig)
+	}
+	var (
+		aggsig    = make([]byte, 32*(n+1))
+		aggsigLen = C.size_t(len(aggsig))
+	)
+	if C.secp256k1_schnorrsig_aggregate(context, (*C.uchar)(unsafe.Pointer(&aggsig[0])), &aggsigLen, &xonly[0], (*C.uchar)(unsafe.Pointer(&msgbuf[0])), (*C.uchar)(unsafe.Pointer(&sigbuf[0])), C.size_t(n)) != 1 {
+		return nil, ErrInvalidSchnorrSig
+	}
+	return aggsig, nil
+}
+
+// SchnorrAggVerify reports whether aggsig is the half-aggregate of valid
+// signatures of msgs[i] by pubkeys[i] for every i. It costs a little more than
+// SchnorrVerifyBatch on the original signatures, which take twice the space.
+func SchnorrAggVerify(pubkeys, msgs [][]byte, aggsig []byte) bool {
+	n := len(pubkeys)
+	if len(aggsig) != 32*(n+1) {
+		return false
+	}
+	xonly, msgbuf, err := schnorrAggInputs(pubkeys, msgs)
+	if err != nil {
+		return false
+	}
+	return C.secp256k1_schnorrsig_aggverify(context, &xonly[0], (*C.uchar)(unsafe.Pointer(&msgbuf[0])), C.size_t(n), (*C.uchar)(unsafe.Pointer(&aggsig[0])), C.size_t(len(aggsig))) == 1
+}
@@ -11,6 +11,8 @@ package secp256k1
 /*
 #cgo CFLAGS: -I./libsecp256k1
 #cgo CFLAGS: -I./libsecp256k1/src/
+#cgo libsecp256k1_stats CFLAGS: -DENABLE_STATS
+#cgo libsecp256k1_usdt CFLAGS: -DENABLE_USDT
 
 #ifdef __SIZEOF_INT128__
 #  define HAVE___INT128
@@ -21,13 +23,27 @@ package secp256k1
 #  define USE_SCALAR_8X32
 #endif
 
+#ifdef __GNUC__
+#  define HAVE_BUILTIN_PREFETCH
+#  define HAVE_ATOMIC_BUILTINS
+#endif
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+#  define HAVE_AVX2_DISPATCH
+#endif
+
 #define USE_ENDOMORPHISM
 #define USE_NUM_NONE
 #define USE_FIELD_INV_BUILTIN
 #define USE_SCALAR_INV_BUILTIN
 #define NDEBUG
 #include "./libsecp256k1/src/secp256k1.c"
+#include "./libsecp256k1/src/modules/ecdh/main_impl.h"
 #include "./libsecp256k1/src/modules/recovery/main_impl.h"
+#include "./libsecp256k1/src/modules/sigcache/main_impl.h"
+#include "./libsecp256k1/src/modules/noncepool/main_impl.h"
+#include "./libsecp256k1/src/modules/schnorrsig/main_impl.h"
+#include "./libsecp256k1/src/modules/musig/main_impl.h"
+#include "./libsecp256k1/src/modules/schnorrsig_halfagg/main_impl.h"
 #include "ext.h"
 
 typedef void (*callbackFunc) (const char* msg, void* data);
@@ -45,12 +61,20 @@ import (
 var context *C.secp256k1_context
 
 func init() {
-	// around 20 ms on a modern CPU.
+	// The tables take around 20 ms to build on a modern CPU, and are built
+	// by the first call that needs them, or by Warmup.
 	context = C.secp256k1_context_create_sign_verify()
 	C.secp256k1_context_set_illegal_callback(context, C.callbackFunc(C.secp256k1GoPanicIllegal), nil)
 	C.secp256k1_context_set_error_callback(context, C.callbackFunc(C.secp256k1GoPanicError), nil)
 }
 
+// Warmup builds the signing and verification tables now rather than on first
+// use, for callers that would rather not pay for them in the latency of their
+// first signature. It is safe to call concurrently with everything else.
+func Warmup() {
+	C.secp256k1_context_warmup(context)
+}
+
 var (
 	ErrInvalidMsgLen       = errors.New("invalid message length, need 32 bytes")
 	ErrInvalidSignatureLen = errors.New("invalid signature length")
@@ -59,6 +83,7 @@ var (
 	ErrInvalidPubkey       = errors.New("invalid public key")
 	ErrSignFailed          = errors.New("signing failed")
 	ErrRecoverFailed       = errors.New("recovery failed")
+	ErrBatchLen            = errors.New("number of messages and keys differ")
 )
 
 // Sign creates a recoverable ECDSA signature.
@@ -98,6 +123,58 @@ func Sign(msg, seckey []byte) ([]byte, error) {
 	return sig, nil
 }
 
+// SignBatch signs msgs[i] with seckeys[i] for every i, giving the same
+// signatures as Sign. Signing a batch saves about a third of the time per
+// signature, as all signatures share two modular inversions.
+func SignBatch(msgs, seckeys [][]byte) ([][]byte, error) {
+	if len(msgs) != len(seckeys) {
+		return nil, ErrBatchLen
+	}
+	n := len(msgs)
+	if n == 0 {
+		return [][]byte{}, nil
+	}
+	msgbuf := make([]byte, 32*n)
+	keybuf := make([]byte, 32*n)
+	defer func() {
+		for i := range keybuf {
+			keybuf[i] = 0
+		}
+	}()
+	for i := range msgs {
+		if len(msgs[i]) != 32 {
+			return nil, ErrInvalidMsgLen
+		}
+		if len(seckeys[i]) != 32 {
+			return nil, ErrInvalidKey
+		}
+		copy(msgbuf[32*i:], msgs[i])
+		copy(keybuf[32*i:], seckeys[i])
+	}
+
+	var (
+		msgdata    = (*C.uchar)(unsafe.Pointer(&msgbuf[0]))
+		keydata    = (*C.uchar)(unsafe.Pointer(&keybuf[0]))
+		noncefunc  = C.secp256k1_nonce_function_rfc6979
+		sigstructs = make([]C.secp256k1_ecdsa_recoverable_signature, n)
+	)
+	// The RFC6979 nonce function does not fail, so only an invalid key can.
+	if C.secp256k1_ecdsa_sign_recoverable_batch(context, &sigstructs[0], msgdata, keydata, C.size_t(n), noncefunc, nil) == 0 {
+		return nil, ErrInvalidKey
+	}
+
+	sigs := make([][]byte, n)
+	buf := make([]byte, 65*n)
+	for i := range sigs {
+		var recid C.int
+		sig := buf[65*i : 65*(i+1) : 65*(i+1)]
+		C.secp256k1_ecdsa_recoverable_signature_serialize_compact(context, (*C.uchar)(unsafe.Pointer(&sig[0])), &recid, &sigstructs[i])
+		sig[64] = byte(recid) // add back recid to get 65 bytes sig
+		sigs[i] = sig
+	}
+	return sigs, nil
+}
+
 // RecoverPubkey returns the public key of the signer.
 // msg must be the 32-byte hash of the message to be signed.
 // sig must be a 65-byte compact ECDSA signature containing the
@@ -12,9 +12,16 @@ import (
 	"crypto/ecdsa"
 	"crypto/elliptic"
 	"crypto/rand"
+	"encoding/binary"
 	"encoding/hex"
 	"errors"
 	"io"
+	"math/big"
+	"os"
+	"path/filepath"
+	"runtime"
+	"sync"
+	"sync/atomic"
 	"testing"
 )
 
@@ -65,6 +72,33 @@ func compactSigCheck(t *testing.T, sig []byte) {
 	}
 }
 
+// TestWarmup comes first, so that the lazily built tables of the context are
+// built by whichever of these goroutines needs them first.
+func TestWarmup(t *testing.T) {
+	pubkey, seckey := generateKeyPair()
+	msg := csprngEntropy(32)
+	var wg sync.WaitGroup
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			if i%2 == 0 {
+				Warmup()
+			}
+			sig, err := Sign(msg, seckey)
+			if err != nil {
+				t.Error(err)
+				return
+			}
+			if !VerifySignature(pubkey, msg, sig[:64]) {
+				t.Error("signature does not verify")
+			}
+		}(i)
+	}
+	wg.Wait()
+	Warmup()
+}
+
 func TestSignatureValidity(t *testing.T) {
 	pubkey, seckey := generateKeyPair()
 	msg := csprngEntropy(32)
@@ -222,6 +256,629 @@ func TestRecoverSanity(t *testing.T) {
 	}
 }
 
+func TestSignBatch(t *testing.T) {
+	// Enough signatures to span several of the library's internal chunks.
+	msgs := make([][]byte, 100)
+	seckeys := make([][]byte, len(msgs))
+	for i := range msgs {
+		_, seckeys[i] = generateKeyPair()
+		msgs[i] = csprngEntropy(32)
+	}
+	sigs, err := SignBatch(msgs, seckeys)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for i := range msgs {
+		sig, err := Sign(msgs[i], seckeys[i])
+		if err != nil {
+			t.Fatal(err)
+		}
+		if !bytes.Equal(sig, sigs[i]) {
+			t.Fatalf("signature %d differs from Sign's", i)
+		}
+	}
+
+	if _, err := SignBatch(msgs, seckeys[1:]); !errors.Is(err, ErrBatchLen) {
+		t.Fatalf("got %v, want %q", err, ErrBatchLen)
+	}
+	seckeys[7] = make([]byte, 32)
+	if _, err := SignBatch(msgs, seckeys); !errors.Is(err, ErrInvalidKey) {
+		t.Fatalf("got %v, want %q", err, ErrInvalidKey)
+	}
+}
+
+func TestSchnorr(t *testing.T) {
+	// BIP340 test vector 0 fixes the key derivation.
+	seckey, _ := hex.DecodeString("0000000000000000000000000000000000000000000000000000000000000003")
+	want, _ := hex.DecodeString("F9308A019258C31049344F85F89D5229B531C845836F99B08601F113BCE036F9")
+	pubkey, err := SchnorrPubkey(seckey)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if !bytes.Equal(pubkey, want) {
+		t.Fatalf("got pubkey %x, want %x", pubkey, want)
+	}
+
+	n := 100
+	pubkeys := make([][]byte, n)
+	msgs := make([][]byte, n)
+	sigs := make([][]byte, n)
+	for i := range msgs {
+		_, seckey = generateKeyPair()
+		if pubkeys[i], err = SchnorrPubkey(seckey); err != nil {
+			t.Fatal(err)
+		}
+		msgs[i] = csprngEntropy(32)
+		if sigs[i], err = SchnorrSign(msgs[i], seckey); err != nil {
+			t.Fatal(err)
+		}
+		if !SchnorrVerify(pubkeys[i], msgs[i], sigs[i]) {
+			t.Fatalf("signature %d does not verify", i)
+		}
+	}
+	if !SchnorrVerifyBatch(pubkeys, msgs, sigs) {
+		t.Fatal("batch does not verify")
+	}
+	if !SchnorrVerifyBatch(nil, nil, nil) {
+		t.Fatal("empty batch does not verify")
+	}
+	if SchnorrVerifyBatch(pubkeys, msgs[1:], sigs) {
+		t.Fatal("batch with too few messages verifies")
+	}
+
+	sigs[42][10] ^= 1
+	if SchnorrVerify(pubkeys[42], msgs[42], sigs[42]) {
+		t.Fatal("corrupted signature verifies")
+	}
+	if SchnorrVerifyBatch(pubkeys, msgs, sigs) {
+		t.Fatal("batch with a corrupted signature verifies")
+	}
+	sigs[42][10] ^= 1
+	msgs[7], msgs[8] = msgs[8], msgs[7]
+	if SchnorrVerifyBatch(pubkeys, msgs, sigs) {
+		t.Fatal("batch with swapped messages verifies")
+	}
+
+	if _, err := SchnorrSign(msgs[0][1:], seckey); !errors.Is(err, ErrInvalidMsgLen) {
+		t.Fatalf("got %v, want %q", err, ErrInvalidMsgLen)
+	}
+	if _, err := SchnorrSign(msgs[0], make([]byte, 32)); !errors.Is(err, ErrInvalidKey) {
+		t.Fatalf("got %v, want %q", err, ErrInvalidKey)
+	}
+}
+
+func TestSchnorrAggregate(t *testing.T) {
+	// More signatures than fit one multi-multiplication.
+	n := 100
+	pubkeys := make([][]byte, n)
+	msgs := make([][]byte, n)
+	sigs := make([][]byte, n)
+	for i := range msgs {
+		_, seckey := generateKeyPair()
+		pubkeys[i], _ = SchnorrPubkey(seckey)
+		msgs[i] = csprngEntropy(32)
+		sigs[i], _ = SchnorrSign(msgs[i], seckey)
+	}
+	aggsig, err := SchnorrAggregate(pubkeys, msgs, sigs)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(aggsig) != 32*(n+1) {
+		t.Fatalf("got %d bytes, want %d", len(aggsig), 32*(n+1))
+	}
+	if !SchnorrAggVerify(pubkeys, msgs, aggsig) {
+		t.Fatal("aggregate does not verify")
+	}
+	if empty, err := SchnorrAggregate(nil, nil, nil); err != nil || !SchnorrAggVerify(nil, nil, empty) {
+		t.Fatal("empty aggregate does not verify")
+	}
+
+	msgs[7], msgs[8] = msgs[8], msgs[7]
+	if SchnorrAggVerify(pubkeys, msgs, aggsig) {
+		t.Fatal("aggregate with swapped messages verifies")
+	}
+	msgs[7], msgs[8] = msgs[8], msgs[7]
+	if SchnorrAggVerify(pubkeys[1:], msgs[1:], aggsig[32:]) {
+		t.Fatal("aggregate without its first signature verifies")
+	}
+	sigs[42][40] ^= 1
+	if aggsig, err = SchnorrAggregate(pubkeys, msgs, sigs); err != nil {
+		t.Fatal(err)
+	}
+	if SchnorrAggVerify(pubkeys, msgs, aggsig) {
+		t.Fatal("aggregate of a corrupted signature verifies")
+	}
+
+	if _, err := SchnorrAggregate(pubkeys, msgs[1:], sigs); !errors.Is(err, ErrBatchLen) {
+		t.Fatalf("got %v, want %q", err, ErrBatchLen)
+	}
+	copy(sigs[42][32:], bytes.Repeat([]byte{0xFF}, 32))
+	if _, err := SchnorrAggregate(pubkeys, msgs, sigs); !errors.Is(err, ErrInvalidSchnorrSig) {
+		t.Fatalf("got %v, want %q", err, ErrInvalidSchnorrSig)
+	}
+}
+
+func TestMusig(t *testing.T) {
+	// An 8-of-8 account; the second signer holds two of the keys.
+	n := 8
+	seckeys := make([][]byte, n)
+	pubkeys := make([][]byte, n)
+	for i := range seckeys {
+		if i == 2 {
+			seckeys[i], pubkeys[i] = seckeys[1], pubkeys[1]
+			continue
+		}
+		var pubkey []byte
+		pubkey, seckeys[i] = generateKeyPair()
+		pubkeys[i] = CompressPubkey(new(big.Int).SetBytes(pubkey[1:33]), new(big.Int).SetBytes(pubkey[33:]))
+	}
+	key, err := NewMusigKey(pubkeys)
+	if err != nil {
+		t.Fatal(err)
+	}
+	msg := csprngEntropy(32)
+
+	nonces := make([]*MusigNonce, n)
+	pubnonces := make([][]byte, n)
+	for i := range nonces {
+		if nonces[i], err = key.NewNonce(seckeys[i], msg); err != nil {
+			t.Fatal(err)
+		}
+		pubnonces[i] = nonces[i].PubNonce
+	}
+	session, err := key.NewSession(pubnonces, msg)
+	if err != nil {
+		t.Fatal(err)
+	}
+	psigs := make([][]byte, n)
+	for i := range psigs {
+		if psigs[i], err = session.PartialSign(nonces[i], seckeys[i]); err != nil {
+			t.Fatal(err)
+		}
+		if !session.PartialVerify(psigs[i], pubnonces[i], pubkeys[i]) {
+			t.Fatalf("partial signature %d does not verify", i)
+		}
+	}
+	if _, err := session.PartialSign(nonces[0], seckeys[0]); !errors.Is(err, ErrMusigNonceUsed) {
+		t.Fatalf("got %v, want %q", err, ErrMusigNonceUsed)
+	}
+	sig, err := session.Aggregate(psigs)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if !SchnorrVerify(key.PubKey(), msg, sig) {
+		t.Fatal("aggregated signature does not verify")
+	}
+
+	psigs[3][31] ^= 1
+	if session.PartialVerify(psigs[3], pubnonces[3], pubkeys[3]) {
+		t.Fatal("corrupted partial signature verifies")
+	}
+	if sig, err = session.Aggregate(psigs); err != nil {
+		t.Fatal(err)
+	}
+	if SchnorrVerify(key.PubKey(), msg, sig) {
+		t.Fatal("signature with a corrupted part verifies")
+	}
+
+	// The same keys in another order make another key.
+	pubkeys[0], pubkeys[1] = pubkeys[1], pubkeys[0]
+	other, err := NewMusigKey(pubkeys)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if bytes.Equal(other.PubKey(), key.PubKey()) {
+		t.Fatal("key order does not matter")
+	}
+	pubkeys[0] = pubkeys[0][1:]
+	if _, err := NewMusigKey(pubkeys); !errors.Is(err, ErrInvalidMusigKeys) {
+		t.Fatalf("got %v, want %q", err, ErrInvalidMusigKeys)
+	}
+	if _, err := key.NewSession(pubnonces[:0], msg); !errors.Is(err, ErrInvalidMusigNonce) {
+		t.Fatalf("got %v, want %q", err, ErrInvalidMusigNonce)
+	}
+}
+
+func TestMusigNonceRace(t *testing.T) {
+	// Goroutines racing to sign with one nonce, each in a session of its
+	// own, get one partial signature between them.
+	pubkey, seckey := generateKeyPair()
+	key, err := NewMusigKey([][]byte{CompressPubkey(new(big.Int).SetBytes(pubkey[1:33]), new(big.Int).SetBytes(pubkey[33:]))})
+	if err != nil {
+		t.Fatal(err)
+	}
+	msg := csprngEntropy(32)
+	nonce, err := key.NewNonce(seckey, msg)
+	if err != nil {
+		t.Fatal(err)
+	}
+	const racers = 8
+	sessions := make([]*MusigSession, racers)
+	for i := range sessions {
+		other, err := key.NewNonce(seckey, msg)
+		if err != nil {
+			t.Fatal(err)
+		}
+		// Fold in another nonce so that every session is a different one.
+		if i > 0 {
+			sessions[i], err = key.NewSession([][]byte{nonce.PubNonce, other.PubNonce}, msg)
+		} else {
+			sessions[i], err = key.NewSession([][]byte{nonce.PubNonce}, msg)
+		}
+		if err != nil {
+			t.Fatal(err)
+		}
+	}
+
+	var (
+		wg     sync.WaitGroup
+		signed atomic.Int32
+		errs   = make([]error, racers)
+	)
+	for i := range sessions {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			if _, err := sessions[i].PartialSign(nonce, seckey); err == nil {
+				signed.Add(1)
+			} else {
+				errs[i] = err
+			}
+		}(i)
+	}
+	wg.Wait()
+	if signed.Load() != 1 {
+		t.Fatalf("one nonce made %d partial signatures", signed.Load())
+	}
+	for i, err := range errs {
+		if err != nil && !errors.Is(err, ErrMusigNonceUsed) {
+			t.Fatalf("racer %d: got %v, want %q", i, err, ErrMusigNonceUsed)
+		}
+	}
+}
+
+func TestNoncePool(t *testing.T) {
+	if _, err := NewNoncePool(0, 1); !errors.Is(err, ErrInvalidNoncePoolSize) {
+		t.Fatalf("got %v, want %q", err, ErrInvalidNoncePoolSize)
+	}
+	pool, err := NewNoncePool(64, 2)
+	if err != nil {
+		t.Fatal(err)
+	}
+	pubkey, seckey := generateKeyPair()
+	msg := csprngEntropy(32)
+	// More signatures than the pool holds, so that some fall back to Sign
+	// while the workers refill it. Every one must recover to the key, and
+	// no two pooled ones may share a nonce.
+	seen := make(map[string]bool)
+	for i := 0; i < 200; i++ {
+		sig, err := pool.Sign(msg, seckey)
+		if err != nil {
+			t.Fatal(err)
+		}
+		compactSigCheck(t, sig)
+		recovered, err := RecoverPubkey(msg, sig)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if !bytes.Equal(pubkey, recovered) {
+			t.Fatalf("signature %d recovers to the wrong key", i)
+		}
+		if r := string(sig[:32]); seen[r] {
+			if det, _ := Sign(msg, seckey); !bytes.Equal(sig, det) {
+				t.Fatalf("nonce of signature %d reused", i)
+			}
+		} else {
+			seen[r] = true
+		}
+	}
+	if _, err := pool.Sign(msg, make([]byte, 32)); !errors.Is(err, ErrInvalidKey) {
+		t.Fatalf("got %v, want %q", err, ErrInvalidKey)
+	}
+
+	pool.Close()
+	pool.Close()
+	sig, err := pool.Sign(msg, seckey)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if det, _ := Sign(msg, seckey); !bytes.Equal(sig, det) {
+		t.Fatal("closed pool does not fall back to Sign")
+	}
+}
+
+func TestSigCache(t *testing.T) {
+	if _, err := NewSigCache(MinSigCacheSize - 1); !errors.Is(err, ErrInvalidSigCacheSize) {
+		t.Fatalf("got %v, want %q", err, ErrInvalidSigCacheSize)
+	}
+	cache, err := NewSigCache(16 * 32)
+	if err != nil {
+		t.Fatal(err)
+	}
+	// More signatures than the cache holds, each checked twice, so that both
+	// hits and evictions happen: results must match the uncached ones.
+	for i := 0; i < 64; i++ {
+		pubkey, seckey := generateKeyPair()
+		msg := csprngEntropy(32)
+		sig, err := Sign(msg, seckey)
+		if err != nil {
+			t.Fatalf("signature error: %s", err)
+		}
+		for j := 0; j < 2; j++ {
+			if !cache.VerifySignature(pubkey, msg, sig[:64]) {
+				t.Fatalf("valid signature %d rejected on pass %d", i, j)
+			}
+		}
+		msg[0] ^= 1
+		for j := 0; j < 2; j++ {
+			if cache.VerifySignature(pubkey, msg, sig[:64]) {
+				t.Fatalf("invalid signature %d accepted on pass %d", i, j)
+			}
+		}
+	}
+}
+
+func TestPubkeyCache(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "pubkeys")
+	cache, err := OpenPubkeyCache(path, 1024)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if runtime.GOOS != "windows" {
+		// The file is locked against a second cache appending to it, or
+		// rewriting what the first one already checked.
+		if _, err := OpenPubkeyCache(path, 1024); !errors.Is(err, ErrPubkeyCacheLocked) {
+			t.Fatalf("second open: got %v, want %q", err, ErrPubkeyCacheLocked)
+		}
+	}
+	type signed struct{ pubkey, msg, sig []byte }
+	var sigs []signed
+	for i := 0; i < 8; i++ {
+		pubkey, seckey := generateKeyPair()
+		x, y := S256().Unmarshal(pubkey)
+		msg := csprngEntropy(32)
+		sig, err := Sign(msg, seckey)
+		if err != nil {
+			t.Fatalf("signature error: %s", err)
+		}
+		sigs = append(sigs, signed{CompressPubkey(x, y), msg, sig[:64]})
+	}
+	check := func(cache *PubkeyCache, sc *SigCache) {
+		t.Helper()
+		for i, s := range sigs {
+			if !cache.VerifySignature(sc, s.pubkey, s.msg, s.sig) {
+				t.Fatalf("valid signature %d rejected", i)
+			}
+			s.msg[0] ^= 1
+			if cache.VerifySignature(sc, s.pubkey, s.msg, s.sig) {
+				t.Fatalf("invalid signature %d accepted", i)
+			}
+			s.msg[0] ^= 1
+		}
+	}
+	check(cache, nil)
+	if cache.Len() != len(sigs) {
+		t.Fatalf("cache holds %d keys, want %d", cache.Len(), len(sigs))
+	}
+	if err := cache.Close(); err != nil {
+		t.Fatal(err)
+	}
+
+	// The keys are read back from the file.
+	sc, err := NewSigCache(1024 * 32)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if cache, err = OpenPubkeyCache(path, 1024); err != nil {
+		t.Fatal(err)
+	}
+	if cache.Len() != len(sigs) {
+		t.Fatalf("reopened cache holds %d keys, want %d", cache.Len(), len(sigs))
+	}
+	check(cache, sc)
+	cache.Close()
+
+	// A damaged record cuts the file short; whatever comes after is parsed
+	// again as needed.
+	data, err := os.ReadFile(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	data[pubkeyCacheHeaderSize+3*pubkeyCacheRecordSize+40] ^= 1
+	if err := os.WriteFile(path, data, 0o600); err != nil {
+		t.Fatal(err)
+	}
+	if cache, err = OpenPubkeyCache(path, 1024); err != nil {
+		t.Fatal(err)
+	}
+	if cache.Len() != 3 {
+		t.Fatalf("cache holds %d keys after damage, want 3", cache.Len())
+	}
+	check(cache, nil)
+	if cache.Len() != len(sigs) {
+		t.Fatalf("cache holds %d keys, want %d", cache.Len(), len(sigs))
+	}
+	cache.Close()
+
+	// A file from elsewhere is started over.
+	copy(data, "NOTACACHE")
+	if err := os.WriteFile(path, data, 0o600); err != nil {
+		t.Fatal(err)
+	}
+	if cache, err = OpenPubkeyCache(path, 1024); err != nil {
+		t.Fatal(err)
+	}
+	if cache.Len() != 0 {
+		t.Fatalf("cache holds %d keys from a foreign file", cache.Len())
+	}
+	check(cache, nil)
+
+	// A key that only comes with invalid signatures is not kept.
+	pubkey, _ := generateKeyPair()
+	x, y := S256().Unmarshal(pubkey)
+	if cache.VerifySignature(nil, CompressPubkey(x, y), sigs[0].msg, sigs[0].sig) {
+		t.Fatal("signature accepted under the wrong key")
+	}
+	if cache.Len() != len(sigs) {
+		t.Fatalf("cache holds %d keys after a failed verification, want %d", cache.Len(), len(sigs))
+	}
+	cache.Close()
+
+	// A smaller limit cuts the file short, and a full cache still verifies.
+	if _, err := OpenPubkeyCache(path, 0); err != ErrInvalidPubkeyCacheSize {
+		t.Fatalf("empty pubkey cache: got %v, want %v", err, ErrInvalidPubkeyCacheSize)
+	}
+	if cache, err = OpenPubkeyCache(path, 5); err != nil {
+		t.Fatal(err)
+	}
+	if cache.Len() != 5 {
+		t.Fatalf("cache holds %d keys, want its limit of 5", cache.Len())
+	}
+	check(cache, nil)
+	if cache.Len() != 5 {
+		t.Fatalf("full cache grew to %d keys", cache.Len())
+	}
+	cache.Close()
+	if st, err := os.Stat(path); err != nil {
+		t.Fatal(err)
+	} else if st.Size() != pubkeyCacheHeaderSize+5*pubkeyCacheRecordSize {
+		t.Fatalf("cache file is %d bytes, want %d", st.Size(), pubkeyCacheHeaderSize+5*pubkeyCacheRecordSize)
+	}
+}
+
+func TestECDH(t *testing.T) {
+	pub1, sec1 := generateKeyPair()
+	pub2, sec2 := generateKeyPair()
+	s1, err := ECDH(pub2, sec1)
+	if err != nil {
+		t.Fatal(err)
+	}
+	x, y := elliptic.Unmarshal(S256(), pub1) //nolint:staticcheck // crypto will be refactored soon.
+	s2, err := ECDH(CompressPubkey(x, y), sec2)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if !bytes.Equal(s1, s2) {
+		t.Fatalf("shared secrets differ: %x != %x", s1, s2)
+	}
+
+	pubkeys := make([][]byte, 70)
+	for i := range pubkeys {
+		pubkeys[i], _ = generateKeyPair()
+	}
+	secrets, err := ECDHBatch(pubkeys, sec1)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for i := range pubkeys {
+		want, err := ECDH(pubkeys[i], sec1)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if !bytes.Equal(secrets[i], want) {
+			t.Fatalf("secret %d: %x != %x", i, secrets[i], want)
+		}
+	}
+
+	if _, err := ECDH(pub2, make([]byte, 32)); err != ErrInvalidKey {
+		t.Fatalf("zero key: got %v, want %v", err, ErrInvalidKey)
+	}
+	if _, err := ECDHBatch(pubkeys, make([]byte, 32)); err != ErrInvalidKey {
+		t.Fatalf("zero key: got %v, want %v", err, ErrInvalidKey)
+	}
+	pubkeys[3] = pubkeys[3][:10]
+	if _, err := ECDHBatch(pubkeys, sec1); err != ErrInvalidPubkey {
+		t.Fatalf("bad public key: got %v, want %v", err, ErrInvalidPubkey)
+	}
+}
+
+func TestCombinePubkeys(t *testing.T) {
+	// Enough keys to be split between goroutines, in both formats.
+	pubkeys := make([][]byte, 3*combineChunk+1)
+	negated := make([][]byte, len(pubkeys))
+	x, y := new(big.Int), new(big.Int)
+	for i := range pubkeys {
+		pubkeys[i], _ = generateKeyPair()
+		px, py := elliptic.Unmarshal(S256(), pubkeys[i]) //nolint:staticcheck // crypto will be refactored soon.
+		x, y = S256().Add(x, y, px, py)
+		if i%2 == 1 {
+			pubkeys[i] = CompressPubkey(px, py)
+		}
+		negated[i] = CompressPubkey(px, new(big.Int).Sub(S256().P, py))
+	}
+	sum, err := CombinePubkeys(pubkeys)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if want := CompressPubkey(x, y); !bytes.Equal(sum, want) {
+		t.Fatalf("sum: %x != %x", sum, want)
+	}
+
+	if _, err := CombinePubkeys(append(pubkeys, negated...)); err != ErrPubkeySumInfinity {
+		t.Fatalf("keys and their negations: got %v, want %v", err, ErrPubkeySumInfinity)
+	}
+	if _, err := CombinePubkeys(append(pubkeys, pubkeys[0][:10])); err != ErrInvalidPubkey {
+		t.Fatalf("bad public key: got %v, want %v", err, ErrInvalidPubkey)
+	}
+}
+
+func TestPrecomputedPoint(t *testing.T) {
+	pubkey, _ := generateKeyPair()
+	p, err := NewPrecomputedPoint(pubkey)
+	if err != nil {
+		t.Fatal(err)
+	}
+	x, y := elliptic.Unmarshal(S256(), pubkey) //nolint:staticcheck // crypto will be refactored soon.
+	for i := 0; i < 100; i++ {
+		_, seckey := generateKeyPair()
+		want, err := ECDH(pubkey, seckey)
+		if err != nil {
+			t.Fatal(err)
+		}
+		got, err := p.ECDH(seckey)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if !bytes.Equal(got, want) {
+			t.Fatalf("ECDH: %x != %x", got, want)
+		}
+		wx, wy := S256().ScalarMult(x, y, seckey)
+		point, err := p.Mul(seckey)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if !bytes.Equal(point, elliptic.Marshal(S256(), wx, wy)) { //nolint:staticcheck // crypto will be refactored soon.
+			t.Fatalf("Mul: %x != (%x, %x)", point, wx, wy)
+		}
+	}
+	if _, err := p.ECDH(make([]byte, 32)); err != ErrInvalidKey {
+		t.Fatalf("zero key: got %v, want %v", err, ErrInvalidKey)
+	}
+	if _, err := NewPrecomputedPoint(pubkey[:10]); err != ErrInvalidPubkey {
+		t.Fatalf("bad public key: got %v, want %v", err, ErrInvalidPubkey)
+	}
+}
+
+func TestScalarMultX(t *testing.T) {
+	curve := S256()
+	for i := 0; i < TestCount; i++ {
+		_, seckey := generateKeyPair()
+		key, _ := ecdsa.GenerateKey(curve, rand.Reader)
+		wantX, _ := curve.ScalarMult(key.X, key.Y, seckey)
+		if x := curve.ScalarMultX(key.X, seckey); x == nil || x.Cmp(wantX) != 0 {
+			t.Fatalf("ScalarMultX = %v, want %v", x, wantX)
+		}
+	}
+
+	_, seckey := generateKeyPair()
+	if x := curve.ScalarMultX(big.NewInt(5), seckey); x != nil {
+		t.Fatal("ScalarMultX accepted an X coordinate that is not on the curve")
+	}
+	if x := curve.ScalarMultX(curve.Gx, make([]byte, 32)); x != nil {
+		t.Fatal("ScalarMultX accepted a zero scalar")
+	}
+}
+
 func BenchmarkSign(b *testing.B) {
 	_, seckey := generateKeyPair()
 	msg := csprngEntropy(32)
@@ -235,6 +892,165 @@ func BenchmarkSign(b *testing.B) {
 	}
 }
 
+func BenchmarkSignBatch(b *testing.B) {
+	msgs := make([][]byte, 100)
+	seckeys := make([][]byte, len(msgs))
+	for i := range msgs {
+		_, seckeys[i] = generateKeyPair()
+		msgs[i] = csprngEntropy(32)
+	}
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i += len(msgs) {
+		if _, err := SignBatch(msgs, seckeys); err != nil {
+			panic(err)
+		}
+	}
+}
+
+func BenchmarkSignPooled(b *testing.B) {
+	_, seckey := generateKeyPair()
+	msg := csprngEntropy(32)
+	pool, err := NewNoncePool(4096, 4)
+	if err != nil {
+		b.Fatal(err)
+	}
+	defer pool.Close()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		if _, err := pool.Sign(msg, seckey); err != nil {
+			panic(err)
+		}
+	}
+}
+
+func BenchmarkSchnorrVerify(b *testing.B) {
+	_, seckey := generateKeyPair()
+	pubkey, _ := SchnorrPubkey(seckey)
+	msg := csprngEntropy(32)
+	sig, _ := SchnorrSign(msg, seckey)
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		if !SchnorrVerify(pubkey, msg, sig) {
+			panic("signature does not verify")
+		}
+	}
+}
+
+func BenchmarkSchnorrVerifyBatch(b *testing.B) {
+	pubkeys := make([][]byte, 64)
+	msgs := make([][]byte, len(pubkeys))
+	sigs := make([][]byte, len(pubkeys))
+	for i := range pubkeys {
+		_, seckey := generateKeyPair()
+		pubkeys[i], _ = SchnorrPubkey(seckey)
+		msgs[i] = csprngEntropy(32)
+		sigs[i], _ = SchnorrSign(msgs[i], seckey)
+	}
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i += len(sigs) {
+		if !SchnorrVerifyBatch(pubkeys, msgs, sigs) {
+			panic("batch does not verify")
+		}
+	}
+}
+
+func BenchmarkSchnorrAggVerify(b *testing.B) {
+	pubkeys := make([][]byte, 1024)
+	msgs := make([][]byte, len(pubkeys))
+	sigs := make([][]byte, len(pubkeys))
+	for i := range pubkeys {
+		_, seckey := generateKeyPair()
+		pubkeys[i], _ = SchnorrPubkey(seckey)
+		msgs[i] = csprngEntropy(32)
+		sigs[i], _ = SchnorrSign(msgs[i], seckey)
+	}
+	aggsig, _ := SchnorrAggregate(pubkeys, msgs, sigs)
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i += len(sigs) {
+		if !SchnorrAggVerify(pubkeys, msgs, aggsig) {
+			panic("aggregate does not verify")
+		}
+	}
+}
+
+func BenchmarkNewMusigKey(b *testing.B) {
+	pubkeys := make([][]byte, 11)
+	for i := range pubkeys {
+		pubkey, _ := generateKeyPair()
+		pubkeys[i] = CompressPubkey(new(big.Int).SetBytes(pubkey[1:33]), new(big.Int).SetBytes(pubkey[33:]))
+	}
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		if _, err := NewMusigKey(pubkeys); err != nil {
+			panic(err)
+		}
+	}
+}
+
+func BenchmarkECDHBatch(b *testing.B) {
+	pubkeys := make([][]byte, 100)
+	for i := range pubkeys {
+		pubkeys[i], _ = generateKeyPair()
+	}
+	_, seckey := generateKeyPair()
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i += len(pubkeys) {
+		if _, err := ECDHBatch(pubkeys, seckey); err != nil {
+			panic(err)
+		}
+	}
+}
+
+func BenchmarkCombinePubkeys(b *testing.B) {
+	pubkeys := make([][]byte, 1000)
+	for i := range pubkeys {
+		pub, _ := generateKeyPair()
+		pubkeys[i] = CompressPubkey(elliptic.Unmarshal(S256(), pub)) //nolint:staticcheck // crypto will be refactored soon.
+	}
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i += len(pubkeys) {
+		if _, err := CombinePubkeys(pubkeys); err != nil {
+			panic(err)
+		}
+	}
+}
+
+func BenchmarkPrecomputedECDH(b *testing.B) {
+	pubkey, seckey := generateKeyPair()
+	p, err := NewPrecomputedPoint(pubkey)
+	if err != nil {
+		b.Fatal(err)
+	}
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		if _, err := p.ECDH(seckey); err != nil {
+			panic(err)
+		}
+	}
+}
+
+func BenchmarkScalarMultX(b *testing.B) {
+	curve := S256()
+	_, seckey := generateKeyPair()
+	key, _ := ecdsa.GenerateKey(curve, rand.Reader)
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		if curve.ScalarMultX(key.X, seckey) == nil {
+			panic("ScalarMultX failed")
+		}
+	}
+}
+
 func BenchmarkRecover(b *testing.B) {
 	msg := csprngEntropy(32)
 	_, seckey := generateKeyPair()
@@ -248,3 +1064,76 @@ func BenchmarkRecover(b *testing.B) {
 		}
 	}
 }
+
+// Replay corpus as written by "bench_replay generate" (libsecp256k1/src/bench_replay.c):
+// a 16-byte header ("SECPRPLY", version, record count, both uint32 little
+// endian) followed by 130-byte records of compressed pubkey, digest and
+// [R || S || V] signature. The replay benchmarks run when
+// SECP256K1_REPLAY_CORPUS names such a file, e.g.
+//
+//	SECP256K1_REPLAY_CORPUS=/tmp/corpus.bin go test -run NONE -bench Replay
+const (
+	replayMagic      = "SECPRPLY"
+	replayVersion    = 1
+	replayHeaderSize = 16
+	replayRecordSize = 130
+)
+
+type replayRecord struct {
+	pubkey []byte // 33 bytes, compressed
+	msg    []byte // 32 bytes
+	sig    []byte // 65 bytes, [R || S || V]
+}
+
+func loadReplayCorpus(b *testing.B) []replayRecord {
+	b.Helper()
+	path := os.Getenv("SECP256K1_REPLAY_CORPUS")
+	if path == "" {
+		b.Skip("SECP256K1_REPLAY_CORPUS not set")
+	}
+	data, err := os.ReadFile(path)
+	if err != nil {
+		b.Fatal(err)
+	}
+	if len(data) < replayHeaderSize || string(data[:8]) != replayMagic || binary.LittleEndian.Uint32(data[8:]) != replayVersion {
+		b.Fatalf("%s is not a replay corpus", path)
+	}
+	n := int(binary.LittleEndian.Uint32(data[12:]))
+	if n == 0 || len(data) != replayHeaderSize+n*replayRecordSize {
+		b.Fatalf("%s: size does not match its %d records", path, n)
+	}
+	records := make([]replayRecord, n)
+	for i := range records {
+		rec := data[replayHeaderSize+i*replayRecordSize:][:replayRecordSize]
+		records[i] = replayRecord{pubkey: rec[:33], msg: rec[33:65], sig: rec[65:]}
+	}
+	return records
+}
+
+func BenchmarkReplayVerify(b *testing.B) {
+	records := loadReplayCorpus(b)
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		rec := &records[i%len(records)]
+		if !VerifySignature(rec.pubkey, rec.msg, rec.sig[:64]) {
+			b.Fatalf("record %d does not verify", i%len(records))
+		}
+	}
+}
+
+func BenchmarkReplayRecover(b *testing.B) {
+	records := loadReplayCorpus(b)
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		rec := &records[i%len(records)]
+		pubkey, err := RecoverPubkey(rec.msg, rec.sig)
+		if err != nil {
+			b.Fatal(err)
+		}
+		if !bytes.Equal(pubkey[1:33], rec.pubkey[1:]) {
+			b.Fatalf("record %d recovers to the wrong key", i%len(records))
+		}
+	}
+}
@@ -0,0 +1,68 @@
+//go:build !gofuzz && cgo
+// +build !gofuzz,cgo
+
+package secp256k1
+
+/*
+#include "libsecp256k1/include/secp256k1.h"
+#include "libsecp256k1/include/secp256k1_sigcache.h"
+
+extern int secp256k1_ext_ecdsa_verify_cached(const secp256k1_context* ctx, secp256k1_sigcache *cache, const unsigned char *sigdata, const unsigned char *msgdata, const unsigned char *pubkeydata, size_t pubkeylen);
+*/
+import "C"
+
+import (
+	"crypto/rand"
+	"errors"
+	"runtime"
+	"unsafe"
+)
+
+// MinSigCacheSize is the smallest table NewSigCache accepts, in bytes.
+const MinSigCacheSize = 4 * 32
+
+var (
+	ErrInvalidSigCacheSize = errors.New("signature cache size too small")
+	ErrSigCacheAlloc       = errors.New("cannot allocate signature cache")
+)
+
+// SigCache remembers signatures that passed verification, so that verifying
+// one again costs a hash lookup. It is safe for concurrent use.
+type SigCache struct {
+	cache *C.secp256k1_sigcache
+}
+
+// NewSigCache allocates a signature cache of size bytes (32 per entry),
+// keyed by a fresh random salt.
+func NewSigCache(size int) (*SigCache, error) {
+	if size < MinSigCacheSize {
+		return nil, ErrInvalidSigCacheSize
+	}
+	salt := make([]byte, 32)
+	if _, err := rand.Read(salt); err != nil {
+		return nil, err
+	}
+	cache := C.secp256k1_sigcache_create(context, C.size_t(size), (*C.uchar)(unsafe.Pointer(&salt[0])))
+	if cache == nil {
+		return nil, ErrSigCacheAlloc
+	}
+	c := &SigCache{cache: cache}
+	runtime.SetFinalizer(c, func(c *SigCache) {
+		C.secp256k1_sigcache_destroy(c.cache)
+	})
+	return c, nil
+}
+
+// VerifySignature is like the package level VerifySignature, but consults the
+// cache first and remembers the signature if it is valid.
+func (c *SigCache) VerifySignature(pubkey, msg, signature []byte) bool {
+	if len(msg) != 32 || len(signature) != 64 || len(pubkey) == 0 {
+		return false
+	}
+	sigdata := (*C.uchar)(unsafe.Pointer(&signature[0]))
+	msgdata := (*C.uchar)(unsafe.Pointer(&msg[0]))
+	keydata := (*C.uchar)(unsafe.Pointer(&pubkey[0]))
+	ok := C.secp256k1_ext_ecdsa_verify_cached(context, c.cache, sigdata, msgdata, keydata, C.size_t(len(pubkey))) != 0
+	runtime.KeepAlive(c)
+	return ok
+}
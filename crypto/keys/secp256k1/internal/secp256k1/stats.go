@@ -0,0 +1,18 @@
+//go:build !gofuzz && cgo
+// +build !gofuzz,cgo
+
+package secp256k1
+
+// Stats holds the operation counters of libsecp256k1 (secp256k1_stats), summed
+// over all threads since the process started.
+type Stats struct {
+	FieldMul    uint64 // field multiplications
+	FieldSqr    uint64 // field squarings
+	FieldInv    uint64 // field inversions
+	FieldSqrt   uint64 // field square roots (pubkey decompression, recovery)
+	ScalarInv   uint64 // scalar inversions
+	Ecmult      uint64 // a*P + b*G (verification, recovery)
+	EcmultConst uint64 // constant time a*P
+	EcmultGen   uint64 // a*G (signing, key generation)
+	Alloc       uint64 // heap allocations
+}
@@ -0,0 +1,13 @@
+//go:build !gofuzz && cgo && !libsecp256k1_stats
+// +build !gofuzz,cgo,!libsecp256k1_stats
+
+package secp256k1
+
+// StatsEnabled reports whether the library keeps operation counters, which
+// requires the libsecp256k1_stats build tag.
+const StatsEnabled = false
+
+// ReadStats returns the current operation counters, always zero in this build.
+func ReadStats() Stats {
+	return Stats{}
+}
@@ -0,0 +1,30 @@
+//go:build !gofuzz && cgo && libsecp256k1_stats
+// +build !gofuzz,cgo,libsecp256k1_stats
+
+package secp256k1
+
+/*
+#include "libsecp256k1/include/secp256k1_stats.h"
+*/
+import "C"
+
+// StatsEnabled reports whether the library keeps operation counters, which
+// requires the libsecp256k1_stats build tag.
+const StatsEnabled = true
+
+// ReadStats returns the current operation counters.
+func ReadStats() Stats {
+	var s C.secp256k1_stats
+	C.secp256k1_context_get_stats(context, &s)
+	return Stats{
+		FieldMul:    uint64(s.field_mul),
+		FieldSqr:    uint64(s.field_sqr),
+		FieldInv:    uint64(s.field_inv),
+		FieldSqrt:   uint64(s.field_sqrt),
+		ScalarInv:   uint64(s.scalar_inv),
+		Ecmult:      uint64(s.ecmult),
+		EcmultConst: uint64(s.ecmult_const),
+		EcmultGen:   uint64(s.ecmult_gen),
+		Alloc:       uint64(s.alloc),
+	}
+}
@@ -4,11 +4,51 @@
 package secp256k1
 
 import (
+	"sync/atomic"
+
 	"github.com/cometbft/cometbft/crypto"
 
 	"github.com/cosmos/cosmos-sdk/crypto/keys/secp256k1/internal/secp256k1"
 )
 
+// sigCacheSize is the memory given to the signature cache: 32 MiB, about a
+// million signatures. The table is only backed by memory where entries land.
+const sigCacheSize = 32 << 20
+
+// sigCache remembers valid signatures, so that a transaction verified in
+// CheckTx is accepted after a hash lookup on recheck and when its block is
+// executed. It is nil if it could not be created, and verification then
+// goes to the library every time.
+var sigCache, _ = secp256k1.NewSigCache(sigCacheSize)
+
+// pubkeyCacheMaxKeys caps the pubkey cache at 256Ki keys: about 26 MB on
+// disk and as much again in memory.
+const pubkeyCacheMaxKeys = 1 << 18
+
+// pubkeyCache holds parsed public keys across restarts once
+// EnablePubkeyCache was called.
+var pubkeyCache atomic.Pointer[secp256k1.PubkeyCache]
+
+// EnablePubkeyCache keeps the parsed (decompressed) form of every public key
+// that a valid signature is verified against from now on in the file at
+// path, and reuses the keys it already holds, so that decompressing a key is
+// paid for once per node rather than once per signature. Once the file holds
+// pubkeyCacheMaxKeys keys, no more are added. It is meant to be called once
+// at startup, e.g. with a file in the node's data directory. The file is
+// locked while the cache is open, so only one node can use it at a time.
+func EnablePubkeyCache(path string) error {
+	// Close a cache enabled before first, in case it is on the same file.
+	if old := pubkeyCache.Swap(nil); old != nil {
+		old.Close()
+	}
+	c, err := secp256k1.OpenPubkeyCache(path, pubkeyCacheMaxKeys)
+	if err != nil {
+		return err
+	}
+	pubkeyCache.Store(c)
+	return nil
+}
+
 // Sign creates an ECDSA signature on curve Secp256k1, using SHA256 on the msg.
 func (privKey *PrivKey) Sign(msg []byte) ([]byte, error) {
 	rsv, err := secp256k1.Sign(crypto.Sha256(msg), privKey.Key)
@@ -23,5 +63,11 @@ func (privKey *PrivKey) Sign(msg []byte) ([]byte, error) {
 // VerifySignature validates the signature.
 // The msg will be hashed prior to signature verification.
 func (pubKey *PubKey) VerifySignature(msg, sigStr []byte) bool {
-	return secp256k1.VerifySignature(pubKey.Bytes(), crypto.Sha256(msg), sigStr)
+	if pc := pubkeyCache.Load(); pc != nil {
+		return pc.VerifySignature(sigCache, pubKey.Bytes(), crypto.Sha256(msg), sigStr)
+	}
+	if sigCache == nil {
+		return secp256k1.VerifySignature(pubKey.Bytes(), crypto.Sha256(msg), sigStr)
+	}
+	return sigCache.VerifySignature(pubKey.Bytes(), crypto.Sha256(msg), sigStr)
 }
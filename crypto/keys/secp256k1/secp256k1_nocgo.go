@@ -53,3 +53,13 @@ func signatureFromBytes(sigStr []byte) (*ecdsa.Signature, error) {
 
 	return ecdsa.NewSignature(&r, &s), nil
 }
+
+// EnablePubkeyCache is a no-op: the persistent cache of parsed public keys
+// is only available with libsecp256k1 (the libsecp256k1_sdk build tag).
+func EnablePubkeyCache(path string) error {
+	return nil
+}
+
+// EmitTelemetry is a no-op: operation counters are only available from
+// libsecp256k1 (the libsecp256k1_sdk and libsecp256k1_stats build tags).
+func EmitTelemetry() {}
@@ -0,0 +1,44 @@
+//go:build libsecp256k1_sdk
+// +build libsecp256k1_sdk
+
+package secp256k1
+
+import (
+	"sync"
+
+	"github.com/cosmos/cosmos-sdk/crypto/keys/secp256k1/internal/secp256k1"
+	"github.com/cosmos/cosmos-sdk/telemetry"
+)
+
+var (
+	telemetryMtx  sync.Mutex
+	telemetryLast secp256k1.Stats
+)
+
+// EmitTelemetry reports the libsecp256k1 operation counters accumulated since
+// the previous call as telemetry counters under the "secp256k1" key, e.g.
+// once per block so crypto work can be set against block processing time.
+// The counters are only maintained when built with the libsecp256k1_stats tag
+// in addition to libsecp256k1_sdk; otherwise this does nothing.
+func EmitTelemetry() {
+	if !secp256k1.StatsEnabled || !telemetry.IsTelemetryEnabled() {
+		return
+	}
+
+	telemetryMtx.Lock()
+	defer telemetryMtx.Unlock()
+
+	cur := secp256k1.ReadStats()
+	prev := telemetryLast
+	telemetryLast = cur
+
+	telemetry.IncrCounter(float32(cur.FieldMul-prev.FieldMul), "secp256k1", "field_mul")
+	telemetry.IncrCounter(float32(cur.FieldSqr-prev.FieldSqr), "secp256k1", "field_sqr")
+	telemetry.IncrCounter(float32(cur.FieldInv-prev.FieldInv), "secp256k1", "field_inv")
+	telemetry.IncrCounter(float32(cur.FieldSqrt-prev.FieldSqrt), "secp256k1", "field_sqrt")
+	telemetry.IncrCounter(float32(cur.ScalarInv-prev.ScalarInv), "secp256k1", "scalar_inv")
+	telemetry.IncrCounter(float32(cur.Ecmult-prev.Ecmult), "secp256k1", "ecmult")
+	telemetry.IncrCounter(float32(cur.EcmultConst-prev.EcmultConst), "secp256k1", "ecmult_const")
+	telemetry.IncrCounter(float32(cur.EcmultGen-prev.EcmultGen), "secp256k1", "ecmult_gen")
+	telemetry.IncrCounter(float32(cur.Alloc-prev.Alloc), "secp256k1", "alloc")
+}